@@ -63,6 +63,8 @@ module fstr_frequency_analysis
 
   implicit none
 
+  character(len=8), parameter, private :: modal_basis_magic = 'FSTRMODB'
+
 contains
 
   subroutine fstr_solve_frequency_analysis(hecMESH, hecMAT, fstrSOLID, fstrEIG,  &
@@ -87,7 +89,7 @@ contains
     !C-- local variable
     !C
     integer(kind=kint)            :: numnode, numelm, startmode, endmode, nummode, ndof, im, in, ntotal, vistype
-    integer(kind=kint)            :: numfreq, idnode, numdisp
+    integer(kind=kint)            :: numfreq, idnode, numdisp, nsample, nbatch, nb, ib, k, mon
     integer(kind=kint)            :: freqiout(3)
     integer(kind=kint), parameter :: ilogin = 9056
     real(kind=kreal), allocatable :: eigenvalue(:), loadvecRe(:), loadvecIm(:)
@@ -95,6 +97,9 @@ contains
     real(kind=kreal), allocatable :: dispRe(:), dispIm(:), velRe(:), velIm(:), accRe(:), accIm(:)
     real(kind=kreal)              :: freq, omega, val, dx, dy, dz, f_start, f_end
     real(kind=kreal)              :: t_start, t_end, time, dxi, dyi, dzi
+    real(kind=kreal), allocatable :: ujRe(:), ujIm(:), sample(:), coefRe(:,:), coefIm(:,:)
+    real(kind=kreal), allocatable :: eigMonitor(:,:), dvaBatchRe(:,:), dvaBatchIm(:,:)
+    logical                       :: is_fullfield
     type(fstr_freqanalysis_data)  :: freqData
 
     numnode   = hecMESH%nn_internal
@@ -102,7 +107,13 @@ contains
     ndof      = hecMESH%n_dof
     startmode = fstrFREQ%start_mode
     endmode   = fstrFREQ%end_mode
+    !all the computed modes are used when !EIGENREAD does not narrow them down
+    if(fstrPARAM%solution_type == kstEIGENFREQ .and. endmode == 0) endmode = fstrEIG%nget
     nummode   = endmode - startmode +1
+    if(nummode < 1) then
+      write(*,*) '###ERROR### no eigen mode is given for the frequency response analysis'
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
 
     freqData%numMode    = nummode
     freqData%numNodeDOF = numnode*ndof
@@ -137,24 +148,42 @@ contains
     loadvecIm(:) = 0.0D0
 
     write(*,*) "--frequency analysis--"
-    write(*,   *) "read from=", trim(fstrFREQ%eigenlog_filename)
-    write(ilog,*) "read from=", trim(fstrFREQ%eigenlog_filename)
+    if(fstrPARAM%solution_type == kstEIGENFREQ) then
+      write(*,   *) "modes of the preceding eigen analysis"
+      write(ilog,*) "modes of the preceding eigen analysis"
+    else if(len_trim(fstrFREQ%basis_filename) > 0) then
+      write(*,   *) "read from=", trim(fstrFREQ%basis_filename)
+      write(ilog,*) "read from=", trim(fstrFREQ%basis_filename)
+    else
+      write(*,   *) "read from=", trim(fstrFREQ%eigenlog_filename)
+      write(ilog,*) "read from=", trim(fstrFREQ%eigenlog_filename)
+    end if
     write(*,   *) "start mode=", startmode
     write(ilog,*) "start mode=", startmode
     write(*,   *) "end mode=", endmode
     write(ilog,*) "end mode=", endmode
-    open(unit=ilogin, file=trim(fstrFREQ%eigenlog_filename), status="OLD", action="READ")
-    call read_eigen_values(ilogin, startmode, endmode, eigenvalue, freqData%eigOmega)
-    !call read_eigen_vector(ilogin, startmode, endmode, ndof, numnode, freqData%eigVector)
-    close(ilogin)
 
-    call read_eigen_vector_res(hecMESH, startmode, endmode, ndof, numnode, freqData%eigVector)
+    if(fstrPARAM%solution_type == kstEIGENFREQ) then
+      !eigenvalues, modes and the mass are still in memory
+      call copy_eigen_modes(fstrEIG, startmode, endmode, ndof, numnode, eigenvalue, freqData%eigOmega, freqData%eigVector)
+    else if(len_trim(fstrFREQ%basis_filename) > 0) then
+      call read_modal_basis(hecMESH, fstrFREQ%basis_filename, startmode, endmode, ndof, numnode, &
+        eigenvalue, freqData%eigOmega, freqData%eigVector, fstrEIG)
+    else
+      open(unit=ilogin, file=trim(fstrFREQ%eigenlog_filename), status="OLD", action="READ")
+      call read_eigen_values(ilogin, startmode, endmode, eigenvalue, freqData%eigOmega)
+      !call read_eigen_vector(ilogin, startmode, endmode, ndof, numnode, freqData%eigVector)
+      close(ilogin)
+
+      call read_eigen_vector_res(hecMESH, startmode, endmode, ndof, numnode, freqData%eigVector)
+
+      write(*,*) "calc mass matrix"
+      call calcMassMatrix(fstrPARAM, hecMESH, hecMAT, fstrSOLID, fstrEIG, hecLagMAT)
+    end if
 
     call extract_surf2node(hecMESH, fstrFREQ, ndof, loadvecRe, loadvecIm)
     call assemble_nodeload(hecMESH, fstrFREQ, ndof, loadvecRe, loadvecIm)
 
-    write(*,*) "calc mass matrix"
-    call calcMassMatrix(fstrPARAM, hecMESH, hecMAT, fstrSOLID, fstrEIG, hecLagMAT)
     write(*,*) "scale eigenvector"
     call scaleEigenVector(fstrEIG, ndof*numnode, nummode, freqData%eigVector)
 
@@ -167,38 +196,73 @@ contains
     write(*   ,*) "monitor nodeid=", idnode
     write(ilog,*) "monitor nodeid=", idnode
 
-    do im=1, numfreq
-      freq = (f_end-f_start)/dble(numfreq)*dble(im) + f_start
-      omega = 2.0D0 * 3.14159265358979D0 * freq
-
-      call calcFreqCoeff(freqData, loadvecRe, loadvecIm, omega, bjRe, bjIm)
-      call calcDispVector(freqData, bjRe, bjIm, dvaRe, dvaIm)
-
-      dx  = sqrt(dvaRe(3*(idnode-1)+1)**2 + dvaIm(3*(idnode-1)+1)**2)
-      dy  = sqrt(dvaRe(3*(idnode-1)+2)**2 + dvaIm(3*(idnode-1)+2)**2)
-      dz  = sqrt(dvaRe(3*(idnode-1)+3)**2 + dvaIm(3*(idnode-1)+3)**2)
-      val = sqrt(dx**2 + dy**2 + dz**2)
-      write(*,    *) freq, "[Hz] : ", val
-      write(ilog, *) freq, "[Hz] : ", val
-      disp(:) = abs(cmplx(dvaRe(:), dvaIm(:)))
-
-      call calcVelVector(freqData, omega, bjRe, bjIm, dvaRe, dvaIm)
-      vel(:) = abs(cmplx(dvaRe(:), dvaIm(:)))
+    call calcModalLoad(freqData, loadvecRe, loadvecIm, ujRe, ujIm)
+    call makeFreqSamples(freqData, f_start, f_end, numfreq, fstrFREQ%n_refine, sample, nsample)
+    if(nsample /= numfreq) then
+      write(*   ,*) "number of the refined sampling points", nsample
+      write(ilog,*) "number of the refined sampling points", nsample
+    end if
 
-      call calcAccVector(freqData, omega, bjRe, bjIm, dvaRe, dvaIm)
-      acc(:) = abs(cmplx(dvaRe(:), dvaIm(:)))
+    !the whole field is expanded only when it is written out
+    is_fullfield = (IRESULT==1) .or. (IVISUAL==1 .and. vistype==1)
+    nbatch = max(1, min(fstrFREQ%n_batch, nsample))
+    allocate(coefRe(nummode, nbatch), coefIm(nummode, nbatch))
+    if(is_fullfield) then
+      allocate(dvaBatchRe(numnode*ndof, nbatch), dvaBatchIm(numnode*ndof, nbatch))
+      mon = 3*(idnode-1)
+    else
+      allocate(eigMonitor(3, nummode))
+      eigMonitor(:,:) = freqData%eigVector(3*(idnode-1)+1:3*idnode, :)
+      allocate(dvaBatchRe(3, nbatch), dvaBatchIm(3, nbatch))
+      mon = 0
+    end if
 
-      if(IRESULT==1) then
-        write(*,   *) freq, "[Hz] : ", im, ".res"
-        write(ilog,*) freq, "[Hz] : ", im, ".res"
-        call output_resfile(hecMESH, freq, im, disp, vel, acc, freqiout)
-      end if
-      if(IVISUAL==1 .and. vistype==1) then
-        write(*,   *) freq, "[Hz] : ", im, ".vis"
-        write(ilog,*) freq, "[Hz] : ", im, ".vis"
-        call output_visfile(hecMESH, im, disp, vel, acc, freqiout)
+    do ib=1, nsample, nbatch
+      nb = min(nbatch, nsample-ib+1)
+      do k=1, nb
+        omega = 2.0D0 * 3.14159265358979D0 * sample(ib+k-1)
+        call calcFreqCoeffModal(freqData, ujRe, ujIm, omega, coefRe(:,k), coefIm(:,k))
+      end do
+      if(is_fullfield) then
+        dvaBatchRe(:,1:nb) = matmul(freqData%eigVector, coefRe(:,1:nb))
+        dvaBatchIm(:,1:nb) = matmul(freqData%eigVector, coefIm(:,1:nb))
+      else
+        dvaBatchRe(:,1:nb) = matmul(eigMonitor, coefRe(:,1:nb))
+        dvaBatchIm(:,1:nb) = matmul(eigMonitor, coefIm(:,1:nb))
       end if
+
+      do k=1, nb
+        im = ib + k - 1
+        freq = sample(im)
+        omega = 2.0D0 * 3.14159265358979D0 * freq
+
+        dx  = sqrt(dvaBatchRe(mon+1,k)**2 + dvaBatchIm(mon+1,k)**2)
+        dy  = sqrt(dvaBatchRe(mon+2,k)**2 + dvaBatchIm(mon+2,k)**2)
+        dz  = sqrt(dvaBatchRe(mon+3,k)**2 + dvaBatchIm(mon+3,k)**2)
+        val = sqrt(dx**2 + dy**2 + dz**2)
+        write(*,    *) freq, "[Hz] : ", val
+        write(ilog, *) freq, "[Hz] : ", val
+        if(.not. is_fullfield) cycle
+
+        !velocity and acceleration are i*omega and -omega**2 times the displacement
+        disp(:) = abs(cmplx(dvaBatchRe(:,k), dvaBatchIm(:,k)))
+        vel(:)  = omega*disp(:)
+        acc(:)  = omega**2*disp(:)
+
+        if(IRESULT==1) then
+          write(*,   *) freq, "[Hz] : ", im, ".res"
+          write(ilog,*) freq, "[Hz] : ", im, ".res"
+          call output_resfile(hecMESH, freq, im, disp, vel, acc, freqiout)
+        end if
+        if(IVISUAL==1 .and. vistype==1) then
+          write(*,   *) freq, "[Hz] : ", im, ".vis"
+          write(ilog,*) freq, "[Hz] : ", im, ".vis"
+          call output_visfile(hecMESH, im, disp, vel, acc, freqiout)
+        end if
+      end do
     end do
+    deallocate(coefRe, coefIm, dvaBatchRe, dvaBatchIm, sample)
+    if(allocated(eigMonitor)) deallocate(eigMonitor)
 
     call setupDYNAParam(fstrDYNAMIC, t_start, t_end, freq, numdisp)
     write(*,   *) "start time:", t_start
@@ -213,7 +277,7 @@ contains
     write(ilog,*) "num disp:", numdisp
 
     omega = 2.0D0 * 3.14159265358979D0 * freq
-    call calcFreqCoeff(freqData, loadvecRe, loadvecIm, omega, bjRe, bjIm)
+    call calcFreqCoeffModal(freqData, ujRe, ujIm, omega, bjRe, bjIm)
     call calcDispVector(freqData, bjRe, bjIm, dvaRe, dvaIm)
 
     do im=1, numdisp
@@ -258,6 +322,8 @@ contains
     deallocate(velIm)
     deallocate(accRe)
     deallocate(accIm)
+    deallocate(ujRe)
+    deallocate(ujIm)
 
   end subroutine
 
@@ -371,6 +437,134 @@ contains
 
   end subroutine
 
+  !> Write the modal basis of the eigen analysis just solved: eigenvalues,
+  !! lumped mass and mode shapes of the internal nodes, one file per rank
+  subroutine fstr_write_modal_basis(hecMESH, fstrEIG, filename)
+    !---- args
+    type(hecmwST_local_mesh), intent(in) :: hecMESH
+    type(fstr_eigen), intent(in)         :: fstrEIG
+    character(len=*), intent(in)         :: filename
+    !---- vals
+    integer(kind=kint), parameter     :: ibasis = 9057
+    integer(kind=kint)                :: imode, nndof, ierr
+    character(len=HECMW_FILENAME_LEN) :: fname
+    !---- body
+
+    nndof = hecMESH%nn_internal*hecMESH%n_dof
+    write(fname, '(a,a,i0)') trim(filename), '.', hecMESH%my_rank
+    open(unit=ibasis, file=trim(fname), status='replace', access='stream', form='unformatted', iostat=ierr)
+    if(ierr /= 0) then
+      write(*,*) '###ERROR### cannot open the modal basis file: ', trim(fname)
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
+    write(ibasis) modal_basis_magic, hecMESH%nn_internal, hecMESH%n_dof, fstrEIG%nget
+    write(ibasis) hecMESH%global_node_ID(1:hecMESH%nn_internal)
+    write(ibasis) fstrEIG%eigval(1:fstrEIG%nget)
+    write(ibasis) fstrEIG%mass(1:nndof)
+    do imode=1, fstrEIG%nget
+      write(ibasis) fstrEIG%eigvec(1:nndof, imode)
+    end do
+    close(ibasis)
+  end subroutine
+
+  !> Read the modes startmode..endmode and the lumped mass written by
+  !! fstr_write_modal_basis; the partition has to be the same
+  subroutine read_modal_basis(hecMESH, filename, startmode, endmode, numdof, numnode, &
+      eigenvalue, anglfreq, eigenvector, fstrEIG)
+    !---- args
+    type(hecmwST_local_mesh), intent(in) :: hecMESH
+    character(len=*), intent(in)         :: filename
+    integer(kind=kint), intent(in)       :: startmode
+    integer(kind=kint), intent(in)       :: endmode
+    integer(kind=kint), intent(in)       :: numdof
+    integer(kind=kint), intent(in)       :: numnode
+    real(kind=kreal), intent(inout)      :: eigenvalue(:) !intend(endmode-startmode+1)
+    real(kind=kreal), intent(inout)      :: anglfreq(:)
+    real(kind=kreal), intent(inout)      :: eigenvector(:, :) !intend (numdof*NN,nmode)
+    type(fstr_eigen), intent(inout)      :: fstrEIG
+    !---- vals
+    integer(kind=kint), parameter     :: ibasis = 9057
+    integer(kind=kint)                :: imode, nn, nd, nmode, ierr
+    integer(kind=kint), allocatable   :: gid(:)
+    real(kind=kreal), allocatable     :: eigval(:)
+    character(len=8)                  :: magic
+    character(len=HECMW_FILENAME_LEN) :: fname
+    !---- body
+
+    write(fname, '(a,a,i0)') trim(filename), '.', hecMESH%my_rank
+    open(unit=ibasis, file=trim(fname), status='old', access='stream', form='unformatted', action='read', iostat=ierr)
+    if(ierr /= 0) then
+      write(*,*) '###ERROR### cannot open the modal basis file: ', trim(fname)
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
+    read(ibasis, iostat=ierr) magic, nn, nd, nmode
+    if(ierr /= 0 .or. magic /= modal_basis_magic) then
+      write(*,*) '###ERROR### not a modal basis file: ', trim(fname)
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
+
+    !the mode shapes are stored by local node, so the partition must match
+    allocate(gid(nn))
+    if(nn == numnode .and. nd == numdof) read(ibasis) gid
+    if(nn /= numnode .or. nd /= numdof) then
+      ierr = 1
+    else if(any(gid(:) /= hecMESH%global_node_ID(1:numnode))) then
+      ierr = 1
+    end if
+    deallocate(gid)
+    if(ierr /= 0) then
+      write(*,*) '###ERROR### the modal basis was written for another mesh partition: ', trim(fname)
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
+    if(startmode < 1 .or. nmode < endmode) then
+      write(*,*) '###ERROR### the modal basis holds modes 1 to', nmode
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
+
+    allocate(eigval(nmode))
+    read(ibasis) eigval
+    eigenvalue(1:endmode-startmode+1) = eigval(startmode:endmode)
+    anglfreq(1:endmode-startmode+1) = sqrt(max(eigenvalue(1:endmode-startmode+1), 0.0D0))
+    deallocate(eigval)
+
+    allocate(fstrEIG%mass(numdof*numnode))
+    read(ibasis) fstrEIG%mass
+
+    !modes below startmode are read into the first column and overwritten
+    do imode=1, endmode
+      read(ibasis) eigenvector(:, max(imode-startmode+1, 1))
+    end do
+    close(ibasis)
+  end subroutine
+
+  !> Take the modes startmode..endmode from the eigen analysis of this run
+  subroutine copy_eigen_modes(fstrEIG, startmode, endmode, numdof, numnode, eigenvalue, anglfreq, eigenvector)
+    !---- args
+    type(fstr_eigen), intent(in)    :: fstrEIG
+    integer(kind=kint), intent(in)  :: startmode
+    integer(kind=kint), intent(in)  :: endmode
+    integer(kind=kint), intent(in)  :: numdof
+    integer(kind=kint), intent(in)  :: numnode
+    real(kind=kreal), intent(inout) :: eigenvalue(:) !intend(endmode-startmode+1)
+    real(kind=kreal), intent(inout) :: anglfreq(:)
+    real(kind=kreal), intent(inout) :: eigenvector(:, :) !intend (numdof*NN,nmode)
+    !---- vals
+    integer(kind=kint) :: imode, idx
+    !---- body
+
+    if(startmode < 1 .or. fstrEIG%nget < endmode) then
+      write(*,*) '###ERROR### the eigen analysis computed modes 1 to', fstrEIG%nget
+      call hecmw_abort(hecmw_comm_get_comm())
+    end if
+
+    do imode=startmode, endmode
+      idx = imode - startmode + 1
+      eigenvalue(idx) = fstrEIG%eigval(imode)
+      anglfreq(idx) = sqrt(max(fstrEIG%eigval(imode), 0.0D0))
+      eigenvector(:, idx) = fstrEIG%eigvec(1:numdof*numnode, imode)
+    end do
+  end subroutine
+
   subroutine read_eigen_vector_res(hecMESH, startmode, endmode, numdof, numnode, eigenvector)
     !---- args
     type(hecmwST_local_mesh), intent(in) :: hecMESH
@@ -384,17 +578,30 @@ contains
     integer(kind=kint)            :: imode, idx, ind, a, b, nallcomp, j
     type(hecmwST_result_data)     :: eigenres
     character(len=HECMW_NAME_LEN) :: name
+    character(len=HECMW_NAME_LEN) :: labels(2)
     !---- body
 
     name = 'result-in'
+    labels(1) = 'DISPLACEMENT'
+    labels(2) = 'ROTATION'
     do imode=startmode, endmode
+      !only the mode shape is read from the result of the eigen analysis
       call nullify_result_data(eigenres)
-      call hecmw_result_read_by_name(hecMESH, name, imode, eigenres)
+      call hecmw_result_read_subset_by_name(hecMESH, name, imode, 2, labels, eigenres)
 
       nallcomp = 0
       do ind=1,eigenres%nn_component
         nallcomp = nallcomp + eigenres%nn_dof(ind)
       end do
+      if(nallcomp < numdof) then
+        call free_result_data(eigenres)
+        call nullify_result_data(eigenres)
+        call hecmw_result_read_by_name(hecMESH, name, imode, eigenres)
+        nallcomp = 0
+        do ind=1,eigenres%nn_component
+          nallcomp = nallcomp + eigenres%nn_dof(ind)
+        end do
+      end if
 
       idx = imode - startmode + 1
       do ind=1, numnode
@@ -761,6 +968,44 @@ contains
     real(kind=kreal), intent(inout)          :: bjRe(:) !intend (numMode)
     real(kind=kreal), intent(inout)          :: bjIm(:) !intend (numMode)
     !---- vals
+    real(kind=kreal), allocatable :: ujRe(:), ujIm(:)
+    !---- body
+
+    call calcModalLoad(freqData, loadRe, loadIm, ujRe, ujIm)
+    call calcFreqCoeffModal(freqData, ujRe, ujIm, inpOmega, bjRe, bjIm)
+    deallocate(ujRe, ujIm)
+    return
+  end subroutine
+
+  !> Projection of the load onto the modes, which does not depend on the frequency
+  subroutine calcModalLoad(freqData, loadRe, loadIm, ujRe, ujIm)
+    !---- args
+    type(fstr_freqanalysis_data), intent(in)   :: freqData
+    real(kind=kreal), intent(in)               :: loadRe(:) !intend (numNodeDOF)
+    real(kind=kreal), intent(in)               :: loadIm(:) !intend (numNodeDOF)
+    real(kind=kreal), allocatable, intent(out) :: ujRe(:) !intend (numMode)
+    real(kind=kreal), allocatable, intent(out) :: ujIm(:) !intend (numMode)
+    !---- vals
+    integer(kind=kint) :: imode
+    !---- body
+
+    allocate(ujRe(freqData%numMode), ujIm(freqData%numMode))
+    do imode=1, freqData%numMode
+      call calcDotProduct(freqData%eigVector(:,imode), loadRe, ujRe(imode))
+      call calcDotProduct(freqData%eigVector(:,imode), loadIm, ujIm(imode))
+    end do
+    return
+  end subroutine
+
+  subroutine calcFreqCoeffModal(freqData, ujRe, ujIm, inpOmega, bjRe, bjIm)
+    !---- args
+    type(fstr_freqanalysis_data), intent(in) :: freqData
+    real(kind=kreal), intent(in)             :: ujRe(:) !intend (numMode)
+    real(kind=kreal), intent(in)             :: ujIm(:) !intend (numMode)
+    real(kind=kreal), intent(in)             :: inpOmega
+    real(kind=kreal), intent(inout)          :: bjRe(:) !intend (numMode)
+    real(kind=kreal), intent(inout)          :: bjIm(:) !intend (numMode)
+    !---- vals
     integer(kind=kint) :: imode
     real(kind=kreal)   :: ujfr, ujfi, a, b, alp, beta
     !---- body
@@ -769,8 +1014,8 @@ contains
     beta = freqData%rayBeta
 
     do imode=1, freqData%numMode
-      call calcDotProduct(freqData%eigVector(:,imode), loadRe, ujfr)
-      call calcDotProduct(freqData%eigVector(:,imode), loadIm, ujfi)
+      ujfr = ujRe(imode)
+      ujfi = ujIm(imode)
 
       a = ujfr*(freqData%eigOmega(imode)**2 - inpOmega**2) + ujfi*(alp + beta*freqData%eigOmega(imode)**2)*inpOmega
       b = (freqData%eigOmega(imode)**2 - inpOmega**2)**2 + ((alp + beta*freqData%eigOmega(imode)**2)*inpOmega)**2
@@ -783,6 +1028,91 @@ contains
     return
   end subroutine
 
+  !> Sampling frequencies: numfreq uniform points in (f_start, f_end] and, if
+  !! nrefine > 0, 4*nrefine+1 points within two half-power bandwidths of
+  !! every damped natural frequency in the range
+  subroutine makeFreqSamples(freqData, f_start, f_end, numfreq, nrefine, sample, nsample)
+    !---- args
+    type(fstr_freqanalysis_data), intent(in)   :: freqData
+    real(kind=kreal), intent(in)               :: f_start
+    real(kind=kreal), intent(in)               :: f_end
+    integer(kind=kint), intent(in)             :: numfreq
+    integer(kind=kint), intent(in)             :: nrefine
+    real(kind=kreal), allocatable, intent(out) :: sample(:)
+    integer(kind=kint), intent(out)            :: nsample
+    !---- vals
+    real(kind=kreal), allocatable :: work(:)
+    real(kind=kreal)   :: fn, zeta, bw, f, tol
+    integer(kind=kint) :: im, imode, k, n
+    !---- body
+
+    allocate(work(numfreq + freqData%numMode*(4*max(nrefine,0)+1)))
+    n = 0
+    do im=1, numfreq
+      n = n + 1
+      work(n) = (f_end-f_start)/dble(numfreq)*dble(im) + f_start
+    end do
+
+    if(nrefine > 0) then
+      do imode=1, freqData%numMode
+        fn = freqData%eigOmega(imode) / (2.0D0 * 3.14159265358979D0)
+        zeta = 0.5D0*(freqData%rayAlpha/freqData%eigOmega(imode) + freqData%rayBeta*freqData%eigOmega(imode))
+        if(zeta <= 0.0D0) cycle
+        bw = 2.0D0*zeta*fn
+        do k=-2*nrefine, 2*nrefine
+          f = fn + bw*dble(k)/dble(nrefine)
+          if(f <= f_start .or. f_end < f) cycle
+          n = n + 1
+          work(n) = f
+        end do
+      end do
+    end if
+
+    call quick_sort_real(work, 1, n)
+    tol = 1.0D-9*abs(f_end-f_start)
+    allocate(sample(n))
+    nsample = 0
+    do im=1, n
+      if(nsample > 0) then
+        if(work(im) - sample(nsample) <= tol) cycle
+      end if
+      nsample = nsample + 1
+      sample(nsample) = work(im)
+    end do
+    deallocate(work)
+  end subroutine
+
+  recursive subroutine quick_sort_real(a, is, ie)
+    !---- args
+    real(kind=kreal), intent(inout) :: a(:)
+    integer(kind=kint), intent(in)  :: is, ie
+    !---- vals
+    real(kind=kreal)   :: p, w
+    integer(kind=kint) :: i, j
+    !---- body
+
+    if(is >= ie) return
+    p = a((is+ie)/2)
+    i = is
+    j = ie
+    do
+      do while(a(i) < p)
+        i = i + 1
+      end do
+      do while(p < a(j))
+        j = j - 1
+      end do
+      if(i >= j) exit
+      w = a(i)
+      a(i) = a(j)
+      a(j) = w
+      i = i + 1
+      j = j - 1
+    end do
+    call quick_sort_real(a, is, j)
+    call quick_sort_real(a, j+1, ie)
+  end subroutine
+
   subroutine calcDispVector(freqData, bjRe, bjIm, dispRe, dispIm)
     !---- args
     type(fstr_freqanalysis_data), intent(in) :: freqData
@@ -55,7 +55,11 @@ contains
 
     call fstr_eigen_output(hecMESH, hecMAT, fstrEIG)
 
-    call fstr_eigen_make_result(hecMESH, hecMAT, fstrEIG, fstrRESULT)
+    !the modes of a combined eigen and frequency response analysis are
+    !passed on in memory, and the result files are kept for the response
+    if(fstrPARAM%solution_type /= kstEIGENFREQ) then
+      call fstr_eigen_make_result(hecMESH, hecMAT, fstrEIG, fstrRESULT)
+    endif
 
     call hecmw_mpc_mat_finalize(hecMESH, hecMAT, hecMESHmpc, hecMATmpc)
 
@@ -8,6 +8,7 @@ contains
 
   subroutine heat_init(hecMESH, fstrHEAT)
     use m_fstr
+    use m_heat_viewfactor
     implicit none
     type(fstr_heat) :: fstrHEAT
     type(hecmwST_local_mesh) :: hecMESH
@@ -42,8 +43,38 @@ contains
         enddo
         write(ILOG,*) ' Initial condition of temperatures: OK'
     endif
+
+    call heat_init_linear(hecMESH, fstrHEAT)
+    call heat_init_viewfactor(hecMESH, fstrHEAT)
   end subroutine heat_init
 
+  !> A problem with temperature independent materials and without radiation
+  !! has constant conductivity and capacity matrices, which are then
+  !! assembled only once and solved without equilibrium iteration.
+  subroutine heat_init_linear(hecMESH, fstrHEAT)
+    use m_fstr
+    implicit none
+    type(fstr_heat) :: fstrHEAT
+    type(hecmwST_local_mesh) :: hecMESH
+    integer(kind=kint) :: itype, im, is_linear
+
+    is_linear = 1
+    if(fstrHEAT%R_SUF_tot > 0) is_linear = 0
+    do itype = 1, hecMESH%n_elem_type
+      if(hecMESH%elem_type_item(itype) == 541) is_linear = 0
+    enddo
+    do im = 1, fstrHEAT%MATERIALtot
+      if(any(fstrHEAT%COND(im,1:fstrHEAT%CONDtab(im)) /= fstrHEAT%COND(im,1))) is_linear = 0
+      if(any(fstrHEAT%CP  (im,1:fstrHEAT%CPtab  (im)) /= fstrHEAT%CP  (im,1))) is_linear = 0
+      if(any(fstrHEAT%RHO (im,1:fstrHEAT%RHOtab (im)) /= fstrHEAT%RHO (im,1))) is_linear = 0
+    enddo
+    call hecmw_allREDUCE_I1(hecMESH, is_linear, hecmw_min)
+
+    fstrHEAT%is_linear = (is_linear == 1)
+    fstrHEAT%LIN_dtime = -1.0d0
+    if(fstrHEAT%is_linear) write(ILOG,*) ' Linear heat transfer: conductivity and capacity assembled once'
+  end subroutine heat_init_linear
+
   subroutine heat_init_log(hecMESH)
     use m_fstr
     implicit none
@@ -66,6 +97,17 @@ contains
     deallocate(fstrHEAT%TEMP0)
     deallocate(fstrHEAT%TEMPC)
     deallocate(fstrHEAT%TEMP )
+    if(associated(fstrHEAT%LIN_KD )) deallocate(fstrHEAT%LIN_KD )
+    if(associated(fstrHEAT%LIN_KAU)) deallocate(fstrHEAT%LIN_KAU)
+    if(associated(fstrHEAT%LIN_KAL)) deallocate(fstrHEAT%LIN_KAL)
+    if(associated(fstrHEAT%LIN_CAP)) deallocate(fstrHEAT%LIN_CAP)
+    if(associated(fstrHEAT%LIN_BC )) deallocate(fstrHEAT%LIN_BC )
+    if(associated(fstrHEAT%R_SUF_vf)) deallocate(fstrHEAT%R_SUF_vf)
+    if(associated(fstrHEAT%VF_index)) deallocate(fstrHEAT%VF_index)
+    if(associated(fstrHEAT%VF_item )) deallocate(fstrHEAT%VF_item )
+    if(associated(fstrHEAT%VF_val  )) deallocate(fstrHEAT%VF_val  )
+    if(associated(fstrHEAT%VF_sink )) deallocate(fstrHEAT%VF_sink )
+    fstrHEAT%VF_n = 0
   end subroutine heat_finalize
 
   !C***
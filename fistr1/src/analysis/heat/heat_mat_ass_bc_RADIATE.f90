@@ -16,6 +16,7 @@ contains
     use m_fstr
     use m_heat_get_amplitude
     use m_heat_LIB_RADIATE
+    use m_heat_viewfactor
 
     implicit none
     integer(kind=kint) :: k, icel, isuf, iam1, iam2, ic_type, isect, nn, is, j, mm, m, ic, ip
@@ -30,6 +31,7 @@ contains
     integer(kind=kint) :: nodLocal(20), nsuf(8), nodSurf(8)
 
     TZERO = hecMESH%zero_temp
+    call heat_update_viewfactor_sink( hecMESH, fstrHEAT, CTIME )
     !C
     do k = 1, fstrHEAT%R_SUF_tot
       icel    = fstrHEAT%R_SUF_elem(k)
@@ -40,6 +42,9 @@ contains
       RR      = fstrHEAT%R_SUF_val (k,1) * QQ
       call heat_get_amplitude ( fstrHEAT, iam2, CTIME, QQ )
       SINK    = fstrHEAT%R_SUF_val (k,2) * QQ
+      if( fstrHEAT%VF_n > 0 ) then
+        if( fstrHEAT%R_SUF_vf(k) > 0 ) SINK = fstrHEAT%VF_sink( fstrHEAT%R_SUF_vf(k) )
+      endif
       ic_type = hecMESH%elem_type(icel)
       isect   = hecMESH%section_ID(icel)
       !C**
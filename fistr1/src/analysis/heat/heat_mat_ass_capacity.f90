@@ -20,6 +20,19 @@ contains
 
     beta = fstrHEAT%beta
 
+    if(fstrHEAT%is_linear .and. associated(fstrHEAT%LIN_CAP))then
+      do inod = 1, hecMESH%n_node
+        hecMAT%D(inod) = hecMAT%D(inod) + fstrHEAT%LIN_CAP(inod) / delta_time
+        hecMAT%B(inod) = hecMAT%B(inod) + fstrHEAT%LIN_CAP(inod)*fstrHEAT%TEMP0(inod) / delta_time
+      enddo
+      return
+    endif
+
+    if(fstrHEAT%is_linear)then
+      allocate(fstrHEAT%LIN_CAP(hecMESH%n_node))
+      fstrHEAT%LIN_CAP = 0.0d0
+    endif
+
     do itype = 1, hecMESH%n_elem_type
       iS = hecMESH%elem_type_index(itype-1) + 1
       iE = hecMESH%elem_type_index(itype  )
@@ -95,6 +108,13 @@ contains
           !$omp atomic
           hecMAT%B(inod) = hecMAT%B(inod) + lumped(ip)*temp(ip) / delta_time
         enddo
+        if(fstrHEAT%is_linear)then
+          do ip = 1, nn
+            inod = nodLOCAL(ip)
+            !$omp atomic
+            fstrHEAT%LIN_CAP(inod) = fstrHEAT%LIN_CAP(inod) + lumped(ip)
+          enddo
+        endif
       enddo
       !$omp end do
       !$omp end parallel
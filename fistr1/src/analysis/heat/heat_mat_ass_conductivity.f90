@@ -6,6 +6,53 @@ module m_heat_mat_ass_conductivity
 contains
 
   subroutine heat_mat_ass_conductivity( hecMESH,hecMAT,fstrHEAT,beta )
+    use hecmw
+    use m_fstr
+    implicit none
+    type(fstr_heat)          :: fstrHEAT
+    type(hecmwST_matrix)     :: hecMAT
+    type(hecmwST_local_mesh) :: hecMESH
+    real(kind=kreal)   :: beta, ALFA
+    real(kind=kreal), allocatable :: S(:)
+
+    ALFA = 1.0 - beta
+
+    if(fstrHEAT%is_linear .and. associated(fstrHEAT%LIN_KD))then
+      hecMAT%D  = fstrHEAT%LIN_KD
+      hecMAT%AU = fstrHEAT%LIN_KAU
+      hecMAT%AL = fstrHEAT%LIN_KAL
+      call hecmw_mat_clear_b(hecMAT)
+    else
+      call hecmw_mat_clear(hecMAT)
+      call hecmw_mat_clear_b(hecMAT)
+      call heat_mat_ass_conductivity_elem(hecMESH, hecMAT, fstrHEAT)
+
+      if(fstrHEAT%is_linear)then
+        allocate(fstrHEAT%LIN_KD(size(hecMAT%D)))
+        allocate(fstrHEAT%LIN_KAU(size(hecMAT%AU)))
+        allocate(fstrHEAT%LIN_KAL(size(hecMAT%AL)))
+        fstrHEAT%LIN_KD  = hecMAT%D
+        fstrHEAT%LIN_KAU = hecMAT%AU
+        fstrHEAT%LIN_KAL = hecMAT%AL
+      endif
+    endif
+
+    allocate(S(hecMAT%NP))
+    S = 0.0d0
+
+    call hecmw_matvec(hecMESH, hecMAT, fstrHEAT%TEMP0, S)
+
+    hecMAT%D  = beta*hecMAT%D
+    hecMAT%AU = beta*hecMAT%AU
+    hecMAT%AL = beta*hecMAT%AL
+    hecMAT%B  = hecMAT%B - ALFA*S
+
+    deallocate(S)
+
+  end subroutine heat_mat_ass_conductivity
+
+  !> Assemble the conductivity matrix at the current temperature
+  subroutine heat_mat_ass_conductivity_elem( hecMESH,hecMAT,fstrHEAT )
     use hecmw
     use m_fstr
     use m_heat_lib
@@ -14,19 +61,13 @@ contains
     type(fstr_heat)          :: fstrHEAT
     type(hecmwST_matrix)     :: hecMAT
     type(hecmwST_local_mesh) :: hecMESH
-    integer(kind=kint) :: itype, is, iE, ic_type, icel, isect, IMAT, ntab, itab, NDOF
-    integer(kind=kint) :: in0, nn, i, in, j, nodLOCAL(20), jsect, ic, ip, inod, jp, jnod, isU, ieU, ik, isL, ieL
-    real(kind=kreal)   :: beta, TZERO, ALFA, temp(1000), funcA(1000), funcB(1000), TT(20), T0(20), SS(400)
+    integer(kind=kint) :: itype, is, iE, ic_type, icel, isect, IMAT, ntab, itab
+    integer(kind=kint) :: in0, nn, i, in, j, nodLOCAL(20), jsect
+    real(kind=kreal)   :: TZERO, temp(1000), funcA(1000), funcB(1000), TT(20), SS(400)
     real(kind=kreal)   :: asect, thick, GTH, GHH, GR1, GR2
-    real(kind=kreal) :: lumped(20), stiff(20, 20), ecoord(3,20)
-    real(kind=kreal), allocatable :: S(:)
+    real(kind=kreal) :: stiff(20, 20), ecoord(3,20)
 
-    NDOF = hecMESH%n_dof
     TZERO = hecMESH%zero_temp
-    ALFA = 1.0 - beta
-
-    call hecmw_mat_clear(hecMAT)
-    call hecmw_mat_clear_b(hecMAT)
 
     do itype = 1, hecMESH%n_elem_type
       iS = hecMESH%elem_type_index(itype-1) + 1
@@ -130,18 +171,5 @@ contains
       !$omp end do
       !$omp end parallel
     enddo
-
-    allocate(S(hecMAT%NP))
-    S = 0.0d0
-
-    call hecmw_matvec(hecMESH, hecMAT, fstrHEAT%TEMP0, S)
-
-    hecMAT%D  = beta*hecMAT%D
-    hecMAT%AU = beta*hecMAT%AU
-    hecMAT%AL = beta*hecMAT%AL
-    hecMAT%B  = hecMAT%B - ALFA*S
-
-    deallocate(S)
-
-  end subroutine heat_mat_ass_conductivity
+  end subroutine heat_mat_ass_conductivity_elem
 end module m_heat_mat_ass_conductivity
@@ -20,6 +20,9 @@ contains
     integer(kind=kint) :: total_step
     real(kind=kreal)   :: start_time, delta_time_base, delta_time, current_time, next_time, total_time, end_time, DELMAX, DELMIN
     real(kind=kreal)   :: tmpmax, dltmp, tmpmax_myrank, remain_time
+    real(kind=kreal)   :: ERRTOL, err, err_old, fac, dt_hist(2)
+    real(kind=kreal), allocatable :: TEMPH(:,:)
+    integer(kind=kint) :: n_hist, order
     type(hecmwST_local_mesh)  :: hecMESH
     type(hecmwST_matrix)      :: hecMAT
     type(hecmwST_result_data) :: fstrRESULT
@@ -47,6 +50,7 @@ contains
     is_end = .false.
     hecMAT%NDOF = 1
     hecMAT%Iarray(98) = 1 !Assembly complete
+    fstrHEAT%LIN_dtime = -1.0d0
     hecMAT%X = 0.0d0
 
     if(fstrHEAT%beta == -1.0d0)then
@@ -57,6 +61,17 @@ contains
       endif
     endif
 
+    ERRTOL = 0.0d0
+    if(fstrHEAT%is_steady /= 1) ERRTOL = fstrHEAT%ERRTOL
+    if(0.0d0 < ERRTOL)then
+      allocate(TEMPH(hecMESH%n_node,2))
+      n_hist = 0
+      dt_hist = 0.0d0
+      err_old = 1.0d0
+      order = 1
+      if(fstrHEAT%beta == 0.5d0) order = 2
+    endif
+
     if(fstrHEAT%is_steady /= 1 .and. total_step == 1) then
       call heat_output_result(hecMESH, fstrHEAT, 0, total_time, .true.)
       call heat_output_visual(hecMESH, fstrRESULT, fstrHEAT, 0, total_time, .true.)
@@ -68,7 +83,7 @@ contains
       if(end_time <= current_time + delta_time_base + delta_time_base*1.0d-6) then
         delta_time_base = end_time - current_time
       endif
-      if( 0.0d0 < DELMIN .and. fstrHEAT%timepoint_id > 0 ) then
+      if( (0.0d0 < DELMIN .or. 0.0d0 < ERRTOL) .and. fstrHEAT%timepoint_id > 0 ) then
         remain_time = get_remain_to_next_timepoints(total_time, 0.0d0, fstrPARAM%timepoints(fstrHEAT%timepoint_id))
         delta_time = dmin1(delta_time_base, remain_time)
       else
@@ -83,7 +98,7 @@ contains
         if( (end_time - next_time) / end_time < 1.d-12 ) is_end = .true.
       endif
 
-      if( 0.0d0 < DELMIN .and. fstrHEAT%timepoint_id > 0 ) then
+      if( (0.0d0 < DELMIN .or. 0.0d0 < ERRTOL) .and. fstrHEAT%timepoint_id > 0 ) then
         outflag = is_end .or. is_at_timepoints(total_time, 0.0d0, fstrPARAM%timepoints(fstrHEAT%timepoint_id))
       else
         outflag = is_end
@@ -103,7 +118,44 @@ contains
 
       call heat_solve_main(hecMESH, hecMAT, hecMESHmpc, hecMATmpc, fstrPARAM, fstrHEAT, ISTEP, iterALL, total_time, delta_time)
 
-      if(0.0d0 < DELMIN)then
+      if(0.0d0 < ERRTOL)then
+        if(fstrHEAT%is_iter_max_limit)then
+          if(delta_time <= 1.0d-8*end_time) call hecmw_abort( hecmw_comm_get_comm() )
+          fstrHEAT%TEMP(:) = fstrHEAT%TEMP0(:)
+          delta_time_base = 0.5d0*delta_time
+          cycle tr_loop
+        endif
+
+        if(order <= n_hist)then
+          err = heat_estimate_error(hecMESH, fstrHEAT, TEMPH, dt_hist, order, delta_time)/ERRTOL
+          if(1.0d0 < err .and. 1.0d-8*end_time < delta_time)then
+            if(hecMESH%my_rank == 0)then
+              write(*,*) ' *** EXCEEDED TOLERANCE OF LOCAL TRUNCATION ERROR.'
+              write(*,*) ' : ERROR / ERRTOL = ', err
+            endif
+            fstrHEAT%TEMP(:) = fstrHEAT%TEMP0(:)
+            delta_time_base = delta_time*max(0.2d0, 0.9d0*err**(-1.0d0/(order+1)))
+            cycle tr_loop
+          endif
+
+          !C PI controller; small increases are ignored to keep the factorized matrix
+          fac = 0.9d0*max(err, 1.0d-4)**(-0.7d0/(order+1))*err_old**(0.4d0/(order+1))
+          fac = min(5.0d0, max(0.2d0, fac))
+          if(1.0d0 <= fac .and. fac < 1.25d0) fac = 1.0d0
+          err_old = max(err, 1.0d-4)
+          if(delta_time < delta_time_base)then
+            delta_time_base = min(delta_time_base, delta_time*fac)
+          else
+            delta_time_base = delta_time*fac
+          endif
+        endif
+
+        TEMPH(:,2) = TEMPH(:,1)
+        TEMPH(:,1) = fstrHEAT%TEMP0(:)
+        dt_hist(2) = dt_hist(1)
+        dt_hist(1) = delta_time
+        n_hist = min(n_hist + 1, 2)
+      elseif(0.0d0 < DELMIN)then
         tmpmax = 0.0d0
         do i = 1, hecMESH%nn_internal
           inod = fstrPARAM%global_local_id(1,i)
@@ -148,7 +200,47 @@ contains
     enddo tr_loop
     !C--------------------   END TRANSIENT LOOP   ------------------------
 
+    if(allocated(TEMPH)) deallocate(TEMPH)
     call hecmw_mpc_mat_finalize(hecMESH, hecMAT, hecMESHmpc, hecMATmpc)
 
   end subroutine heat_solve_TRAN
+
+  !> Local truncation error of the step from TEMP0 to TEMP, estimated by
+  !! comparing it with an explicit predictor extrapolated from the last
+  !! accepted temperatures TEMPH (Milne's device). The predictor is linear
+  !! for first order schemes and quadratic for Crank-Nicolson (order = 2).
+  function heat_estimate_error(hecMESH, fstrHEAT, TEMPH, dt_hist, order, delta_time) result(err)
+    use m_fstr
+    implicit none
+    type(hecmwST_local_mesh) :: hecMESH
+    type(fstr_heat)          :: fstrHEAT
+    real(kind=kreal)   :: TEMPH(:,:), dt_hist(2), delta_time, err
+    integer(kind=kint) :: order
+    real(kind=kreal)   :: h1, h2, w0, w1, w2, c_lte, c_pred, pred
+    integer(kind=kint) :: i
+
+    h1 = dt_hist(1)
+    h2 = dt_hist(2)
+    if(order == 1)then
+      w0 = 1.0d0 + delta_time/h1
+      w1 = -delta_time/h1
+      w2 = 0.0d0
+      c_lte  = (fstrHEAT%beta - 0.5d0)*delta_time*delta_time
+      c_pred = 0.5d0*delta_time*(delta_time + h1)
+    else
+      w0 = (delta_time + h1)*(delta_time + h1 + h2)/(h1*(h1 + h2))
+      w1 = -delta_time*(delta_time + h1 + h2)/(h1*h2)
+      w2 = delta_time*(delta_time + h1)/((h1 + h2)*h2)
+      c_lte  = -delta_time*delta_time*delta_time/12.0d0
+      c_pred = delta_time*(delta_time + h1)*(delta_time + h1 + h2)/6.0d0
+    endif
+
+    err = 0.0d0
+    do i = 1, hecMESH%nn_internal
+      pred = w0*fstrHEAT%TEMP0(i) + w1*TEMPH(i,1) + w2*TEMPH(i,2)
+      err = max(err, dabs(fstrHEAT%TEMP(i) - pred))
+    enddo
+    call hecmw_allREDUCE_R1(hecMESH, err, hecmw_max)
+    err = err*dabs(c_lte)/dabs(c_lte + c_pred)
+  end function heat_estimate_error
 end module m_heat_solve_TRAN
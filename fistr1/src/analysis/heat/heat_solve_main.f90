@@ -33,6 +33,9 @@ contains
       call heat_mat_ass_boundary(hecMESH, hecMAT, hecMESHmpc, hecMATmpc, fstrHEAT, next_time, delta_time)
 
       hecMATmpc%Iarray(97) = 1 !Need numerical factorization
+      if(fstrHEAT%is_linear)then
+        if(heat_is_matrix_unchanged(hecMESH, fstrHEAT, next_time, delta_time)) hecMATmpc%Iarray(97) = 0
+      endif
       bup_n_dof = hecMESH%n_dof
       hecMESH%n_dof = 1
       call solve_LINEQ(hecMESHmpc, hecMATmpc)
@@ -47,9 +50,50 @@ contains
       call heat_check_convergence(hecMESH, fstrHEAT, fstrPARAM, ISTEP, iterALL, is_congerged)
 
       if(is_congerged .or. fstrHEAT%is_iter_max_limit .or. fstrHEAT%beta == 0.0d0) exit
+      if(fstrHEAT%is_linear) exit
     enddo
   end subroutine heat_solve_main
 
+  !> In a linear problem the matrix changes only with the time increment,
+  !! the FILM coefficient amplitudes and the set of active FIXT nodes.
+  !! Returns .true. when the factorization of the last step can be reused.
+  function heat_is_matrix_unchanged(hecMESH, fstrHEAT, next_time, delta_time) result(is_unchanged)
+    use m_fstr
+    use m_heat_get_amplitude
+    implicit none
+    type(hecmwST_local_mesh)  :: hecMESH
+    type(fstr_heat)           :: fstrHEAT
+    real(kind=kreal)   :: next_time, delta_time, QQ
+    integer(kind=kint) :: k, n, is_same
+    logical :: is_unchanged, OutOfRange
+
+    n = fstrHEAT%H_SUF_tot + fstrHEAT%T_FIX_tot
+    is_same = 1
+    if(.not. associated(fstrHEAT%LIN_BC))then
+      allocate(fstrHEAT%LIN_BC(n))
+      fstrHEAT%LIN_BC = 0.0d0
+      is_same = 0
+    endif
+    if(fstrHEAT%LIN_dtime /= delta_time) is_same = 0
+
+    do k = 1, fstrHEAT%H_SUF_tot
+      call heat_get_amplitude(fstrHEAT, fstrHEAT%H_SUF_ampl(k,1), next_time, QQ)
+      if(fstrHEAT%LIN_BC(k) /= QQ) is_same = 0
+      fstrHEAT%LIN_BC(k) = QQ
+    enddo
+    do k = 1, fstrHEAT%T_FIX_tot
+      call heat_get_amplitude(fstrHEAT, fstrHEAT%T_FIX_ampl(k), next_time, QQ, OutOfRange)
+      QQ = 1.0d0
+      if(OutOfRange) QQ = 0.0d0
+      if(fstrHEAT%LIN_BC(fstrHEAT%H_SUF_tot+k) /= QQ) is_same = 0
+      fstrHEAT%LIN_BC(fstrHEAT%H_SUF_tot+k) = QQ
+    enddo
+    fstrHEAT%LIN_dtime = delta_time
+
+    call hecmw_allREDUCE_I1(hecMESH, is_same, hecmw_min)
+    is_unchanged = (is_same == 1)
+  end function heat_is_matrix_unchanged
+
   subroutine heat_check_convergence(hecMESH, fstrHEAT, fstrPARAM, ISTEP, iterALL, is_congerged)
     use m_fstr
     implicit none
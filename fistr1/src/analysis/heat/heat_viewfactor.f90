@@ -0,0 +1,399 @@
+!-------------------------------------------------------------------------------
+! Copyright (c) 2019 FrontISTR Commons
+! This software is released under the MIT License, see LICENSE.txt
+!-------------------------------------------------------------------------------
+!> \brief This module provides surface-to-surface radiation between the
+!! RADIATE facets of a cavity
+!!
+!! The view factors of all cavity facets are computed once and cached in
+!! the file fstrVF_<hash>.dat, where the hash is taken over the facet
+!! geometry and the number of rays. A later run with the same geometry
+!! reads the file instead of casting rays again.
+!! At each assembly the radiosity of the gray diffuse enclosure is solved
+!! with the current temperatures, and the irradiation of a facet is
+!! converted into an effective SINK temperature for heat_RADIATE_xxx.
+module m_heat_viewfactor
+  use m_fstr
+  use m_heat_LIB_VIEWFACTOR
+  implicit none
+
+  private
+  public :: heat_init_viewfactor
+  public :: heat_update_viewfactor_sink
+
+  integer(kind=8), parameter :: HASH_P  = 2147483647_8
+  integer(kind=8), parameter :: HASH_B1 = 131_8
+  integer(kind=8), parameter :: HASH_B2 = 1000003_8
+  character(len=8), parameter :: VF_MAGIC = 'FSTRVF01'
+
+contains
+
+  !> Gather the cavity facets of all ranks, load or compute their view
+  !! factors and map every local RADIATE facet to its row
+  subroutine heat_init_viewfactor(hecMESH, fstrHEAT)
+    type(hecmwST_local_mesh) :: hecMESH
+    type(fstr_heat) :: fstrHEAT
+    integer(kind=kint), allocatable :: cnt(:), key(:,:), ikey(:), perm(:), nc(:), cavity(:)
+    real(kind=kreal), allocatable :: xyz(:,:,:), rbuf(:), area(:)
+    integer(kind=kint) :: k, i, n, nloc, offset, icel, isuf, ierr, nnz
+    integer(kind=kint) :: corner(4), ncl
+    integer(kind=8) :: h1, h2
+    real(kind=kreal) :: x(3,4)
+    character(len=HECMW_FILENAME_LEN) :: fname
+    logical :: found
+
+    fstrHEAT%VF_n = 0
+    if(fstrHEAT%R_SUF_tot == 0) return
+    if(.not. associated(fstrHEAT%R_SUF_cavity)) return
+    allocate(fstrHEAT%R_SUF_vf(fstrHEAT%R_SUF_tot))
+    fstrHEAT%R_SUF_vf(:) = 0
+
+    ! facets owned by this rank
+    nloc = 0
+    ierr = 0
+    do k = 1, fstrHEAT%R_SUF_tot
+      if(fstrHEAT%R_SUF_cavity(k) <= 0) cycle
+      icel = fstrHEAT%R_SUF_elem(k)
+      call heat_viewfactor_corner(hecMESH%elem_type(icel), fstrHEAT%R_SUF_surf(k), ncl, corner)
+      if(ncl == 0) ierr = 1
+      if(hecMESH%elem_ID(2*icel) == hecMESH%my_rank) nloc = nloc + 1
+    enddo
+    call hecmw_allreduce_I1(hecMESH, ierr, hecmw_max)
+    if(ierr /= 0)then
+      write(*,*) '###ERROR### : RADIATE with CAVITY requires solid or shell elements of type'
+      write(*,*) '              341, 342, 351, 352, 361, 362, 731 or 741'
+      call hecmw_abort(hecmw_comm_get_comm())
+    endif
+
+    allocate(cnt(hecMESH%PETOT))
+    call hecmw_allgather_int_1(nloc, cnt, hecMESH%MPI_COMM)
+    n = sum(cnt)
+    offset = sum(cnt(1:hecMESH%my_rank))
+    deallocate(cnt)
+    if(n == 0) return
+
+    ! global facet list; every rank fills its own slots
+    allocate(key(4,n), rbuf(12*n))
+    key(:,:) = 0
+    rbuf(:) = 0.0d0
+    i = offset
+    do k = 1, fstrHEAT%R_SUF_tot
+      if(fstrHEAT%R_SUF_cavity(k) <= 0) cycle
+      icel = fstrHEAT%R_SUF_elem(k)
+      if(hecMESH%elem_ID(2*icel) /= hecMESH%my_rank) cycle
+      i = i + 1
+      isuf = fstrHEAT%R_SUF_surf(k)
+      call facet_coord(hecMESH, icel, isuf, ncl, x)
+      key(1,i) = fstrHEAT%R_SUF_cavity(k)
+      key(2,i) = hecMESH%global_elem_ID(icel)
+      key(3,i) = isuf
+      key(4,i) = ncl
+      rbuf(12*i-11:12*i) = reshape(x, (/12/))
+    enddo
+    call hecmw_allreduce_I(hecMESH, key, 4*n, hecmw_sum)
+    call hecmw_allreduce_R(hecMESH, rbuf, 12*n, hecmw_sum)
+
+    ! canonical order, independent of the partitioning
+    allocate(perm(n), ikey(3*n), nc(n), cavity(n), xyz(3,4,n))
+    do i = 1, n
+      perm(i) = i
+    enddo
+    call sort_facet(key, perm, 1, n)
+    do i = 1, n
+      k = perm(i)
+      ikey(3*i-2:3*i) = key(1:3,k)
+      nc(i) = key(4,k)
+      cavity(i) = key(1,k)
+      xyz(:,:,i) = reshape(rbuf(12*k-11:12*k), (/3,4/))
+    enddo
+    deallocate(key, rbuf, perm)
+
+    h1 = 0
+    h2 = 0
+    call hash_int(h1, h2, n)
+    call hash_int(h1, h2, fstrHEAT%VF_rays)
+    do i = 1, 3*n
+      call hash_int(h1, h2, ikey(i))
+    enddo
+    do i = 1, n
+      call hash_int(h1, h2, nc(i))
+      do k = 1, 4
+        call hash_real(h1, h2, xyz(1,k,i))
+        call hash_real(h1, h2, xyz(2,k,i))
+        call hash_real(h1, h2, xyz(3,k,i))
+      enddo
+    enddo
+    write(fname,'(a,z8.8,z8.8,a)') 'fstrVF_', h1, h2, '.dat'
+
+    ! rank 0 reads or computes the view factors
+    nnz = 0
+    if(hecMESH%my_rank == 0)then
+      call read_cache(fname, n, fstrHEAT%VF_rays, h1, h2, ikey, fstrHEAT, found)
+      if(found)then
+        write(ILOG,*) ' View factors read from ', trim(fname)
+      else
+        allocate(area(n))
+        call heat_viewfactor_compute(n, nc, xyz, cavity, fstrHEAT%VF_rays, area, &
+          fstrHEAT%VF_index, fstrHEAT%VF_item, fstrHEAT%VF_val)
+        deallocate(area)
+        call write_cache(fname, n, fstrHEAT%VF_rays, h1, h2, ikey, fstrHEAT)
+        write(ILOG,*) ' View factors computed and written to ', trim(fname)
+      endif
+      nnz = fstrHEAT%VF_index(n)
+    endif
+    call hecmw_bcast_I1(hecMESH, nnz, 0)
+    if(hecMESH%my_rank /= 0)then
+      allocate(fstrHEAT%VF_index(0:n), fstrHEAT%VF_item(nnz), fstrHEAT%VF_val(nnz))
+    endif
+    call hecmw_bcast_I(hecMESH, fstrHEAT%VF_index, n+1, 0)
+    if(nnz > 0)then
+      call hecmw_bcast_I(hecMESH, fstrHEAT%VF_item, nnz, 0)
+      call hecmw_bcast_R(hecMESH, fstrHEAT%VF_val, nnz, 0)
+    endif
+    fstrHEAT%VF_n = n
+    allocate(fstrHEAT%VF_sink(n))
+    fstrHEAT%VF_sink(:) = 0.0d0
+    write(ILOG,*) ' Radiation cavity facets:', n, '  view factors:', nnz
+
+    ! row of each local facet, including facets of overlapping elements
+    do k = 1, fstrHEAT%R_SUF_tot
+      if(fstrHEAT%R_SUF_cavity(k) <= 0) cycle
+      icel = fstrHEAT%R_SUF_elem(k)
+      fstrHEAT%R_SUF_vf(k) = search_facet(ikey, n, fstrHEAT%R_SUF_cavity(k), &
+        hecMESH%global_elem_ID(icel), fstrHEAT%R_SUF_surf(k))
+    enddo
+    deallocate(ikey, nc, cavity, xyz)
+  end subroutine heat_init_viewfactor
+
+  !> Solve the radiosity of all cavities with the current temperatures and
+  !! store the effective SINK temperature of every cavity facet
+  subroutine heat_update_viewfactor_sink(hecMESH, fstrHEAT, CTIME)
+    use m_heat_get_amplitude
+    type(hecmwST_local_mesh) :: hecMESH
+    type(fstr_heat) :: fstrHEAT
+    real(kind=kreal) :: CTIME
+    real(kind=kreal), allocatable :: buf(:), eps(:), Eb(:), Esink(:), G(:)
+    integer(kind=kint) :: k, i, n, icel, ncl, j, is, corner(4)
+    real(kind=kreal) :: TZERO, QQ, sigma, t
+
+    n = fstrHEAT%VF_n
+    if(n == 0) return
+    TZERO = hecMESH%zero_temp
+    sigma = fstrHEAT%VF_sigma
+
+    allocate(buf(3*n))
+    buf(:) = 0.0d0
+    do k = 1, fstrHEAT%R_SUF_tot
+      i = fstrHEAT%R_SUF_vf(k)
+      if(i == 0) cycle
+      icel = fstrHEAT%R_SUF_elem(k)
+      if(hecMESH%elem_ID(2*icel) /= hecMESH%my_rank) cycle
+      call heat_viewfactor_corner(hecMESH%elem_type(icel), fstrHEAT%R_SUF_surf(k), ncl, corner)
+      is = hecMESH%elem_node_index(icel-1)
+      t = 0.0d0
+      do j = 1, ncl
+        t = t + fstrHEAT%TEMP(hecMESH%elem_node_item(is+corner(j)))
+      enddo
+      buf(3*i-2) = t/ncl - TZERO
+      call heat_get_amplitude(fstrHEAT, fstrHEAT%R_SUF_ampl(k,1), CTIME, QQ)
+      buf(3*i-1) = min(max(fstrHEAT%R_SUF_val(k,1)*QQ/sigma, 0.0d0), 1.0d0)
+      call heat_get_amplitude(fstrHEAT, fstrHEAT%R_SUF_ampl(k,2), CTIME, QQ)
+      buf(3*i  ) = fstrHEAT%R_SUF_val(k,2)*QQ - TZERO
+    enddo
+    call hecmw_allreduce_R(hecMESH, buf, 3*n, hecmw_sum)
+
+    allocate(eps(n), Eb(n), Esink(n), G(n))
+    do i = 1, n
+      Eb(i)    = sigma*buf(3*i-2)**4
+      eps(i)   = buf(3*i-1)
+      Esink(i) = sigma*buf(3*i)**4
+    enddo
+    call heat_viewfactor_radiosity(n, fstrHEAT%VF_index, fstrHEAT%VF_item, fstrHEAT%VF_val, eps, Eb, Esink, G)
+    do i = 1, n
+      fstrHEAT%VF_sink(i) = (max(G(i), 0.0d0)/sigma)**0.25d0 + TZERO
+    enddo
+    deallocate(buf, eps, Eb, Esink, G)
+  end subroutine heat_update_viewfactor_sink
+
+  !-----------------------------------------------------------------------------
+
+  !> corner coordinates of a facet; the normal of a solid facet is turned
+  !! away from the element, i.e. into the cavity
+  subroutine facet_coord(hecMESH, icel, isuf, ncl, x)
+    type(hecmwST_local_mesh) :: hecMESH
+    integer(kind=kint), intent(in)  :: icel, isuf
+    integer(kind=kint), intent(out) :: ncl
+    real(kind=kreal), intent(out)   :: x(3,4)
+    integer(kind=kint) :: ic_type, nn, is, j, inod, corner(4)
+    real(kind=kreal) :: ce(3), cf(3), a(3), b(3), nrm(3), tmp(3)
+
+    ic_type = hecMESH%elem_type(icel)
+    call heat_viewfactor_corner(ic_type, isuf, ncl, corner)
+    is = hecMESH%elem_node_index(icel-1)
+    x(:,:) = 0.0d0
+    do j = 1, ncl
+      inod = hecMESH%elem_node_item(is+corner(j))
+      x(:,j) = hecMESH%node(3*inod-2:3*inod)
+    enddo
+    if(ic_type == 731 .or. ic_type == 741) return
+
+    nn = hecmw_get_max_node(ic_type)
+    ce(:) = 0.0d0
+    do j = 1, nn
+      inod = hecMESH%elem_node_item(is+j)
+      ce(:) = ce(:) + hecMESH%node(3*inod-2:3*inod)
+    enddo
+    ce(:) = ce(:)/nn
+    cf(:) = sum(x(:,1:ncl), dim=2)/ncl
+    a(:) = x(:,2) - x(:,1)
+    b(:) = x(:,3) - x(:,1)
+    nrm(1) = a(2)*b(3) - a(3)*b(2)
+    nrm(2) = a(3)*b(1) - a(1)*b(3)
+    nrm(3) = a(1)*b(2) - a(2)*b(1)
+    if(dot_product(nrm, cf - ce) < 0.0d0)then
+      tmp(:) = x(:,2)
+      x(:,2) = x(:,ncl)
+      x(:,ncl) = tmp(:)
+    endif
+  end subroutine facet_coord
+
+  !> order of two facets by (cavity, global element ID, surface)
+  logical function facet_less(a, b)
+    integer(kind=kint), intent(in) :: a(:), b(:)
+    integer(kind=kint) :: i
+    facet_less = .false.
+    do i = 1, 3
+      if(a(i) /= b(i))then
+        facet_less = a(i) < b(i)
+        return
+      endif
+    enddo
+  end function facet_less
+
+  recursive subroutine sort_facet(key, perm, is, ie)
+    integer(kind=kint), intent(in)    :: key(:,:)
+    integer(kind=kint), intent(inout) :: perm(:)
+    integer(kind=kint), intent(in)    :: is, ie
+    integer(kind=kint) :: i, j, p(3), w
+
+    if(is >= ie) return
+    p(:) = key(1:3, perm((is+ie)/2))
+    i = is
+    j = ie
+    do
+      do while(facet_less(key(1:3,perm(i)), p))
+        i = i + 1
+      enddo
+      do while(facet_less(p, key(1:3,perm(j))))
+        j = j - 1
+      enddo
+      if(i >= j) exit
+      w = perm(i)
+      perm(i) = perm(j)
+      perm(j) = w
+      i = i + 1
+      j = j - 1
+    enddo
+    call sort_facet(key, perm, is, j)
+    call sort_facet(key, perm, j+1, ie)
+  end subroutine sort_facet
+
+  integer(kind=kint) function search_facet(ikey, n, cavity, gid, isuf)
+    integer(kind=kint), intent(in) :: ikey(:), n, cavity, gid, isuf
+    integer(kind=kint) :: lo, hi, mid, p(3)
+
+    p(:) = (/cavity, gid, isuf/)
+    search_facet = 0
+    lo = 1
+    hi = n
+    do while(lo <= hi)
+      mid = (lo+hi)/2
+      if(facet_less(ikey(3*mid-2:3*mid), p))then
+        lo = mid + 1
+      elseif(facet_less(p, ikey(3*mid-2:3*mid)))then
+        hi = mid - 1
+      else
+        search_facet = mid
+        return
+      endif
+    enddo
+  end function search_facet
+
+  subroutine hash_int(h1, h2, v)
+    integer(kind=8), intent(inout) :: h1, h2
+    integer(kind=kint), intent(in) :: v
+    h1 = mod(h1*HASH_B1 + modulo(int(v,8), HASH_P), HASH_P)
+    h2 = mod(h2*HASH_B2 + modulo(int(v,8), HASH_P), HASH_P)
+  end subroutine hash_int
+
+  subroutine hash_real(h1, h2, v)
+    integer(kind=8), intent(inout) :: h1, h2
+    real(kind=kreal), intent(in) :: v
+    integer(kind=4) :: w(2)
+    w = transfer(v, w)
+    call hash_int(h1, h2, w(1))
+    call hash_int(h1, h2, w(2))
+  end subroutine hash_real
+
+  subroutine read_cache(fname, n, nrays, h1, h2, ikey, fstrHEAT, found)
+    character(len=*), intent(in) :: fname
+    integer(kind=kint), intent(in) :: n, nrays, ikey(:)
+    integer(kind=8), intent(in) :: h1, h2
+    type(fstr_heat) :: fstrHEAT
+    logical, intent(out) :: found
+    character(len=8) :: magic
+    integer(kind=kint) :: fn, frays, nnz, ios
+    integer(kind=8) :: fh1, fh2
+    integer(kind=kint), allocatable :: fkey(:)
+
+    found = .false.
+    open(IVFC, file=fname, status='old', access='stream', form='unformatted', iostat=ios)
+    if(ios /= 0) return
+    read(IVFC, iostat=ios) magic, fn, frays, fh1, fh2
+    if(ios /= 0 .or. magic /= VF_MAGIC .or. fn /= n .or. frays /= nrays .or. fh1 /= h1 .or. fh2 /= h2)then
+      close(IVFC)
+      return
+    endif
+    allocate(fkey(3*n))
+    read(IVFC, iostat=ios) fkey
+    if(ios /= 0 .or. any(fkey /= ikey(1:3*n)))then
+      deallocate(fkey)
+      close(IVFC)
+      return
+    endif
+    deallocate(fkey)
+    allocate(fstrHEAT%VF_index(0:n))
+    read(IVFC, iostat=ios) fstrHEAT%VF_index
+    if(ios == 0)then
+      nnz = fstrHEAT%VF_index(n)
+      allocate(fstrHEAT%VF_item(nnz), fstrHEAT%VF_val(nnz))
+      read(IVFC, iostat=ios) fstrHEAT%VF_item, fstrHEAT%VF_val
+    endif
+    close(IVFC)
+    if(ios /= 0)then
+      deallocate(fstrHEAT%VF_index)
+      if(associated(fstrHEAT%VF_item)) deallocate(fstrHEAT%VF_item, fstrHEAT%VF_val)
+      return
+    endif
+    found = .true.
+  end subroutine read_cache
+
+  subroutine write_cache(fname, n, nrays, h1, h2, ikey, fstrHEAT)
+    character(len=*), intent(in) :: fname
+    integer(kind=kint), intent(in) :: n, nrays, ikey(:)
+    integer(kind=8), intent(in) :: h1, h2
+    type(fstr_heat) :: fstrHEAT
+    integer(kind=kint) :: ios
+
+    open(IVFC, file=fname, status='replace', access='stream', form='unformatted', iostat=ios)
+    if(ios /= 0)then
+      write(ILOG,*) ' Warning: cannot write view factor cache ', trim(fname)
+      return
+    endif
+    write(IVFC) VF_MAGIC, n, nrays, h1, h2
+    write(IVFC) ikey(1:3*n)
+    write(IVFC) fstrHEAT%VF_index, fstrHEAT%VF_item, fstrHEAT%VF_val
+    close(IVFC)
+  end subroutine write_cache
+
+end module m_heat_viewfactor
@@ -26,8 +26,7 @@ contains
     type(fstr_param)         :: fstrPARAM
     type(fstr_solid)         :: fstrSOLID
 
-    integer(kind=kint) :: istep, i, j
-    integer(kind=kint) :: ng
+    integer(kind=kint) :: istep, i
     integer(kind=kint) :: ncont, nstate
 
     do istep=1,fstrSOLID%nstep_tot
@@ -45,16 +44,15 @@ contains
     endif
 
     !(2)elemental values
+    allocate(fstrSOLID%gauss_stores_bkup(size(fstrSOLID%gauss_stores)))
+    do i=1,size(fstrSOLID%gauss_stores)
+      call fstr_init_gauss_store( fstrSOLID%gauss_stores_bkup(i), fstrSOLID%gauss_stores(i)%gausses(1)%pMaterial, &
+        fstrSOLID%gauss_stores(i)%ngauss )
+    end do
     allocate(fstrSOLID%elements_bkup(size(fstrSOLID%elements)))
     do i=1,size(fstrSOLID%elements)
       if (hecmw_is_etype_link( fstrSOLID%elements(i)%etype )) cycle
       if (hecmw_is_etype_patch( fstrSOLID%elements(i)%etype )) cycle
-      ng = NumOfQuadPoints( fstrSOLID%elements(i)%etype )
-      allocate( fstrSOLID%elements_bkup(i)%gausses(ng) )
-      do j=1,ng
-        fstrSOLID%elements_bkup(i)%gausses(j)%pMaterial => fstrSOLID%elements(i)%gausses(j)%pMaterial
-        call fstr_init_gauss( fstrSOLID%elements_bkup(i)%gausses(j) )
-      end do
       if( associated( fstrSOLID%elements(i)%aux ) ) then
         allocate( fstrSOLID%elements_bkup(i)%aux(3,3) )
       endif
@@ -76,8 +74,7 @@ contains
   subroutine fstr_cutback_finalize( fstrSOLID )
     type(fstr_solid) :: fstrSOLID
 
-    integer(kind=kint) :: i, j
-    integer(kind=kint) :: ng
+    integer(kind=kint) :: i
     integer(kind=kint) :: ncont
 
     if( .not. is_cutback_active ) return
@@ -91,14 +88,13 @@ contains
     endif
 
     !(2)elemental values
+    do i=1,size(fstrSOLID%gauss_stores_bkup)
+      call fstr_finalize_gauss_store( fstrSOLID%gauss_stores_bkup(i) )
+    end do
+    deallocate(fstrSOLID%gauss_stores_bkup)
     do i=1,size(fstrSOLID%elements)
       if (hecmw_is_etype_link( fstrSOLID%elements(i)%etype )) cycle
       if (hecmw_is_etype_patch( fstrSOLID%elements(i)%etype )) cycle
-      ng = NumOfQuadPoints( fstrSOLID%elements(i)%etype )
-      do j=1,ng
-        call fstr_finalize_gauss( fstrSOLID%elements_bkup(i)%gausses(j) )
-      end do
-      deallocate( fstrSOLID%elements_bkup(i)%gausses )
       if( associated( fstrSOLID%elements_bkup(i)%aux ) ) then
         deallocate( fstrSOLID%elements_bkup(i)%aux )
       endif
@@ -122,7 +118,6 @@ contains
     type(fstr_info_contactChange), intent(inout) :: infoCTChange_bak !< contact change info
 
     integer(kind=kint) :: i, j
-    integer(kind=kint) :: ng
     integer(kind=kint) :: ncont, nstate
 
     if( .not. is_cutback_active ) return
@@ -141,13 +136,12 @@ contains
     endif
 
     !(2)elemental values
+    do i=1,size(fstrSOLID%gauss_stores)
+      call fstr_copy_gauss_store( fstrSOLID%gauss_stores(i), fstrSOLID%gauss_stores_bkup(i) )
+    end do
     do i=1,size(fstrSOLID%elements)
       if (hecmw_is_etype_link( fstrSOLID%elements(i)%etype )) cycle
       if (hecmw_is_etype_patch( fstrSOLID%elements(i)%etype )) cycle
-      ng = NumOfQuadPoints( fstrSOLID%elements(i)%etype )
-      do j=1,ng
-        call fstr_copy_gauss( fstrSOLID%elements(i)%gausses(j), fstrSOLID%elements_bkup(i)%gausses(j) )
-      end do
       if( associated( fstrSOLID%elements(i)%aux ) ) then
         fstrSOLID%elements_bkup(i)%aux(:,:) = fstrSOLID%elements(i)%aux(:,:)
       endif
@@ -173,7 +167,6 @@ contains
     type(fstr_info_contactChange), intent(inout) :: infoCTChange_bak !< contact change info
 
     integer(kind=kint) :: i, j
-    integer(kind=kint) :: ng
     integer(kind=kint) :: ncont, nstate
 
     if( .not. is_cutback_active ) return
@@ -192,13 +185,12 @@ contains
     endif
 
     !(2)elemental values
+    do i=1,size(fstrSOLID%gauss_stores)
+      call fstr_copy_gauss_store( fstrSOLID%gauss_stores_bkup(i), fstrSOLID%gauss_stores(i) )
+    end do
     do i=1,size(fstrSOLID%elements)
       if (hecmw_is_etype_link( fstrSOLID%elements(i)%etype )) cycle
       if (hecmw_is_etype_patch( fstrSOLID%elements(i)%etype )) cycle
-      ng = NumOfQuadPoints( fstrSOLID%elements(i)%etype )
-      do j=1,ng
-        call fstr_copy_gauss( fstrSOLID%elements_bkup(i)%gausses(j), fstrSOLID%elements(i)%gausses(j) )
-      end do
       if( associated( fstrSOLID%elements(i)%aux ) ) then
         fstrSOLID%elements(i)%aux(:,:) = fstrSOLID%elements_bkup(i)%aux(:,:)
       endif
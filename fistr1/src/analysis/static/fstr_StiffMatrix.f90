@@ -35,9 +35,13 @@ contains
     integer(kind=kint) :: ndof, itype, is, iE, ic_type, nn, icel, iiS, i, j
     real(kind=kreal)   :: u(6,fstrSOLID%max_ncon), du(6,fstrSOLID%max_ncon), coords(3,3), u_prev(6,fstrSOLID%max_ncon)
     integer            :: isect, ihead, cdsys_ID
+    integer(kind=kint) :: ib0, ib1
+    logical, allocatable :: batched(:)
 
     ! ----- initialize
     call hecmw_mat_clear( hecMAT )
+    allocate( batched(hecMESH%elem_type_index(hecMESH%n_elem_type)) )
+    batched(:) = .false.
 
     ndof = hecMAT%NDOF
     tt(:) = 0.d0
@@ -51,13 +55,30 @@ contains
       if (hecmw_is_etype_patch(ic_type)) cycle
       ! ----- Set number of nodes
 
+      ! ----- batched element loop ( solid elements of same type and material )
+      !$omp parallel default(none), &
+        !$omp&  private(ib0,ib1,nn), &
+        !$omp&  shared(iS,iE,hecMESH,ndof,fstrSOLID,ic_type,hecMAT,time,tincr,batched)
+      !$omp do
+      do ib0= is, iE, kC3BatchSize
+        ib1 = min( ib0+kC3BatchSize-1, iE )
+        if( ndof /= 3 ) cycle
+        if( .not. isBatchable_C3( hecMESH, fstrSOLID, ic_type, ib0, ib1, .false. ) ) cycle
+        nn = hecMESH%elem_node_index(ib0)-hecMESH%elem_node_index(ib0-1)
+        call StiffMat_batch( hecMESH, hecMAT, fstrSOLID, ic_type, nn, ib0, ib1, time, tincr )
+        batched(ib0:ib1) = .true.
+      enddo
+      !$omp end do
+      !$omp end parallel
+
       ! ----- element loop
       !$omp parallel default(none), &
         !$omp&  private(icel,iiS,nn,j,nodLOCAL,i,ecoord,du,u,u_prev,tt,cdsys_ID,coords, &
         !$omp&          material,thick,stiffness,isect,ihead), &
-        !$omp&  shared(iS,iE,hecMESH,ndof,fstrSOLID,ic_type,hecMAT,time,tincr)
+        !$omp&  shared(iS,iE,hecMESH,ndof,fstrSOLID,ic_type,hecMAT,time,tincr,batched)
       !$omp do
       do icel= is, iE
+        if( batched(icel) ) cycle
 
         ! ----- nodal coordinate & displacement
         iiS= hecMESH%elem_node_index(icel-1)
@@ -100,7 +121,8 @@ contains
           if( fstrSOLID%sections(isect)%elemopt361 == kel361FI ) then ! full integration element
             call STF_C3                                                                              &
               ( ic_type, nn, ecoord(:, 1:nn), fstrSOLID%elements(icel)%gausses(:),                &
-              stiffness(1:nn*ndof, 1:nn*ndof), cdsys_ID, coords, time, tincr, u(1:3,1:nn), tt(1:nn) )
+              stiffness(1:nn*ndof, 1:nn*ndof), cdsys_ID, coords, time, tincr, u(1:3,1:nn), tt(1:nn),  &
+              fstrSOLID%elements(icel)%gderiv, fstrSOLID%elements(icel)%wdet )
           else if( fstrSOLID%sections(isect)%elemopt361 == kel361BBAR ) then ! B-bar element
             call STF_C3D8Bbar                                                                        &
               ( ic_type, nn, ecoord(:, 1:nn), fstrSOLID%elements(icel)%gausses(:),                &
@@ -120,7 +142,8 @@ contains
           if( ic_type==341 .and. fstrSOLID%sections(isect)%elemopt341 == kel341SESNS ) cycle ! skip smoothed fem
           call STF_C3                                                                              &
             ( ic_type, nn, ecoord(:, 1:nn), fstrSOLID%elements(icel)%gausses(:),                &
-            stiffness(1:nn*ndof, 1:nn*ndof), cdsys_ID, coords, time, tincr, u(1:3,1:nn), tt(1:nn) )
+            stiffness(1:nn*ndof, 1:nn*ndof), cdsys_ID, coords, time, tincr, u(1:3,1:nn), tt(1:nn),  &
+            fstrSOLID%elements(icel)%gderiv, fstrSOLID%elements(icel)%wdet )
 
         else if( ic_type == 611) then
           if( material%nlgeom_flag /= INFINITESIMAL ) call StiffMat_abort( ic_type, 2 )
@@ -168,8 +191,52 @@ contains
       !$omp end parallel
     enddo        ! itype
 
+    deallocate( batched )
   end subroutine fstr_StiffMatrix
 
+  !> Stiffness matrices of elements is:iE calculated by the batched kernel
+  subroutine StiffMat_batch( hecMESH, hecMAT, fstrSOLID, ic_type, nn, is, iE, time, tincr )
+    use m_static_LIB
+
+    type (hecmwST_local_mesh)      :: hecMESH      !< mesh information
+    type (hecmwST_matrix)          :: hecMAT       !< linear equation
+    type (fstr_solid)              :: fstrSOLID    !< we need boundary conditions of curr step
+    integer(kind=kint), intent(in) :: ic_type      !< element type
+    integer(kind=kint), intent(in) :: nn           !< number of elemental nodes
+    integer(kind=kint), intent(in) :: is, iE       !< range of elements in batch
+    real(kind=kreal), intent(in)   :: time         !< current time
+    real(kind=kreal), intent(in)   :: tincr        !< time increment
+
+    real(kind=kreal)   :: ecoord(iE-is+1,3,nn), u(iE-is+1,3,nn), tt(iE-is+1,nn)
+    real(kind=kreal)   :: stiffness(nn*3,nn*3,iE-is+1)
+    integer(kind=kint) :: nodLOCAL(nn), ndof, icel, ib, iiS, i, j
+
+    ndof = hecMAT%NDOF
+    tt(:,:) = 0.d0
+    do icel = is, iE
+      ib = icel-is+1
+      iiS = hecMESH%elem_node_index(icel-1)
+      do j = 1, nn
+        nodLOCAL(j) = hecMESH%elem_node_item(iiS+j)
+        do i = 1, 3
+          ecoord(ib,i,j) = hecMESH%node(3*nodLOCAL(j)+i-3)
+          u(ib,i,j) = fstrSOLID%unode(ndof*nodLOCAL(j)+i-ndof) + fstrSOLID%dunode(ndof*nodLOCAL(j)+i-ndof)
+        enddo
+        if( fstrSOLID%TEMP_ngrp_tot > 0 .or. fstrSOLID%TEMP_irres >0 )  &
+          tt(ib,j) = fstrSOLID%temperature( nodLOCAL(j) )
+      enddo
+    enddo
+
+    call STF_C3_batch( ic_type, nn, iE-is+1, ecoord, fstrSOLID%elements(is:iE), stiffness, time, tincr, u, tt )
+
+    do icel = is, iE
+      ib = icel-is+1
+      iiS = hecMESH%elem_node_index(icel-1)
+      nodLOCAL(1:nn) = hecMESH%elem_node_item(iiS+1:iiS+nn)
+      call hecmw_mat_ass_elem(hecMAT, nn, nodLOCAL, stiffness(:,:,ib))
+    enddo
+  end subroutine StiffMat_batch
+
   subroutine StiffMat_abort( ic_type, flag, mtype )
     integer(kind=kint), intent(in)           :: ic_type
     integer(kind=kint), intent(in)           :: flag
@@ -7,7 +7,7 @@ module m_fstr_Update
   use m_fstr
   implicit none
 
-  private :: Update_abort
+  private :: Update_abort, UpdateNewton_batch
 
 contains
 
@@ -47,9 +47,13 @@ contains
     real(kind=kreal), optional :: strainEnergy
     real(kind=kreal) :: tmp
     real(kind=kreal)   :: ddaux(3,3)
+    integer(kind=kint) :: ib0, ib1
+    logical, allocatable :: batched(:)
 
     ndof = hecMAT%NDOF
     fstrSOLID%QFORCE=0.0d0
+    allocate( batched(hecMESH%elem_type_index(hecMESH%n_elem_type)) )
+    batched(:) = .false.
 
     tt0 = 0.d0
     ttn = 0.d0
@@ -83,15 +87,32 @@ contains
       if (hecmw_is_etype_link(ic_type)) cycle
       if (hecmw_is_etype_patch(ic_type)) cycle
 
+      !batched element loop ( solid elements of same type and material )
+      !$omp parallel default(none), &
+        !$omp&  private(ib0,ib1,nn), &
+        !$omp&  shared(iS,iE,hecMESH,fstrSOLID,ndof,hecMAT,ic_type,strainEnergy,time,tincr,initt,batched)
+      !$omp do
+      do ib0 = is, iE, kC3BatchSize
+        ib1 = min( ib0+kC3BatchSize-1, iE )
+        if( ndof /= 3 ) cycle
+        if( .not. isBatchable_C3( hecMESH, fstrSOLID, ic_type, ib0, ib1, .true. ) ) cycle
+        nn = hecMESH%elem_node_index(ib0)-hecMESH%elem_node_index(ib0-1)
+        call UpdateNewton_batch( hecMESH, hecMAT, fstrSOLID, ic_type, nn, ib0, ib1, time, tincr, initt, strainEnergy )
+        batched(ib0:ib1) = .true.
+      enddo
+      !$omp end do
+      !$omp end parallel
+
       !element loop
       !$omp parallel default(none), &
         !$omp&  private(icel,iiS,j,nn,nodLOCAL,i,ecoord,ddu,du,total_disp, &
         !$omp&  cdsys_ID,coords,thick,qf,isect,ihead,tmp,ndim,ddaux), &
         !$omp&  shared(iS,iE,hecMESH,fstrSOLID,ndof,hecMAT,ic_type,fstrPR, &
-        !$omp&         strainEnergy,iter,time,tincr,initt,g_InitialCnd), &
+        !$omp&         strainEnergy,iter,time,tincr,initt,g_InitialCnd,batched), &
         !$omp&  firstprivate(tt0,ttn,tt)
       !$omp do
       do icel = is, iE
+        if( batched(icel) ) cycle
 
         ! ----- nodal coordinate, displacement and temperature
         iiS = hecMESH%elem_node_index(icel-1)
@@ -145,7 +166,8 @@ contains
         else if( ic_type == 361 ) then
           if( fstrSOLID%sections(isect)%elemopt361 == kel361FI ) then ! full integration element
             call UPDATE_C3( ic_type, nn, ecoord(:,1:nn), total_disp(1:3,1:nn), du(1:3,1:nn), cdsys_ID, coords, &
-              qf(1:nn*ndof), fstrSOLID%elements(icel)%gausses(:), iter, time, tincr, tt(1:nn), tt0(1:nn), ttn(1:nn)  )
+              qf(1:nn*ndof), fstrSOLID%elements(icel)%gausses(:), iter, time, tincr, tt(1:nn), tt0(1:nn), ttn(1:nn), &
+              fstrSOLID%elements(icel)%gderiv, fstrSOLID%elements(icel)%wdet )
           else if( fstrSOLID%sections(isect)%elemopt361 == kel361BBAR ) then ! B-bar element
             call UPDATE_C3D8Bbar( ic_type, nn, ecoord(:,1:nn), total_disp(1:3,1:nn), du(1:3,1:nn), cdsys_ID, coords,    &
               qf(1:nn*ndof), fstrSOLID%elements(icel)%gausses(:), iter, time, tincr, tt(1:nn), tt0(1:nn), ttn(1:nn)  )
@@ -162,7 +184,8 @@ contains
         else if (ic_type == 341 .or. ic_type == 351 .or. ic_type == 342 .or. ic_type == 352 .or. ic_type == 362 ) then
           if( ic_type==341 .and. fstrSOLID%sections(isect)%elemopt341 == kel341SESNS ) cycle ! skip smoothed fem
           call UPDATE_C3( ic_type, nn, ecoord(:,1:nn), total_disp(1:3,1:nn), du(1:3,1:nn), cdsys_ID, coords, &
-            qf(1:nn*ndof), fstrSOLID%elements(icel)%gausses(:), iter, time, tincr, tt(1:nn), tt0(1:nn), ttn(1:nn)  )
+            qf(1:nn*ndof), fstrSOLID%elements(icel)%gausses(:), iter, time, tincr, tt(1:nn), tt0(1:nn), ttn(1:nn), &
+            fstrSOLID%elements(icel)%gderiv, fstrSOLID%elements(icel)%wdet )
 
         else if( ic_type == 611) then
           if( fstrPR%nlgeom ) call Update_abort( ic_type, 2 )
@@ -238,8 +261,89 @@ contains
     !C Update for fstrSOLID%QFORCE
     !C
     call hecmw_update_R(hecMESH,fstrSOLID%QFORCE,hecMESH%n_node, ndof)
+    deallocate( batched )
   end subroutine fstr_UpdateNewton
 
+  !> Update stress, strain and internal forces of elements is:iE by the batched kernel
+  subroutine UpdateNewton_batch( hecMESH, hecMAT, fstrSOLID, ic_type, nn, is, iE, time, tincr, initt, strainEnergy )
+    use m_static_lib
+
+    type (hecmwST_local_mesh)      :: hecMESH   !< mesh information
+    type (hecmwST_matrix)          :: hecMAT    !< linear equation
+    type (fstr_solid)              :: fstrSOLID !< we need boundary conditions of curr step
+    integer(kind=kint), intent(in) :: ic_type   !< element type
+    integer(kind=kint), intent(in) :: nn        !< number of elemental nodes
+    integer(kind=kint), intent(in) :: is, iE    !< range of elements in batch
+    real(kind=kreal),intent(in)    :: time      !< current time
+    real(kind=kreal),intent(in)    :: tincr     !< time increment
+    integer(kind=kint), intent(in) :: initt     !< index of initial temperature condition
+    real(kind=kreal), optional     :: strainEnergy
+
+    real(kind=kreal)   :: ecoord(iE-is+1,3,nn), total_disp(iE-is+1,3,nn), du(iE-is+1,3,nn), ddu(iE-is+1,3,nn)
+    real(kind=kreal)   :: tt(iE-is+1,nn), tt0(iE-is+1,nn), ttn(iE-is+1,nn), qf(iE-is+1,nn*3)
+    integer(kind=kint) :: nodLOCAL(nn), ndof, icel, ib, iiS, i, j
+    real(kind=kreal)   :: tmp
+
+    ndof = hecMAT%NDOF
+    tt(:,:) = 0.d0
+    tt0(:,:) = 0.d0
+    ttn(:,:) = 0.d0
+    do icel = is, iE
+      ib = icel-is+1
+      iiS = hecMESH%elem_node_index(icel-1)
+      do j = 1, nn
+        nodLOCAL(j) = hecMESH%elem_node_item(iiS+j)
+        do i = 1, 3
+          ecoord(ib,i,j) = hecMESH%node(3*nodLOCAL(j)+i-3)
+          ddu(ib,i,j) = hecMAT%X(ndof*nodLOCAL(j)+i-ndof)
+          du(ib,i,j)  = fstrSOLID%dunode(ndof*nodLOCAL(j)+i-ndof)
+          total_disp(ib,i,j) = fstrSOLID%unode(ndof*nodLOCAL(j)+i-ndof)
+        enddo
+
+        if( fstrSOLID%TEMP_ngrp_tot > 0 .or. fstrSOLID%TEMP_irres > 0 ) then
+          if( isElastoplastic(fstrSOLID%elements(icel)%gausses(1)%pMaterial%mtype) .or. &
+              fstrSOLID%elements(icel)%gausses(1)%pMaterial%mtype == NORTON ) then
+            tt0(ib,j) = fstrSOLID%last_temp( nodLOCAL(j) )
+          else
+            if( hecMESH%hecmw_flag_initcon == 1 ) tt0(ib,j) = hecMESH%node_init_val_item(nodLOCAL(j))
+            if( initt>0 ) tt0(ib,j) = g_InitialCnd(initt)%realval(nodLOCAL(j))
+          endif
+          ttn(ib,j) = fstrSOLID%last_temp( nodLOCAL(j) )
+          tt(ib,j)  = fstrSOLID%temperature( nodLOCAL(j) )
+        endif
+      enddo
+    enddo
+
+    call UPDATE_C3_batch( ic_type, nn, iE-is+1, ecoord, total_disp, du, qf, fstrSOLID%elements(is:iE), &
+      time, tincr, tt, tt0, ttn )
+
+    do icel = is, iE
+      ib = icel-is+1
+      iiS = hecMESH%elem_node_index(icel-1)
+      nodLOCAL(1:nn) = hecMESH%elem_node_item(iiS+1:iiS+nn)
+
+      ! ----- calculate the global internal force ( Q(u_{n+1}^{k-1}) )
+      do j = 1, nn
+        do i = 1, ndof
+          !$omp atomic
+          fstrSOLID%QFORCE(ndof*(nodLOCAL(j)-1)+i) = fstrSOLID%QFORCE(ndof*(nodLOCAL(j)-1)+i)+qf(ib,ndof*(j-1)+i)
+        enddo
+      enddo
+
+      ! ----- calculate strain energy
+      if(present(strainEnergy))then
+        do j = 1, nn
+          do i = 1, 3
+            tmp = 0.5d0*( fstrSOLID%elements(icel)%equiForces(3*(j-1)+i)+qf(ib,3*(j-1)+i) )*ddu(ib,i,j)
+            !$omp atomic
+            strainEnergy = strainEnergy+tmp
+            fstrSOLID%elements(icel)%equiForces(3*(j-1)+i) = qf(ib,3*(j-1)+i)
+          enddo
+        enddo
+      endif
+    enddo
+  end subroutine UpdateNewton_batch
+
 
   !> Update elastiplastic status
   subroutine fstr_UpdateState( hecMESH, fstrSOLID, tincr)
@@ -286,13 +390,12 @@ contains
             enddo
           endif
         endif
-
-        do i = 1, ngauss
-          fstrSOLID%elements(icel)%gausses(i)%strain_bak = fstrSOLID%elements(icel)%gausses(i)%strain
-          fstrSOLID%elements(icel)%gausses(i)%stress_bak = fstrSOLID%elements(icel)%gausses(i)%stress
-        enddo
       enddo
     enddo
+
+    do i = 1, size(fstrSOLID%gauss_stores)
+      call fstr_backup_gauss_store( fstrSOLID%gauss_stores(i) )
+    enddo
   end subroutine fstr_UpdateState
 
   subroutine Update_abort( ic_type, flag, mtype )
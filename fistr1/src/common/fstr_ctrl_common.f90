@@ -47,7 +47,7 @@ contains
 
     fstr_ctrl_get_SOLUTION = -1
 
-    s = 'ELEMCHECK,STATIC,EIGEN,HEAT,DYNAMIC,NLSTATIC,STATICEIGEN,NZPROF '
+    s = 'ELEMCHECK,STATIC,EIGEN,HEAT,DYNAMIC,NLSTATIC,STATICEIGEN,NZPROF,EIGENFREQ '
     if( fstr_ctrl_get_param_ex( ctrl,      'TYPE ',     s,    1,   'P',  type )/= 0) return
     type = type -1
 
@@ -655,9 +655,10 @@ contains
   end function fstr_ctrl_get_CONTACTPARAM
 
   !> Read in !ELEMOPT
-  function fstr_ctrl_get_ELEMOPT( ctrl, elemopt361 )
+  function fstr_ctrl_get_ELEMOPT( ctrl, elemopt361, geomcache )
     integer(kind=kint) :: ctrl
     integer(kind=kint) :: elemopt361
+    real(kind=kreal)   :: geomcache     !< memory budget of geometric cache in MB
     integer(kind=kint) :: fstr_ctrl_get_ELEMOPT
 
     character(72) :: o361list = 'IC,Bbar '
@@ -670,6 +671,7 @@ contains
 
     !* parameter in header line -----------------------------------------------------------------*!
     if( fstr_ctrl_get_param_ex( ctrl, '361 ', o361list, 0, 'P', o361 ) /= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'GEOMCACHE ', '# ', 0, 'R', geomcache ) /= 0) return
 
     elemopt361 = o361 - 1
 
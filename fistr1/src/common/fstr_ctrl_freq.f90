@@ -106,15 +106,27 @@
     type(fstr_param_pack) :: P
   !---- vals
     integer(kind=kint)                :: filename_len
-    character(len=HECMW_NAME_LEN) :: datafmt, ss
+    character(len=HECMW_NAME_LEN) :: datafmt, ss, basis
   !---- body
 
     filename_len = HECMW_FILENAME_LEN
     write(ss,*) filename_len
     write(datafmt, '(a,a,a)') 'S', trim(adjustl(ss)), ' '
 
-    if( fstr_ctrl_get_data_ex( ctrl, 1, datafmt, P%FREQ%eigenlog_filename ) /= 0) return
-    if( fstr_ctrl_get_data_ex( ctrl, 2, 'ii ', P%FREQ%start_mode, P%FREQ%end_mode ) /= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'REFINE ', '# ', 0, 'I', P%FREQ%n_refine ) /= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'BATCH ',  '# ', 0, 'I', P%FREQ%n_batch  ) /= 0) return
+    basis = ''
+    if( fstr_ctrl_get_param_ex( ctrl, 'BASIS ',  '# ', 0, 'S', basis ) /= 0) return
+    P%FREQ%basis_filename = basis
+
+    !the eigen log is not needed when the modes come from a modal basis file
+    !or from the preceding eigen analysis; then only the mode range is given
+    if( fstr_ctrl_get_data_line_n( ctrl ) == 1 ) then
+      if( fstr_ctrl_get_data_ex( ctrl, 1, 'ii ', P%FREQ%start_mode, P%FREQ%end_mode ) /= 0) return
+    else
+      if( fstr_ctrl_get_data_ex( ctrl, 1, datafmt, P%FREQ%eigenlog_filename ) /= 0) return
+      if( fstr_ctrl_get_data_ex( ctrl, 2, 'ii ', P%FREQ%start_mode, P%FREQ%end_mode ) /= 0) return
+    end if
 
     return
 
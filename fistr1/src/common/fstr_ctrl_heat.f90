@@ -32,7 +32,7 @@ contains
 
 
   !> Read in !HEAT
-  function fstr_ctrl_get_HEAT( ctrl, dt, etime, dtmin, deltmx, itmax, eps, tpname, beta )
+  function fstr_ctrl_get_HEAT( ctrl, dt, etime, dtmin, deltmx, itmax, eps, tpname, beta, errtol )
     implicit none
     integer(kind=kint) :: ctrl
     real(kind=kreal),pointer :: dt(:)
@@ -45,6 +45,7 @@ contains
     integer(kind=kint) :: fstr_ctrl_get_HEAT
     integer(kind=kint) :: result
     real(kind=kreal) :: beta, t_beta
+    real(kind=kreal) :: errtol
 
     fstr_ctrl_get_HEAT = -1
 
@@ -59,6 +60,8 @@ contains
     if( fstr_ctrl_get_param_ex( ctrl, 'BETA ', '# ', 0, 'R', t_beta)/=0 ) return
     if(0.0d0 <= t_beta .and. t_beta <= 1.0d0) beta = t_beta
 
+    if( fstr_ctrl_get_param_ex( ctrl, 'ERRTOL ', '# ', 0, 'R', errtol)/=0 ) return
+
     fstr_ctrl_get_HEAT = 0
   end function fstr_ctrl_get_HEAT
 
@@ -316,7 +319,8 @@ contains
   !> Read in !RADIATE (heat)
   !* ----------------------------------------------------------------------------------------------- *!
 
-  function fstr_ctrl_get_RADIATE( ctrl, amp1, amp2, elem_grp_name, elem_grp_name_len, load_type, value, sink)
+  function fstr_ctrl_get_RADIATE( ctrl, amp1, amp2, elem_grp_name, elem_grp_name_len, load_type, value, sink, &
+      cavity, sigma, rays)
     implicit none
     integer(kind=kint) :: ctrl
     character(len=HECMW_NAME_LEN) :: amp1
@@ -327,6 +331,9 @@ contains
     integer(kind=kint),pointer :: load_type(:)
     real(kind=kreal),pointer :: value(:)
     real(kind=kreal),pointer :: sink(:)
+    integer(kind=kint) :: cavity
+    real(kind=kreal)   :: sigma
+    integer(kind=kint) :: rays
     integer(kind=kint) :: fstr_ctrl_get_RADIATE
 
     integer(kind=kint),parameter :: type_name_size = 5
@@ -342,6 +349,9 @@ contains
     ! JP-14
     if( fstr_ctrl_get_param_ex( ctrl, 'AMP1 ',  '# ',         0,     'S',   amp1   )/= 0) return
     if( fstr_ctrl_get_param_ex( ctrl, 'AMP2 ',  '# ',         0,     'S',   amp2   )/= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'CAVITY ', '# ',        0,     'I',   cavity )/= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'SIGMA ', '# ',         0,     'R',   sigma  )/= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'RAYS ',  '# ',         0,     'I',   rays   )/= 0) return
 
     write(s1,*)  elem_grp_name_len
     write(s2,*)  type_name_size
@@ -387,7 +397,8 @@ contains
   !> Read in !SRADIATE  (heat)
   !* ----------------------------------------------------------------------------------------------- *!
 
-  function fstr_ctrl_get_SRADIATE( ctrl, amp1, amp2, surface_grp_name, surface_grp_name_len, value, sink)
+  function fstr_ctrl_get_SRADIATE( ctrl, amp1, amp2, surface_grp_name, surface_grp_name_len, value, sink, &
+      cavity, sigma, rays)
     implicit none
     integer(kind=kint) :: ctrl
     character(len=HECMW_NAME_LEN) :: amp1
@@ -397,6 +408,9 @@ contains
     integer(kind=kint) :: surface_grp_name_len
     real(kind=kreal),pointer :: value(:)
     real(kind=kreal),pointer :: sink(:)
+    integer(kind=kint) :: cavity
+    real(kind=kreal)   :: sigma
+    integer(kind=kint) :: rays
     integer(kind=kint) :: fstr_ctrl_get_SRADIATE
 
     character(len=HECMW_NAME_LEN) :: data_fmt
@@ -407,6 +421,9 @@ contains
     ! JP-15
     if( fstr_ctrl_get_param_ex( ctrl, 'AMP1 ',  '# ',          0,     'S',   amp1    )/= 0) return
     if( fstr_ctrl_get_param_ex( ctrl, 'AMP2 ',  '# ',          0,     'S',   amp2    )/= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'CAVITY ', '# ',         0,     'I',   cavity  )/= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'SIGMA ', '# ',          0,     'R',   sigma   )/= 0) return
+    if( fstr_ctrl_get_param_ex( ctrl, 'RAYS ',  '# ',          0,     'I',   rays    )/= 0) return
 
     write(s1,*) surface_grp_name_len;
     write(data_fmt,'(a,a,a)') 'S', trim(adjustl(s1)), 'Rr  '
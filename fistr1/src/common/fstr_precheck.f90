@@ -20,7 +20,8 @@ contains
 
     if(fstrPR%solution_type == kstEIGEN .or. &
        fstrPR%solution_type == kstSTATICEIGEN .or. &
-       fstrPR%solution_type == kstDYNAMIC)then
+       fstrPR%solution_type == kstDYNAMIC .or. &
+       fstrPR%solution_type == kstEIGENFREQ)then
       do i = 1, hecMESH%section%n_sect
         if(hecMESH%section%sect_type(i) == 4) cycle
         cid = hecMESH%section%sect_mat_ID_item(i)
@@ -385,7 +385,7 @@ contains
         else
           fstrSOLID%sections(i)%elemopt361 = kel361IC
         end if
-      else if( p%PARAM%solution_type==kstEIGEN ) then
+      else if( p%PARAM%solution_type==kstEIGEN .or. p%PARAM%solution_type==kstEIGENFREQ ) then
         fstrSOLID%sections(i)%elemopt361 = kel361IC
       else if( p%PARAM%solution_type==kstSTATICEIGEN ) then
         fstrSOLID%sections(i)%elemopt361 = kel361FBAR
@@ -420,6 +420,7 @@ contains
     c_aincparam = 0
     c_timepoints = 0
     fstrSOLID%elemopt361 = 0
+    fstrSOLID%geomcache_budget = 0.d0
     fstrSOLID%AutoINC_stat = 0
     fstrSOLID%CutBack_stat = 0
     fstrSOLID%NRstat_i(:) = 0
@@ -545,7 +546,7 @@ contains
 
       else if( header_name == '!ELEMOPT'  ) then
         c_elemopt = c_elemopt+1
-        if( fstr_ctrl_get_ELEMOPT( ctrl, fstrSOLID%elemopt361 )/=0 ) then
+        if( fstr_ctrl_get_ELEMOPT( ctrl, fstrSOLID%elemopt361, fstrSOLID%geomcache_budget )/=0 ) then
           write(*,*) '### Error: Fail in read in ELEMOPT definition : ' , c_elemopt
           write(ILOG,*) '### Error: Fail in read in ELEMOPT definition : ', c_elemopt
           stop
@@ -817,6 +818,10 @@ contains
       enddo
     endif
 
+    do i=1, size(fstrSOLID%materials)
+      call compileMaterial( fstrSOLID%materials(i) )
+    enddo
+
     if( fstrSOLID%TEMP_ngrp_tot > 0 .or. fstrSOLID%TEMP_irres > 0 ) then
       allocate ( fstrSOLID%temperature( hecMESH%n_node )      ,stat=ierror )
       if( ierror /= 0 ) then
@@ -888,7 +893,8 @@ contains
 
     if( p%PARAM%solution_type /= kstHEAT) call fstr_element_init( hecMESH, fstrSOLID )
     if( p%PARAM%solution_type==kstSTATIC .or. p%PARAM%solution_type==kstDYNAMIC .or.   &
-      p%PARAM%solution_type==kstEIGEN  .or. p%PARAM%solution_type==kstSTATICEIGEN )  &
+      p%PARAM%solution_type==kstEIGEN  .or. p%PARAM%solution_type==kstSTATICEIGEN .or. &
+      p%PARAM%solution_type==kstEIGENFREQ ) &
       call fstr_solid_alloc( hecMESH, fstrSOLID )
 
     if( p%PARAM%solution_type == kstHEAT) then
@@ -1081,8 +1087,9 @@ contains
     type(hecmwST_local_mesh),target :: hecMESH
     type(fstr_solid)                :: fstrSOLID
 
-    integer :: i, j, ng, isect, ndof, id, nn, n_elem
+    integer :: i, ng, isect, ndof, id, nn, n_elem
     integer :: ncon_stf
+    integer, allocatable :: mat_of(:)
 
     if( hecMESH%n_elem <=0 ) then
       stop "no element defined!"
@@ -1097,6 +1104,8 @@ contains
     ! number of elements
     n_elem = hecMESH%elem_type_index(hecMESH%n_elem_type)
     allocate( fstrSOLID%elements(n_elem) )
+    allocate( mat_of(n_elem) )
+    mat_of(:) = 0
 
     do i= 1, n_elem
       fstrSOLID%elements(i)%etype = hecMESH%elem_type(i)
@@ -1105,7 +1114,6 @@ contains
       if (hecmw_is_etype_patch(fstrSOLID%elements(i)%etype)) cycle
       ng = NumOfQuadPoints( fstrSOLID%elements(i)%etype )
       if( ng > fstrSOLID%maxn_gauss ) fstrSOLID%maxn_gauss = ng
-      if( ng > 0 ) allocate( fstrSOLID%elements(i)%gausses( ng ) )
 
       isect= hecMESH%section_ID(i)
       ndof = getSpaceDimension( fstrSOLID%elements(i)%etype )
@@ -1124,10 +1132,7 @@ contains
         stop "Error in element's section definition"
       id = hecMESH%section%sect_mat_ID_item(isect)
       fstrSOLID%materials(id)%cdsys_ID = hecMESH%section%sect_orien_ID(isect)
-      do j=1,ng
-        fstrSOLID%elements(i)%gausses(j)%pMaterial => fstrSOLID%materials(id)
-        call fstr_init_gauss( fstrSOLID%elements(i)%gausses( j )  )
-      enddo
+      if( ng > 0 ) mat_of(i) = id
 
       nn = hecMESH%elem_node_index(i)-hecMESH%elem_node_index(i-1)
       allocate(fstrSOLID%elements(i)%equiForces(nn*ndof))
@@ -1143,12 +1148,126 @@ contains
 
     enddo
 
+    call fstr_gauss_store_init( hecMESH, fstrSOLID, mat_of )
+    deallocate( mat_of )
+
     fstrSOLID%max_ncon_stf = fstrSOLID%max_ncon
     if( fstrSOLID%is_smoothing_active ) call fstr_smoothed_element_calcmaxcon( hecMESH, fstrSOLID )
 
     call hecmw_allreduce_I1(hecMESH,fstrSOLID%maxn_gauss,HECMW_MAX)
+
+    if( fstrSOLID%geomcache_budget > 0.d0 ) call fstr_element_geomcache_init( hecMESH, fstrSOLID )
   end subroutine
 
+  !> Allocate quadrature points of all elements. Points of elements sharing
+  !! element type and material are gathered into one tGaussStore
+  subroutine fstr_gauss_store_init( hecMESH, fstrSOLID, mat_of )
+    use elementInfo
+    use mMechGauss
+    type(hecmwST_local_mesh) :: hecMESH
+    type(fstr_solid)         :: fstrSOLID
+    integer, intent(in)      :: mat_of(:)     !< material of each element, 0 if no quadrature point
+
+    integer :: itype, is, iE, icel, id, ng, n_mat, nstore, k
+    integer, allocatable :: store_size(:,:), store_id(:,:), offset(:)
+
+    n_mat = size(fstrSOLID%materials)
+    allocate( store_size(n_mat, hecMESH%n_elem_type), store_id(n_mat, hecMESH%n_elem_type) )
+    store_size(:,:) = 0
+    store_id(:,:) = 0
+
+    do itype = 1, hecMESH%n_elem_type
+      is = hecMESH%elem_type_index(itype-1) + 1
+      iE = hecMESH%elem_type_index(itype  )
+      do icel = is, iE
+        id = mat_of(icel)
+        if( id == 0 ) cycle
+        store_size(id,itype) = store_size(id,itype) + NumOfQuadPoints( fstrSOLID%elements(icel)%etype )
+      enddo
+    enddo
+
+    nstore = count( store_size > 0 )
+    allocate( fstrSOLID%gauss_stores(nstore), offset(nstore) )
+    offset(:) = 0
+    k = 0
+    do itype = 1, hecMESH%n_elem_type
+      do id = 1, n_mat
+        if( store_size(id,itype) == 0 ) cycle
+        k = k + 1
+        store_id(id,itype) = k
+        call fstr_init_gauss_store( fstrSOLID%gauss_stores(k), fstrSOLID%materials(id), store_size(id,itype) )
+      enddo
+    enddo
+
+    do itype = 1, hecMESH%n_elem_type
+      is = hecMESH%elem_type_index(itype-1) + 1
+      iE = hecMESH%elem_type_index(itype  )
+      do icel = is, iE
+        id = mat_of(icel)
+        if( id == 0 ) cycle
+        k = store_id(id,itype)
+        ng = NumOfQuadPoints( fstrSOLID%elements(icel)%etype )
+        fstrSOLID%elements(icel)%gausses => fstrSOLID%gauss_stores(k)%gausses(offset(k)+1:offset(k)+ng)
+        offset(k) = offset(k) + ng
+      enddo
+    enddo
+
+    deallocate( store_size, store_id, offset )
+  end subroutine fstr_gauss_store_init
+
+  !> Store global shape derivatives and weight*det(J) of small-strain solid
+  !! elements, as long as the memory budget given by !ELEMOPT, GEOMCACHE allows
+  subroutine fstr_element_geomcache_init( hecMESH, fstrSOLID )
+    use elementInfo
+    use mMechGauss
+    type(hecmwST_local_mesh) :: hecMESH
+    type(fstr_solid)         :: fstrSOLID
+
+    integer(kind=kint) :: itype, is, iE, ic_type, icel, isect, iiS, nn, i, j, LX, ncache
+    real(kind=kreal)   :: ecoord(3,20), det, budget, used
+    logical            :: is_full
+
+    budget = fstrSOLID%geomcache_budget*1024.d0*1024.d0
+    used = 0.d0
+    ncache = 0
+    is_full = .false.
+    do itype = 1, hecMESH%n_elem_type
+      if( is_full ) exit
+      is = hecMESH%elem_type_index(itype-1) + 1
+      iE = hecMESH%elem_type_index(itype  )
+      ic_type = hecMESH%elem_type_item(itype)
+      if( ic_type/=341 .and. ic_type/=342 .and. ic_type/=351 .and. ic_type/=352 .and. &
+        ic_type/=361 .and. ic_type/=362 ) cycle
+      do icel = is, iE
+        isect = hecMESH%section_ID(icel)
+        if( ic_type==341 .and. fstrSOLID%sections(isect)%elemopt341 == kel341SESNS ) cycle
+        if( ic_type==361 .and. fstrSOLID%sections(isect)%elemopt361 /= kel361FI ) cycle
+        if( fstrSOLID%elements(icel)%gausses(1)%pMaterial%nlgeom_flag /= INFINITESIMAL ) cycle
+
+        iiS = hecMESH%elem_node_index(icel-1)
+        nn = hecMESH%elem_node_index(icel)-iiS
+        if( .not. fstr_alloc_geomcache( fstrSOLID%elements(icel), nn, 3, budget, used ) ) then
+          is_full = .true.
+          exit
+        endif
+        do j = 1, nn
+          do i = 1, 3
+            ecoord(i,j) = hecMESH%node( 3*hecMESH%elem_node_item(iiS+j)+i-3 )
+          enddo
+        enddo
+        do LX = 1, NumOfQuadPoints(ic_type)
+          call getQuadGlobalDeriv( ic_type, nn, LX, ecoord(:,1:nn), det, &
+            fstrSOLID%elements(icel)%gderiv(:,:,LX) )
+          fstrSOLID%elements(icel)%wdet(LX) = getQuadWeight( ic_type, LX )*det
+        enddo
+        ncache = ncache + 1
+      enddo
+    enddo
+
+    write(ILOG,'(a,i10,a,f12.2,a)') ' Geometric cache:', ncache, ' elements,', used/1024.d0/1024.d0, ' MB'
+    if( is_full ) write(ILOG,*) ' Geometric cache: budget exceeded, the rest are recomputed'
+  end subroutine fstr_element_geomcache_init
+
   !> Finalizer of fstr_solid
   subroutine fstr_solid_finalize( fstrSOLID )
     type(fstr_solid) :: fstrSOLID
@@ -1161,21 +1280,24 @@ contains
     endif
     if( .not. associated(fstrSOLID%elements ) ) return
     do i=1,size(fstrSOLID%elements)
-      if( associated(fstrSOLID%elements(i)%gausses) ) then
-        do j=1,size(fstrSOLID%elements(i)%gausses)
-          call fstr_finalize_gauss(fstrSOLID%elements(i)%gausses(j))
-        enddo
-        deallocate( fstrSOLID%elements(i)%gausses )
-      endif
+      ! quadrature points are slices of fstrSOLID%gauss_stores
+      nullify( fstrSOLID%elements(i)%gausses )
       if(associated(fstrSOLID%elements(i)%equiForces) ) then
         deallocate(fstrSOLID%elements(i)%equiForces)
       endif
       if( associated(fstrSOLID%elements(i)%aux) ) then
         deallocate(fstrSOLID%elements(i)%aux)
       endif
+      call fstr_finalize_geomcache( fstrSOLID%elements(i) )
     enddo
 
     deallocate( fstrSOLID%elements )
+    if( associated(fstrSOLID%gauss_stores) ) then
+      do j=1,size(fstrSOLID%gauss_stores)
+        call fstr_finalize_gauss_store( fstrSOLID%gauss_stores(j) )
+      enddo
+      deallocate( fstrSOLID%gauss_stores )
+    endif
     if( associated( fstrSOLID%mpc_const ) ) then
       deallocate( fstrSOLID%mpc_const )
     endif
@@ -1404,6 +1526,10 @@ contains
     fstrHEAT%H_SUF_tot   = 0
     fstrHEAT%WL_tot      = 0
     fstrHEAT%beta        = -1.0d0
+    fstrHEAT%ERRTOL      = 0.0d0
+    fstrHEAT%VF_n        = 0
+    fstrHEAT%VF_rays     = 1000
+    fstrHEAT%VF_sigma    = 5.670374419d-8
   end subroutine fstr_heat_init
 
   !> Initial setting of eigen ca;culation
@@ -1608,7 +1734,8 @@ contains
     if( P%PARAM%solution_type == kstSTATIC &
         .or. P%PARAM%solution_type == kstEIGEN  &
         .or. P%PARAM%solution_type == kstDYNAMIC &
-        .or. P%PARAM%solution_type == kstSTATICEIGEN ) then
+        .or. P%PARAM%solution_type == kstSTATICEIGEN &
+        .or. P%PARAM%solution_type == kstEIGENFREQ ) then
       ! Memory Allocation for Result Vectors ------------
       if( P%MESH%n_dof == 6 .or. P%SOLID%is_33shell == 1 ) then
         allocate ( P%SOLID%SHELL )
@@ -1981,12 +2108,19 @@ end function fstr_setup_INITIAL
     integer(kind=kint) :: nout
     integer(kind=kint) :: version
 
-    integer(kind=kint) :: rcode
+    integer(kind=kint) :: rcode, async, nkeep
     nout = 0
     rcode = fstr_ctrl_get_param_ex( ctrl, 'FREQUENCY ', '# ', 0, 'I', nout )
     if( rcode /= 0 ) call fstr_ctrl_err_stop
     rcode = fstr_ctrl_get_param_ex( ctrl, 'VERSION ', '# ', 0, 'I', version )
     if( rcode /= 0 ) call fstr_ctrl_err_stop
+    async = 0
+    rcode = fstr_ctrl_get_param_ex( ctrl, 'ASYNC ', '# ', 0, 'I', async )
+    if( rcode /= 0 ) call fstr_ctrl_err_stop
+    nkeep = 1
+    rcode = fstr_ctrl_get_param_ex( ctrl, 'KEEP ', '# ', 0, 'I', nkeep )
+    if( rcode /= 0 ) call fstr_ctrl_err_stop
+    call hecmw_restart_set_option( async, nkeep )
 
   end subroutine fstr_setup_RESTART
 
@@ -2527,7 +2661,8 @@ end function fstr_setup_INITIAL
       P%PARAM%itmax,     &
       P%PARAM%eps,       &
       mName,             &
-      P%HEAT%beta)
+      P%HEAT%beta,       &
+      P%HEAT%ERRTOL)
     if( rcode /= 0 ) then
       call fstr_ctrl_err_stop
     end if
@@ -3085,7 +3220,7 @@ end function fstr_setup_INITIAL
 
     integer(kind=kint) :: rcode
     character(HECMW_NAME_LEN) :: amp1, amp2
-    integer(kind=kint) :: amp_id1, amp_id2
+    integer(kind=kint) :: amp_id1, amp_id2, cavity
     character(HECMW_NAME_LEN), pointer :: grp_id_name(:)
     integer(kind=kint),pointer :: load_type(:)
     real(kind=kreal),pointer :: value(:)
@@ -3105,8 +3240,9 @@ end function fstr_setup_INITIAL
 
     amp1 = ' '
     amp2 = ' '
+    cavity = 0
     rcode = fstr_ctrl_get_RADIATE( ctrl, amp1, amp2, &
-      grp_id_name, HECMW_NAME_LEN, load_type, value, shink )
+      grp_id_name, HECMW_NAME_LEN, load_type, value, shink, cavity, P%HEAT%VF_sigma, P%HEAT%VF_rays )
     if( rcode /= 0 ) call fstr_ctrl_err_stop
 
     call amp_name_to_id( P%MESH, '!RADIATE', amp1, amp_id1 )
@@ -3136,6 +3272,7 @@ end function fstr_setup_INITIAL
     call fstr_expand_integer_array(  P%HEAT%R_SUF_elem,    old_size, new_size )
     call fstr_expand_integer_array2( P%HEAT%R_SUF_ampl, 2, old_size, new_size )
     call fstr_expand_integer_array(  P%HEAT%R_SUF_surf,    old_size, new_size )
+    call fstr_expand_integer_array(  P%HEAT%R_SUF_cavity,  old_size, new_size )
     call fstr_expand_real_array2(    P%HEAT%R_SUF_val,  2, old_size, new_size )
     P%HEAT%R_SUF_tot = new_size
 
@@ -3159,6 +3296,7 @@ end function fstr_setup_INITIAL
         P%HEAT%R_SUF_val  (id,2) = shink(i)
         P%HEAT%R_SUF_ampl (id,1) = amp_id1
         P%HEAT%R_SUF_ampl (id,2) = amp_id2
+        P%HEAT%R_SUF_cavity(id)  = cavity
         id = id + 1
       end do
     end do
@@ -3183,7 +3321,7 @@ end function fstr_setup_INITIAL
 
     integer(kind=kint) :: rcode
     character(HECMW_NAME_LEN) :: amp1, amp2
-    integer(kind=kint) :: amp_id1, amp_id2
+    integer(kind=kint) :: amp_id1, amp_id2, cavity
     character(HECMW_NAME_LEN), pointer :: grp_id_name(:)
     real(kind=kreal),pointer :: value(:)
     real(kind=kreal),pointer :: shink(:)
@@ -3200,7 +3338,9 @@ end function fstr_setup_INITIAL
 
     amp1 = ' '
     amp2 = ' '
-    rcode = fstr_ctrl_get_SRADIATE( ctrl, amp1, amp2, grp_id_name, HECMW_NAME_LEN, value, shink )
+    cavity = 0
+    rcode = fstr_ctrl_get_SRADIATE( ctrl, amp1, amp2, grp_id_name, HECMW_NAME_LEN, value, shink, &
+      cavity, P%HEAT%VF_sigma, P%HEAT%VF_rays )
     if( rcode /= 0 ) call fstr_ctrl_err_stop
 
     call amp_name_to_id( P%MESH, '!SRADIATE', amp1, amp_id1 )
@@ -3224,6 +3364,7 @@ end function fstr_setup_INITIAL
     call fstr_expand_integer_array(  P%HEAT%R_SUF_elem,    old_size, new_size )
     call fstr_expand_integer_array2( P%HEAT%R_SUF_ampl, 2, old_size, new_size )
     call fstr_expand_integer_array(  P%HEAT%R_SUF_surf,    old_size, new_size )
+    call fstr_expand_integer_array(  P%HEAT%R_SUF_cavity,  old_size, new_size )
     call fstr_expand_real_array2(    P%HEAT%R_SUF_val,  2, old_size, new_size )
     P%HEAT%R_SUF_tot = new_size
 
@@ -3242,6 +3383,7 @@ end function fstr_setup_INITIAL
         P%HEAT%R_SUF_val  (id,2) = shink(i)
         P%HEAT%R_SUF_ampl (id,1) = amp_id1
         P%HEAT%R_SUF_ampl (id,2) = amp_id2
+        P%HEAT%R_SUF_cavity(id)  = cavity
         id = id + 1
       end do
     end do
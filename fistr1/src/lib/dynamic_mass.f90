@@ -36,9 +36,8 @@ contains
     if(sec_opt == 2) thick = 1.0d0
 
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint(etype, LX, naturalCoord)
-      call getShapeFunc(etype, naturalCoord, func)
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, func)
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       if(present(temperature))then
         !ina(1) = temperature
@@ -61,7 +60,7 @@ contains
       D(1,1) = rho*thick
       D(2,2) = rho*thick
 
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
 
       N = 0.0d0
       do i = 1, nn
@@ -106,9 +105,8 @@ contains
     matl => gausses(1)%pMaterial
 
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint(etype, LX, naturalCoord)
-      call getShapeFunc(etype, naturalCoord, func)
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, func)
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       if(present(temperature))then
         !ina(1) = temperature
@@ -132,7 +130,7 @@ contains
       D(2,2) = rho
       D(3,3) = rho
 
-      wg = getWeight(etype,LX)*det
+      wg = getQuadWeight( etype, LX )*det
 
       N = 0.0d0
       do i = 1, nn
@@ -105,6 +105,30 @@ module elementInfo
   integer, parameter :: fe_quad8n_patch   = 1042
   ! ---------------------------------------------
 
+  !-------------------------------------------
+  !     Following tabulated shape functions
+  !-------------------------------------------
+  !> Shape functions, their derivatives and weights of one element type
+  !! evaluated once at all quadrature points of the element
+  type tShapeTable
+    integer :: nn   = 0                                  !< number of nodes
+    integer :: nqp  = 0                                  !< number of quadrature points
+    integer :: ndim = 0                                  !< space dimension
+    real(kind=kreal), pointer :: weight(:) => null()     !< weight(nqp)
+    real(kind=kreal), pointer :: func(:,:) => null()     !< func(nn,nqp)
+    real(kind=kreal), pointer :: deriv(:,:,:) => null()  !< deriv(nn,ndim,nqp)
+  end type
+
+  integer, parameter, private :: nShapeTable = 12
+  integer, parameter, private :: shapeTableTypes(nShapeTable) = (/ fe_tri3n, fe_tri6n,  &
+    fe_quad4n, fe_quad8n, fe_tet4n, fe_tet4n_pipi, fe_tet10n, fe_prism6n, fe_prism15n,  &
+    fe_hex8n, fe_hex20n, fe_beam341 /)
+  integer, parameter, private :: maxShapeTableType = 4000
+
+  type(tShapeTable), target, save, private :: shapeTables(nShapeTable)
+  integer, save, private :: shapeTableIndex(0:maxShapeTableType) = 0
+  logical, save, private :: isShapeTableReady = .false.
+
 contains
 
   !************************************
@@ -743,11 +767,42 @@ contains
     real(kind=kreal), intent(out) :: det             !< nodal coord of curr element
     real(kind=kreal), intent(out) :: gderiv(:,:)     !< shape derivative in global coordinate system
 
-    real(kind=kreal) :: DUM, XJ(3,3), XJI(3,3), deriv(nn,3)
+    real(kind=kreal) :: deriv(nn,3)
     integer          :: nspace
 
     nspace = getSpaceDimension( fetype )
     call getShapeDeriv( fetype, localCoord(:), deriv(1:nn,:) )
+    call calcGlobalDeriv( nspace, nn, deriv, elecoord, det, gderiv )
+  end subroutine
+
+  !> Calculate shape derivative in global coordinate system at a quadrature point
+  !! with tabulated shape derivatives
+  subroutine getQuadGlobalDeriv( fetype, nn, np, elecoord, det, gderiv )
+    integer, intent(in)           :: fetype          !< element type
+    integer, intent(in)           :: nn              !< number of elemental nodes
+    integer, intent(in)           :: np              !< number of curr quadrature point
+    real(kind=kreal), intent(in)  :: elecoord(:,:)   !< nodal coord of curr element
+    real(kind=kreal), intent(out) :: det             !< nodal coord of curr element
+    real(kind=kreal), intent(out) :: gderiv(:,:)     !< shape derivative in global coordinate system
+
+    real(kind=kreal) :: deriv(nn,3)
+    integer          :: nspace
+
+    nspace = getSpaceDimension( fetype )
+    call getQuadShapeDeriv( fetype, np, deriv(1:nn,:) )
+    call calcGlobalDeriv( nspace, nn, deriv, elecoord, det, gderiv )
+  end subroutine
+
+  !> Transform shape derivative in natural coordinate into global coordinate system
+  subroutine calcGlobalDeriv( nspace, nn, deriv, elecoord, det, gderiv )
+    integer, intent(in)           :: nspace          !< space dimension
+    integer, intent(in)           :: nn              !< number of elemental nodes
+    real(kind=kreal), intent(in)  :: deriv(nn,3)     !< shape derivative in natural coordinate system
+    real(kind=kreal), intent(in)  :: elecoord(:,:)   !< nodal coord of curr element
+    real(kind=kreal), intent(out) :: det             !< nodal coord of curr element
+    real(kind=kreal), intent(out) :: gderiv(:,:)     !< shape derivative in global coordinate system
+
+    real(kind=kreal) :: DUM, XJ(3,3), XJI(3,3)
 
     if( nspace==2 ) then
       XJ(1:2,1:2)=matmul( elecoord(1:2,1:nn), deriv(1:nn,1:2) )
@@ -1223,5 +1278,147 @@ contains
     getReferenceLength = dsqrt( detJ )
   end function getReferenceLength
 
+  !************************************
+  !    Following tabulated shape functions
+  !************************************
+  !> Evaluate shape functions, their derivatives and weights at the quadrature
+  !! points of all tabulated element types. Called once at startup; the
+  !! fetch routines below also call it on first use.
+  subroutine initShapeTables()
+    integer          :: it, fetype, nn, nqp, ndim, np
+    real(kind=kreal) :: pos(3)
+
+    if( isShapeTableReady ) return
+    !$omp critical (shape_table_init)
+    if( .not. isShapeTableReady ) then
+      do it = 1, nShapeTable
+        fetype = shapeTableTypes(it)
+        nn   = getNumberOfNodes( fetype )
+        nqp  = NumOfQuadPoints( fetype )
+        ndim = getSpaceDimension( fetype )
+        shapeTables(it)%nn   = nn
+        shapeTables(it)%nqp  = nqp
+        shapeTables(it)%ndim = ndim
+        allocate( shapeTables(it)%weight(nqp) )
+        allocate( shapeTables(it)%func(nn,nqp) )
+        allocate( shapeTables(it)%deriv(nn,ndim,nqp) )
+        do np = 1, nqp
+          pos(:) = 0.d0
+          call getQuadPoint( fetype, np, pos(1:ndim) )
+          shapeTables(it)%weight(np) = getWeight( fetype, np )
+          call getShapeFunc( fetype, pos(1:ndim), shapeTables(it)%func(:,np) )
+          call getShapeDeriv( fetype, pos(1:ndim), shapeTables(it)%deriv(:,:,np) )
+        enddo
+        shapeTableIndex(fetype) = it
+      enddo
+      isShapeTableReady = .true.
+    endif
+    !$omp end critical (shape_table_init)
+  end subroutine initShapeTables
+
+  !> Release the tabulated shape functions
+  subroutine finalizeShapeTables()
+    integer :: it
+
+    if( .not. isShapeTableReady ) return
+    do it = 1, nShapeTable
+      deallocate( shapeTables(it)%weight, shapeTables(it)%func, shapeTables(it)%deriv )
+    enddo
+    shapeTableIndex(:) = 0
+    isShapeTableReady = .false.
+  end subroutine finalizeShapeTables
+
+  !> Obtain the table of the element, null if the element type is not tabulated
+  function getShapeTable( fetype ) result( table )
+    integer, intent(in)        :: fetype           !< element type
+    type(tShapeTable), pointer :: table
+
+    table => null()
+    if( .not. isShapeTableReady ) call initShapeTables()
+    if( fetype < 0 .or. fetype > maxShapeTableType ) return
+    if( shapeTableIndex(fetype) == 0 ) return
+    table => shapeTables(shapeTableIndex(fetype))
+  end function getShapeTable
+
+  !> Contiguous view of tabulated shape functions func(nn,nqp), null if not tabulated
+  function quadShapeFuncTable( fetype ) result( func )
+    integer, intent(in)       :: fetype            !< element type
+    real(kind=kreal), pointer :: func(:,:)
+    type(tShapeTable), pointer :: table
+
+    func => null()
+    table => getShapeTable( fetype )
+    if( associated(table) ) func => table%func
+  end function quadShapeFuncTable
+
+  !> Contiguous view of tabulated shape derivatives deriv(nn,ndim,nqp), null if not tabulated
+  function quadShapeDerivTable( fetype ) result( deriv )
+    integer, intent(in)       :: fetype            !< element type
+    real(kind=kreal), pointer :: deriv(:,:,:)
+    type(tShapeTable), pointer :: table
+
+    deriv => null()
+    table => getShapeTable( fetype )
+    if( associated(table) ) deriv => table%deriv
+  end function quadShapeDerivTable
+
+  !> Contiguous view of tabulated quadrature weights weight(nqp), null if not tabulated
+  function quadWeightTable( fetype ) result( weight )
+    integer, intent(in)       :: fetype            !< element type
+    real(kind=kreal), pointer :: weight(:)
+    type(tShapeTable), pointer :: table
+
+    weight => null()
+    table => getShapeTable( fetype )
+    if( associated(table) ) weight => table%weight
+  end function quadWeightTable
+
+  !> Fetch the shape function at a quadrature point
+  subroutine getQuadShapeFunc( fetype, np, func )
+    integer, intent(in)           :: fetype        !< element type
+    integer, intent(in)           :: np            !< number of curr quadrature point
+    real(kind=kreal), intent(out) :: func(:)       !< shape function
+    type(tShapeTable), pointer :: table
+    real(kind=kreal) :: pos(3)
+
+    table => getShapeTable( fetype )
+    if( associated(table) ) then
+      func(1:table%nn) = table%func(:,np)
+    else
+      call getQuadPoint( fetype, np, pos )
+      call getShapeFunc( fetype, pos, func )
+    endif
+  end subroutine getQuadShapeFunc
+
+  !> Fetch derivatives of shape function in natural coordinate system at a quadrature point
+  subroutine getQuadShapeDeriv( fetype, np, shapederiv )
+    integer, intent(in)           :: fetype           !< element type
+    integer, intent(in)           :: np               !< number of curr quadrature point
+    real(kind=kreal), intent(out) :: shapederiv(:,:)  !< derivative of shape function
+    type(tShapeTable), pointer :: table
+    real(kind=kreal) :: pos(3)
+
+    table => getShapeTable( fetype )
+    if( associated(table) ) then
+      shapederiv(1:table%nn,1:table%ndim) = table%deriv(:,:,np)
+    else
+      call getQuadPoint( fetype, np, pos )
+      call getShapeDeriv( fetype, pos, shapederiv )
+    endif
+  end subroutine getQuadShapeDeriv
+
+  !> Fetch the weight value at a quadrature point
+  real(kind=kreal) function getQuadWeight( fetype, np )
+    integer, intent(in) :: fetype                 !< element type
+    integer, intent(in) :: np                     !< number of curr quadrature point
+    type(tShapeTable), pointer :: table
+
+    table => getShapeTable( fetype )
+    if( associated(table) ) then
+      getQuadWeight = table%weight(np)
+    else
+      getQuadWeight = getWeight( fetype, np )
+    endif
+  end function getQuadWeight
 
 end module
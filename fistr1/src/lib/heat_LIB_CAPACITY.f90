@@ -99,16 +99,15 @@ contains
     !matl => gausses(1)%pMaterial
 
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint(etype, LX, naturalCoord)
-      call getShapeFunc(etype, naturalCoord, func)
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, func)
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       temp = dot_product(func, temperature)
       call heat_GET_coefficient(temp, IMAT, SPE, ntab1, temp1, funcA1, funcB1)
       call heat_GET_coefficient(temp, IMAT, DEN, ntab2, temp2, funcA2, funcB2)
 
       D(1,1) = SPE(1)*DEN(1)*thick
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
 
       N = 0.0d0
       do i = 1, nn
@@ -155,9 +154,8 @@ contains
     !matl => gausses(1)%pMaterial
 
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint(etype, LX, naturalCoord)
-      call getShapeFunc(etype, naturalCoord, func)
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, func)
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       temp = dot_product(func, temperature)
       call heat_GET_coefficient(temp, IMAT, SPE, ntab1, temp1, funcA1, funcB1)
@@ -165,7 +163,7 @@ contains
 
       D = 0.0d0
       D(1,1) = SPE(1)*DEN(1)
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
 
       N = 0.0d0
       do i = 1, nn
@@ -92,9 +92,8 @@ contains
     !matl => gausses(1)%pMaterial
 
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint(etype, LX, naturalCoord)
-      call getShapeFunc(etype, naturalCoord, func)
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, func)
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       temp_i = dot_product(func, temperature)
       call heat_GET_coefficient(temp_i, IMAT, CC, ntab, temp, funcA, funcB)
@@ -102,7 +101,7 @@ contains
       D = 0.0d0
       D(1,1) = CC(1)*thick
       D(2,2) = CC(1)*thick
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
 
       DN = matmul(D, transpose(gderiv))
       forall(i = 1:nn,  j = 1:nn)
@@ -137,9 +136,8 @@ contains
     !matl => gausses(1)%pMaterial
 
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint(etype, LX, naturalCoord)
-      call getShapeFunc(etype, naturalCoord, func)
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, func)
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       temp_i = dot_product(func, temperature)
       call heat_GET_coefficient(temp_i, IMAT, SPE, ntab, temp, funcA, funcB)
@@ -148,7 +146,7 @@ contains
       D(1,1) = SPE(1)
       D(2,2) = SPE(1)
       D(3,3) = SPE(1)
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
 
       DN = matmul(D, transpose(gderiv))
       forall(i = 1:nn,  j = 1:nn)
@@ -0,0 +1,525 @@
+!-------------------------------------------------------------------------------
+! Copyright (c) 2019 FrontISTR Commons
+! This software is released under the MIT License, see LICENSE.txt
+!-------------------------------------------------------------------------------
+!> \brief This module provides view factors between radiating facets and
+!! the radiosity solution of gray diffuse enclosures
+!!
+!! View factors are estimated by casting cosine distributed rays from every
+!! facet against a bounding volume hierarchy of the facets of its cavity.
+!! Rays are generated from Halton sequences, so the result is reproducible.
+module m_heat_LIB_VIEWFACTOR
+  use hecmw
+  implicit none
+
+  private
+  public :: heat_viewfactor_corner
+  public :: heat_viewfactor_compute
+  public :: heat_viewfactor_radiosity
+
+  integer(kind=kint), parameter :: BVH_LEAF  = 4
+  integer(kind=kint), parameter :: BVH_STACK = 128
+  real(kind=kreal),   parameter :: PI = 3.14159265358979323846d0
+
+  !> triangles of one cavity and their bounding volume hierarchy
+  type tVFScene
+    integer(kind=kint) :: n_tri, n_node
+    real(kind=kreal), allocatable :: v0(:,:), e1(:,:), e2(:,:), nrm(:,:)
+    integer(kind=kint), allocatable :: facet(:)
+    real(kind=kreal), allocatable :: bmin(:,:), bmax(:,:)
+    integer(kind=kint), allocatable :: child(:), first(:), last(:)
+    integer(kind=kint), allocatable :: tri(:)
+  end type tVFScene
+
+  !> one row of the view factor matrix
+  type tVFRow
+    integer(kind=kint) :: n
+    integer(kind=kint), allocatable :: item(:)
+    real(kind=kreal), allocatable :: val(:)
+  end type tVFRow
+
+contains
+
+  !> Corner nodes of a radiating facet, numbered as in heat_RADIATE_xxx
+  !! (nc = 0 if the element type cannot be part of a cavity)
+  subroutine heat_viewfactor_corner(etype, ltype, nc, corner)
+    integer(kind=kint), intent(in)  :: etype, ltype
+    integer(kind=kint), intent(out) :: nc, corner(4)
+    integer(kind=kint), parameter :: tet(3,4) = reshape( &
+      (/ 1,2,3, 4,2,1, 4,3,2, 4,1,3 /), (/3,4/) )
+    integer(kind=kint), parameter :: pri(4,5) = reshape( &
+      (/ 1,2,3,0, 6,5,4,0, 4,5,2,1, 5,6,3,2, 6,4,1,3 /), (/4,5/) )
+    integer(kind=kint), parameter :: hex(4,6) = reshape( &
+      (/ 1,2,3,4, 8,7,6,5, 5,6,2,1, 6,7,3,2, 7,8,4,3, 8,5,1,4 /), (/4,6/) )
+
+    nc = 0
+    corner = 0
+    select case(etype)
+      case(341, 342)
+        if(ltype < 1 .or. 4 < ltype) return
+        nc = 3
+        corner(1:3) = tet(:,ltype)
+      case(351, 352)
+        if(ltype < 1 .or. 5 < ltype) return
+        nc = 4
+        if(ltype <= 2) nc = 3
+        corner(1:nc) = pri(1:nc,ltype)
+      case(361, 362)
+        if(ltype < 1 .or. 6 < ltype) return
+        nc = 4
+        corner = hex(:,ltype)
+      case(731)
+        nc = 3
+        corner(1:3) = (/1,2,3/)
+      case(741)
+        nc = 4
+        corner = (/1,2,3,4/)
+    end select
+  end subroutine heat_viewfactor_corner
+
+  !> Compute the view factor matrix F(i,j) of n facets in CRS format.
+  !! Facet i is a triangle or quadrilateral xyz(:,1:nc(i),i) whose
+  !! right-handed normal points into its cavity. Facets only see
+  !! facets with the same cavity ID. The result satisfies reciprocity
+  !! area(i)*F(i,j) = area(j)*F(j,i).
+  subroutine heat_viewfactor_compute(n, nc, xyz, cavity, nrays, area, index, item, val)
+    integer(kind=kint), intent(in) :: n, nc(n), cavity(n), nrays
+    real(kind=kreal), intent(in)   :: xyz(3,4,n)
+    real(kind=kreal), intent(out)  :: area(n)
+    integer(kind=kint), pointer    :: index(:), item(:)
+    real(kind=kreal), pointer      :: val(:)
+    type(tVFRow), allocatable :: row(:)
+    type(tVFScene) :: scene
+    integer(kind=kint), allocatable :: member(:)
+    integer(kind=kint) :: i, m, icav, cav_max, cav_min
+
+    allocate(row(n))
+    do i = 1, n
+      area(i) = facet_area(nc(i), xyz(:,:,i))
+      row(i)%n = 0
+    enddo
+
+    if(n > 0)then
+      cav_min = minval(cavity)
+      cav_max = maxval(cavity)
+    else
+      cav_min = 1
+      cav_max = 0
+    endif
+    allocate(member(n))
+    do icav = cav_min, cav_max
+      m = 0
+      do i = 1, n
+        if(cavity(i) /= icav) cycle
+        m = m + 1
+        member(m) = i
+      enddo
+      if(m == 0) cycle
+      call scene_build(scene, m, member, nc, xyz)
+      call cast_rays(scene, n, m, member, nc, xyz, nrays, row)
+      call scene_free(scene)
+    enddo
+    deallocate(member)
+
+    call make_reciprocal(n, area, row, index, item, val)
+    deallocate(row)
+  end subroutine heat_viewfactor_compute
+
+  !> Solve the radiosity J = eps*Eb + (1-eps)*G of a gray diffuse
+  !! enclosure by Gauss-Seidel iteration and return the irradiation
+  !! G(i) = sum_j F(i,j)*J(j) + (1 - sum_j F(i,j))*Esink(i).
+  subroutine heat_viewfactor_radiosity(n, index, item, val, eps, Eb, Esink, G)
+    integer(kind=kint), intent(in) :: n, index(0:n), item(:)
+    real(kind=kreal), intent(in)   :: val(:), eps(n), Eb(n), Esink(n)
+    real(kind=kreal), intent(out)  :: G(n)
+    real(kind=kreal), allocatable  :: J(:)
+    real(kind=kreal) :: Fsum, Jnew, dmax, jmax
+    integer(kind=kint) :: i, k, iter
+
+    allocate(J(n))
+    J(:) = Eb(:)
+    do iter = 1, 1000
+      dmax = 0.0d0
+      jmax = 0.0d0
+      do i = 1, n
+        G(i) = 0.0d0
+        Fsum = 0.0d0
+        do k = index(i-1)+1, index(i)
+          G(i) = G(i) + val(k)*J(item(k))
+          Fsum = Fsum + val(k)
+        enddo
+        G(i) = G(i) + (1.0d0 - Fsum)*Esink(i)
+        Jnew = eps(i)*Eb(i) + (1.0d0 - eps(i))*G(i)
+        dmax = max(dmax, abs(Jnew - J(i)))
+        jmax = max(jmax, abs(Jnew))
+        J(i) = Jnew
+      enddo
+      if(dmax <= 1.0d-12*jmax) exit
+    enddo
+    deallocate(J)
+  end subroutine heat_viewfactor_radiosity
+
+  !-----------------------------------------------------------------------------
+
+  function facet_area(nc, x) result(a)
+    integer(kind=kint), intent(in) :: nc
+    real(kind=kreal), intent(in)   :: x(3,4)
+    real(kind=kreal) :: a
+    a = 0.5d0*norm2(cross(x(:,2)-x(:,1), x(:,3)-x(:,1)))
+    if(nc == 4) a = a + 0.5d0*norm2(cross(x(:,3)-x(:,1), x(:,4)-x(:,1)))
+  end function facet_area
+
+  function cross(a, b) result(c)
+    real(kind=kreal), intent(in) :: a(3), b(3)
+    real(kind=kreal) :: c(3)
+    c(1) = a(2)*b(3) - a(3)*b(2)
+    c(2) = a(3)*b(1) - a(1)*b(3)
+    c(3) = a(1)*b(2) - a(2)*b(1)
+  end function cross
+
+  !> radical inverse of i in the given prime base
+  function halton(i, base) result(h)
+    integer(kind=kint), intent(in) :: i, base
+    real(kind=kreal) :: h, f
+    integer(kind=kint) :: k
+    h = 0.0d0
+    f = 1.0d0/base
+    k = i
+    do while(k > 0)
+      h = h + f*mod(k, base)
+      k = k/base
+      f = f/base
+    enddo
+  end function halton
+
+  !> split facets into triangles and build the hierarchy top-down,
+  !! dividing each node at the middle of its longest centroid extent
+  subroutine scene_build(s, m, member, nc, xyz)
+    type(tVFScene), intent(inout) :: s
+    integer(kind=kint), intent(in) :: m, member(m), nc(:)
+    real(kind=kreal), intent(in)   :: xyz(:,:,:)
+    real(kind=kreal), allocatable :: cen(:,:)
+    integer(kind=kint) :: stack(BVH_STACK)
+    integer(kind=kint) :: i, f, t, nd, sp, is, ie, ia, ib, ax, tmp
+    real(kind=kreal) :: cmin(3), cmax(3), mid
+
+    s%n_tri = 0
+    do i = 1, m
+      s%n_tri = s%n_tri + nc(member(i)) - 2
+    enddo
+    allocate(s%v0(3,s%n_tri), s%e1(3,s%n_tri), s%e2(3,s%n_tri), s%nrm(3,s%n_tri))
+    allocate(s%facet(s%n_tri), s%tri(s%n_tri), cen(3,s%n_tri))
+    t = 0
+    do i = 1, m
+      f = member(i)
+      do ia = 3, nc(f)
+        t = t + 1
+        s%v0(:,t) = xyz(:,1,f)
+        s%e1(:,t) = xyz(:,ia-1,f) - xyz(:,1,f)
+        s%e2(:,t) = xyz(:,ia,f) - xyz(:,1,f)
+        s%nrm(:,t) = cross(s%e1(:,t), s%e2(:,t))
+        s%facet(t) = f
+        s%tri(t) = t
+        cen(:,t) = s%v0(:,t) + (s%e1(:,t) + s%e2(:,t))/3.0d0
+      enddo
+    enddo
+
+    allocate(s%bmin(3,2*s%n_tri), s%bmax(3,2*s%n_tri))
+    allocate(s%child(2*s%n_tri), s%first(2*s%n_tri), s%last(2*s%n_tri))
+    s%n_node = 1
+    s%first(1) = 1
+    s%last(1) = s%n_tri
+    sp = 1
+    stack(1) = 1
+    do while(sp > 0)
+      nd = stack(sp)
+      sp = sp - 1
+      is = s%first(nd)
+      ie = s%last(nd)
+      s%bmin(:,nd) =  huge(1.0d0)
+      s%bmax(:,nd) = -huge(1.0d0)
+      cmin(:) =  huge(1.0d0)
+      cmax(:) = -huge(1.0d0)
+      do i = is, ie
+        t = s%tri(i)
+        s%bmin(:,nd) = min(s%bmin(:,nd), s%v0(:,t), s%v0(:,t)+s%e1(:,t), s%v0(:,t)+s%e2(:,t))
+        s%bmax(:,nd) = max(s%bmax(:,nd), s%v0(:,t), s%v0(:,t)+s%e1(:,t), s%v0(:,t)+s%e2(:,t))
+        cmin(:) = min(cmin(:), cen(:,t))
+        cmax(:) = max(cmax(:), cen(:,t))
+      enddo
+      s%child(nd) = 0
+      if(ie - is + 1 <= BVH_LEAF) cycle
+
+      ax = maxloc(cmax - cmin, 1)
+      mid = 0.5d0*(cmin(ax) + cmax(ax))
+      ia = is
+      ib = ie
+      do while(ia <= ib)
+        if(cen(ax,s%tri(ia)) < mid)then
+          ia = ia + 1
+        else
+          tmp = s%tri(ia)
+          s%tri(ia) = s%tri(ib)
+          s%tri(ib) = tmp
+          ib = ib - 1
+        endif
+      enddo
+      if(ia == is .or. ia > ie) ia = (is + ie + 1)/2
+
+      s%child(nd) = s%n_node + 1
+      s%first(s%n_node+1) = is
+      s%last (s%n_node+1) = ia - 1
+      s%first(s%n_node+2) = ia
+      s%last (s%n_node+2) = ie
+      s%n_node = s%n_node + 2
+      if(sp + 2 > BVH_STACK) stop 'heat_viewfactor: BVH stack overflow'
+      stack(sp+1) = s%n_node - 1
+      stack(sp+2) = s%n_node
+      sp = sp + 2
+    enddo
+    deallocate(cen)
+  end subroutine scene_build
+
+  subroutine scene_free(s)
+    type(tVFScene), intent(inout) :: s
+    deallocate(s%v0, s%e1, s%e2, s%nrm, s%facet, s%tri)
+    deallocate(s%bmin, s%bmax, s%child, s%first, s%last)
+  end subroutine scene_free
+
+  !> nearest facet hit by the ray o + t*d (0 if none or hit from behind)
+  function trace(s, o, d, self) result(hit)
+    type(tVFScene), intent(in) :: s
+    real(kind=kreal), intent(in) :: o(3), d(3)
+    integer(kind=kint), intent(in) :: self
+    integer(kind=kint) :: hit
+    integer(kind=kint) :: stack(BVH_STACK), sp, nd, i, t, c
+    real(kind=kreal) :: inv(3), t0(3), t1(3), tnear, tfar, tbest
+    real(kind=kreal) :: p(3), q(3), r(3), det, u, v, tt
+    logical :: front
+
+    hit = 0
+    front = .false.
+    tbest = huge(1.0d0)
+    do i = 1, 3
+      if(d(i) /= 0.0d0)then
+        inv(i) = 1.0d0/d(i)
+      else
+        inv(i) = huge(1.0d0)
+      endif
+    enddo
+
+    sp = 1
+    stack(1) = 1
+    do while(sp > 0)
+      nd = stack(sp)
+      sp = sp - 1
+      t0 = (s%bmin(:,nd) - o)*inv
+      t1 = (s%bmax(:,nd) - o)*inv
+      tnear = maxval(min(t0, t1))
+      tfar  = minval(max(t0, t1))
+      if(tfar < max(tnear, 0.0d0) .or. tnear > tbest) cycle
+
+      c = s%child(nd)
+      if(c > 0)then
+        stack(sp+1) = c
+        stack(sp+2) = c + 1
+        sp = sp + 2
+        cycle
+      endif
+
+      do i = s%first(nd), s%last(nd)
+        t = s%tri(i)
+        if(s%facet(t) == self) cycle
+        p = cross(d, s%e2(:,t))
+        det = dot_product(s%e1(:,t), p)
+        if(abs(det) < tiny(1.0d0)) cycle
+        r = o - s%v0(:,t)
+        u = dot_product(r, p)/det
+        if(u < 0.0d0 .or. u > 1.0d0) cycle
+        q = cross(r, s%e1(:,t))
+        v = dot_product(d, q)/det
+        if(v < 0.0d0 .or. u + v > 1.0d0) cycle
+        tt = dot_product(s%e2(:,t), q)/det
+        if(tt <= 0.0d0 .or. tt >= tbest) cycle
+        tbest = tt
+        hit = s%facet(t)
+        front = (dot_product(d, s%nrm(:,t)) < 0.0d0)
+      enddo
+    enddo
+    if(.not. front) hit = 0
+  end function trace
+
+  subroutine cast_rays(s, n, m, member, nc, xyz, nrays, row)
+    type(tVFScene), intent(in) :: s
+    integer(kind=kint), intent(in) :: n, m, member(m), nc(n), nrays
+    real(kind=kreal), intent(in)   :: xyz(3,4,n)
+    type(tVFRow), intent(inout)    :: row(n)
+    integer(kind=kint), allocatable :: cnt(:), touched(:)
+    integer(kind=kint) :: i, f, k, nt, j, seq
+    real(kind=kreal) :: a1, a2, u1, u2, u3, u4, r, phi, sq
+    real(kind=kreal) :: nrm(3), t1(3), t2(3), o(3), d(3), x0(3), xb(3), xc(3), h
+
+    !$omp parallel default(none), &
+      !$omp&  private(i,f,k,nt,j,seq,a1,a2,u1,u2,u3,u4,r,phi,sq,nrm,t1,t2,o,d,x0,xb,xc,h,cnt,touched), &
+      !$omp&  shared(s,n,m,member,nc,xyz,nrays,row)
+    allocate(cnt(n), touched(n))
+    cnt(:) = 0
+    !$omp do schedule(dynamic)
+    do i = 1, m
+      f = member(i)
+      a1 = 0.5d0*norm2(cross(xyz(:,2,f)-xyz(:,1,f), xyz(:,3,f)-xyz(:,1,f)))
+      a2 = 0.0d0
+      if(nc(f) == 4) a2 = 0.5d0*norm2(cross(xyz(:,3,f)-xyz(:,1,f), xyz(:,4,f)-xyz(:,1,f)))
+      nrm = cross(xyz(:,2,f)-xyz(:,1,f), xyz(:,3,f)-xyz(:,1,f))
+      if(nc(f) == 4) nrm = nrm + cross(xyz(:,3,f)-xyz(:,1,f), xyz(:,4,f)-xyz(:,1,f))
+      nrm = nrm/norm2(nrm)
+      t1 = xyz(:,2,f) - xyz(:,1,f)
+      t1 = t1 - dot_product(t1, nrm)*nrm
+      t1 = t1/norm2(t1)
+      t2 = cross(nrm, t1)
+      h = 1.0d-9*sqrt(a1 + a2)
+
+      nt = 0
+      do k = 1, nrays
+        seq = (f-1)*nrays + k
+        u1 = halton(seq, 2)
+        u2 = halton(seq, 3)
+        u3 = halton(seq, 5)
+        u4 = halton(seq, 7)
+
+        x0 = xyz(:,1,f)
+        xb = xyz(:,2,f)
+        xc = xyz(:,3,f)
+        if(u1*(a1 + a2) >= a1)then
+          u1 = (u1*(a1 + a2) - a1)/a2
+          xb = xyz(:,3,f)
+          xc = xyz(:,4,f)
+        else
+          u1 = u1*(a1 + a2)/a1
+        endif
+        sq = sqrt(u1)
+        o = (1.0d0 - sq)*x0 + sq*(1.0d0 - u2)*xb + sq*u2*xc + h*nrm
+
+        r = sqrt(u3)
+        phi = 2.0d0*PI*u4
+        d = r*cos(phi)*t1 + r*sin(phi)*t2 + sqrt(max(0.0d0, 1.0d0 - u3))*nrm
+
+        j = trace(s, o, d, f)
+        if(j == 0) cycle
+        if(cnt(j) == 0)then
+          nt = nt + 1
+          touched(nt) = j
+        endif
+        cnt(j) = cnt(j) + 1
+      enddo
+
+      row(f)%n = nt
+      allocate(row(f)%item(nt), row(f)%val(nt))
+      do k = 1, nt
+        j = touched(k)
+        row(f)%item(k) = j
+        row(f)%val(k) = dble(cnt(j))/dble(nrays)
+        cnt(j) = 0
+      enddo
+    enddo
+    !$omp end do
+    deallocate(cnt, touched)
+    !$omp end parallel
+  end subroutine cast_rays
+
+  !> average the estimates of area(i)*F(i,j) and area(j)*F(j,i) and store
+  !! the result in CRS format, rescaling rows whose sum exceeds one
+  subroutine make_reciprocal(n, area, row, index, item, val)
+    integer(kind=kint), intent(in) :: n
+    real(kind=kreal), intent(in)   :: area(n)
+    type(tVFRow), intent(inout)    :: row(n)
+    integer(kind=kint), pointer    :: index(:), item(:)
+    real(kind=kreal), pointer      :: val(:)
+    integer(kind=kint), allocatable :: tindex(:), titem(:), pos(:), touched(:)
+    real(kind=kreal), allocatable :: tval(:), work(:)
+    integer(kind=kint) :: i, j, k, nnz, nt
+    real(kind=kreal) :: rsum
+
+    ! transpose
+    allocate(tindex(0:n), pos(n))
+    tindex(:) = 0
+    do i = 1, n
+      do k = 1, row(i)%n
+        j = row(i)%item(k)
+        tindex(j) = tindex(j) + 1
+      enddo
+    enddo
+    do i = 1, n
+      tindex(i) = tindex(i) + tindex(i-1)
+    enddo
+    allocate(titem(tindex(n)), tval(tindex(n)))
+    pos(:) = tindex(0:n-1)
+    do i = 1, n
+      do k = 1, row(i)%n
+        j = row(i)%item(k)
+        pos(j) = pos(j) + 1
+        titem(pos(j)) = i
+        tval(pos(j)) = area(i)*row(i)%val(k)
+      enddo
+    enddo
+
+    ! merge row i of area*F and of its transpose
+    allocate(work(n), touched(n))
+    work(:) = 0.0d0
+    allocate(index(0:n))
+    index(0) = 0
+    do i = 1, n
+      nt = row(i)%n
+      do k = 1, row(i)%n
+        work(row(i)%item(k)) = area(i)*row(i)%val(k)
+      enddo
+      do k = tindex(i-1)+1, tindex(i)
+        j = titem(k)
+        if(work(j) == 0.0d0)then
+          nt = nt + 1
+        endif
+        work(j) = work(j) + tval(k)
+      enddo
+      index(i) = index(i-1) + nt
+      do k = 1, row(i)%n
+        work(row(i)%item(k)) = 0.0d0
+      enddo
+      do k = tindex(i-1)+1, tindex(i)
+        work(titem(k)) = 0.0d0
+      enddo
+    enddo
+
+    nnz = index(n)
+    allocate(item(nnz), val(nnz))
+    do i = 1, n
+      nt = 0
+      do k = 1, row(i)%n
+        j = row(i)%item(k)
+        work(j) = area(i)*row(i)%val(k)
+        nt = nt + 1
+        touched(nt) = j
+      enddo
+      do k = tindex(i-1)+1, tindex(i)
+        j = titem(k)
+        if(work(j) == 0.0d0)then
+          nt = nt + 1
+          touched(nt) = j
+        endif
+        work(j) = work(j) + tval(k)
+      enddo
+      rsum = 0.0d0
+      do k = 1, nt
+        j = touched(k)
+        item(index(i-1)+k) = j
+        val(index(i-1)+k) = 0.5d0*work(j)/area(i)
+        rsum = rsum + val(index(i-1)+k)
+        work(j) = 0.0d0
+      enddo
+      if(rsum > 1.0d0) val(index(i-1)+1:index(i)) = val(index(i-1)+1:index(i))/rsum
+      if(allocated(row(i)%item)) deallocate(row(i)%item, row(i)%val)
+    enddo
+
+    deallocate(tindex, titem, tval, pos, work, touched)
+  end subroutine make_reciprocal
+
+end module m_heat_LIB_VIEWFACTOR
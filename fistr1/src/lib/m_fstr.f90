@@ -41,6 +41,7 @@ module m_fstr
   !integer(kind=kint), parameter :: kstNLSTATIC  =   5
   integer(kind=kint), parameter :: kstSTATICEIGEN = 6
   integer(kind=kint), parameter :: kstNZPROF      = 7
+  integer(kind=kint), parameter :: kstEIGENFREQ   = 8
 
   !> solver method (sm)    !CAUTION : (<=100):indirect, (>100):direct
   integer(kind=kint), parameter :: ksmCG       = 1
@@ -100,6 +101,7 @@ module m_fstr
   integer(kind=kint), parameter :: IDBG = 52 ! debug
   integer(kind=kint), parameter :: IFVS = 53 ! visual.ini file
   integer(kind=kint), parameter :: INEU = 54 ! neutral file (heat)
+  integer(kind=kint), parameter :: IVFC = 55 ! view factor cache (heat)
   integer(kind=kint), parameter :: IRESOUT = 100 ! ~110, keeping for result output file
 
   !> SOLVER CONTROL
@@ -360,6 +362,7 @@ module m_fstr
     integer(kind=kint), pointer :: is_rot(:) => null()
     integer(kind=kint) :: elemopt361
     logical            :: is_smoothing_active
+    real(kind=kreal)   :: geomcache_budget   !< memory budget of geometric cache in MB (0: disabled)
     real(kind=kreal)   :: FACTOR     (2)   !< factor of incrementation
     !< 1:time t  2: time t+dt
     !> for increment control
@@ -379,6 +382,7 @@ module m_fstr
     real(kind=kreal), pointer :: last_temp(:)  => null()
 
     type( tElement ), pointer :: elements(:)   =>null()  !< elements information
+    type( tGaussStore ), pointer :: gauss_stores(:) =>null() !< quadrature points, per element type and material
     type( tMaterial ),pointer :: materials(:)  =>null()  !< material properties
     type( tContact ), pointer :: contacts(:)   =>null()  !< contact information
     integer                   :: n_fix_mpc               !< number mpc conditions user defined
@@ -396,6 +400,7 @@ module m_fstr
     real(kind=kreal), pointer :: QFORCE_bkup(:)    => null() !< equivalent nodal force (backup)
     real(kind=kreal), pointer :: last_temp_bkup(:) => null()
     type( tElement ), pointer :: elements_bkup(:)  =>null()  !< elements information (backup)
+    type( tGaussStore ), pointer :: gauss_stores_bkup(:) =>null() !< quadrature points (backup)
     type( tContact ), pointer :: contacts_bkup(:)  =>null()  !< contact information (backup)
   end type fstr_solid
 
@@ -412,6 +417,7 @@ module m_fstr
     real(kind=kreal), pointer :: STEP_DLTIME(:), STEP_EETIME(:)
     real(kind=kreal), pointer :: STEP_DELMIN(:), STEP_DELMAX(:)
     integer(kind=kint) :: timepoint_id
+    real(kind=kreal)   :: ERRTOL        !< tolerance of the local truncation error (0: not controlled)
 
     !> MATERIAL
     integer(kind=kint) :: MATERIALtot
@@ -466,6 +472,17 @@ module m_fstr
     integer(kind=kint), pointer :: R_SUF_ampl(:,:)
     integer(kind=kint), pointer :: R_SUF_surf(:)
     real(kind=kreal), pointer :: R_SUF_val(:,:)
+    integer(kind=kint), pointer :: R_SUF_cavity(:) => null() !< cavity ID (0: radiation to SINK only)
+    integer(kind=kint), pointer :: R_SUF_vf(:) => null()     !< row of the facet in the view factor matrix
+
+    !> VIEW FACTOR of cavity facets (surface to surface radiation)
+    integer(kind=kint) :: VF_n                               !< number of cavity facets
+    integer(kind=kint) :: VF_rays                            !< rays per facet
+    real(kind=kreal)   :: VF_sigma                           !< Stefan-Boltzmann constant
+    integer(kind=kint), pointer :: VF_index(:) => null()
+    integer(kind=kint), pointer :: VF_item(:)  => null()
+    real(kind=kreal), pointer :: VF_val(:)  => null()
+    real(kind=kreal), pointer :: VF_sink(:) => null()        !< effective sink temperature of each facet
 
     !> FILM, SFILM
     integer(kind=kint) :: H_SUF_tot
@@ -476,6 +493,15 @@ module m_fstr
 
     integer(kind=kint)  :: WL_tot
     type(tWeldLine), pointer :: weldline(:) => null()
+
+    !> LINEAR PROBLEM (constant material, no radiation)
+    logical :: is_linear
+    real(kind=kreal)   :: LIN_dtime                  !< time increment of the last factorized matrix
+    real(kind=kreal), pointer :: LIN_KD(:)  => null() !< conductivity matrix (diagonal)
+    real(kind=kreal), pointer :: LIN_KAU(:) => null() !< conductivity matrix (upper)
+    real(kind=kreal), pointer :: LIN_KAL(:) => null() !< conductivity matrix (lower)
+    real(kind=kreal), pointer :: LIN_CAP(:) => null() !< lumped heat capacity
+    real(kind=kreal), pointer :: LIN_BC(:)  => null() !< FILM/FIXT state of the last factorized matrix
   end type fstr_heat
 
   !> Data for DYNAMIC ANSLYSIS  (fstrDYNAMIC)
@@ -557,6 +583,9 @@ module m_fstr
     character(len=HECMW_FILENAME_LEN) :: eigenlog_filename
     integer(kind=kint)                :: start_mode
     integer(kind=kint)                :: end_mode
+    integer(kind=kint)                :: n_refine !< sampling points per half-power bandwidth (0: uniform)
+    integer(kind=kint)                :: n_batch  !< frequencies expanded together
+    character(len=HECMW_FILENAME_LEN) :: basis_filename !< binary modal basis (eigenvalues, modes, mass)
   end type fstr_freqanalysis
 
   type fstr_freqanalysis_data
@@ -749,10 +778,23 @@ contains
     nullify( H%R_SUF_ampl )
     nullify( H%R_SUF_surf )
     nullify( H%R_SUF_val )
+    nullify( H%R_SUF_cavity )
+    nullify( H%R_SUF_vf )
+    nullify( H%VF_index )
+    nullify( H%VF_item )
+    nullify( H%VF_val )
+    nullify( H%VF_sink )
     nullify( H%H_SUF_elem )
     nullify( H%H_SUF_ampl )
     nullify( H%H_SUF_surf )
     nullify( H%H_SUF_val )
+    nullify( H%LIN_KD )
+    nullify( H%LIN_KAU )
+    nullify( H%LIN_KAL )
+    nullify( H%LIN_CAP )
+    nullify( H%LIN_BC )
+    H%is_linear = .false.
+    H%LIN_dtime = -1.0d0
   end subroutine fstr_nullify_fstr_heat
 
   subroutine fstr_nullify_fstr_dynamic( DY )
@@ -772,6 +814,11 @@ contains
     type( fstr_freqanalysis ), intent(inout) :: f
 
     f%FLOAD_ngrp_tot = 0
+    f%n_refine = 0
+    f%n_batch  = 64
+    f%start_mode = 1
+    f%end_mode   = 0
+    f%basis_filename = ''
     nullify( f%FLOAD_ngrp_GRPID )
     nullify( f%FLOAD_ngrp_ID )
     nullify( f%FLOAD_ngrp_TYPE )
@@ -25,7 +25,7 @@ contains
     D(:,:)=0.d0
 
     ina(1) = temp
-    call fetch_TableData( MC_ISOELASTIC, matl%dict, outa, ierr, ina )
+    call fetch_MatTableData( MT_ISOELASTIC, matl, outa, ierr, ina )
     if( ierr ) then
       ee = matl%variables(M_YOUNGS)
       pp = matl%variables(M_POISSON)
@@ -118,7 +118,7 @@ contains
     logical :: ierr
 
     ina(1) = temp
-    call fetch_TableData( MC_ORTHOELASTIC, matl%dict, outa, ierr, ina )
+    call fetch_MatTableData( MT_ORTHOELASTIC, matl, outa, ierr, ina )
     if( ierr ) then
       stop "Fails in fetching orthotropic elastic constants!"
     endif
@@ -191,7 +191,7 @@ contains
 
     !--------------------------------------------------------------------
 
-    call fetch_TableData(MC_ISOELASTIC, matl%dict, outa, ierr)
+    call fetch_MatTableData( MT_ISOELASTIC, matl, outa, ierr)
 
     !--------------------------------------------------------------------
 
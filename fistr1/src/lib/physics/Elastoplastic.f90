@@ -214,7 +214,7 @@ contains
         calHardenCoeff = matl%variables(M_PLCONST2)
       case (1)  ! Multilinear approximation
         ina(1) = temp;  ina(2)=pstrain
-        call fetch_TableGrad( MC_YIELD, ina, matl%dict, calHardenCoeff, ierr )
+        call fetch_MatTableGrad( MT_YIELD, ina, matl, calHardenCoeff, ierr )
       case (2)  ! Swift
         s0= matl%variables(M_PLCONST1)
         s1= matl%variables(M_PLCONST2)
@@ -280,7 +280,7 @@ contains
         calCurrYield = matl%variables(M_PLCONST1)+matl%variables(M_PLCONST2)*pstrain
       case (1)  ! Multilinear approximation
         ina(1) = temp;  ina(2)=pstrain
-        call fetch_TableData(MC_YIELD, matl%dict, outa, ierr, ina)
+        call fetch_MatTableData( MT_YIELD, matl, outa, ierr, ina)
         if( ierr ) stop "Fail to get yield stress!"
         calCurrYield = outa(1)
       case (2)  ! Swift
@@ -417,7 +417,7 @@ contains
     yd = cal_equivalent_stress(matl, stress, fstat)
 
     ina(1) = temp
-    call fetch_TableData(MC_ISOELASTIC, matl%dict, ee, ierr, ina)
+    call fetch_MatTableData( MT_ISOELASTIC, matl, ee, ierr, ina)
     if( ierr ) then
       stop " fail to fetch young's modulus in elastoplastic calculation"
     else
@@ -108,7 +108,7 @@ contains
     ddt = dt
 
     ina(1) = temp
-    call fetch_TableData( MC_ISOELASTIC, matl%dict, outa, ierr, ina )
+    call fetch_MatTableData( MT_ISOELASTIC, matl, outa, ierr, ina )
     if( ierr ) then
       EE = matl%variables(M_YOUNGS)
       PP = matl%variables(M_POISSON)
@@ -191,7 +191,7 @@ contains
     ddt = dt
 
     ina(1) = temp
-    call fetch_TableData( MC_ISOELASTIC, matl%dict, outa, ierr, ina )
+    call fetch_MatTableData( MT_ISOELASTIC, matl, outa, ierr, ina )
     if( ierr ) then
       EE = matl%variables(M_YOUNGS)
       PP = matl%variables(M_POISSON)
@@ -270,7 +270,7 @@ contains
 
     integer :: i, n, nrow
     real(kind=kreal) :: thetan, vstrain(6)
-    nrow = fetch_TableRow( MC_VISCOELASTIC, gauss%pMaterial%dict )
+    nrow = fetch_MatTableRow( MT_VISCOELASTIC, gauss%pMaterial )
     do n = 1,nrow
       do i = 1,6
         gauss%fstatus((n-1)*12+i) = gauss%fstatus((n-1)*12+i+6)
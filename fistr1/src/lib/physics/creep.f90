@@ -52,7 +52,7 @@ contains
     !     elastic constants
     !
     ina(1) = temp
-    call fetch_TableData( MC_ISOELASTIC, matl%dict, outa(1:2), ierr, ina )
+    call fetch_MatTableData( MT_ISOELASTIC, matl, outa(1:2), ierr, ina )
 
     if( ierr ) then
       stop "error in isotropic elasticity definition"
@@ -64,7 +64,7 @@ contains
     !      Norton
     if( matl%mtype==NORTON ) then         ! those with no yield surface
       ina(1) = temp
-      call fetch_TableData( MC_NORTON, matl%dict, outa, ierr, ina )
+      call fetch_MatTableData( MT_NORTON, matl, outa, ierr, ina )
       xxn=outa(2)
       aa=outa(1)*((ttime+dtime)**(outa(3)+1.d0)-ttime**(outa(3)+1.d0))/(outa(3)+1.d0)
     endif
@@ -149,7 +149,7 @@ contains
     !     elastic constants
     !
     ina(1) = temp
-    call fetch_TableData( MC_ISOELASTIC, matl%dict, outa(1:2), ierr, ina )
+    call fetch_MatTableData( MT_ISOELASTIC, matl, outa(1:2), ierr, ina )
     if( ierr ) then
       stop "error in isotropic elasticity definition"
     else
@@ -160,7 +160,7 @@ contains
     !      Norton
     if( matl%mtype==NORTON ) then         ! those with no yield surface
       ina(1) = temp
-      call fetch_TableData( MC_NORTON, matl%dict, outa, ierr, ina )
+      call fetch_MatTableData( MT_NORTON, matl, outa, ierr, ina )
       if( ierr ) then
         stop "error in isotropic elasticity definition"
       else
@@ -125,6 +125,22 @@ module mMaterial
   character(len=DICT_KEY_LENGTH) :: MC_NORTON = 'NORTON'             ! NOrton's creep law
   character(len=DICT_KEY_LENGTH) :: MC_INCOMP_NEWTONIAN = 'INCOMP_FLUID' ! viscocity
 
+  ! Position of the dictionary tables above in tMaterial%tables
+  integer(kind=kint), parameter :: MT_ISOELASTIC       = 1
+  integer(kind=kint), parameter :: MT_ORTHOELASTIC     = 2
+  integer(kind=kint), parameter :: MT_YIELD            = 3
+  integer(kind=kint), parameter :: MT_THEMOEXP         = 4
+  integer(kind=kint), parameter :: MT_ORTHOEXP         = 5
+  integer(kind=kint), parameter :: MT_VISCOELASTIC     = 6
+  integer(kind=kint), parameter :: MT_NORTON           = 7
+  integer(kind=kint), parameter :: MT_INCOMP_NEWTONIAN = 8
+  integer(kind=kint), parameter :: N_MATTABLE          = 8
+
+  !> Reference to one table of the material dictionary
+  type tTableRef
+    type(tTable), pointer      :: p => null()
+  end type tTableRef
+
   type tshellmat
     integer(kind=kint)         :: ortho
     real(kind=kreal)           :: ee
@@ -153,6 +169,8 @@ module mMaterial
     integer(kind=kint)         :: n_table           !< size of table
     real(kind=kreal), pointer  :: table(:)=>null()  !< material properties in tables
     type(DICT_STRUCT), pointer :: dict              !< material properties in dictionaried linked list
+    logical                    :: is_compiled       !< tables resolved by compileMaterial
+    type(tTableRef)            :: tables(N_MATTABLE) !< tables of dict, null if not defined
   end type tMaterial
 
   type(tMaterial), allocatable :: materials(:)
@@ -167,10 +185,86 @@ contains
     material%nlgeom_flag = INFINITESIMAL ! Default: INFINITESIMAL ANALYSIS
     material%variables =  0.d0           ! not defined yet
     material%totallyr =  0               ! not defined yet
+    material%is_compiled = .false.
 
     call dict_create( material%dict, 'INIT', DICT_NULL )
   end subroutine
 
+  !> Resolve the dictionary tables of a material once input is complete, so that
+  !! constitutive routines reach them without key lookup
+  subroutine compileMaterial( material )
+    type( tMaterial ), intent(inout) :: material
+    material%tables(MT_ISOELASTIC)%p       => dict_get_key( material%dict, MC_ISOELASTIC )
+    material%tables(MT_ORTHOELASTIC)%p     => dict_get_key( material%dict, MC_ORTHOELASTIC )
+    material%tables(MT_YIELD)%p            => dict_get_key( material%dict, MC_YIELD )
+    material%tables(MT_THEMOEXP)%p         => dict_get_key( material%dict, MC_THEMOEXP )
+    material%tables(MT_ORTHOEXP)%p         => dict_get_key( material%dict, MC_ORTHOEXP )
+    material%tables(MT_VISCOELASTIC)%p     => dict_get_key( material%dict, MC_VISCOELASTIC )
+    material%tables(MT_NORTON)%p           => dict_get_key( material%dict, MC_NORTON )
+    material%tables(MT_INCOMP_NEWTONIAN)%p => dict_get_key( material%dict, MC_INCOMP_NEWTONIAN )
+    material%is_compiled = .true.
+  end subroutine compileMaterial
+
+  !> Table itab of a material, looked up in the dictionary if not compiled yet
+  function getMaterialTable( itab, material ) result( table )
+    integer(kind=kint), intent(in)        :: itab      !< MT_XXX
+    type( tMaterial ), intent(in)         :: material
+    type(tTable), pointer                 :: table
+
+    if( material%is_compiled ) then
+      table => material%tables(itab)%p
+      return
+    endif
+    select case( itab )
+      case( MT_ISOELASTIC );       table => dict_get_key( material%dict, MC_ISOELASTIC )
+      case( MT_ORTHOELASTIC );     table => dict_get_key( material%dict, MC_ORTHOELASTIC )
+      case( MT_YIELD );            table => dict_get_key( material%dict, MC_YIELD )
+      case( MT_THEMOEXP );         table => dict_get_key( material%dict, MC_THEMOEXP )
+      case( MT_ORTHOEXP );         table => dict_get_key( material%dict, MC_ORTHOEXP )
+      case( MT_VISCOELASTIC );     table => dict_get_key( material%dict, MC_VISCOELASTIC )
+      case( MT_NORTON );           table => dict_get_key( material%dict, MC_NORTON )
+      case( MT_INCOMP_NEWTONIAN ); table => dict_get_key( material%dict, MC_INCOMP_NEWTONIAN )
+      case default;                table => null()
+    end select
+  end function getMaterialTable
+
+  !> Interpolate table itab of a material, the counterpart of fetch_TableData
+  subroutine fetch_MatTableData( itab, material, outa, ierr, a )
+    integer(kind=kint), intent(in)         :: itab      !< MT_XXX
+    type( tMaterial ), intent(in)          :: material
+    real(kind=kreal), intent(out)          :: outa(:)   !< output data
+    logical, intent(out)                   :: ierr      !< .true. if not defined
+    real(kind=kreal), intent(in), optional :: a(:)      !< dependent variables
+    type(tTable), pointer :: table
+
+    table => getMaterialTable( itab, material )
+    call get_TableData( table, outa, ierr, a )
+  end subroutine fetch_MatTableData
+
+  !> Gradient of table itab of a material, the counterpart of fetch_TableGrad
+  subroutine fetch_MatTableGrad( itab, a, material, outa, ierr )
+    integer(kind=kint), intent(in) :: itab      !< MT_XXX
+    real(kind=kreal), intent(in)   :: a(:)      !< dependent variables
+    type( tMaterial ), intent(in)  :: material
+    real(kind=kreal), intent(out)  :: outa      !< gradient
+    logical, intent(out)           :: ierr      !< .true. if not defined
+    type(tTable), pointer :: table
+
+    table => getMaterialTable( itab, material )
+    call get_TableGrad( table, a, outa, ierr )
+  end subroutine fetch_MatTableGrad
+
+  !> Number of rows of table itab of a material, -1 if not defined
+  integer function fetch_MatTableRow( itab, material )
+    integer(kind=kint), intent(in) :: itab      !< MT_XXX
+    type( tMaterial ), intent(in)  :: material
+    type(tTable), pointer :: table
+
+    table => getMaterialTable( itab, material )
+    fetch_MatTableRow = -1
+    if( associated(table) ) fetch_MatTableRow = table%tbrow
+  end function fetch_MatTableRow
+
   !> Finalizer
   subroutine finalizeMaterial( material )
     type( tMaterial ), intent(inout) :: material
@@ -32,6 +32,22 @@ module mMechGauss
     real(kind=kreal), pointer   :: equiForces(:) => null()  !< equivalent forces
     type(tGaussStatus), pointer :: gausses(:) => null()  !< info of qudrature points
     real(kind=kreal), pointer   :: aux(:,:) => null()    !< nodeless dof for incompatible element
+    real(kind=kreal), pointer   :: gderiv(:,:,:) => null() !< cached global shape derivatives (nn,ndim,ngauss)
+    real(kind=kreal), pointer   :: wdet(:) => null()     !< cached weight*det(J) of quadrature points
+  end type
+
+  ! ----------------------------------------------------------------------------
+  !> Contiguous store of quadrature points sharing one element type and material.
+  !! Status variables of all points live in two flat arrays; gausses(k)%istatus
+  !! and gausses(k)%fstatus are views of their k-th columns, and every element
+  !! refers to a slice of gausses(:).
+  type tGaussStore
+    integer                     :: ngauss   = 0            !< number of quadrature points
+    integer                     :: nistatus = 0            !< integer status variables per point
+    integer                     :: nfstatus = 0            !< real status variables per point
+    type(tGaussStatus), pointer :: gausses(:) => null()    !< quadrature points
+    integer, pointer            :: istatus(:,:) => null()  !< integer status variables (nistatus,ngauss)
+    real(kind=kreal), pointer   :: fstatus(:,:) => null()  !< real status variables (nfstatus,ngauss)
   end type
 
 contains
@@ -39,40 +55,59 @@ contains
   !> Initializer
   subroutine fstr_init_gauss( gauss )
     type( tGaussStatus ), intent(inout) :: gauss
-    integer :: n
+    integer :: nistatus, nfstatus
+
+    call fstr_clear_gauss( gauss )
+    call fstr_gauss_status_size( gauss%pMaterial, nistatus, nfstatus )
+    if( nistatus > 0 ) then
+      allocate( gauss%istatus(nistatus) )
+      gauss%istatus = 0
+    endif
+    if( nfstatus > 0 ) then
+      allocate( gauss%fstatus(nfstatus) )
+      gauss%fstatus = 0.d0
+    endif
+  end subroutine fstr_init_gauss
+
+  !> Zero clear of the state variables stored inline
+  subroutine fstr_clear_gauss( gauss )
+    type( tGaussStatus ), intent(inout) :: gauss
     gauss%strain=0.d0; gauss%stress=0.d0
     gauss%strain_bak=0.d0; gauss%stress_bak=0.d0
     gauss%strain_out=0.d0; gauss%stress_out=0.d0
     gauss%plstrain =0.d0
     gauss%nqm =0.d0
-    if( gauss%pMaterial%mtype==USERMATERIAL ) then
-      if( gauss%pMaterial%nfstatus> 0 ) then
-        allocate( gauss%fstatus(gauss%pMaterial%nfstatus) )
-        gauss%fstatus(:) = 0.d0
-      endif
-    else if( isElastoplastic(gauss%pMaterial%mtype) ) then
-      allocate( gauss%istatus(1) )    ! 0:elastic 1:plastic
-      if( isKinematicHarden( gauss%pMaterial%mtype ) ) then
-        allocate( gauss%fstatus(7+6) )  ! plastic strain, back stress
+  end subroutine fstr_clear_gauss
+
+  !> Number of status variables needed by a material
+  subroutine fstr_gauss_status_size( pMaterial, nistatus, nfstatus )
+    type(tMaterial), intent(in) :: pMaterial
+    integer, intent(out)        :: nistatus   !< number of integer status variables
+    integer, intent(out)        :: nfstatus   !< number of real status variables
+    integer :: n
+
+    nistatus = 0
+    nfstatus = 0
+    if( pMaterial%mtype==USERMATERIAL ) then
+      if( pMaterial%nfstatus> 0 ) nfstatus = pMaterial%nfstatus
+    else if( isElastoplastic(pMaterial%mtype) ) then
+      nistatus = 1                    ! 0:elastic 1:plastic
+      if( isKinematicHarden( pMaterial%mtype ) ) then
+        nfstatus = 7+6                ! plastic strain, back stress
       else
-        allocate( gauss%fstatus(2) )    ! plastic strain
+        nfstatus = 2                  ! plastic strain
       endif
-      gauss%istatus = 0
-      gauss%fstatus = 0.d0
-    else if( isViscoelastic(gauss%pMaterial%mtype) ) then
-      n = fetch_TableRow( MC_VISCOELASTIC, gauss%pMaterial%dict )
+    else if( isViscoelastic(pMaterial%mtype) ) then
+      n = fetch_MatTableRow( MT_VISCOELASTIC, pMaterial )
       if( n>0 ) then
-        allocate( gauss%fstatus(12*n+6) )    ! visco stress components
-        gauss%fstatus = 0.d0
+        nfstatus = 12*n+6             ! visco stress components
       else
         stop "Viscoelastic properties not defined"
       endif
-    else if( gauss%pMaterial%mtype==NORTON ) then
-      allocate( gauss%fstatus(2) )        ! effective stress, effective viscoplastic strain
-      gauss%fstatus = 0.d0
-      gauss%plstrain = 0.d0
+    else if( pMaterial%mtype==NORTON ) then
+      nfstatus = 2                    ! effective stress, effective viscoplastic strain
     endif
-  end subroutine fstr_init_gauss
+  end subroutine fstr_gauss_status_size
 
   !> Finializer
   subroutine fstr_finalize_gauss( gauss )
@@ -100,6 +135,94 @@ contains
     end if
   end subroutine fstr_copy_gauss
 
+  !> Allocate the geometric cache of an element. The cache is kept only while
+  !! the total size stays within budget (in bytes); it returns .false. otherwise
+  !! and the element falls back to recomputing its Jacobians.
+  logical function fstr_alloc_geomcache( element, nn, ndim, budget, used )
+    type( tElement ), intent(inout) :: element
+    integer, intent(in)             :: nn       !< number of elemental nodes
+    integer, intent(in)             :: ndim     !< space dimension
+    real(kind=kreal), intent(in)    :: budget   !< memory budget in bytes
+    real(kind=kreal), intent(inout) :: used     !< memory already used in bytes
+    integer :: ng
+    real(kind=kreal) :: nbytes
+
+    fstr_alloc_geomcache = .false.
+    if( .not. associated(element%gausses) ) return
+    ng = size(element%gausses)
+    nbytes = dble(ng*(nn*ndim+1))*kreal
+    if( used+nbytes > budget ) return
+    allocate( element%gderiv(nn,ndim,ng), element%wdet(ng) )
+    used = used+nbytes
+    fstr_alloc_geomcache = .true.
+  end function fstr_alloc_geomcache
+
+  !> Initializer of a store of ngauss quadrature points of one material
+  subroutine fstr_init_gauss_store( store, material, ngauss )
+    type( tGaussStore ), intent(inout)    :: store
+    type( tMaterial ), target, intent(in) :: material
+    integer, intent(in)                   :: ngauss
+    integer :: k
+
+    store%ngauss = ngauss
+    call fstr_gauss_status_size( material, store%nistatus, store%nfstatus )
+    allocate( store%gausses(ngauss) )
+    allocate( store%istatus(store%nistatus, ngauss) )
+    allocate( store%fstatus(store%nfstatus, ngauss) )
+    store%istatus(:,:) = 0
+    store%fstatus(:,:) = 0.d0
+    do k = 1, ngauss
+      store%gausses(k)%pMaterial => material
+      call fstr_clear_gauss( store%gausses(k) )
+      if( store%nistatus > 0 ) store%gausses(k)%istatus => store%istatus(:,k)
+      if( store%nfstatus > 0 ) store%gausses(k)%fstatus => store%fstatus(:,k)
+    enddo
+  end subroutine fstr_init_gauss_store
+
+  !> Finalizer of a store
+  subroutine fstr_finalize_gauss_store( store )
+    type( tGaussStore ), intent(inout) :: store
+    if( associated( store%gausses ) ) deallocate( store%gausses )
+    if( associated( store%istatus ) ) deallocate( store%istatus )
+    if( associated( store%fstatus ) ) deallocate( store%fstatus )
+    store%ngauss = 0
+  end subroutine fstr_finalize_gauss_store
+
+  !> Copy all quadrature points of store1 to store2 of the same layout
+  subroutine fstr_copy_gauss_store( store1, store2 )
+    type( tGaussStore ), intent(in)    :: store1
+    type( tGaussStore ), intent(inout) :: store2
+    integer :: k
+
+    do k = 1, store1%ngauss
+      store2%gausses(k)%strain     = store1%gausses(k)%strain
+      store2%gausses(k)%stress     = store1%gausses(k)%stress
+      store2%gausses(k)%strain_bak = store1%gausses(k)%strain_bak
+      store2%gausses(k)%stress_bak = store1%gausses(k)%stress_bak
+      store2%gausses(k)%plstrain   = store1%gausses(k)%plstrain
+    enddo
+    store2%istatus(:,:) = store1%istatus(:,:)
+    store2%fstatus(:,:) = store1%fstatus(:,:)
+  end subroutine fstr_copy_gauss_store
+
+  !> Save current strain and stress of all quadrature points as converged values
+  subroutine fstr_backup_gauss_store( store )
+    type( tGaussStore ), intent(inout) :: store
+    integer :: k
+
+    do k = 1, store%ngauss
+      store%gausses(k)%strain_bak = store%gausses(k)%strain
+      store%gausses(k)%stress_bak = store%gausses(k)%stress
+    enddo
+  end subroutine fstr_backup_gauss_store
+
+  !> Release the geometric cache of an element
+  subroutine fstr_finalize_geomcache( element )
+    type( tElement ), intent(inout) :: element
+    if( associated( element%gderiv ) ) deallocate( element%gderiv )
+    if( associated( element%wdet ) ) deallocate( element%wdet )
+  end subroutine fstr_finalize_geomcache
+
 
 end module
 
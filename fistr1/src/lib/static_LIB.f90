@@ -11,6 +11,7 @@ module m_static_LIB
   use m_static_LIB_1d
   use m_static_LIB_2d
   use m_static_LIB_3d
+  use m_static_LIB_3d_batch
   use m_static_LIB_3d_vp
   use m_static_LIB_C3D4SESNS
   use m_static_LIB_C3D8
@@ -45,9 +45,9 @@ contains
 
     if( present(temperature) ) then
       ina(1) = 0.5d0*(temperature(1)+temperature(2))
-      call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa, ierr, ina )
+      call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa, ierr, ina )
     else
-      call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa, ierr )
+      call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa, ierr )
     endif
     if( ierr ) outa(1) = gausses(1)%pMaterial%variables(M_YOUNGS)
     coeff = outa(1)*area*llen0/(llen*llen)
@@ -110,22 +110,22 @@ contains
       tt0 = 0.5d0*(T0(1)+T0(2))
 
       ina(1) = ttc
-      call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa, ierr, ina )
+      call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa, ierr, ina )
       if( ierr ) outa(1) = gausses(1)%pMaterial%variables(M_YOUNGS)
       young = outa(1)
 
-      call fetch_TableData( MC_THEMOEXP, gausses(1)%pMaterial%dict, outa(:), ierr, ina )
+      call fetch_MatTableData( MT_THEMOEXP, gausses(1)%pMaterial, outa(:), ierr, ina )
       if( ierr ) outa(1) = gausses(1)%pMaterial%variables(M_EXAPNSION)
       alp = outa(1)
 
       ina(1) = tt0
-      call fetch_TableData( MC_THEMOEXP, gausses(1)%pMaterial%dict, outa(:), ierr, ina )
+      call fetch_MatTableData( MT_THEMOEXP, gausses(1)%pMaterial, outa(:), ierr, ina )
       if( ierr ) outa(1) = gausses(1)%pMaterial%variables(M_EXAPNSION)
       alp0 = outa(1)
 
       epsth=alp*(ttc-ref_temp)-alp0*(tt0-ref_temp)
     else
-      call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa, ierr )
+      call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa, ierr )
       if( ierr ) outa(1) = gausses(1)%pMaterial%variables(M_YOUNGS)
       young = outa(1)
     endif
@@ -65,17 +65,16 @@ contains
         stop
       endif
 
-      call getQuadPoint( ETYPE, LX, localcoord )
-      call getGlobalDeriv( etype, nn, localcoord, ecoord, det, gderiv )
+      call getQuadGlobalDeriv(ETYPE, nn, LX, ecoord, det, gderiv )
       !
       if(ISET==2) then
-        call getShapeFunc( ETYPE, localcoord, H(:) )
+        call getQuadShapeFunc( ETYPE, LX, H(:) )
         RR=dot_product( H(1:NN), ecoord(1,1:NN) )
-        WG=getWeight( ETYPE, LX )*DET*RR*2.d0*PAI
+        WG=getQuadWeight( ETYPE, LX )*DET*RR*2.d0*PAI
       else
         RR=THICK
         H(:)=0.d0
-        WG=getWeight( ETYPE, LX )*DET*RR
+        WG=getQuadWeight( ETYPE, LX )*DET*RR
       end if
       do J=1,NN
         B(1,2*J-1)=gderiv(J,1)
@@ -213,9 +212,9 @@ contains
       !** INTEGRATION OVER SURFACE
       do LX=1,NumOfQuadPoints( SURTYPE )
         call getQuadPoint( SURTYPE, LX, localcoord(1:1) )
-        call getShapeFunc( SURTYPE, localcoord(1:1), H(1:NSUR) )
+        call getQuadShapeFunc( SURTYPE, LX, H(1:NSUR) )
         normal=EdgeNormal( SURTYPE, NSUR, localcoord(1:1), elecoord(:,1:NSUR) )
-        WG = getWeight( SURTYPE, LX )
+        WG = getQuadWeight( SURTYPE, LX )
         if( ISET==2 ) then
           RR=0.d0
           do I=1,NSUR
@@ -236,15 +235,14 @@ contains
       PLX(:)=0.d0
       PLY(:)=0.d0
       do LX=1,NumOfQuadPoints( ETYPE )
-        call getQuadPoint( ETYPE, LX, localcoord(1:2) )
-        call getShapeDeriv( ETYPE, localcoord(1:2), deriv )
-        call getShapeFunc( ETYPE, localcoord(1:2), H(1:NN) )
+        call getQuadShapeDeriv( ETYPE, LX, deriv )
+        call getQuadShapeFunc( ETYPE, LX, H(1:NN) )
         XJ(1,1:2)=matmul( XX(1:NN), deriv(1:NN,1:2) )
         XJ(2,1:2)=matmul( YY(1:NN), deriv(1:NN,1:2) )
 
         DET=XJ(1,1)*XJ(2,2)-XJ(2,1)*XJ(1,2)
 
-        WG = getWeight( ETYPE, LX )
+        WG = getQuadWeight( ETYPE, LX )
         if(ISET==2) then
           RR=dot_product( H(1:NN),XX(1:NN) )
           WG=WG*DET*RR*2.d0*PAI
@@ -341,9 +339,8 @@ contains
     pp = gausses(1)%pMaterial%variables(M_POISSON)
     !* LOOP OVER ALL INTEGRATION POINTS
     do LX=1,NumOfQuadPoints( ETYPE )
-      call getQuadPoint( ETYPE, LX, localcoord )
-      call getShapeFunc( ETYPE, localcoord, H(1:NN) )
-      call getShapeDeriv( ETYPE, localcoord, deriv(:,:) )
+      call getQuadShapeFunc( ETYPE, LX, H(1:NN) )
+      call getQuadShapeDeriv( ETYPE, LX, deriv(:,:) )
       XJ(1,1:2)=matmul( XX(1:NN), deriv(1:NN,1:2) )
       XJ(2,1:2)=matmul( YY(1:NN), deriv(1:NN,1:2) )
 
@@ -353,10 +350,10 @@ contains
       TEMP0=dot_product(H(1:NN),T0(1:NN))
       if(ISET==2) then
         RR=dot_product(H(1:NN),XX(1:NN))
-        WG=getWeight( ETYPE, LX )*DET*RR*2.d0*PAI
+        WG=getQuadWeight( ETYPE, LX )*DET*RR*2.d0*PAI
       else
         RR=THICK
-        WG=getWeight( ETYPE, LX )*DET*RR
+        WG=getQuadWeight( ETYPE, LX )*DET*RR
       end if
       DUM=1.d0/DET
       XJI(1,1)= XJ(2,2)*DUM
@@ -462,29 +459,28 @@ contains
     do LX=1, NumOfQuadPoints(etype)
       call MatlMatrix( gausses(LX), ISET, D, 1.d0, 1.d0, cdsys, 0.d0 )
 
-      call getQuadPoint( etype, LX, localCoord(:) )
-      call getGlobalDeriv( etype, nn, localcoord, ecoord, det, gderiv )
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv )
       !
       EPSTH = 0.d0
-      call getShapeFunc( ETYPE, localcoord, H(:) )
+      call getQuadShapeFunc( etype, LX, H(:) )
       ttc = dot_product(TT(:), H(:))
       tt0 = dot_product(T0(:), H(:))
       ttn = dot_product(TN(:), H(:))
       if( dabs(ttc-tt0) > 1.d-14 ) then
         ina(1) = ttc
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp = outa(1)
         ina(1) = tt0
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp0 = outa(1)
         EPSTH(1:2)=alp*(ttc-ref_temp)-alp0*(tt0-ref_temp)
       end if
       !
-      WG=getWeight( etype, LX )*DET
+      WG=getQuadWeight( etype, LX )*DET
       if(ISET==2) then
-        call getShapeFunc( ETYPE, localcoord, H(:) )
+        call getQuadShapeFunc( etype, LX, H(:) )
         RR=dot_product( H(1:NN), ecoord(1,1:NN) )
       else
         RR=THICK
@@ -49,7 +49,7 @@ contains
   !----------------------------------------------------------------------*
   subroutine STF_C3                                                &
       (etype, nn, ecoord, gausses, stiff, cdsys_ID, coords, &
-      time, tincr, u ,temperature)
+      time, tincr, u ,temperature, gcache, wdet)
     !----------------------------------------------------------------------*
 
     use mMechGauss
@@ -69,10 +69,13 @@ contains
     real(kind=kreal), intent(in)    :: tincr                  !< time increment
     real(kind=kreal), intent(in)    :: temperature(nn) !< temperature
     real(kind=kreal), intent(in), optional :: u(:,:)          !< nodal displacemwent
+    real(kind=kreal), pointer, intent(in), optional :: gcache(:,:,:) !< cached global shape derivatives
+    real(kind=kreal), pointer, intent(in), optional :: wdet(:)       !< cached weight*det(J)
 
     !---------------------------------------------------------------------
 
     integer(kind=kint) :: flag
+    logical :: is_cached
     integer(kind=kint), parameter :: ndof = 3
     real(kind=kreal) :: D(6, 6), B(6, NDOF*nn), DB(6, NDOF*nn)
     real(kind=kreal) :: gderiv(nn, 3), stress(6), mat(6, 6)
@@ -92,11 +95,18 @@ contains
     if( .not. present(u) ) flag = INFINITESIMAL    ! enforce to infinitesimal deformation analysis
     elem(:, :) = ecoord(:, :)
     if( flag == UPDATELAG ) elem(:, :) = ecoord(:, :)+u(:, :)
+    is_cached = .false.
+    if( present(gcache) .and. flag == INFINITESIMAL ) is_cached = associated(gcache)
 
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      if( is_cached ) then
+        gderiv(1:nn, 1:3) = gcache(1:nn, 1:3, LX)
+        wg = wdet(LX)
+      else
+        call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
+        wg = getQuadWeight( etype, LX )*det
+      endif
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -106,7 +116,7 @@ contains
         end if
       end if
 
-      call getShapeFunc(etype, naturalcoord, spfunc)
+      call getQuadShapeFunc( etype, LX, spfunc)
       temp = dot_product(temperature, spfunc)
       call MatlMatrix( gausses(LX), D3, D, time, tincr, coordsys, temp )
 
@@ -115,7 +125,6 @@ contains
         D(:, :) = D(:, :)-mat
       endif
 
-      wg = getWeight(etype, LX)*det
       B(1:6, 1:nn*ndof) = 0.0D0
       do j = 1, nn
         B(1, 3*j-2)=gderiv(j, 1)
@@ -283,9 +292,9 @@ contains
       enddo
       do IG2=1,NumOfQuadPoints( SURTYPE )
         call getQuadPoint( SURTYPE, IG2, localcoord(1:2) )
-        call getShapeFunc( SURTYPE, localcoord(1:2), H(1:NSUR) )
+        call getQuadShapeFunc( SURTYPE, IG2, H(1:NSUR) )
 
-        WG=getWeight( SURTYPE, IG2 )
+        WG=getQuadWeight( SURTYPE, IG2 )
         normal=SurfaceNormal( SURTYPE, NSUR, localcoord(1:2), elecoord(:,1:NSUR) )
         do I=1,NSUR
           VECT(3*NOD(I)-2)=VECT(3*NOD(I)-2)+val*WG*H(I)*normal(1)
@@ -301,9 +310,8 @@ contains
       PLZ(:)=0.0D0
       ! LOOP FOR INTEGRATION POINTS
       do  LX=1,NumOfQuadPoints( ETYPE )
-        call getQuadPoint( ETYPE, LX, localcoord )
-        call getShapeFunc( ETYPE, localcoord, H(1:nn) )
-        call getShapeDeriv( ETYPE, localcoord, deriv )
+        call getQuadShapeFunc( ETYPE, LX, H(1:nn) )
+        call getQuadShapeDeriv( ETYPE, LX, deriv )
         !  JACOBI MATRIX
         XJ(1,1:3)= matmul( xx(1:nn), deriv(1:nn,1:3) )
         XJ(2,1:3)= matmul( yy(1:nn), deriv(1:nn,1:3) )
@@ -335,7 +343,7 @@ contains
           COEFZ=RHO*val*val*PHZ
         end if
 
-        WG=getWeight( etype, LX )*DET
+        WG=getQuadWeight( ETYPE, LX )*DET
         do I=1,nn
           PLX(I)=PLX(I)+H(I)*WG*COEFX
           PLY(I)=PLY(I)+H(I)*WG*COEFY
@@ -417,7 +425,7 @@ contains
 
     if( cdsys_ID > 0 ) then   ! cannot define aniso expansion when no local coord defined
       ina = TT(1)
-      call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+      call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
       if( .not. ierr ) matlaniso = .TRUE.
     end if
 
@@ -430,9 +438,8 @@ contains
     ! LOOP FOR INTEGRATION POINTS
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getShapeFunc( ETYPE, naturalcoord, H(1:nn) )
-      call getGlobalDeriv( etype, nn, naturalcoord, ecoord, det, gderiv )
+      call getQuadShapeFunc( etype, LX, H(1:nn) )
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv )
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys, serr )
@@ -443,7 +450,7 @@ contains
       end if
 
       ! WEIGHT VALUE AT GAUSSIAN POINT
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6,1:nn*NDOF)=0.0D0
       do J=1,nn
         B(1,3*J-2)=gderiv(j,1)
@@ -464,19 +471,19 @@ contains
 
       ina(1) = TEMPC
       if( matlaniso ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(LX)%pMaterial%dict, alpo(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(LX)%pMaterial, alpo(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp = outa(1)
       end if
       ina(1) = TEMP0
       if( matlaniso  ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(LX)%pMaterial%dict, alpo0(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(LX)%pMaterial, alpo0(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp0 = outa(1)
       end if
@@ -531,19 +538,19 @@ contains
 
     ina(1) = ttc
     if( matlaniso ) then
-      call fetch_TableData( MC_ORTHOEXP, material%dict, alpo(:), ierr, ina )
+      call fetch_MatTableData( MT_ORTHOEXP, material, alpo(:), ierr, ina )
       if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
     else
-      call fetch_TableData( MC_THEMOEXP, material%dict, outa(:), ierr, ina )
+      call fetch_MatTableData( MT_THEMOEXP, material, outa(:), ierr, ina )
       if( ierr ) outa(1) = material%variables(M_EXAPNSION)
       alp = outa(1)
     end if
     ina(1) = tt0
     if( matlaniso  ) then
-      call fetch_TableData( MC_ORTHOEXP, material%dict, alpo0(:), ierr, ina )
+      call fetch_MatTableData( MT_ORTHOEXP, material, alpo0(:), ierr, ina )
       if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
     else
-      call fetch_TableData( MC_THEMOEXP, material%dict, outa(:), ierr, ina )
+      call fetch_MatTableData( MT_THEMOEXP, material, outa(:), ierr, ina )
       if( ierr ) outa(1) = material%variables(M_EXAPNSION)
       alp0 = outa(1)
     end if
@@ -758,7 +765,7 @@ contains
   !---------------------------------------------------------------------*
   subroutine UPDATE_C3                                       &
       (etype,nn,ecoord, u, ddu, cdsys_ID, coords, qf, &
-      gausses, iter, time, tincr, TT, T0, TN)
+      gausses, iter, time, tincr, TT, T0, TN, gcache, wdet)
     !---------------------------------------------------------------------*
 
     use m_fstr
@@ -783,9 +790,12 @@ contains
     real(kind=kreal), intent(in)      :: TT(nn)   !< current temperature
     real(kind=kreal), intent(in)      :: T0(nn)   !< reference temperature
     real(kind=kreal), intent(in)      :: TN(nn)   !< reference temperature
+    real(kind=kreal), pointer, intent(in), optional :: gcache(:,:,:) !< cached global shape derivatives
+    real(kind=kreal), pointer, intent(in), optional :: wdet(:)       !< cached weight*det(J)
 
     ! LOCAL VARIABLES
     integer(kind=kint) :: flag
+    logical            :: is_cached
     integer(kind=kint), parameter :: ndof = 3
     real(kind=kreal)   :: B(6,ndof*nn), B1(6,ndof*nn), spfunc(nn), ina(1)
     real(kind=kreal)   :: gderiv(nn,3), gderiv1(nn,3), gdispderiv(3,3), F(3,3), det, det1, WG, ttc, tt0, ttn
@@ -810,13 +820,20 @@ contains
 
     matlaniso = .FALSE.
     ina = TT(1)
-    call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+    call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
     if( .not. ierr ) matlaniso = .true.
+    is_cached = .false.
+    if( present(gcache) .and. flag == INFINITESIMAL ) is_cached = associated(gcache)
 
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      if( is_cached ) then
+        gderiv(1:nn, 1:3) = gcache(1:nn, 1:3, LX)
+        WG = wdet(LX)
+      else
+        call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
+        WG = getQuadWeight( etype, LX )*DET
+      endif
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:,:), serr )
@@ -832,7 +849,7 @@ contains
 
       ! Thermal Strain
       EPSTH = 0.0D0
-      call getShapeFunc(etype, naturalcoord, spfunc)
+      call getQuadShapeFunc( etype, LX, spfunc)
       ttc = dot_product(TT, spfunc)
       tt0 = dot_product(T0, spfunc)
       ttn = dot_product(TN, spfunc)
@@ -876,7 +893,7 @@ contains
 
         gausses(LX)%strain(1:6) = gausses(LX)%strain_bak(1:6)+dstrain(1:6)+EPSTH(:)
 
-        call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det1, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, ecoord, det1, gderiv1)
         F(1:3,1:3) = F(1:3,1:3) + matmul( u(1:ndof, 1:nn)+ddu(1:ndof, 1:nn), gderiv1(1:nn, 1:ndof) )
 
       end if
@@ -935,7 +952,7 @@ contains
 
       else if( flag == UPDATELAG ) then
 
-        call getGlobalDeriv(etype, nn, naturalcoord, elem1, det, gderiv)
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv)
         B(1:6, 1:nn*ndof) = 0.0D0
         do j = 1, nn
           B(1, 3*J-2) = gderiv(j, 1)
@@ -952,7 +969,7 @@ contains
       end if
 
       ! calculate the Internal Force
-      WG=getWeight( etype, LX )*DET
+      if( flag == UPDATELAG ) WG=getQuadWeight( etype, LX )*DET
       qf(1:nn*ndof)                                                          &
         = qf(1:nn*ndof)+matmul( gausses(LX)%stress(1:6), B(1:6,1:nn*ndof) )*WG
 
@@ -1058,8 +1075,7 @@ contains
     ! LOOP FOR INTEGRATION POINTS
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint(etype, LX, localcoord)
-      call getShapeDeriv(etype, localcoord, deriv)
+      call getQuadShapeDeriv( etype, LX, deriv)
 
       ! JACOBI MATRIX
       XJ(1, 1:3)= matmul( xx(1:nn), deriv(1:nn,1:3) )
@@ -1074,7 +1090,7 @@ contains
         -XJ(2, 1)*XJ(1, 2)*XJ(3, 3) &
         -XJ(1, 1)*XJ(3, 2)*XJ(2, 3)
 
-      VOLUME_C3 = VOLUME_C3+getWeight(etype, LX)*det
+      VOLUME_C3 = VOLUME_C3+getQuadWeight( etype, LX )*det
 
     end do
 
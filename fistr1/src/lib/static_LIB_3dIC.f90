@@ -88,7 +88,7 @@ contains
     do LX = 1, NumOfQuadPoints(etype)
 
       call getQuadPoint(etype, LX, naturalCoord)
-      call getGlobalDeriv( etype, nn, naturalcoord, elem, det, gderiv(1:nn, 1:3) )
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv(1:nn, 1:3) )
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -98,7 +98,7 @@ contains
         end if
       end if
 
-      call getShapeFunc( etype, naturalcoord, spfunc )
+      call getQuadShapeFunc( etype, LX, spfunc )
       temp = dot_product( temperature, spfunc )
       call MatlMatrix( gausses(LX), D3, D, time, tincr, coordsys, temp )
 
@@ -116,7 +116,7 @@ contains
       gderiv(nn+2, :) = -2.0D0*naturalcoord(2)*inverse(2, :)/det
       gderiv(nn+3, :) = -2.0D0*naturalcoord(3)*inverse(3, :)/det
 
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6, 1:(nn+3)*ndof)=0.0D0
       do j = 1, nn+3
         B(1, 3*j-2) = gderiv(j, 1)
@@ -287,7 +287,7 @@ contains
     do LX = 1, NumOfQuadPoints(etype)
 
       call getQuadPoint(etype, LX, naturalCoord)
-      call getGlobalDeriv( etype, nn, naturalcoord, elem, det, gderiv(1:nn, 1:3) )
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv(1:nn, 1:3) )
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -297,7 +297,7 @@ contains
         end if
       end if
 
-      call getShapeFunc( etype, naturalcoord, spfunc )
+      call getQuadShapeFunc( etype, LX, spfunc )
       ttc = dot_product( tt, spfunc )
       call MatlMatrix( gausses(LX), D3, D, time, tincr, coordsys, ttc )
 
@@ -315,7 +315,7 @@ contains
       gderiv(nn+2, :) = -2.0D0*naturalcoord(2)*inverse(2, :)/det
       gderiv(nn+3, :) = -2.0D0*naturalcoord(3)*inverse(3, :)/det
 
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6, 1:(nn+3)*ndof)=0.0D0
       do j = 1, nn+3
         B(1, 3*j-2) = gderiv(j, 1)
@@ -448,7 +448,7 @@ contains
 
     matlaniso = .FALSE.
     ina = TT(1)
-    call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+    call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
     if( .not. ierr ) matlaniso = .true.
 
     ! --- Inverse of Jacobian at elemental center
@@ -467,7 +467,7 @@ contains
       mtype = gausses(LX)%pMaterial%mtype
 
       call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:,:), serr )
@@ -483,7 +483,7 @@ contains
 
       ! Thermal Strain
       EPSTH = 0.0D0
-      call getShapeFunc(etype, naturalcoord, spfunc)
+      call getQuadShapeFunc( etype, LX, spfunc)
       ttc = dot_product(TT, spfunc)
       tt0 = dot_product(T0, spfunc)
       ttn = dot_product(TN, spfunc)
@@ -536,7 +536,7 @@ contains
         rot(1, 3)= 0.5d0*(gdispderiv(1, 3)-gdispderiv(3, 1) );  rot(3, 1) = -rot(1, 3)
 
         gausses(LX)%strain(1:6) = gausses(LX)%strain_bak(1:6)+ dstrain(1:6)+EPSTH(:)
-        call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det0, gderiv0)
+        call getQuadGlobalDeriv(etype, nn, LX, ecoord, det0, gderiv0)
         gderiv0(nn+1, :) = -2.0D0*naturalcoord(1)*inverse0(1, :)/det0
         gderiv0(nn+2, :) = -2.0D0*naturalcoord(2)*inverse0(2, :)/det0
         gderiv0(nn+3, :) = -2.0D0*naturalcoord(3)*inverse0(3, :)/det0
@@ -598,7 +598,7 @@ contains
 
       else if( flag == UPDATELAG ) then
 
-        call getGlobalDeriv(etype, nn, naturalcoord, elem1, det, gderiv(1:nn,1:3))
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv(1:nn,1:3))
 
         ! -- Derivative of shape function of incompatible mode --
         !     [ -2*a   0,   0   ]
@@ -624,7 +624,7 @@ contains
 
       end if
 
-      WG=getWeight( etype, LX )*DET
+      WG=getQuadWeight( etype, LX )*DET
 
       DB(1:6, 1:(nn+3)*ndof) = matmul( D, B(1:6, 1:(nn+3)*ndof) )
       forall( i=1:3*ndof, j=1:nn*ndof )
@@ -695,7 +695,7 @@ contains
     matlaniso = .FALSE.
     if( cdsys_ID > 0 ) then   ! cannot define aniso expansion when no local coord defined
       ina = TT(1)
-      call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+      call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
       if( .not. ierr ) matlaniso = .true.
     end if
 
@@ -719,7 +719,7 @@ contains
     do IC = 1, NumOfQuadPoints(etype)
 
       call getQuadPoint(etype, IC, naturalCoord)
-      call getGlobalDeriv( etype, nn, naturalcoord, ecoord, det, gderiv(1:nn, 1:3) )
+      call getQuadGlobalDeriv(etype, nn, IC, ecoord, det, gderiv(1:nn, 1:3) )
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -729,7 +729,7 @@ contains
         end if
       end if
 
-      call getShapeFunc( etype, naturalcoord, H(1:nn) )
+      call getQuadShapeFunc( etype, IC, H(1:nn) )
       TEMPC = dot_product( H(1:nn), TT(1:nn) )
       TEMP0 = dot_product( H(1:nn), T0(1:nn) )
       call MatlMatrix( gausses(IC), D3, D, 1.d0, 1.0D0, coordsys, TEMPC )
@@ -743,7 +743,7 @@ contains
       gderiv(nn+2, :) = -2.0D0*naturalcoord(2)*inverse(2, :)/det
       gderiv(nn+3, :) = -2.0D0*naturalcoord(3)*inverse(3, :)/det
 
-      wg = getWeight(etype, IC)*det
+      wg = getQuadWeight( etype, IC )*det
       do j = 1, nn+3
         B(1, 3*j-2) = gderiv(j, 1)
         B(2, 3*j-1) = gderiv(j, 2)
@@ -766,19 +766,19 @@ contains
 
       ina(1) = TEMPC
       if( matlaniso ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(IC)%pMaterial%dict, alpo(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(IC)%pMaterial, alpo(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(IC)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(IC)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(IC)%pMaterial%variables(M_EXAPNSION)
         alp = outa(1)
       end if
       ina(1) = TEMP0
       if( matlaniso  ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(IC)%pMaterial%dict, alpo0(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(IC)%pMaterial, alpo0(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(IC)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(IC)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(IC)%pMaterial%variables(M_EXAPNSION)
         alp0 = outa(1)
       end if
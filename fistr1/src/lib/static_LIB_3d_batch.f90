@@ -0,0 +1,504 @@
+!-------------------------------------------------------------------------------
+! Copyright (c) 2019 FrontISTR Commons
+! This software is released under the MIT License, see LICENSE.txt
+!-------------------------------------------------------------------------------
+!> \brief  This module provides batched versions of the general solid element
+!!  routines STF_C3 and UPDATE_C3.
+!!
+!>  Up to kC3BatchSize consecutive elements of the same type and material are
+!!  processed in one call. Nodal data are stored structure-of-arrays with the
+!!  element index running fastest, so that jacobians, B-matrices and B^T*D*B
+!!  products are evaluated for the whole batch in inner loops the compiler can
+!!  vectorize. Constitutive routines are still called per quadrature point.
+module m_static_LIB_3d_batch
+
+  use hecmw, only : kint, kreal
+  use elementInfo
+
+  implicit none
+
+  !> number of elements processed in one call of the batched kernels
+  integer(kind=kint), parameter :: kC3BatchSize = 8
+
+contains
+
+  !> Check whether elements is:iE can be treated as one batch
+  logical function isBatchable_C3( hecMESH, fstrSOLID, ic_type, is, iE, for_update )
+    use m_fstr
+
+    type(hecmwST_local_mesh), intent(in) :: hecMESH
+    type(fstr_solid), intent(in)         :: fstrSOLID
+    integer(kind=kint), intent(in)       :: ic_type
+    integer(kind=kint), intent(in)       :: is, iE
+    logical, intent(in)                  :: for_update  !< .true. for UPDATE_C3_batch, .false. for STF_C3_batch
+
+    type(tMaterial), pointer :: material
+    integer(kind=kint) :: icel, isect, flag
+
+    isBatchable_C3 = .false.
+    if( iE < is ) return
+    select case( ic_type )
+      case( fe_tet4n, fe_tet10n, fe_prism6n, fe_prism15n, fe_hex8n, fe_hex20n )
+      case default
+        return
+    end select
+
+    material => fstrSOLID%elements(is)%gausses(1)%pMaterial
+    flag = material%nlgeom_flag
+    if( flag /= INFINITESIMAL .and. flag /= TOTALLAG ) then
+      if( for_update .or. flag /= UPDATELAG ) return
+    endif
+
+    do icel = is, iE
+      if( .not. associated( fstrSOLID%elements(icel)%gausses(1)%pMaterial, material ) ) return
+      isect = hecMESH%section_ID(icel)
+      if( hecMESH%section%sect_orien_ID(isect) > 0 ) return
+      if( ic_type == fe_tet4n .and. fstrSOLID%sections(isect)%elemopt341 == kel341SESNS ) return
+      if( ic_type == fe_hex8n .and. fstrSOLID%sections(isect)%elemopt361 /= kel361FI ) return
+    enddo
+
+    isBatchable_C3 = .true.
+  end function isBatchable_C3
+
+  !> Calculate global shape derivatives of a batch of elements at one quadrature point
+  subroutine getGlobalDeriv_batch( nb, nn, deriv, elem, det, gderiv )
+    integer(kind=kint), intent(in) :: nb              !< number of elements in batch
+    integer(kind=kint), intent(in) :: nn              !< number of elemental nodes
+    real(kind=kreal), intent(in)   :: deriv(nn,3)     !< shape derivative in natural coordinate
+    real(kind=kreal), intent(in)   :: elem(nb,3,nn)   !< nodal coordinates
+    real(kind=kreal), intent(out)  :: det(nb)         !< determinant of jacobian
+    real(kind=kreal), intent(out)  :: gderiv(nb,nn,3) !< shape derivative in global coordinate
+
+    real(kind=kreal) :: XJ(nb,3,3), XJI(nb,3,3), dum
+    integer(kind=kint) :: ib, i, j, n
+
+    XJ(:,:,:) = 0.0D0
+    do j = 1, 3
+      do i = 1, 3
+        do n = 1, nn
+          do ib = 1, nb
+            XJ(ib,i,j) = XJ(ib,i,j)+elem(ib,i,n)*deriv(n,j)
+          enddo
+        enddo
+      enddo
+    enddo
+
+    do ib = 1, nb
+      det(ib) = XJ(ib,1,1)*XJ(ib,2,2)*XJ(ib,3,3)  &
+        +XJ(ib,2,1)*XJ(ib,3,2)*XJ(ib,1,3)         &
+        +XJ(ib,3,1)*XJ(ib,1,2)*XJ(ib,2,3)         &
+        -XJ(ib,3,1)*XJ(ib,2,2)*XJ(ib,1,3)         &
+        -XJ(ib,2,1)*XJ(ib,1,2)*XJ(ib,3,3)         &
+        -XJ(ib,1,1)*XJ(ib,3,2)*XJ(ib,2,3)
+    enddo
+    if( any( det(1:nb) == 0.d0 ) ) stop "Math error in getGlobalDeriv_batch! Determinant==0.0"
+
+    do ib = 1, nb
+      dum = 1.d0/det(ib)
+      XJI(ib,1,1) = dum*( XJ(ib,2,2)*XJ(ib,3,3)-XJ(ib,3,2)*XJ(ib,2,3) )
+      XJI(ib,1,2) = dum*(-XJ(ib,1,2)*XJ(ib,3,3)+XJ(ib,3,2)*XJ(ib,1,3) )
+      XJI(ib,1,3) = dum*( XJ(ib,1,2)*XJ(ib,2,3)-XJ(ib,2,2)*XJ(ib,1,3) )
+      XJI(ib,2,1) = dum*(-XJ(ib,2,1)*XJ(ib,3,3)+XJ(ib,3,1)*XJ(ib,2,3) )
+      XJI(ib,2,2) = dum*( XJ(ib,1,1)*XJ(ib,3,3)-XJ(ib,3,1)*XJ(ib,1,3) )
+      XJI(ib,2,3) = dum*(-XJ(ib,1,1)*XJ(ib,2,3)+XJ(ib,2,1)*XJ(ib,1,3) )
+      XJI(ib,3,1) = dum*( XJ(ib,2,1)*XJ(ib,3,2)-XJ(ib,3,1)*XJ(ib,2,2) )
+      XJI(ib,3,2) = dum*(-XJ(ib,1,1)*XJ(ib,3,2)+XJ(ib,3,1)*XJ(ib,1,2) )
+      XJI(ib,3,3) = dum*( XJ(ib,1,1)*XJ(ib,2,2)-XJ(ib,2,1)*XJ(ib,1,2) )
+    enddo
+
+    gderiv(:,:,:) = 0.0D0
+    do j = 1, 3
+      do i = 1, 3
+        do n = 1, nn
+          do ib = 1, nb
+            gderiv(ib,n,j) = gderiv(ib,n,j)+deriv(n,i)*XJI(ib,i,j)
+          enddo
+        enddo
+      enddo
+    enddo
+  end subroutine getGlobalDeriv_batch
+
+  !> Fill linear B-matrix of a batch ( plus BL1 term for total Lagrange )
+  subroutine getBMatrix_batch( nb, nn, gderiv, B, gdispderiv )
+    integer(kind=kint), intent(in) :: nb
+    integer(kind=kint), intent(in) :: nn
+    real(kind=kreal), intent(in)   :: gderiv(nb,nn,3)
+    real(kind=kreal), intent(out)  :: B(nb,6,3*nn)
+    real(kind=kreal), intent(in), optional :: gdispderiv(nb,3,3)  !< displacement gradient (total Lagrange)
+
+    integer(kind=kint) :: ib, j, k
+
+    B(:,:,:) = 0.0D0
+    do j = 1, nn
+      do ib = 1, nb
+        B(ib,1,3*j-2) = gderiv(ib,j,1)
+        B(ib,2,3*j-1) = gderiv(ib,j,2)
+        B(ib,3,3*j  ) = gderiv(ib,j,3)
+        B(ib,4,3*j-2) = gderiv(ib,j,2)
+        B(ib,4,3*j-1) = gderiv(ib,j,1)
+        B(ib,5,3*j-1) = gderiv(ib,j,3)
+        B(ib,5,3*j  ) = gderiv(ib,j,2)
+        B(ib,6,3*j-2) = gderiv(ib,j,3)
+        B(ib,6,3*j  ) = gderiv(ib,j,1)
+      enddo
+    enddo
+    if( .not. present(gdispderiv) ) return
+
+    do j = 1, nn
+      do k = 1, 3
+        do ib = 1, nb
+          B(ib,1,3*j-3+k) = B(ib,1,3*j-3+k)+gdispderiv(ib,k,1)*gderiv(ib,j,1)
+          B(ib,2,3*j-3+k) = B(ib,2,3*j-3+k)+gdispderiv(ib,k,2)*gderiv(ib,j,2)
+          B(ib,3,3*j-3+k) = B(ib,3,3*j-3+k)+gdispderiv(ib,k,3)*gderiv(ib,j,3)
+          B(ib,4,3*j-3+k) = B(ib,4,3*j-3+k)+gdispderiv(ib,k,2)*gderiv(ib,j,1)+gdispderiv(ib,k,1)*gderiv(ib,j,2)
+          B(ib,5,3*j-3+k) = B(ib,5,3*j-3+k)+gdispderiv(ib,k,2)*gderiv(ib,j,3)+gdispderiv(ib,k,3)*gderiv(ib,j,2)
+          B(ib,6,3*j-3+k) = B(ib,6,3*j-3+k)+gdispderiv(ib,k,3)*gderiv(ib,j,1)+gdispderiv(ib,k,1)*gderiv(ib,j,3)
+        enddo
+      enddo
+    enddo
+  end subroutine getBMatrix_batch
+
+  !> Displacement gradient of a batch
+  subroutine getDispDeriv_batch( nb, nn, disp, gderiv, gdispderiv )
+    integer(kind=kint), intent(in) :: nb
+    integer(kind=kint), intent(in) :: nn
+    real(kind=kreal), intent(in)   :: disp(nb,3,nn)
+    real(kind=kreal), intent(in)   :: gderiv(nb,nn,3)
+    real(kind=kreal), intent(out)  :: gdispderiv(nb,3,3)
+
+    integer(kind=kint) :: ib, i, j, n
+
+    gdispderiv(:,:,:) = 0.0D0
+    do j = 1, 3
+      do i = 1, 3
+        do n = 1, nn
+          do ib = 1, nb
+            gdispderiv(ib,i,j) = gdispderiv(ib,i,j)+disp(ib,i,n)*gderiv(ib,n,j)
+          enddo
+        enddo
+      enddo
+    enddo
+  end subroutine getDispDeriv_batch
+
+  !> Check whether geometric cache is available for all elements of a batch
+  logical function isGeomCached_batch( nb, elements, flag )
+    use mMechGauss
+    integer(kind=kint), intent(in) :: nb
+    type(tElement), intent(in)     :: elements(nb)
+    integer(kind=kint), intent(in) :: flag          !< nlgeom flag of the batch
+
+    integer(kind=kint) :: ib
+
+    isGeomCached_batch = .false.
+    if( flag /= INFINITESIMAL ) return
+    do ib = 1, nb
+      if( .not. associated(elements(ib)%gderiv) ) return
+    enddo
+    isGeomCached_batch = .true.
+  end function isGeomCached_batch
+
+  !> Gather cached global shape derivatives and weight*det(J) of a batch at one quadrature point
+  subroutine getCachedDeriv_batch( nb, nn, LX, elements, gderiv, wg )
+    use mMechGauss
+    integer(kind=kint), intent(in) :: nb
+    integer(kind=kint), intent(in) :: nn
+    integer(kind=kint), intent(in) :: LX
+    type(tElement), intent(in)     :: elements(nb)
+    real(kind=kreal), intent(out)  :: gderiv(nb,nn,3)
+    real(kind=kreal), intent(out)  :: wg(nb)
+
+    integer(kind=kint) :: ib, j, n
+
+    do j = 1, 3
+      do n = 1, nn
+        do ib = 1, nb
+          gderiv(ib,n,j) = elements(ib)%gderiv(n,j,LX)
+        enddo
+      enddo
+    enddo
+    do ib = 1, nb
+      wg(ib) = elements(ib)%wdet(LX)
+    enddo
+  end subroutine getCachedDeriv_batch
+
+  !=====================================================================*
+  !>  Batched counterpart of STF_C3 for elements without material
+  !!  coordinate system
+  !----------------------------------------------------------------------*
+  subroutine STF_C3_batch                                          &
+      (etype, nn, nb, ecoord, elements, stiff, time, tincr, u, temperature)
+    !----------------------------------------------------------------------*
+
+    use mMechGauss
+    use m_MatMatrix
+    use m_static_LIB_3d, only : GEOMAT_C3
+
+    !---------------------------------------------------------------------
+
+    integer(kind=kint), intent(in)  :: etype                !< element type
+    integer(kind=kint), intent(in)  :: nn                   !< number of elemental nodes
+    integer(kind=kint), intent(in)  :: nb                   !< number of elements in batch
+    real(kind=kreal),   intent(in)  :: ecoord(nb,3,nn)      !< coordinates of elemental nodes
+    type(tElement),     intent(in)  :: elements(nb)         !< elements of the batch
+    real(kind=kreal),   intent(out) :: stiff(:,:,:)         !< stiff matrices (3*nn,3*nn,nb)
+    real(kind=kreal),   intent(in)  :: time                 !< current time
+    real(kind=kreal),   intent(in)  :: tincr                !< time increment
+    real(kind=kreal),   intent(in)  :: u(nb,3,nn)           !< nodal displacemwent
+    real(kind=kreal),   intent(in)  :: temperature(nb,nn)   !< temperature
+
+    !---------------------------------------------------------------------
+
+    integer(kind=kint) :: flag
+    integer(kind=kint), parameter :: ndof = 3
+    real(kind=kreal) :: D(nb,6,6), B(nb,6,ndof*nn), DB(nb,6,ndof*nn), st(nb,ndof*nn,ndof*nn)
+    real(kind=kreal) :: gderiv(nb,nn,3), gdispderiv(nb,3,3), elem(nb,3,nn)
+    real(kind=kreal) :: det(nb), wg(nb), temp(nb), sg(nb,3,3), gs(nb,3)
+    real(kind=kreal) :: Dl(6,6), mat(6,6), coordsys(3,3), w
+    real(kind=kreal) :: spfunc(nn), deriv(nn,3)
+    integer(kind=kint) :: ib, i, j, k, m, a, c, LX
+    logical :: is_cached
+
+    !---------------------------------------------------------------------
+
+    st(:,:,:) = 0.0D0
+    coordsys(:,:) = 0.0D0
+    flag = elements(1)%gausses(1)%pMaterial%nlgeom_flag
+    elem(:,:,:) = ecoord(:,:,:)
+    if( flag == UPDATELAG ) elem(:,:,:) = ecoord(:,:,:)+u(:,:,:)
+    is_cached = isGeomCached_batch( nb, elements, flag )
+
+    do LX = 1, NumOfQuadPoints(etype)
+
+      call getQuadShapeFunc( etype, LX, spfunc )
+      if( is_cached ) then
+        call getCachedDeriv_batch( nb, nn, LX, elements, gderiv, wg )
+      else
+        call getQuadShapeDeriv( etype, LX, deriv )
+        call getGlobalDeriv_batch( nb, nn, deriv, elem, det, gderiv )
+        w = getQuadWeight( etype, LX )
+        do ib = 1, nb
+          wg(ib) = w*det(ib)
+        enddo
+      endif
+
+      temp(:) = 0.0D0
+      do j = 1, nn
+        do ib = 1, nb
+          temp(ib) = temp(ib)+temperature(ib,j)*spfunc(j)
+        enddo
+      enddo
+
+      ! constitutive matrices, one quadrature point of each element
+      do ib = 1, nb
+        call MatlMatrix( elements(ib)%gausses(LX), D3, Dl, time, tincr, coordsys, temp(ib) )
+        if( flag == UPDATELAG ) then
+          call GEOMAT_C3( elements(ib)%gausses(LX)%stress, mat )
+          Dl(:,:) = Dl(:,:)-mat(:,:)
+        endif
+        D(ib,:,:) = Dl(:,:)
+      enddo
+
+      if( flag == TOTALLAG ) then
+        call getDispDeriv_batch( nb, nn, u, gderiv, gdispderiv )
+        call getBMatrix_batch( nb, nn, gderiv, B, gdispderiv )
+      else
+        call getBMatrix_batch( nb, nn, gderiv, B )
+      endif
+
+      ! DB = D*B
+      DB(:,:,:) = 0.0D0
+      do j = 1, nn*ndof
+        do m = 1, 6
+          do k = 1, 6
+            do ib = 1, nb
+              DB(ib,k,j) = DB(ib,k,j)+D(ib,k,m)*B(ib,m,j)
+            enddo
+          enddo
+        enddo
+      enddo
+
+      ! K = K + B^T*DB*wg
+      do j = 1, nn*ndof
+        do i = 1, nn*ndof
+          do k = 1, 6
+            do ib = 1, nb
+              st(ib,i,j) = st(ib,i,j)+B(ib,k,i)*DB(ib,k,j)*wg(ib)
+            enddo
+          enddo
+        enddo
+      enddo
+
+      ! initial stress matrix: (grad N_a)^T * sigma * (grad N_c) on each displacement component
+      if( flag == TOTALLAG .or. flag == UPDATELAG ) then
+        do ib = 1, nb
+          sg(ib,1,1) = elements(ib)%gausses(LX)%stress(1)
+          sg(ib,2,2) = elements(ib)%gausses(LX)%stress(2)
+          sg(ib,3,3) = elements(ib)%gausses(LX)%stress(3)
+          sg(ib,1,2) = elements(ib)%gausses(LX)%stress(4); sg(ib,2,1) = sg(ib,1,2)
+          sg(ib,2,3) = elements(ib)%gausses(LX)%stress(5); sg(ib,3,2) = sg(ib,2,3)
+          sg(ib,3,1) = elements(ib)%gausses(LX)%stress(6); sg(ib,1,3) = sg(ib,3,1)
+        enddo
+        do c = 1, nn
+          gs(:,:) = 0.0D0
+          do j = 1, 3
+            do i = 1, 3
+              do ib = 1, nb
+                gs(ib,i) = gs(ib,i)+sg(ib,i,j)*gderiv(ib,c,j)
+              enddo
+            enddo
+          enddo
+          do a = 1, nn
+            do k = 1, 3
+              do ib = 1, nb
+                st(ib,3*a-3+k,3*c-3+k) = st(ib,3*a-3+k,3*c-3+k)                  &
+                  +( gderiv(ib,a,1)*gs(ib,1)+gderiv(ib,a,2)*gs(ib,2)+gderiv(ib,a,3)*gs(ib,3) )*wg(ib)
+              enddo
+            enddo
+          enddo
+        enddo
+      endif
+
+    enddo ! gauss loop
+
+    do ib = 1, nb
+      stiff(1:nn*ndof,1:nn*ndof,ib) = st(ib,:,:)
+    enddo
+
+  end subroutine STF_C3_batch
+
+  !> Batched counterpart of UPDATE_C3 for elements without material
+  !! coordinate system ( small strain and total Lagrange only )
+  !---------------------------------------------------------------------*
+  subroutine UPDATE_C3_batch                                 &
+      (etype, nn, nb, ecoord, u, ddu, qf, elements, time, tincr, TT, T0, TN)
+    !---------------------------------------------------------------------*
+
+    use m_fstr
+    use mMaterial
+    use mMechGauss
+    use m_MatMatrix
+    use m_static_LIB_3d, only : Update_Stress3D, Cal_Thermal_expansion_C3
+
+    integer(kind=kint), intent(in)    :: etype             !< element type
+    integer(kind=kint), intent(in)    :: nn                !< number of elemental nodes
+    integer(kind=kint), intent(in)    :: nb                !< number of elements in batch
+    real(kind=kreal), intent(in)      :: ecoord(nb,3,nn)   !< coordinates of elemental nodes
+    real(kind=kreal), intent(in)      :: u(nb,3,nn)        !< nodal dislplacements
+    real(kind=kreal), intent(in)      :: ddu(nb,3,nn)      !< nodal displacement increment
+    real(kind=kreal), intent(out)     :: qf(nb,3*nn)       !< internal force
+    type(tElement), intent(inout)     :: elements(nb)      !< elements of the batch, gausses updated
+    real(kind=kreal), intent(in)      :: time              !< current time
+    real(kind=kreal), intent(in)      :: tincr             !< time increment
+    real(kind=kreal), intent(in)      :: TT(nb,nn)         !< current temperature
+    real(kind=kreal), intent(in)      :: T0(nb,nn)         !< reference temperature
+    real(kind=kreal), intent(in)      :: TN(nb,nn)         !< temperature at last step
+
+    integer(kind=kint) :: flag
+    integer(kind=kint), parameter :: ndof = 3
+    real(kind=kreal)   :: B(nb,6,ndof*nn), gderiv(nb,nn,3), gdispderiv(nb,3,3), totaldisp(nb,3,nn)
+    real(kind=kreal)   :: det(nb), wg(nb), ttc(nb), tt0(nb), ttn(nb), dstrain(nb,6), stress(nb,6)
+    real(kind=kreal)   :: spfunc(nn), deriv(nn,3), w, ina(1)
+    real(kind=kreal)   :: rot(3,3), F(3,3), EPSTH(nb,6), coordsys(3,3), alpo(3)
+    integer(kind=kint) :: ib, j, k, LX
+    logical            :: ierr, matlaniso, is_cached
+
+    qf(:,:) = 0.0D0
+    rot(:,:) = 0.0D0
+    coordsys(:,:) = 0.0D0
+    flag = elements(1)%gausses(1)%pMaterial%nlgeom_flag
+    totaldisp(:,:,:) = u(:,:,:)+ddu(:,:,:)
+
+    ! all elements of a batch share one material
+    matlaniso = .FALSE.
+    ina = TT(1,1)
+    call fetch_MatTableData( MT_ORTHOEXP, elements(1)%gausses(1)%pMaterial, alpo(:), ierr, ina )
+    if( .not. ierr ) matlaniso = .true.
+
+    is_cached = isGeomCached_batch( nb, elements, flag )
+
+    do LX = 1, NumOfQuadPoints(etype)
+
+      call getQuadShapeFunc( etype, LX, spfunc )
+      if( is_cached ) then
+        call getCachedDeriv_batch( nb, nn, LX, elements, gderiv, wg )
+      else
+        call getQuadShapeDeriv( etype, LX, deriv )
+        call getGlobalDeriv_batch( nb, nn, deriv, ecoord, det, gderiv )
+        w = getQuadWeight( etype, LX )
+        do ib = 1, nb
+          wg(ib) = w*det(ib)
+        enddo
+      endif
+      ttc(:) = 0.0D0; tt0(:) = 0.0D0; ttn(:) = 0.0D0
+      do j = 1, nn
+        do ib = 1, nb
+          ttc(ib) = ttc(ib)+TT(ib,j)*spfunc(j)
+          tt0(ib) = tt0(ib)+T0(ib,j)*spfunc(j)
+          ttn(ib) = ttn(ib)+TN(ib,j)*spfunc(j)
+        enddo
+      enddo
+
+      ! thermal strain, one quadrature point of each element
+      EPSTH(:,:) = 0.0D0
+      do ib = 1, nb
+        call Cal_Thermal_expansion_C3( tt0(ib), ttc(ib), elements(ib)%gausses(LX)%pMaterial, coordsys, matlaniso, &
+          EPSTH(ib,:) )
+      enddo
+
+      ! small strain part
+      call getDispDeriv_batch( nb, nn, totaldisp, gderiv, gdispderiv )
+      do ib = 1, nb
+        dstrain(ib,1) = gdispderiv(ib,1,1)
+        dstrain(ib,2) = gdispderiv(ib,2,2)
+        dstrain(ib,3) = gdispderiv(ib,3,3)
+        dstrain(ib,4) = ( gdispderiv(ib,1,2)+gdispderiv(ib,2,1) )
+        dstrain(ib,5) = ( gdispderiv(ib,2,3)+gdispderiv(ib,3,2) )
+        dstrain(ib,6) = ( gdispderiv(ib,3,1)+gdispderiv(ib,1,3) )
+      enddo
+      do k = 1, 6
+        do ib = 1, nb
+          dstrain(ib,k) = dstrain(ib,k)-EPSTH(ib,k)
+        enddo
+      enddo
+
+      ! Green-Lagrange strain
+      if( flag == TOTALLAG ) then
+        do ib = 1, nb
+          dstrain(ib,1) = dstrain(ib,1)+0.5d0*dot_product( gdispderiv(ib,:,1), gdispderiv(ib,:,1) )
+          dstrain(ib,2) = dstrain(ib,2)+0.5d0*dot_product( gdispderiv(ib,:,2), gdispderiv(ib,:,2) )
+          dstrain(ib,3) = dstrain(ib,3)+0.5d0*dot_product( gdispderiv(ib,:,3), gdispderiv(ib,:,3) )
+          dstrain(ib,4) = dstrain(ib,4)+dot_product( gdispderiv(ib,:,1), gdispderiv(ib,:,2) )
+          dstrain(ib,5) = dstrain(ib,5)+dot_product( gdispderiv(ib,:,2), gdispderiv(ib,:,3) )
+          dstrain(ib,6) = dstrain(ib,6)+dot_product( gdispderiv(ib,:,1), gdispderiv(ib,:,3) )
+        enddo
+      endif
+
+      ! stress update, one quadrature point of each element
+      do ib = 1, nb
+        elements(ib)%gausses(LX)%strain(1:6) = dstrain(ib,1:6)+EPSTH(ib,1:6)
+        F(1:3,1:3) = 0.d0; F(1,1)=1.d0; F(2,2)=1.d0; F(3,3)=1.d0
+        if( flag == TOTALLAG ) F(1:3,1:3) = F(1:3,1:3)+gdispderiv(ib,1:3,1:3)
+        call Update_Stress3D( flag, elements(ib)%gausses(LX), rot, dstrain(ib,:), F, coordsys, time, tincr, &
+          ttc(ib), tt0(ib), ttn(ib) )
+        stress(ib,1:6) = elements(ib)%gausses(LX)%stress(1:6)
+      enddo
+
+      ! internal force
+      if( flag == TOTALLAG ) then
+        call getBMatrix_batch( nb, nn, gderiv, B, gdispderiv )
+      else
+        call getBMatrix_batch( nb, nn, gderiv, B )
+      endif
+      do j = 1, nn*ndof
+        do k = 1, 6
+          do ib = 1, nb
+            qf(ib,j) = qf(ib,j)+stress(ib,k)*B(ib,k,j)*wg(ib)
+          enddo
+        enddo
+      enddo
+
+    enddo
+
+  end subroutine UPDATE_C3_batch
+
+end module m_static_LIB_3d_batch
@@ -422,7 +422,7 @@ contains
 
     matlaniso = .FALSE.
     ina = TT(1)
-    call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+    call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
     if( .not. ierr ) matlaniso = .true.
 
     if( cdsys_ID > 0 ) then
@@ -74,8 +74,7 @@ contains
 
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -85,7 +84,7 @@ contains
         end if
       end if
 
-      call getShapeFunc( etype, naturalcoord, spfunc )
+      call getQuadShapeFunc( etype, LX, spfunc )
       temp = dot_product( temperature, spfunc )
       call MatlMatrix( gausses(LX), D3, D, time, tincr, coordsys, temp )
 
@@ -94,7 +93,7 @@ contains
         D(:, :) = D(:, :)-mat
       endif
 
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6, 1:nn*ndof) = 0.0D0
       do j = 1, nn
         B4 = ( Bbar(j, 1)-gderiv(j, 1) )/3.0D0
@@ -258,7 +257,7 @@ contains
 
     matlaniso = .FALSE.
     ina = TT(1)
-    call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+    call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
     if( .not. ierr ) matlaniso = .TRUE.
 
     ! dilatation at centroid
@@ -272,8 +271,7 @@ contains
 
       mtype = gausses(LX)%pMaterial%mtype
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -294,7 +292,7 @@ contains
       ! ========================================================
 
       ! Thermal Strain
-      call getShapeFunc(etype, naturalcoord, spfunc)
+      call getQuadShapeFunc( etype, LX, spfunc)
       ttc = dot_product(TT, spfunc)
       tt0 = dot_product(T0, spfunc)
       ttn = dot_product(TN, spfunc)
@@ -336,7 +334,7 @@ contains
         rot(1, 3)= 0.5D0*( gdispderiv(1, 3)-gdispderiv(3, 1) );  rot(3, 1) = -rot(1, 3)
 
         gausses(LX)%strain(1:6) = gausses(LX)%strain_bak(1:6)+dstrain(1:6)+EPSTH(:)
-        call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det1, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, ecoord, det1, gderiv1)
         F(1:3,1:3) = F(1:3,1:3) + matmul( u(1:ndof, 1:nn)+du(1:ndof, 1:nn), gderiv1(1:nn, 1:ndof) )
 
       end if
@@ -405,7 +403,7 @@ contains
 
       else if( flag == UPDATELAG ) then
 
-        call getGlobalDeriv(etype, nn, naturalcoord, elem1, det, gderiv)
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv)
         B(1:6, 1:nn*ndof) = 0.0D0
         do j = 1, nn
           B4 = ( Bbar2(j, 1)-gderiv(j, 1) )/3.0D0
@@ -433,7 +431,7 @@ contains
       end if
 
       !!  calculate the Internal Force
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       qf(1:nn*ndof) = qf(1:nn*ndof)                                           &
         +matmul( gausses(LX)%stress(1:6), B(1:6, 1:nn*ndof) )*wg
 
@@ -481,7 +479,7 @@ contains
 
     if( cdsys_ID > 0 ) then   ! cannot define aniso expansion when no local coord defined
       ina = TT(1)
-      call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+      call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
       if( .not. ierr ) matlaniso = .TRUE.
     end if
 
@@ -500,9 +498,8 @@ contains
     ! LOOP FOR INTEGRATION POINTS
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getShapeFunc( etype, naturalcoord, H(1:nn) )
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, H(1:nn) )
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys(coords, g_LocalCoordSys(cdsys_ID), coordsys, serr)
@@ -513,7 +510,7 @@ contains
       end if
 
       !  WEIGHT VALUE AT GAUSSIAN POINT
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6, 1:nn*ndof) = 0.0D0
       do j = 1, nn
         B4 = ( Bbar(j, 1)-gderiv(j, 1) )/3.0D0
@@ -546,19 +543,19 @@ contains
 
       ina(1) = TEMPC
       if( matlaniso ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(LX)%pMaterial%dict, alpo(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(LX)%pMaterial, alpo(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp = outa(1)
       end if
       ina(1) = TEMP0
       if( matlaniso ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(LX)%pMaterial%dict, alpo0(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(LX)%pMaterial, alpo0(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp0 = outa(1)
       end if
@@ -81,9 +81,8 @@ contains
     gderiv1_ave(1:nn,1:ndof) = 0.d0
     gderiv2_ave(1:ndof*nn,1:ndof*nn) = 0.d0
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv( etype, nn, naturalcoord, elem0, det, gderiv)
-      wg = getWeight(etype, LX)*det
+      call getQuadGlobalDeriv(etype, nn, LX, elem0, det, gderiv)
+      wg = getQuadWeight( etype, LX )*det
       if( flag == INFINITESIMAL ) then
         jacob = 1.d0
         gderiv1_ave(1:nn,1:ndof) = gderiv1_ave(1:nn,1:ndof) + jacob*wg*gderiv(1:nn, 1:ndof)
@@ -91,7 +90,7 @@ contains
         gdispderiv(1:3, 1:3) = matmul( u(1:ndof, 1:nn), gderiv(1:nn, 1:ndof) )
         jacob = Determinant33( I33(1:ndof,1:ndof) + gdispderiv(1:ndof, 1:ndof) )
         Jratio(LX) = dsign(dabs(jacob)**(-1.d0/3.d0),jacob)
-        call getGlobalDeriv( etype, nn, naturalcoord, elem1, det, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv1)
         gderiv1_ave(1:nn,1:ndof) = gderiv1_ave(1:nn,1:ndof) + jacob*wg*gderiv1(1:nn, 1:ndof)
         do p=1,nn
           do q=1,nn
@@ -119,8 +118,7 @@ contains
 
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -130,7 +128,7 @@ contains
         end if
       end if
 
-      call getShapeFunc( etype, naturalcoord, spfunc )
+      call getQuadShapeFunc( etype, LX, spfunc )
       temp = dot_product( temperature, spfunc )
       call MatlMatrix( gausses(LX), D3, D, time, tincr, coordsys, temp )
 
@@ -139,7 +137,7 @@ contains
         D(:, :) = D(:, :)-mat
       endif
 
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6, 1:nn*ndof) = 0.0D0
       do j = 1, nn
         B(1, 3*j-2) = gderiv(j, 1)
@@ -171,7 +169,7 @@ contains
       else if( flag == TOTALLAG ) then
         gdispderiv(1:ndof, 1:ndof) = matmul( u(1:ndof, 1:nn), gderiv(1:nn, 1:ndof) )
         Fbar(1:ndof, 1:ndof) = Jratio(LX)*(I33(1:ndof,1:ndof) + gdispderiv(1:ndof, 1:ndof))
-        call getGlobalDeriv( etype, nn, naturalcoord, elem1, det, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv1)
 
         ! ---dudx(i,j) ==> gdispderiv(i,j)
         B1(1:6, 1:nn*ndof) = 0.0D0
@@ -220,7 +218,7 @@ contains
         end do
 
       else if( flag == UPDATELAG ) then
-        wg = (Jratio(LX)**3.d0)*getWeight(etype, LX)*det
+        wg = (Jratio(LX)**3.d0)*getQuadWeight( etype, LX )*det
 
         B2(1:3, 1:nn*ndof) = 0.0D0
         do j = 1, nn
@@ -402,7 +400,7 @@ contains
 
     matlaniso = .FALSE.
     ina = TT(1)
-    call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+    call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
     if( .not. ierr ) matlaniso = .TRUE.
 
     !cal volumetric average of J=detF and dN/dx
@@ -414,9 +412,8 @@ contains
       gderiv05_ave(1:nn,1:ndof) = 0.d0
     endif
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv( etype, nn, naturalcoord, elem0, det, gderiv)
-      wg = getWeight(etype, LX)*det
+      call getQuadGlobalDeriv(etype, nn, LX, elem0, det, gderiv)
+      wg = getQuadWeight( etype, LX )*det
       if( flag == INFINITESIMAL ) then
         jacob = 1.d0
         gderiv1(1:nn, 1:ndof) = gderiv(1:nn, 1:ndof)
@@ -425,14 +422,14 @@ contains
         jacob = Determinant33( I33(1:ndof,1:ndof) + gdispderiv(1:ndof, 1:ndof) )
         Jratio(LX) = dsign(dabs(jacob)**(-1.d0/3.d0),jacob) ! Jratio(LX) = jacob**(-1.d0/3.d0)
 
-        call getGlobalDeriv( etype, nn, naturalcoord, elem1, det, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv1)
       endif
       V0 = V0 + wg
       jacob_ave = jacob_ave + jacob*wg
       gderiv1_ave(1:nn,1:ndof) = gderiv1_ave(1:nn,1:ndof) + jacob*wg*gderiv1(1:nn, 1:ndof)
       if( flag == UPDATELAG ) then
-        call getGlobalDeriv( etype, nn, naturalcoord, elem, det, gderiv1)
-        wg = getWeight(etype, LX)*det
+        call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv1)
+        wg = getQuadWeight( etype, LX )*det
         jacob_ave05 = jacob_ave05 + wg
         gderiv05_ave(1:nn,1:ndof) = gderiv05_ave(1:nn,1:ndof) + wg*gderiv1(1:nn, 1:ndof)
       endif
@@ -449,8 +446,7 @@ contains
 
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv(etype, nn, naturalcoord, elem, det, gderiv)
+      call getQuadGlobalDeriv(etype, nn, LX, elem, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys( coords, g_LocalCoordSys(cdsys_ID), coordsys(:, :), serr )
@@ -467,7 +463,7 @@ contains
       ! ========================================================
 
       ! Thermal Strain
-      call getShapeFunc(etype, naturalcoord, spfunc)
+      call getQuadShapeFunc( etype, LX, spfunc)
       ttc = dot_product(TT, spfunc)
       tt0 = dot_product(T0, spfunc)
       ttn = dot_product(TN, spfunc)
@@ -523,7 +519,7 @@ contains
 
         gausses(LX)%strain(1:6) = gausses(LX)%strain_bak(1:6)+dstrain(1:6)+EPSTH(:)
 
-        call getGlobalDeriv( etype, nn, naturalcoord, elem0, det, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, elem0, det, gderiv1)
         gdispderiv(1:ndof, 1:ndof) = matmul( du(1:ndof, 1:nn)+u(1:ndof, 1:nn), gderiv1(1:nn, 1:ndof) )
         Fbar(1:ndof, 1:ndof) = Jratio(LX)*(I33(1:ndof,1:ndof) + gdispderiv(1:ndof, 1:ndof))
 
@@ -549,7 +545,7 @@ contains
         B(6,3*j  ) = gderiv(j, 1)
       end do
 
-      WG=getWeight( etype, LX )*DET
+      WG=getQuadWeight( etype, LX )*DET
       if( flag == INFINITESIMAL ) then
         gderiv1(1:nn, 1:ndof) = gderiv(1:nn, 1:ndof)
 
@@ -590,7 +586,7 @@ contains
           B1(6, 3*j  ) = gdispderiv(3, 3)*gderiv(j, 1)+gdispderiv(3, 1)*gderiv(j, 3)
         end do
 
-        call getGlobalDeriv(etype, nn, naturalcoord, elem1, det, gderiv1)
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv1)
 
         B2(1:6, 1:nn*ndof) = 0.0D0
         do j = 1, nn
@@ -610,8 +606,8 @@ contains
 
       else if( flag == UPDATELAG ) then
 
-        call getGlobalDeriv(etype, nn, naturalcoord, elem1, det, gderiv)
-        wg = (Jratio(LX)**3.d0)*getWeight(etype, LX)*det
+        call getQuadGlobalDeriv(etype, nn, LX, elem1, det, gderiv)
+        wg = (Jratio(LX)**3.d0)*getQuadWeight( etype, LX )*det
         B(1:6, 1:nn*ndof) = 0.0D0
         do j = 1, nn
           B(1, 3*j-2) = gderiv(j, 1)
@@ -686,7 +682,7 @@ contains
 
     if( cdsys_ID > 0 ) then   ! cannot define aniso expansion when no local coord defined
       ina = TT(1)
-      call fetch_TableData( MC_ORTHOEXP, gausses(1)%pMaterial%dict, alpo(:), ierr, ina )
+      call fetch_MatTableData( MT_ORTHOEXP, gausses(1)%pMaterial, alpo(:), ierr, ina )
       if( .not. ierr ) matlaniso = .TRUE.
     end if
 
@@ -701,9 +697,8 @@ contains
     jacob_ave = 0.d0
     gderiv1_ave(1:nn,1:ndof) = 0.d0
     do LX = 1, NumOfQuadPoints(etype)
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getGlobalDeriv( etype, nn, naturalcoord, ecoord, det, gderiv)
-      wg = getWeight(etype, LX)*det
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
+      wg = getQuadWeight( etype, LX )*det
       V0 = V0 + wg
       jacob_ave = jacob_ave + wg
       gderiv1_ave(1:nn,1:ndof) = gderiv1_ave(1:nn,1:ndof) + wg*gderiv(1:nn, 1:ndof)
@@ -719,9 +714,8 @@ contains
     ! LOOP FOR INTEGRATION POINTS
     do LX = 1, NumOfQuadPoints(etype)
 
-      call getQuadPoint( etype, LX, naturalCoord(:) )
-      call getShapeFunc( etype, naturalcoord, H(1:nn) )
-      call getGlobalDeriv(etype, nn, naturalcoord, ecoord, det, gderiv)
+      call getQuadShapeFunc( etype, LX, H(1:nn) )
+      call getQuadGlobalDeriv(etype, nn, LX, ecoord, det, gderiv)
 
       if( cdsys_ID > 0 ) then
         call set_localcoordsys(coords, g_LocalCoordSys(cdsys_ID), coordsys, serr)
@@ -732,7 +726,7 @@ contains
       end if
 
       !  WEIGHT VALUE AT GAUSSIAN POINT
-      wg = getWeight(etype, LX)*det
+      wg = getQuadWeight( etype, LX )*det
       B(1:6, 1:nn*ndof) = 0.0D0
       do j = 1, nn
         B(1,3*j-2) = gderiv(j, 1)
@@ -760,19 +754,19 @@ contains
 
       ina(1) = TEMPC
       if( matlaniso ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(LX)%pMaterial%dict, alpo(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(LX)%pMaterial, alpo(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp = outa(1)
       end if
       ina(1) = TEMP0
       if( matlaniso ) then
-        call fetch_TableData( MC_ORTHOEXP, gausses(LX)%pMaterial%dict, alpo0(:), ierr, ina )
+        call fetch_MatTableData( MT_ORTHOEXP, gausses(LX)%pMaterial, alpo0(:), ierr, ina )
         if( ierr ) stop "Fails in fetching orthotropic expansion coefficient!"
       else
-        call fetch_TableData( MC_THEMOEXP, gausses(LX)%pMaterial%dict, outa(:), ierr, ina )
+        call fetch_MatTableData( MT_THEMOEXP, gausses(LX)%pMaterial, outa(:), ierr, ina )
         if( ierr ) outa(1) = gausses(LX)%pMaterial%variables(M_EXAPNSION)
         alp0 = outa(1)
       end if
@@ -246,7 +246,7 @@ contains
 
       ina1(1) = tempc
 
-      call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa1, ierr, ina1 )
+      call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa1, ierr, ina1 )
 
     else
 
@@ -465,7 +465,7 @@ contains
 
        ina1(1) = tempc
 
-       CALL fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa1, ierr, ina1 )
+       CALL fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa1, ierr, ina1 )
 
       ELSE
 
@@ -780,7 +780,7 @@ contains
 
     ina1(1) = tempc
 
-    call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa1, ierr, ina1 )
+    call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa1, ierr, ina1 )
 
     if( ierr ) then
 
@@ -798,7 +798,7 @@ contains
 
     ina2(1) = tempc
 
-    call fetch_TableData( MC_THEMOEXP, gausses(1)%pMaterial%dict, outa2(:), ierr, ina2 )
+    call fetch_MatTableData( MT_THEMOEXP, gausses(1)%pMaterial, outa2(:), ierr, ina2 )
 
     if( ierr ) stop "Fails in fetching expansion coefficient!"
 
@@ -808,7 +808,7 @@ contains
 
     ina2(1) = temp0
 
-    call fetch_TableData( MC_THEMOEXP, gausses(1)%pMaterial%dict, outa2(:), ierr, ina2 )
+    call fetch_MatTableData( MT_THEMOEXP, gausses(1)%pMaterial, outa2(:), ierr, ina2 )
 
     if( ierr ) stop "Fails in fetching expansion coefficient!"
 
@@ -947,7 +947,7 @@ contains
 
       ina1(1) = tempc
 
-      call fetch_TableData( MC_ISOELASTIC, gausses(1)%pMaterial%dict, outa1, ierr, ina1 )
+      call fetch_MatTableData( MT_ISOELASTIC, gausses(1)%pMaterial, outa1, ierr, ina1 )
 
     else
 
@@ -975,7 +975,7 @@ contains
 
       ina2(1) = tempc
 
-      call fetch_TableData( MC_THEMOEXP, gausses(1)%pMaterial%dict, outa2(:), ierr, ina2 )
+      call fetch_MatTableData( MT_THEMOEXP, gausses(1)%pMaterial, outa2(:), ierr, ina2 )
 
       if( ierr ) stop "Fails in fetching expansion coefficient!"
 
@@ -989,7 +989,7 @@ contains
 
       ina2(1) = temp0
 
-      call fetch_TableData( MC_THEMOEXP, gausses(1)%pMaterial%dict, outa2(:), ierr, ina2 )
+      call fetch_MatTableData( MT_THEMOEXP, gausses(1)%pMaterial, outa2(:), ierr, ina2 )
 
       if( ierr ) stop "Fails in fetching expansion coefficient!"
 
@@ -142,7 +142,7 @@ module Table_DICTS
   implicit none
   integer, parameter, private :: kreal = kind(0.0d0)
 
-  private :: GetTableGrad, GetTableData
+  private :: GetTableGrad, GetTableData, GetTableData1D
 
   include "dictionary.f90"
 
@@ -187,8 +187,20 @@ module Table_DICTS
     logical, intent(out)           :: ierr
 
     type(DICT_DATA), pointer       :: dicval
-    integer          :: na, dd, crow, cindex
     dicval => dict_get_key( dict, key )
+    call get_TableGrad( dicval, a, outa, ierr )
+    ! call finalize_table( dicval )
+
+  end subroutine
+
+  !> Same as fetch_TableGrad, with the table already looked up
+  subroutine get_TableGrad( dicval, a, outa, ierr )
+    type(DICT_DATA), pointer       :: dicval  !< data table
+    real(kind=kreal), intent(in)   :: a(:)    !< automatic variables
+    real(kind=kreal), intent(out)  :: outa    !< gradient
+    logical, intent(out)           :: ierr
+
+    integer          :: na, dd, crow, cindex
     ierr = .false.
     if( .not. associated(dicval) ) then
       ierr=.true.;  return
@@ -202,8 +214,6 @@ module Table_DICTS
     endif
 
     call GetTableGrad( a(na:), cindex, dicval, dd, crow, outa )
-    ! call finalize_table( dicval )
-
   end subroutine
 
   !> fetch a grad value by interpolation
@@ -284,9 +294,22 @@ module Table_DICTS
     real(kind=kreal), intent(in), optional   :: a(:)    !< automatic variables
 
     type(DICT_DATA), pointer       :: dicval
-    integer          :: nval, na, dd, crow, cindex
 
     dicval => dict_get_key( dict, key )
+    call get_TableData( dicval, outa, ierr, a )
+    !  call finalize_table( dicval )
+
+  end subroutine
+
+  !> Same as fetch_TableData, with the table already looked up
+  subroutine get_TableData( dicval, outa, ierr, a )
+    type(DICT_DATA), pointer       :: dicval  !< data table
+    real(kind=kreal), intent(out)  :: outa(:) !< output data
+    logical, intent(out)           :: ierr    !< error message
+    real(kind=kreal), intent(in), optional   :: a(:)    !< automatic variables
+
+    integer          :: nval, na, dd, crow, cindex
+
     ierr = .false.
     if( .not. associated(dicval) ) then
       ierr=.true.;  return
@@ -314,11 +337,48 @@ module Table_DICTS
     !    na = dicval%ndepends- size(a)+1
     !    cindex = na
     !  endif
+    if( dicval%ndepends==1 ) then
+      call GetTableData1D( a(na), dicval, outa )
+      return
+    endif
     call GetTableData( a(na:), cindex, dicval, dd, crow, outa )
-    !  call finalize_table( dicval )
 
   end subroutine
 
+  !> fetch a data value of a table with one dependent variable. Rows are sorted
+  !! by the dependent variable, so the bracketing interval is found by bisection
+  subroutine GetTableData1D( a, table, outa )
+    real(kind=kreal), intent(in)   :: a
+    type(DICT_DATA)                :: table
+    real(kind=kreal), intent(out)  :: outa(:)
+
+    integer          :: lo, hi, mid, ccol
+    real(kind=kreal) :: lambda
+
+    ccol = table%tbcol
+    if( a<table%tbval(ccol, 1) ) then
+      outa(:) = table%tbval(1:ccol-1, 1)
+      return
+    elseif( a>=table%tbval(ccol, table%tbrow) ) then
+      outa(:) = table%tbval(1:ccol-1, table%tbrow)
+      return
+    endif
+
+    ! tbval(ccol,lo) <= a < tbval(ccol,hi)
+    lo = 1
+    hi = table%tbrow
+    do while( hi-lo>1 )
+      mid = (lo+hi)/2
+      if( a>=table%tbval(ccol, mid) ) then
+        lo = mid
+      else
+        hi = mid
+      endif
+    enddo
+    lambda = (a-table%tbval(ccol, lo))/(table%tbval(ccol, hi)-table%tbval(ccol, lo))
+    outa(:) = (1.d0-lambda)*table%tbval(1:ccol-1, lo)+ lambda* table%tbval(1:ccol-1, hi)
+  end subroutine
+
   !> fetch a data value by interpolation
   recursive subroutine GetTableData( a, cindex, table, dd, crow, outa )
     real(kind=kreal), intent(in)   :: a(:)
@@ -6,6 +6,7 @@ module m_fstr_main
 
   use hecmw
   use m_fstr
+  use elementInfo, only: initShapeTables, finalizeShapeTables
   use m_hecmw2fstr_mesh_conv
   use m_fstr_setup
   use m_fstr_solve_heat
@@ -17,6 +18,7 @@ module m_fstr_main
   use m_fstr_precheck
   use m_fstr_rcap_io
   use fstr_solver_dynamic
+  use fstr_frequency_analysis, only: fstr_write_modal_basis
   use fstr_debug_dump
 
   type(hecmwST_local_mesh), save             :: hecMESH
@@ -79,6 +81,8 @@ contains
         call fstr_heat_analysis
       case( kstSTATICEIGEN )
         call fstr_static_eigen_analysis
+      case( kstEIGENFREQ )
+        call fstr_eigen_freq_analysis
     end select
 
     T3 = hecmw_Wtime()
@@ -125,6 +129,7 @@ contains
     call fstr_nullify_fstr_eigen  ( fstrEIG     )
     call fstr_nullify_fstr_dynamic( fstrDYNAMIC )
     call fstr_nullify_fstr_couple ( fstrCPL     )
+    call fstr_nullify_fstr_freqanalysis( fstrFREQ )
     call fstr_init_file
 
     ! ----  default setting of global params ---
@@ -148,6 +153,7 @@ contains
 
 
     ! ------- initial value setting -------------
+    call initShapeTables()
     call fstr_mat_init  ( hecMAT   )
     call fstr_param_init( fstrPR, hecMESH )
 
@@ -408,6 +414,50 @@ contains
 
   end subroutine fstr_static_eigen_analysis
 
+  !=============================================================================!
+  !> Master subroutine of eigen -> frequency response analysis                  !
+  !=============================================================================!
+
+  subroutine fstr_eigen_freq_analysis
+    implicit none
+
+    if( IECHO==1 ) call fstr_echo(hecMESH)
+
+    if( fstrDYNAMIC%idx_resp /= 2 ) then
+      if( myrank == 0 ) write(*,*) '###ERROR### !DYNAMIC of EIGENFREQ has to be a frequency response analysis'
+      call hecmw_abort( hecmw_comm_get_comm() )
+    endif
+
+    if(myrank == 0) then
+      write(IMSG,*)
+      write(IMSG,*)
+      write(IMSG,*)
+      write(IMSG,*) ' ***   STAGE Eigen -> Frequency response analysis   **'
+      write(*,*) ' ***   STAGE Eigen -> Frequency response analysis   **'
+      write(IMSG,*)
+      write(IMSG,*) ' ***   Stage 1: Eigenvalue analysis  **'
+      write(*,*) ' ***   Stage 1: Eigenvalue analysis   **'
+    endif
+
+    call fstr_solve_EIGEN( hecMESH, hecMAT, fstrEIG, fstrSOLID, fstrRESULT, fstrPR, hecLagMAT )
+
+    if( len_trim(fstrFREQ%basis_filename) > 0 ) then
+      call fstr_write_modal_basis( hecMESH, fstrEIG, fstrFREQ%basis_filename )
+    endif
+
+    if(myrank == 0) then
+      write(IMSG,*)
+      write(IMSG,*) ' ***   Stage 2: Frequency response analysis  **'
+      write(*,*)
+      write(*,*) ' ***   Stage 2: Frequency response analysis   **'
+    endif
+
+    call fstr_solve_dynamic( hecMESH, hecMAT, fstrSOLID, fstrEIG, &
+      fstrDYNAMIC, fstrRESULT, fstrPR, fstrCPL, fstrFREQ, hecLagMAT, &
+      conMAT )
+
+  end subroutine fstr_eigen_freq_analysis
+
   !=============================================================================!
   !> Finalizer                                                                  !
   !=============================================================================!
@@ -428,6 +478,7 @@ contains
 
     call fstr_solid_finalize( fstrSOLID )
     call hecMAT_finalize( hecMAT )
+    call finalizeShapeTables()
 
     close(ILOG)
     close(IDBG)
@@ -4,6 +4,7 @@
  *****************************************************************************/
 
 #include <stdio.h>
+#include <string.h>
 #include "hecmw_config.h"
 #include "hecmw_comm.h"
 #include "hecmw_util.h"
@@ -481,6 +482,138 @@ error:
 #endif
 }
 
+#ifndef HECMW_SERIAL
+static int get_mpi_datatype(HECMW_Datatype datatype, MPI_Datatype *_datatype) {
+  if (datatype == HECMW_INT) {
+    *_datatype = MPI_INT;
+
+  } else if (datatype == HECMW_DOUBLE) {
+    *_datatype = MPI_DOUBLE;
+
+  } else if (datatype == HECMW_CHAR) {
+    *_datatype = MPI_CHAR;
+
+  } else {
+    HECMW_set_error(HECMW_ALL_E1003, "Invalid data type is found");
+    return -1;
+  }
+
+  return 0;
+}
+#else
+static size_t get_datatype_size(HECMW_Datatype datatype) {
+  if (datatype == HECMW_INT) {
+    return sizeof(int);
+
+  } else if (datatype == HECMW_DOUBLE) {
+    return sizeof(double);
+
+  } else if (datatype == HECMW_CHAR) {
+    return sizeof(char);
+  }
+
+  HECMW_set_error(HECMW_ALL_E1003, "Invalid data type is found");
+  return 0;
+}
+#endif
+
+extern int HECMW_Allgatherv(void *sendbuf, int sendcount,
+                            HECMW_Datatype sendtype, void *recvbuf,
+                            int *recvcounts, int *displs,
+                            HECMW_Datatype recvtype, HECMW_Comm comm) {
+#ifndef HECMW_SERIAL
+  MPI_Datatype _sendtype, _recvtype;
+  int rtc;
+
+  if (get_mpi_datatype(sendtype, &_sendtype)) goto error;
+  if (get_mpi_datatype(recvtype, &_recvtype)) goto error;
+
+  rtc = MPI_Allgatherv(sendbuf, sendcount, _sendtype, recvbuf, recvcounts,
+                       displs, _recvtype, comm);
+
+  if (rtc != MPI_SUCCESS) {
+    HECMW_set_error(HECMW_ALL_E1003, "MPI_Allgatherv");
+    goto error;
+  }
+
+  return 0;
+error:
+  return -1;
+#else
+  size_t size = get_datatype_size(sendtype);
+
+  if (size == 0) return -1;
+  memcpy((char *)recvbuf + size * displs[0], sendbuf, size * sendcount);
+
+  return 0;
+#endif
+}
+
+extern int HECMW_Alltoall(void *sendbuf, int sendcount,
+                          HECMW_Datatype sendtype, void *recvbuf,
+                          int recvcount, HECMW_Datatype recvtype,
+                          HECMW_Comm comm) {
+#ifndef HECMW_SERIAL
+  MPI_Datatype _sendtype, _recvtype;
+  int rtc;
+
+  if (get_mpi_datatype(sendtype, &_sendtype)) goto error;
+  if (get_mpi_datatype(recvtype, &_recvtype)) goto error;
+
+  rtc = MPI_Alltoall(sendbuf, sendcount, _sendtype, recvbuf, recvcount,
+                     _recvtype, comm);
+
+  if (rtc != MPI_SUCCESS) {
+    HECMW_set_error(HECMW_ALL_E1003, "MPI_Alltoall");
+    goto error;
+  }
+
+  return 0;
+error:
+  return -1;
+#else
+  size_t size = get_datatype_size(sendtype);
+
+  if (size == 0) return -1;
+  memcpy(recvbuf, sendbuf, size * sendcount);
+
+  return 0;
+#endif
+}
+
+extern int HECMW_Alltoallv(void *sendbuf, int *sendcounts, int *sdispls,
+                           HECMW_Datatype sendtype, void *recvbuf,
+                           int *recvcounts, int *rdispls,
+                           HECMW_Datatype recvtype, HECMW_Comm comm) {
+#ifndef HECMW_SERIAL
+  MPI_Datatype _sendtype, _recvtype;
+  int rtc;
+
+  if (get_mpi_datatype(sendtype, &_sendtype)) goto error;
+  if (get_mpi_datatype(recvtype, &_recvtype)) goto error;
+
+  rtc = MPI_Alltoallv(sendbuf, sendcounts, sdispls, _sendtype, recvbuf,
+                      recvcounts, rdispls, _recvtype, comm);
+
+  if (rtc != MPI_SUCCESS) {
+    HECMW_set_error(HECMW_ALL_E1003, "MPI_Alltoallv");
+    goto error;
+  }
+
+  return 0;
+error:
+  return -1;
+#else
+  size_t size = get_datatype_size(sendtype);
+
+  if (size == 0) return -1;
+  memcpy((char *)recvbuf + size * rdispls[0],
+         (char *)sendbuf + size * sdispls[0], size * sendcounts[0]);
+
+  return 0;
+#endif
+}
+
 extern int HECMW_Group_incl(HECMW_Group group, int n, int *ranks,
                             HECMW_Group *newgroup) {
 #ifndef HECMW_SERIAL
@@ -37,6 +37,18 @@ extern int HECMW_Allgather(void *sendbuf, int sendcount,
                            HECMW_Datatype sendtype, void *recvbuf,
                            int recvcount, HECMW_Datatype recvtype,
                            HECMW_Comm comm);
+extern int HECMW_Allgatherv(void *sendbuf, int sendcount,
+                            HECMW_Datatype sendtype, void *recvbuf,
+                            int *recvcounts, int *displs,
+                            HECMW_Datatype recvtype, HECMW_Comm comm);
+extern int HECMW_Alltoall(void *sendbuf, int sendcount,
+                          HECMW_Datatype sendtype, void *recvbuf,
+                          int recvcount, HECMW_Datatype recvtype,
+                          HECMW_Comm comm);
+extern int HECMW_Alltoallv(void *sendbuf, int *sendcounts, int *sdispls,
+                           HECMW_Datatype sendtype, void *recvbuf,
+                           int *recvcounts, int *rdispls,
+                           HECMW_Datatype recvtype, HECMW_Comm comm);
 extern int HECMW_Group_incl(HECMW_Group group, int n, int *ranks,
                             HECMW_Group *newgroup);
 extern int HECMW_Group_excl(HECMW_Group group, int n, int *ranks,
@@ -56,6 +56,9 @@ struct result_entry {
   /*#define HECMW_CTRL_FILE_IO_IN 1*/
   /*#define HECMW_CTRL_FILE_IO_OUT 2*/
   int fg_text; /* 1:text(default), 0:binary */
+  int fg_compress; /* 1:compressed binary */
+  int fg_series; /* 1:all steps in one result series file */
+  double tolerance; /* relative error bound of lossy compression, 0:lossless */
   char *filename;
   struct result_entry *next;
 };
@@ -477,7 +480,9 @@ static int add_mesh_group_entry(struct mesh_grp_entry *mesh) {
 }
 
 static struct result_entry *make_result_entry(char *name_ID, int io,
-                                              int fg_text, char *filename) {
+                                              int fg_text, int fg_compress,
+                                              int fg_series, double tolerance,
+                                              char *filename) {
   char *p;
   struct result_entry *result = NULL;
   result                      = HECMW_calloc(1, sizeof(*result));
@@ -487,10 +492,13 @@ static struct result_entry *make_result_entry(char *name_ID, int io,
     goto error;
   }
 
-  result->io      = io;
-  result->fg_text = fg_text;
-  result->next    = NULL;
-  p               = HECMW_strdup(name_ID);
+  result->io          = io;
+  result->fg_text     = fg_text;
+  result->fg_compress = fg_compress;
+  result->fg_series   = fg_series;
+  result->tolerance   = tolerance;
+  result->next        = NULL;
+  p                   = HECMW_strdup(name_ID);
 
   if (p == NULL) {
     HECMW_set_error(errno, "");
@@ -1293,7 +1301,8 @@ static int read_result_param_io(int *io) {
   return 0;
 }
 
-static int read_result_param_type(int *fg_text) {
+static int read_result_param_type(int *fg_text, int *fg_compress,
+                                  int *fg_series) {
   int token;
   char s[HECMW_NAME_LEN + 1];
   char *p;
@@ -1324,21 +1333,55 @@ static int read_result_param_type(int *fg_text) {
 
   *sp = 0;
 
+  *fg_compress = 0;
+  *fg_series   = 0;
+
   if (strcmp(s, "TEXT") == 0) {
     *fg_text = 1;
 
   } else if (strcmp(s, "BINARY") == 0) {
     *fg_text = 0;
 
+  } else if (strcmp(s, "COMPRESSED") == 0) {
+    *fg_text     = 0;
+    *fg_compress = 1;
+
+  } else if (strcmp(s, "SERIES") == 0) {
+    *fg_text   = 0;
+    *fg_series = 1;
+
   } else {
-    set_err(HECMW_UTIL_E0020, "TEXT or BINARY required");
+    set_err(HECMW_UTIL_E0020, "TEXT, BINARY, COMPRESSED or SERIES required");
     return -1;
   }
 
   return 0;
 }
 
-static int read_result_data(char *name, int io, int fg_text) {
+static int read_result_param_tolerance(double *tolerance) {
+  int token;
+  token = HECMW_ctrllex_next_token();
+
+  if (token != '=') {
+    set_err_token(token, HECMW_UTIL_E0020, "'=' required after TOLERANCE");
+    return -1;
+  }
+
+  /* TOLERANCE value */
+  token = HECMW_ctrllex_next_token();
+
+  if ((token != HECMW_CTRLLEX_DOUBLE && token != HECMW_CTRLLEX_INT) ||
+      HECMW_ctrllex_get_number() < 0.0) {
+    set_err_token(token, HECMW_UTIL_E0020, "Invalid TOLERANCE");
+    return -1;
+  }
+
+  *tolerance = HECMW_ctrllex_get_number();
+  return 0;
+}
+
+static int read_result_data(char *name, int io, int fg_text, int fg_compress,
+                            int fg_series, double tolerance) {
   int token;
   char *p;
   struct result_entry *result;
@@ -1357,7 +1400,8 @@ static int read_result_data(char *name, int io, int fg_text) {
   }
 
   /* create */
-  result = make_result_entry(name, io, fg_text, p);
+  result = make_result_entry(name, io, fg_text, fg_compress, fg_series,
+                             tolerance, p);
 
   if (result == NULL) return -1;
 
@@ -1381,6 +1425,9 @@ static int read_result(void) {
   int flag_io   = 0; /* flag for IO */
   int io;
   int fg_text; /* default : text */
+  int fg_compress;
+  int fg_series;
+  double tolerance;
   char name[HECMW_NAME_LEN + 1] = "";
   enum {
     ST_FINISHED,
@@ -1388,8 +1435,11 @@ static int read_result(void) {
     ST_HEADER_LINE_PARAM,
     ST_DATA_LINE,
   };
-  fg_text = 1;
-  state   = ST_HEADER_LINE;
+  fg_text     = 1;
+  fg_compress = 0;
+  fg_series   = 0;
+  tolerance   = 0.0;
+  state       = ST_HEADER_LINE;
 
   while (state != ST_FINISHED) {
     if (state == ST_HEADER_LINE) {
@@ -1414,7 +1464,13 @@ static int read_result(void) {
 
       } else if (token == HECMW_CTRLLEX_K_TYPE) {
         /* option */
-        if (read_result_param_type(&fg_text)) return -1;
+        if (read_result_param_type(&fg_text, &fg_compress, &fg_series))
+          return -1;
+
+      } else if (token == HECMW_CTRLLEX_NAME &&
+                 strcmp(HECMW_ctrllex_get_text(), "TOLERANCE") == 0) {
+        /* option, for TYPE=COMPRESSED */
+        if (read_result_param_tolerance(&tolerance)) return -1;
 
       } else {
         set_err_token(token, HECMW_UTIL_E0020, "Unknown parameter");
@@ -1450,7 +1506,9 @@ static int read_result(void) {
     } else if (state == ST_DATA_LINE) {
       HECMW_assert(flag_name);
 
-      if (read_result_data(name, io, fg_text)) return -1;
+      if (read_result_data(name, io, fg_text, fg_compress, fg_series,
+                           tolerance))
+        return -1;
 
       state = ST_FINISHED;
 
@@ -2338,6 +2396,35 @@ char *HECMW_ctrl_get_result_filebody(char *name_ID) {
   return get_result_filebody(name_ID);
 }
 
+int HECMW_ctrl_get_result_compression(char *name_ID, double *tolerance) {
+  struct result_entry *result;
+
+  result = get_result_entry(name_ID);
+
+  if (result == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0024, "NAME: %s",
+                    name_ID ? name_ID : "Not specified");
+    return -1;
+  }
+
+  *tolerance = result->tolerance;
+  return result->fg_compress;
+}
+
+int HECMW_ctrl_get_result_series(char *name_ID) {
+  struct result_entry *result;
+
+  result = get_result_entry(name_ID);
+
+  if (result == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0024, "NAME: %s",
+                    name_ID ? name_ID : "Not specified");
+    return -1;
+  }
+
+  return result->fg_series;
+}
+
 char *HECMW_ctrl_get_restart_file(char *name_ID) {
   int nrank, myrank, irank;
   char *fname, *retfname;
@@ -65,6 +65,9 @@ extern char *HECMW_ctrl_get_result_fileheader_sub(char *name_ID,
                                                   int istep, int n_rank,
                                                   int i_rank, int *fg_text);
 extern char *HECMW_ctrl_get_result_filebody(char *name_ID);
+extern int HECMW_ctrl_get_result_compression(char *name_ID,
+                                             double *tolerance);
+extern int HECMW_ctrl_get_result_series(char *name_ID);
 extern char *HECMW_ctrl_get_restart_file(char *name_ID);
 extern char *HECMW_ctrl_get_restart_file_by_io(int io);
 extern char *HECMW_ctrl_get_control_file(char *name_ID);
@@ -5,10 +5,16 @@
 
 #include "hecmw_finalize.h"
 #include "hecmw_util.h"
+#include "hecmw_restart.h"
+#include "hecmw_result.h"
 
 int HECMW_finalize(void) {
   HECMW_log(HECMW_LOG_DEBUG, "Finalizing...");
 
+  HECMW_restart_wait();
+  HECMW_result_cmp_wait();
+  HECMW_result_series_clear();
+
   HECMW_ctrl_finalize();
 
 #ifndef HECMW_SERIAL
@@ -1185,6 +1185,7 @@ static int flag_including = 0;
 static FILE *incfp;
 static char include_filename[HECMW_FILENAME_LEN+1];
 static YY_BUFFER_STATE prev_state;
+static YY_BUFFER_STATE membuf;
 static int flag_header;
 
 static void set_flag_header(int flag);
@@ -3048,7 +3049,13 @@ HECMW_heclex_set_input(FILE *fp)
 {
 	static int first = 1;
 	if(fp == NULL) return -1;
-	if(first) {
+	if(membuf) {
+		yy_delete_buffer(membuf);
+		membuf = NULL;
+		yyin = fp;
+		yy_switch_to_buffer(yy_create_buffer(fp, YY_BUF_SIZE));
+		first = 0;
+	} else if(first) {
 		yyin = fp;
 		first = 0;
 	} else {
@@ -3059,6 +3066,46 @@ HECMW_heclex_set_input(FILE *fp)
 }
 
 
+/*
+ * buf[size-2] and buf[size-1] must be NUL; buf is scanned in place and
+ * must stay alive while it is the input.
+ */
+int
+HECMW_heclex_set_input_buffer(char *buf, size_t size)
+{
+	YY_BUFFER_STATE prev = YY_CURRENT_BUFFER;
+	if(buf == NULL) return -1;
+	if((membuf = yy_scan_buffer(buf, size)) == NULL) return -1;
+	if(prev) yy_delete_buffer(prev);
+	lineno = 1;
+	return 0;
+}
+
+
+/* position of the next character to scan, NULL unless reading a buffer */
+char *
+HECMW_heclex_get_input_pos(void)
+{
+	if(membuf == NULL || flag_including || (yy_c_buf_p) == NULL) return NULL;
+	*(yy_c_buf_p) = (yy_hold_char);
+	return (yy_c_buf_p);
+}
+
+
+/* continue at pos, a line head nline lines after the current position */
+int
+HECMW_heclex_skip_input(char *pos, int nline)
+{
+	if(membuf == NULL || flag_including) return -1;
+	*(yy_c_buf_p) = (yy_hold_char);
+	(yy_c_buf_p) = pos;
+	(yy_hold_char) = *pos;
+	YY_CURRENT_BUFFER->yy_at_bol = 1;
+	lineno += nline;
+	return 0;
+}
+
+
 int
 HECMW_heclex_skip_line(void)
 {
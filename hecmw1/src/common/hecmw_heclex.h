@@ -89,6 +89,12 @@ extern int HECMW_heclex_next_token_skip(int skip_token);
 
 extern int HECMW_heclex_set_input(FILE *fp);
 
+extern int HECMW_heclex_set_input_buffer(char *buf, size_t size);
+
+extern char *HECMW_heclex_get_input_pos(void);
+
+extern int HECMW_heclex_skip_input(char *pos, int nline);
+
 extern int HECMW_heclex_skip_line(void);
 
 extern int HECMW_heclex_switch_to_include(const char *filename);
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
 #include "hecmw_util.h"
 #include "hecmw_ablex.h"
 #include "hecmw_io_abaqus.h"
@@ -20,12 +21,16 @@
 #include "hecmw_path.h"
 #include "hecmw_conn_conv.h"
 #include "hecmw_map_int.h"
+#include "hecmw_io_bulk.h"
 
 /*----------------------------------------------------------------------------*/
 
 static char grid_filename[HECMW_FILENAME_LEN + 1]    = "Unknown";
 static char include_filename[HECMW_FILENAME_LEN + 1] = "Unknown";
 
+/* end of the mesh file read into memory by HECMW_read_abaqus_mesh */
+static char *input_end = NULL;
+
 /*----------------------------------------------------------------------------*/
 
 static void do_logging(int loglv, int msgno, int add_location, const char *fmt,
@@ -487,6 +492,28 @@ error:
   ReadFunc
 */
 
+/*----------------------------------------------------------------------------*/
+/*  bulk data lines of *NODE and *ELEMENT                                     */
+/*----------------------------------------------------------------------------*/
+
+static int bulk_is_comment(const char *p) { return p[0] == '*' && p[1] == '*'; }
+
+static int bulk_node_line(const char *p, const char *eol, int *ival,
+                          double *dval, void *arg) {
+  if (bulk_is_comment(p)) return HECMW_IO_BULK_SKIP;
+  if (HECMW_io_bulk_scan_node(p, eol, ival, dval)) return -1;
+  return HECMW_IO_BULK_REC;
+}
+
+static int bulk_elem_line(const char *p, const char *eol, int *ival,
+                          double *dval, void *arg) {
+  if (bulk_is_comment(p)) return HECMW_IO_BULK_SKIP;
+  if (HECMW_io_bulk_scan_elem(p, eol, *(int *)arg, 1, ival)) return -1;
+  return HECMW_IO_BULK_REC;
+}
+
+/*----------------------------------------------------------------------------*/
+
 static int read_input(int msgno_invalid_token) {
   int token;
   char *p;
@@ -1272,6 +1299,67 @@ static int read_element_data(int *id, int nnode, int *node) {
   return 0;
 }
 
+/*
+ * Read all data lines of the block at once. Returns 1 if they have to be
+ * read token by token instead.
+ */
+static int read_element_bulk(int type, int hecmw_etype, int nnode,
+                             int flag_elset, char *elset) {
+  struct hecmw_io_bulk bulk;
+  char *p, *q;
+  int nline, rtc;
+  size_t i;
+
+  if ((p = HECMW_ablex_get_input_pos()) == NULL) return 1;
+  q   = (char *)HECMW_io_bulk_block_end(p, input_end, '*', &nline);
+  rtc = HECMW_io_bulk_parse(p, q, nnode + 1, 0, bulk_elem_line, &nnode, &bulk);
+  if (rtc) return rtc;
+  if (bulk.n == 0 || bulk.n > INT_MAX) {
+    HECMW_io_bulk_free(&bulk);
+    return 1;
+  }
+
+  if (elem_secopt == NULL) {
+    elem_secopt =
+        (struct hecmw_map_int *)HECMW_malloc(sizeof(struct hecmw_map_int));
+    if (elem_secopt == NULL || HECMW_map_int_init(elem_secopt, free_Integer)) {
+      HECMW_io_bulk_free(&bulk);
+      return -1;
+    }
+  }
+
+  for (i = 0; i < bulk.n; i++) {
+    int *rec = bulk.ival + (size_t)(nnode + 1) * i;
+    Integer *secopt;
+
+    if (HECMW_convert_connectivity(HECMW_CONNTYPE_ABAQUS, hecmw_etype,
+                                   rec + 1))
+      break;
+    if (HECMW_io_add_elem(rec[0], hecmw_etype, rec + 1, 0, NULL) == NULL)
+      break;
+
+    secopt = HECMW_malloc(sizeof(*secopt));
+    if (secopt == NULL) {
+      set_err(errno, "");
+      break;
+    }
+    secopt->i = get_secopt_abaqus(type);
+    HECMW_assert(secopt->i != -1);
+    if (HECMW_map_int_add(elem_secopt, rec[0], secopt) < 0) break;
+
+    /* collect the IDs in front; slot i belongs to a record already added */
+    bulk.ival[i] = rec[0];
+  }
+  if (i < bulk.n || HECMW_io_add_egrp("ALL", (int)bulk.n, bulk.ival) < 0 ||
+      (flag_elset && HECMW_io_add_egrp(elset, (int)bulk.n, bulk.ival) < 0)) {
+    HECMW_io_bulk_free(&bulk);
+    return -1;
+  }
+  HECMW_io_bulk_free(&bulk);
+
+  return HECMW_ablex_skip_input(q, nline);
+}
+
 static int read_element(void) {
   int token, state;
   int id;
@@ -1288,6 +1376,7 @@ static int read_element(void) {
     ST_KEYWORD_LINE,
     ST_KEYWORD_LINE_PARAM,
     ST_DATA_INCLUDE,
+    ST_DATA_BULK,
     ST_DATA_LINE,
     ST_DATA_LINE_REGIST
   };
@@ -1329,7 +1418,7 @@ static int read_element(void) {
           set_err(HECMW_IO_ABAQUS_E0606, "");
           return -1;
         }
-        state = flag_input ? ST_DATA_INCLUDE : ST_DATA_LINE;
+        state = flag_input ? ST_DATA_INCLUDE : ST_DATA_BULK;
       } else if (token == ',') {
         ; /* continue this state */
       } else {
@@ -1341,6 +1430,10 @@ static int read_element(void) {
       HECMW_assert(flag_type);
       if (HECMW_ablex_switch_to_include(include_filename)) return -1;
       state = ST_DATA_LINE;
+    } else if (state == ST_DATA_BULK) {
+      int rtc = read_element_bulk(type, hecmw_etype, nnode, flag_elset, elset);
+      if (rtc < 0) return -1;
+      state = rtc ? ST_DATA_LINE : ST_FINISHED;
     } else if (state == ST_DATA_LINE) {
       HECMW_assert(flag_type);
       if (read_element_data(&id, nnode, node)) return -1;
@@ -2981,6 +3074,40 @@ static int read_node_data_system(int system, double *x, double *y, double *z) {
   return 0;
 }
 
+/*
+ * Read all data lines of the block at once. Returns 1 if they have to be
+ * read token by token instead.
+ */
+static int read_node_bulk(int system, int flag_nset, char *nset) {
+  struct hecmw_io_bulk bulk;
+  char *p, *q;
+  int nline, rtc;
+  size_t i;
+
+  if ((p = HECMW_ablex_get_input_pos()) == NULL) return 1;
+  q   = (char *)HECMW_io_bulk_block_end(p, input_end, '*', &nline);
+  rtc = HECMW_io_bulk_parse(p, q, 1, 3, bulk_node_line, NULL, &bulk);
+  if (rtc) return rtc;
+  if (bulk.n == 0 || bulk.n > INT_MAX) {
+    HECMW_io_bulk_free(&bulk);
+    return 1;
+  }
+
+  for (i = 0; i < bulk.n; i++) {
+    double *x = bulk.dval + 3 * i;
+    if (read_node_data_system(system, &x[0], &x[1], &x[2])) break;
+    if (HECMW_io_add_node(bulk.ival[i], x[0], x[1], x[2]) == NULL) break;
+  }
+  if (i < bulk.n || HECMW_io_add_ngrp("ALL", (int)bulk.n, bulk.ival) < 0 ||
+      (flag_nset && HECMW_io_add_ngrp(nset, (int)bulk.n, bulk.ival) < 0)) {
+    HECMW_io_bulk_free(&bulk);
+    return -1;
+  }
+  HECMW_io_bulk_free(&bulk);
+
+  return HECMW_ablex_skip_input(q, nline);
+}
+
 static int read_node(void) {
   int token, state;
   int system = 'R'; /* C:cylindrical coordinates, R:cartesian coordinates */
@@ -2994,6 +3121,7 @@ static int read_node(void) {
     ST_KEYWORD_LINE,
     ST_KEYWORD_LINE_PARAM,
     ST_DATA_INCLUDE,
+    ST_DATA_BULK,
     ST_DATA_LINE
   };
 
@@ -3002,7 +3130,7 @@ static int read_node(void) {
     if (state == ST_KEYWORD_LINE) {
       if (read_node_keyword(&token)) return -1;
       if (token == HECMW_ABLEX_NL) {
-        state = ST_DATA_LINE;
+        state = ST_DATA_BULK;
       } else if (token == ',') {
         state = ST_KEYWORD_LINE_PARAM;
       } else {
@@ -3032,7 +3160,7 @@ static int read_node(void) {
       /* check next parameter */
       token = HECMW_ablex_next_token();
       if (token == HECMW_ABLEX_NL) {
-        state = flag_input ? ST_DATA_INCLUDE : ST_DATA_LINE;
+        state = flag_input ? ST_DATA_INCLUDE : ST_DATA_BULK;
       } else if (token == ',') {
         ; /* continue this state */
       } else {
@@ -3043,6 +3171,10 @@ static int read_node(void) {
       HECMW_assert(flag_input);
       if (HECMW_ablex_switch_to_include(include_filename)) return -1;
       state = ST_DATA_LINE;
+    } else if (state == ST_DATA_BULK) {
+      int rtc = read_node_bulk(system, flag_nset, nset);
+      if (rtc < 0) return -1;
+      state = rtc ? ST_DATA_LINE : ST_FINISHED;
     } else if (state == ST_DATA_LINE) {
       int id;
       double x, y, z;
@@ -4279,7 +4411,9 @@ static int post_abaqus(void) {
 
 /* read only. Not make hecmwST_local_mesh */
 int HECMW_read_abaqus_mesh(const char *filename) {
-  FILE *fp;
+  char *buf;
+  size_t size;
+  int rtc;
 
   HECMW_log(HECMW_LOG_DEBUG, "Start to read ABAQUS mesh");
 
@@ -4298,22 +4432,24 @@ int HECMW_read_abaqus_mesh(const char *filename) {
   strcpy(grid_filename, filename);
   HECMW_io_set_gridfile(grid_filename);
 
-  if ((fp = fopen(filename, "r")) == NULL) {
+  /* the lexer scans the file in memory, bulk data are parsed in parallel */
+  if ((buf = HECMW_io_bulk_load(filename, &size)) == NULL) {
     set_err_noloc(HECMW_IO_ABAQUS_E0001, "File: %s, %s", filename,
                   strerror(errno));
     return -1;
   }
+  input_end = buf + size - 2;
 
-  if (HECMW_ablex_set_input(fp)) return -1;
-
-  HECMW_log(HECMW_LOG_DEBUG, "Parsing...");
-  if (parse()) {
-    return -1;
+  if (HECMW_ablex_set_input_buffer(buf, size)) {
+    rtc = -1;
+  } else {
+    HECMW_log(HECMW_LOG_DEBUG, "Parsing...");
+    rtc = parse();
   }
 
-  if (fclose(fp)) {
-    set_err_noloc(HECMW_IO_ABAQUS_E0002, "File: %s, %s", filename,
-                  strerror(errno));
+  HECMW_free(buf);
+  input_end = NULL;
+  if (rtc) {
     return -1;
   }
 
@@ -0,0 +1,304 @@
+/*****************************************************************************
+ * Copyright (c) 2019 FrontISTR Commons
+ * This software is released under the MIT License, see LICENSE.txt
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "hecmw_util.h"
+#include "hecmw_io_bulk.h"
+
+/* smallest chunk handed to a thread */
+#define BULK_MIN_CHUNK (1 << 20)
+
+char *HECMW_io_bulk_load(const char *filename, size_t *size) {
+  FILE *fp;
+  char *buf;
+  long len;
+
+  if ((fp = fopen(filename, "rb")) == NULL) return NULL;
+  if (fseek(fp, 0L, SEEK_END) || (len = ftell(fp)) < 0 ||
+      fseek(fp, 0L, SEEK_SET)) {
+    fclose(fp);
+    return NULL;
+  }
+  if ((buf = HECMW_malloc((size_t)len + 3)) == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+  if (len > 0 && fread(buf, (size_t)len, 1, fp) != 1) {
+    if (!ferror(fp)) errno = EIO;
+    HECMW_free(buf);
+    fclose(fp);
+    return NULL;
+  }
+  fclose(fp);
+
+  /* make the last line complete; the two NULs terminate a flex buffer */
+  buf[len]     = '\n';
+  buf[len + 1] = '\0';
+  buf[len + 2] = '\0';
+  *size        = (size_t)len + 3;
+  return buf;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const char *skip_blank(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t')) p++;
+  return p;
+}
+
+int HECMW_io_bulk_scan_int(const char **p, const char *end, int *val) {
+  const char *q = skip_blank(*p, end);
+  long v        = 0;
+  int neg       = 0;
+  int ndigit    = 0;
+
+  if (q < end && (*q == '+' || *q == '-')) {
+    neg = (*q == '-');
+    q++;
+  }
+  while (q < end && *q >= '0' && *q <= '9') {
+    v = v * 10 + (*q - '0');
+    if (v > 2147483647L) return -1;
+    q++;
+    ndigit++;
+  }
+  if (ndigit == 0) return -1;
+  /* not an integer, e.g. 1.0 or 1e3 */
+  if (q < end && (*q == '.' || *q == 'e' || *q == 'E')) return -1;
+  *val = (int)(neg ? -v : v);
+  *p   = q;
+  return 0;
+}
+
+/*
+ * Only the plain decimal notation of the mesh readers is accepted; the
+ * conversion itself is left to strtod so that values are bit-identical to
+ * those of the lexers.
+ */
+int HECMW_io_bulk_scan_double(const char **p, const char *end, double *val) {
+  const char *q = skip_blank(*p, end);
+  const char *s = q;
+  char *e;
+  int ndigit = 0;
+
+  if (q < end && (*q == '+' || *q == '-')) q++;
+  while (q < end && *q >= '0' && *q <= '9') {
+    q++;
+    ndigit++;
+  }
+  if (q < end && *q == '.') {
+    q++;
+    while (q < end && *q >= '0' && *q <= '9') {
+      q++;
+      ndigit++;
+    }
+  }
+  if (ndigit == 0) return -1;
+  if (q < end && (*q == 'e' || *q == 'E')) {
+    q++;
+    if (q < end && (*q == '+' || *q == '-')) q++;
+    if (q >= end || *q < '0' || *q > '9') return -1;
+    while (q < end && *q >= '0' && *q <= '9') q++;
+  }
+  *val = strtod(s, &e);
+  if (e != q) return -1;
+  *p = q;
+  return 0;
+}
+
+int HECMW_io_bulk_scan_char(const char **p, const char *end, int c) {
+  const char *q = skip_blank(*p, end);
+
+  if (q >= end || *q != c) return -1;
+  *p = q + 1;
+  return 0;
+}
+
+int HECMW_io_bulk_is_eol(const char *p, const char *end) {
+  p = skip_blank(p, end);
+  if (p < end && *p == '\r') p++;
+  return p >= end;
+}
+
+const char *HECMW_io_bulk_next_line(const char *p, const char *end) {
+  const char *q = memchr(p, '\n', end - p);
+  return q ? q + 1 : end;
+}
+
+const char *HECMW_io_bulk_block_end(const char *p, const char *end,
+                                    int key, int *nline) {
+  int n = 0;
+
+  while (p < end) {
+    const char *next = HECMW_io_bulk_next_line(p, end);
+    const char *eol  = next > p && next[-1] == '\n' ? next - 1 : next;
+    if (HECMW_io_bulk_is_eol(p, eol)) break;
+    if (p[0] == key && p[1] != key) break;
+    p = next;
+    n++;
+  }
+  *nline = n;
+  return p;
+}
+
+int HECMW_io_bulk_scan_node(const char *p, const char *eol, int *id,
+                            double *xyz) {
+  int k;
+
+  if (HECMW_io_bulk_scan_int(&p, eol, id) || *id <= 0) return -1;
+  if (HECMW_io_bulk_scan_char(&p, eol, ',')) return -1;
+
+  xyz[0] = xyz[1] = xyz[2] = 0.0;
+  for (k = 0; k < 3; k++) {
+    if (HECMW_io_bulk_is_eol(p, eol)) break;
+    if (HECMW_io_bulk_scan_double(&p, eol, &xyz[k])) return -1;
+    if (HECMW_io_bulk_is_eol(p, eol)) break;
+    if (HECMW_io_bulk_scan_char(&p, eol, ',')) return -1;
+  }
+  return HECMW_io_bulk_is_eol(p, eol) ? 0 : -1;
+}
+
+int HECMW_io_bulk_scan_elem(const char *p, const char *eol, int nnode,
+                            int trailing_comma, int *ival) {
+  int i;
+
+  for (i = 0; i <= nnode; i++) {
+    if (i > 0 && HECMW_io_bulk_scan_char(&p, eol, ',')) return -1;
+    if (HECMW_io_bulk_scan_int(&p, eol, &ival[i]) || ival[i] <= 0) return -1;
+  }
+  if (trailing_comma) HECMW_io_bulk_scan_char(&p, eol, ',');
+  return HECMW_io_bulk_is_eol(p, eol) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static const char *chunk_begin(const char *begin, const char *end, int ic,
+                               int nchunk) {
+  const char *p;
+
+  if (ic == 0) return begin;
+  if (ic == nchunk) return end;
+  p = begin + (size_t)(end - begin) / nchunk * ic;
+  return HECMW_io_bulk_next_line(p - 1, end);
+}
+
+static size_t count_lines(const char *p, const char *end) {
+  size_t n = 0;
+
+  while (p < end) {
+    p = HECMW_io_bulk_next_line(p, end);
+    n++;
+  }
+  return n;
+}
+
+int HECMW_io_bulk_parse(const char *begin, const char *end, int ni, int nd,
+                        HECMW_io_bulk_line_func func, void *arg,
+                        struct hecmw_io_bulk *bulk) {
+  size_t *offset, *nrec, nline, n;
+  int nchunk = 1;
+  int ic, bad = 0;
+
+  bulk->n    = 0;
+  bulk->ni   = ni;
+  bulk->nd   = nd;
+  bulk->ival = NULL;
+  bulk->dval = NULL;
+
+#ifdef _OPENMP
+  nchunk = omp_get_max_threads();
+#endif
+  if ((size_t)(end - begin) / BULK_MIN_CHUNK + 1 < (size_t)nchunk)
+    nchunk = (int)((size_t)(end - begin) / BULK_MIN_CHUNK + 1);
+
+  offset = HECMW_calloc(nchunk + 1, sizeof(*offset));
+  nrec   = HECMW_calloc(nchunk, sizeof(*nrec));
+  if (offset == NULL || nrec == NULL) {
+    HECMW_set_error(errno, "");
+    HECMW_free(offset);
+    HECMW_free(nrec);
+    return -1;
+  }
+
+  /* lines per chunk give the slots of each chunk in the output arrays */
+#pragma omp parallel for schedule(static, 1)
+  for (ic = 0; ic < nchunk; ic++) {
+    offset[ic + 1] = count_lines(chunk_begin(begin, end, ic, nchunk),
+                                 chunk_begin(begin, end, ic + 1, nchunk));
+  }
+  for (ic = 0; ic < nchunk; ic++) offset[ic + 1] += offset[ic];
+  nline = offset[nchunk];
+
+  if (nline > 0) {
+    bulk->ival = HECMW_malloc(sizeof(int) * (ni > 0 ? ni : 1) * nline);
+    bulk->dval = HECMW_malloc(sizeof(double) * (nd > 0 ? nd : 1) * nline);
+    if (bulk->ival == NULL || bulk->dval == NULL) {
+      HECMW_set_error(errno, "");
+      HECMW_io_bulk_free(bulk);
+      HECMW_free(offset);
+      HECMW_free(nrec);
+      return -1;
+    }
+  }
+
+#pragma omp parallel for schedule(static, 1) reduction(+ : bad)
+  for (ic = 0; ic < nchunk; ic++) {
+    const char *p   = chunk_begin(begin, end, ic, nchunk);
+    const char *q   = chunk_begin(begin, end, ic + 1, nchunk);
+    int *ival       = bulk->ival + (size_t)ni * offset[ic];
+    double *dval    = bulk->dval + (size_t)nd * offset[ic];
+    size_t k        = 0;
+    while (p < q) {
+      const char *next = HECMW_io_bulk_next_line(p, q);
+      const char *eol  = next > p && next[-1] == '\n' ? next - 1 : next;
+      int rtc = func(p, eol, ival + (size_t)ni * k, dval + (size_t)nd * k, arg);
+      if (rtc < 0) {
+        bad++;
+        break;
+      }
+      if (rtc == HECMW_IO_BULK_REC) k++;
+      p = next;
+    }
+    nrec[ic] = k;
+  }
+
+  if (bad) {
+    HECMW_io_bulk_free(bulk);
+    HECMW_free(offset);
+    HECMW_free(nrec);
+    return 1;
+  }
+
+  /* close the gaps left by skipped lines */
+  n = nrec[0];
+  for (ic = 1; ic < nchunk; ic++) {
+    if (n != offset[ic]) {
+      memmove(bulk->ival + (size_t)ni * n, bulk->ival + (size_t)ni * offset[ic],
+              sizeof(int) * ni * nrec[ic]);
+      memmove(bulk->dval + (size_t)nd * n, bulk->dval + (size_t)nd * offset[ic],
+              sizeof(double) * nd * nrec[ic]);
+    }
+    n += nrec[ic];
+  }
+  bulk->n = n;
+
+  HECMW_free(offset);
+  HECMW_free(nrec);
+  return 0;
+}
+
+void HECMW_io_bulk_free(struct hecmw_io_bulk *bulk) {
+  HECMW_free(bulk->ival);
+  HECMW_free(bulk->dval);
+  bulk->ival = NULL;
+  bulk->dval = NULL;
+  bulk->n    = 0;
+}
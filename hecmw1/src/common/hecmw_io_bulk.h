@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * Copyright (c) 2019 FrontISTR Commons
+ * This software is released under the MIT License, see LICENSE.txt
+ *****************************************************************************/
+
+#ifndef HECMW_IO_BULK_INCLUDED
+#define HECMW_IO_BULK_INCLUDED
+
+#include <stddef.h>
+
+/*
+ * Fast path for the bulk node/element data of mesh input files.
+ * The file is read into memory and a block of data lines is split at line
+ * boundaries into chunks which are parsed in parallel into flat arrays.
+ */
+
+#define HECMW_IO_BULK_SKIP 0 /* line without data (comment etc.) */
+#define HECMW_IO_BULK_REC 1  /* line holds one record */
+
+/*
+ * Parse one line [p, eol) into ival[ni] and dval[nd].
+ * Returns HECMW_IO_BULK_REC, HECMW_IO_BULK_SKIP or -1 if the line has to be
+ * left to the regular reader. Called concurrently from several threads.
+ */
+typedef int (*HECMW_io_bulk_line_func)(const char *p, const char *eol,
+                                       int *ival, double *dval, void *arg);
+
+struct hecmw_io_bulk {
+  size_t n;     /* number of records */
+  int ni;       /* ints per record */
+  int nd;       /* doubles per record */
+  int *ival;    /* ival[n*ni] */
+  double *dval; /* dval[n*nd] */
+};
+
+/*
+ * Whole file followed by "\n\0\0"; *size counts the two NUL bytes.
+ * Returns NULL with errno set on failure.
+ */
+extern char *HECMW_io_bulk_load(const char *filename, size_t *size);
+
+/* Returns 0 on success, 1 if a line cannot be handled, -1 on error */
+extern int HECMW_io_bulk_parse(const char *begin, const char *end, int ni,
+                               int nd, HECMW_io_bulk_line_func func, void *arg,
+                               struct hecmw_io_bulk *bulk);
+
+extern void HECMW_io_bulk_free(struct hecmw_io_bulk *bulk);
+
+/* Number scanners; skip blanks, then advance *p past the item */
+extern int HECMW_io_bulk_scan_int(const char **p, const char *end, int *val);
+
+extern int HECMW_io_bulk_scan_double(const char **p, const char *end,
+                                     double *val);
+
+extern int HECMW_io_bulk_scan_char(const char **p, const char *end, int c);
+
+extern int HECMW_io_bulk_is_eol(const char *p, const char *end);
+
+extern const char *HECMW_io_bulk_next_line(const char *p, const char *end);
+
+/*
+ * Head of the line which ends a block of data lines: a blank line or a
+ * keyword line starting with key (but not with key twice, a comment).
+ * *nline is the number of lines before it.
+ */
+extern const char *HECMW_io_bulk_block_end(const char *p, const char *end,
+                                           int key, int *nline);
+
+/* "ID, X, Y, Z" where trailing coordinates may be omitted (0.0) */
+extern int HECMW_io_bulk_scan_node(const char *p, const char *eol, int *id,
+                                   double *xyz);
+
+/* "ID, N1, ..., Nnnode" into ival[nnode+1], optionally followed by ',' */
+extern int HECMW_io_bulk_scan_elem(const char *p, const char *eol, int nnode,
+                                   int trailing_comma, int *ival);
+
+#endif
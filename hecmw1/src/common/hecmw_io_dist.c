@@ -24,6 +24,147 @@
 #define FILE_MAGIC_LEN (sizeof(FILE_MAGIC) - 1)
 #define HEADER_STRING "!HECMW-DMD-ASCII version="
 
+/*
+ * Binary format (native byte order):
+ *   magic, format version, byte order mark, mesh version
+ *   followed by one record per section:
+ *     section tag, <data in the same order as the ASCII format>, checksum
+ *   Arrays start at 8 byte boundaries from the top of the file so that they
+ *   can be read by one fread or mapped directly; the checksum is Adler-32
+ *   of all bytes of the section after its tag.
+ */
+#define BIN_FILE_MAGIC "!HECMW-DMD-BINARY"
+#define BIN_FILE_MAGIC_LEN (sizeof(BIN_FILE_MAGIC) - 1)
+#define BIN_FORMAT_VERSION 1
+#define BIN_BYTE_ORDER 0x01020304
+#define BIN_ALIGN 8
+
+enum {
+  SECTION_GLOBAL = 1,
+  SECTION_NODE,
+  SECTION_ELEM,
+  SECTION_COMM,
+  SECTION_ADAPT,
+  SECTION_SECT,
+  SECTION_MAT,
+  SECTION_MPC,
+  SECTION_AMP,
+  SECTION_NODE_GRP,
+  SECTION_ELEM_GRP,
+  SECTION_SURF_GRP,
+  SECTION_REFINE,
+  SECTION_CONTACT
+};
+
+static int put_format = HECMW_DIST_FORMAT_ASCII;
+
+/* state of the file being read or written */
+static int is_binary = 0;
+static long bin_offset;
+static unsigned long bin_sum_a, bin_sum_b;
+
+extern void HECMW_set_dist_mesh_format(int format) { put_format = format; }
+
+/*                                                                            */
+/*  binary I/O                                                                */
+/*                                                                            */
+
+static void bin_sum_update(const void *data, size_t size) {
+  const unsigned char *p = data;
+  unsigned long a = bin_sum_a, b = bin_sum_b;
+
+  while (size > 0) {
+    size_t n = size < 5552 ? size : 5552; /* no overflow before modulo */
+    size -= n;
+    while (n--) {
+      a += *p++;
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+  }
+  bin_sum_a = a;
+  bin_sum_b = b;
+}
+
+static int bin_read(void *ptr, size_t size, FILE *fp) {
+  if (size == 0) return 0;
+  if (fread(ptr, size, 1, fp) != 1) {
+    HECMW_set_error(feof(fp) ? HECMW_IO_E5003 : HECMW_IO_E5004, "");
+    return -1;
+  }
+  bin_offset += size;
+  bin_sum_update(ptr, size);
+  return 0;
+}
+
+static int bin_write(const void *ptr, size_t size, FILE *fp) {
+  if (size == 0) return 0;
+  if (fwrite(ptr, size, 1, fp) != 1) {
+    HECMW_set_error(HECMW_IO_E5004, "");
+    return -1;
+  }
+  bin_offset += size;
+  bin_sum_update(ptr, size);
+  return 0;
+}
+
+static int bin_read_pad(FILE *fp) {
+  char pad[BIN_ALIGN];
+  return bin_read(pad, (BIN_ALIGN - bin_offset % BIN_ALIGN) % BIN_ALIGN, fp);
+}
+
+static int bin_write_pad(FILE *fp) {
+  static const char pad[BIN_ALIGN] = {0};
+  return bin_write(pad, (BIN_ALIGN - bin_offset % BIN_ALIGN) % BIN_ALIGN, fp);
+}
+
+static int get_section_begin(int tag, FILE *fp) {
+  int rtag;
+
+  if (!is_binary) return 0;
+  if (bin_read_pad(fp) || bin_read(&rtag, sizeof(rtag), fp)) return -1;
+  if (rtag != tag) {
+    HECMW_set_error(HECMW_IO_E5004, "section %d expected, found %d", tag,
+                    rtag);
+    return -1;
+  }
+  bin_sum_a = 1;
+  bin_sum_b = 0;
+  return 0;
+}
+
+static int get_section_end(int tag, FILE *fp) {
+  unsigned int sum, rsum;
+
+  if (!is_binary) return 0;
+  if (bin_read_pad(fp)) return -1;
+  sum = (unsigned int)((bin_sum_b << 16) | bin_sum_a);
+  if (bin_read(&rsum, sizeof(rsum), fp)) return -1;
+  if (rsum != sum) {
+    HECMW_set_error(HECMW_IO_E5004, "checksum mismatch in section %d", tag);
+    return -1;
+  }
+  return 0;
+}
+
+static int put_section_begin(int tag, FILE *fp) {
+  if (!is_binary) return 0;
+  if (bin_write_pad(fp) || bin_write(&tag, sizeof(tag), fp)) return -1;
+  bin_sum_a = 1;
+  bin_sum_b = 0;
+  return 0;
+}
+
+static int put_section_end(FILE *fp) {
+  unsigned int sum;
+
+  if (!is_binary) return 0;
+  if (bin_write_pad(fp)) return -1;
+  sum = (unsigned int)((bin_sum_b << 16) | bin_sum_a);
+  return bin_write(&sum, sizeof(sum), fp);
+}
+
 /*                                                                            */
 /*  get data                                                                  */
 /*                                                                            */
@@ -34,6 +175,8 @@
 static int get_int(int *i, FILE *fp) {
   int rtc;
 
+  if (is_binary) return bin_read(i, sizeof(int), fp);
+
   rtc = fscanf(fp, "%d", i);
   if (rtc < 1) {
     HECMW_set_error(HECMW_IO_E5004, "");
@@ -52,6 +195,8 @@ static int get_int(int *i, FILE *fp) {
 static int get_double(double *d, FILE *fp) {
   int rtc;
 
+  if (is_binary) return bin_read(d, sizeof(double), fp);
+
   rtc = fscanf(fp, "%lf", d);
   if (rtc < 1) {
     HECMW_set_error(HECMW_IO_E5004, "");
@@ -70,6 +215,17 @@ static int get_double(double *d, FILE *fp) {
 static int get_string(char *s, int max, FILE *fp) {
   int c, len;
 
+  if (is_binary) {
+    if (bin_read(&len, sizeof(len), fp)) return -1;
+    if (len < 0 || len >= max) {
+      HECMW_set_error(HECMW_IO_E5004, "line too long");
+      return -1;
+    }
+    if (bin_read(s, len, fp)) return -1;
+    s[len] = '\0';
+    return len;
+  }
+
   while ((c = fgetc(fp)) != EOF && isspace(c))
     ; /* skip */
   if (c == EOF) {
@@ -103,6 +259,8 @@ static int get_string(char *s, int max, FILE *fp) {
 static int get_comm(HECMW_Comm *i, FILE *fp) {
   int rtc;
 
+  if (is_binary) return bin_read((int *)i, sizeof(int), fp);
+
   rtc = fscanf(fp, "%d", (int *)i);
   if (rtc < 1) {
     HECMW_set_error(HECMW_IO_E5004, "");
@@ -121,6 +279,12 @@ static int get_comm(HECMW_Comm *i, FILE *fp) {
 static int get_int_ary(int *ary, int n, FILE *fp) {
   int rtc, i;
 
+  if (is_binary) {
+    if (n <= 0) return 0;
+    if (bin_read_pad(fp)) return -1;
+    return bin_read(ary, sizeof(int) * (size_t)n, fp);
+  }
+
   for (i = 0; i < n; i++) {
     rtc = fscanf(fp, "%d", &ary[i]);
     if (rtc < 1) {
@@ -141,6 +305,12 @@ static int get_int_ary(int *ary, int n, FILE *fp) {
 static int get_double_ary(double *ary, int n, FILE *fp) {
   int rtc, i;
 
+  if (is_binary) {
+    if (n <= 0) return 0;
+    if (bin_read_pad(fp)) return -1;
+    return bin_read(ary, sizeof(double) * (size_t)n, fp);
+  }
+
   for (i = 0; i < n; i++) {
     rtc = fscanf(fp, "%lf", &ary[i]);
     if (rtc < 1) {
@@ -182,16 +352,21 @@ static int get_string_ary(char **ary, int n, FILE *fp) {
 /*                                                                            */
 /*============================================================================*/
 static int is_hecmw_dist_file(FILE *fp) {
-  char filetype[FILE_MAGIC_LEN];
+  char filetype[BIN_FILE_MAGIC_LEN];
 
-  if (fread(filetype, FILE_MAGIC_LEN, 1, fp) != 1) {
+  if (fread(filetype, BIN_FILE_MAGIC_LEN, 1, fp) != 1) {
     HECMW_set_error(HECMW_IO_E5004, "");
     return 0;
   }
+  if (memcmp(filetype, BIN_FILE_MAGIC, BIN_FILE_MAGIC_LEN) == 0) {
+    is_binary = 1;
+    return 1;
+  }
   if (memcmp(filetype, FILE_MAGIC, FILE_MAGIC_LEN)) {
     HECMW_set_error(HECMW_IO_E5005, "Not a HECMW-DIST ASCII file");
     return 0;
   }
+  is_binary = 0;
   return 1;
 }
 
@@ -213,10 +388,30 @@ static int rewind_fp(FILE *fp) {
 /*  get header                                                                */
 /*                                                                            */
 /*============================================================================*/
+static int get_bin_header(FILE *fp) {
+  char magic[BIN_FILE_MAGIC_LEN];
+  int info[3];
+
+  bin_offset = 0;
+  if (bin_read(magic, BIN_FILE_MAGIC_LEN, fp)) return -1;
+  if (bin_read_pad(fp) || bin_read(info, sizeof(info), fp)) return -1;
+  if (info[0] != BIN_FORMAT_VERSION) {
+    HECMW_set_error(HECMW_IO_E5006, "Invalid version");
+    return -1;
+  }
+  if (info[1] != BIN_BYTE_ORDER) {
+    HECMW_set_error(HECMW_IO_E5005, "Byte order of HECMW-DIST file differs");
+    return -1;
+  }
+  return 0;
+}
+
 static int get_header(FILE *fp) {
   char header[HECMW_HEADER_LEN + 1];
   int ver;
 
+  if (is_binary) return get_bin_header(fp);
+
   if (fgets(header, sizeof(header), fp) == NULL) {
     HECMW_set_error(HECMW_IO_E5004, "");
     return -1;
@@ -1671,7 +1866,7 @@ extern struct hecmwST_local_mesh *HECMW_get_dist_mesh(char *fname) {
   }
 
   /* file open */
-  if ((fp = fopen(fname, "r")) == NULL) {
+  if ((fp = fopen(fname, "rb")) == NULL) {
     HECMW_set_error(HECMW_IO_E5001, "File: %s, %s", fname, HECMW_strmsg(errno));
     return NULL;
   }
@@ -1691,59 +1886,87 @@ extern struct hecmwST_local_mesh *HECMW_get_dist_mesh(char *fname) {
     return NULL;
   }
 
-  if (get_global_info(mesh, fp)) {
+  if (get_section_begin(SECTION_GLOBAL, fp) ||
+      get_global_info(mesh, fp) ||
+      get_section_end(SECTION_GLOBAL, fp)) {
     return NULL;
   }
 
-  if (get_node_info(mesh, fp)) {
+  if (get_section_begin(SECTION_NODE, fp) ||
+      get_node_info(mesh, fp) ||
+      get_section_end(SECTION_NODE, fp)) {
     return NULL;
   }
 
-  if (get_elem_info(mesh, fp)) {
+  if (get_section_begin(SECTION_ELEM, fp) ||
+      get_elem_info(mesh, fp) ||
+      get_section_end(SECTION_ELEM, fp)) {
     return NULL;
   }
 
-  if (get_comm_info(mesh, fp)) {
+  if (get_section_begin(SECTION_COMM, fp) ||
+      get_comm_info(mesh, fp) ||
+      get_section_end(SECTION_COMM, fp)) {
     return NULL;
   }
 
-  if (get_adapt_info(mesh, fp)) {
+  if (get_section_begin(SECTION_ADAPT, fp) ||
+      get_adapt_info(mesh, fp) ||
+      get_section_end(SECTION_ADAPT, fp)) {
     return NULL;
   }
 
-  if (get_section_info(mesh->section, fp)) {
+  if (get_section_begin(SECTION_SECT, fp) ||
+      get_section_info(mesh->section, fp) ||
+      get_section_end(SECTION_SECT, fp)) {
     return NULL;
   }
 
-  if (get_material_info(mesh->material, fp)) {
+  if (get_section_begin(SECTION_MAT, fp) ||
+      get_material_info(mesh->material, fp) ||
+      get_section_end(SECTION_MAT, fp)) {
     return NULL;
   }
 
-  if (get_mpc_info(mesh->mpc, fp, mesh->hecmw_flag_version)) {
+  if (get_section_begin(SECTION_MPC, fp) ||
+      get_mpc_info(mesh->mpc, fp, mesh->hecmw_flag_version) ||
+      get_section_end(SECTION_MPC, fp)) {
     return NULL;
   }
 
-  if (get_amp_info(mesh->amp, fp)) {
+  if (get_section_begin(SECTION_AMP, fp) ||
+      get_amp_info(mesh->amp, fp) ||
+      get_section_end(SECTION_AMP, fp)) {
     return NULL;
   }
 
-  if (get_node_group_info(mesh->node_group, fp)) {
+  if (get_section_begin(SECTION_NODE_GRP, fp) ||
+      get_node_group_info(mesh->node_group, fp) ||
+      get_section_end(SECTION_NODE_GRP, fp)) {
     return NULL;
   }
 
-  if (get_elem_group_info(mesh->elem_group, fp)) {
+  if (get_section_begin(SECTION_ELEM_GRP, fp) ||
+      get_elem_group_info(mesh->elem_group, fp) ||
+      get_section_end(SECTION_ELEM_GRP, fp)) {
     return NULL;
   }
 
-  if (get_surf_group_info(mesh->surf_group, fp)) {
+  if (get_section_begin(SECTION_SURF_GRP, fp) ||
+      get_surf_group_info(mesh->surf_group, fp) ||
+      get_section_end(SECTION_SURF_GRP, fp)) {
     return NULL;
   }
 
-  if (get_refine_info(mesh, fp)) {
+  if (get_section_begin(SECTION_REFINE, fp) ||
+      get_refine_info(mesh, fp) ||
+      get_section_end(SECTION_REFINE, fp)) {
     return NULL;
   }
 
-  if (get_contact_info(mesh->contact_pair, fp, mesh->hecmw_flag_version)) {
+  if (get_section_begin(SECTION_CONTACT, fp) ||
+      get_contact_info(mesh->contact_pair, fp, mesh->hecmw_flag_version) ||
+      get_section_end(SECTION_CONTACT, fp)) {
     return NULL;
   }
 
@@ -1772,6 +1995,8 @@ extern struct hecmwST_local_mesh *HECMW_get_dist_mesh(char *fname) {
 static int print_int(int item, FILE *fp) {
   int rtc;
 
+  if (is_binary) return bin_write(&item, sizeof(item), fp);
+
   rtc = fprintf(fp, "%d\n", item);
   if (rtc < 0) {
     HECMW_set_error(HECMW_IO_E5004, "");
@@ -1787,6 +2012,8 @@ static int print_int(int item, FILE *fp) {
 static int print_double(double item, FILE *fp) {
   int rtc;
 
+  if (is_binary) return bin_write(&item, sizeof(item), fp);
+
   rtc = fprintf(fp, "%.16E\n", item);
   if (rtc < 0) {
     HECMW_set_error(HECMW_IO_E5004, "");
@@ -1802,6 +2029,12 @@ static int print_double(double item, FILE *fp) {
 static int print_string(const char *item, FILE *fp) {
   int rtc;
 
+  if (is_binary) {
+    int len = strlen(item);
+    if (bin_write(&len, sizeof(len), fp)) return -1;
+    return bin_write(item, len, fp);
+  }
+
   rtc = fprintf(fp, "%s\n", item);
   if (rtc < 0) {
     HECMW_set_error(HECMW_IO_E5004, "");
@@ -1817,6 +2050,11 @@ static int print_string(const char *item, FILE *fp) {
 static int print_comm(HECMW_Comm item, FILE *fp) {
   int rtc;
 
+  if (is_binary) {
+    int zero = 0;
+    return bin_write(&zero, sizeof(zero), fp);
+  }
+
   /* rtc = fprintf( fp, "%d\n", (int)item ); */
   rtc = fprintf(fp, "%d\n", 0);
   if (rtc < 0) {
@@ -1835,6 +2073,11 @@ static int print_int_ary(const int *ary, int n, int cols, FILE *fp) {
 
   if (n <= 0) return 0;
 
+  if (is_binary) {
+    if (bin_write_pad(fp)) return -1;
+    return bin_write(ary, sizeof(int) * (size_t)n, fp);
+  }
+
   for (i = 0; i < n; i++) {
     rtc = fprintf(fp, "%d%c", ary[i], (i + 1) % cols ? ' ' : '\n');
     if (rtc < 0) {
@@ -1861,6 +2104,11 @@ static int print_double_ary(const double *ary, int n, int cols, FILE *fp) {
 
   if (n <= 0) return 0;
 
+  if (is_binary) {
+    if (bin_write_pad(fp)) return -1;
+    return bin_write(ary, sizeof(double) * (size_t)n, fp);
+  }
+
   for (i = 0; i < n; i++) {
     rtc = fprintf(fp, "%.16E%c", ary[i], (i + 1) % cols ? ' ' : '\n');
     if (rtc < 0) {
@@ -1885,6 +2133,13 @@ static int print_double_ary(const double *ary, int n, int cols, FILE *fp) {
 static int print_string_ary(char **ary, int n, FILE *fp) {
   int rtc, i;
 
+  if (is_binary) {
+    for (i = 0; i < n; i++) {
+      if (print_string(ary[i], fp)) return -1;
+    }
+    return 0;
+  }
+
   for (i = 0; i < n; i++) {
     rtc = fprintf(fp, "%s\n", ary[i]);
     if (rtc < 0) {
@@ -1899,10 +2154,24 @@ static int print_string_ary(char **ary, int n, FILE *fp) {
 /*----------------------------------------------------------------------------*/
 /*  print header                                                              */
 /*----------------------------------------------------------------------------*/
+static int print_bin_header(const struct hecmwST_local_mesh *mesh, FILE *fp) {
+  int info[3];
+
+  info[0]    = BIN_FORMAT_VERSION;
+  info[1]    = BIN_BYTE_ORDER;
+  info[2]    = mesh->hecmw_flag_version;
+  bin_offset = 0;
+  if (bin_write(BIN_FILE_MAGIC, BIN_FILE_MAGIC_LEN, fp)) return -1;
+  if (bin_write_pad(fp)) return -1;
+  return bin_write(info, sizeof(info), fp);
+}
+
 static int print_header(const struct hecmwST_local_mesh *mesh, FILE *fp) {
   int rtc;
   char header[HECMW_HEADER_LEN + 1];
 
+  if (is_binary) return print_bin_header(mesh, fp);
+
   strcpy(header, HEADER_STRING);
   rtc = sprintf(header + strlen(header), "%d", mesh->hecmw_flag_version);
   if (rtc < 0) {
@@ -2779,7 +3048,8 @@ extern int HECMW_put_dist_mesh(const struct hecmwST_local_mesh *mesh,
   }
 
   /* open file */
-  if ((fp = fopen(fname, "w")) == NULL) {
+  is_binary = (put_format == HECMW_DIST_FORMAT_BINARY);
+  if ((fp = fopen(fname, is_binary ? "wb" : "w")) == NULL) {
     HECMW_set_error(HECMW_IO_E5001, "File: %s, %s", fname, strerror(errno));
     return -1;
   }
@@ -2790,72 +3060,100 @@ extern int HECMW_put_dist_mesh(const struct hecmwST_local_mesh *mesh,
   }
 
   /* global info. */
-  if (print_global_info(mesh, fp)) {
+  if (put_section_begin(SECTION_GLOBAL, fp) ||
+      print_global_info(mesh, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* node info. */
-  if (print_node_info(mesh, fp)) {
+  if (put_section_begin(SECTION_NODE, fp) ||
+      print_node_info(mesh, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* element info. */
-  if (print_elem_info(mesh, fp)) {
+  if (put_section_begin(SECTION_ELEM, fp) ||
+      print_elem_info(mesh, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* domain info & communication table */
-  if (print_comm_info(mesh, fp)) {
+  if (put_section_begin(SECTION_COMM, fp) ||
+      print_comm_info(mesh, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* adaptation info. */
-  if (print_adapt_info(mesh, fp)) {
+  if (put_section_begin(SECTION_ADAPT, fp) ||
+      print_adapt_info(mesh, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* section info. */
-  if (print_section_info(mesh->section, fp)) {
+  if (put_section_begin(SECTION_SECT, fp) ||
+      print_section_info(mesh->section, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* material info. */
-  if (print_material_info(mesh->material, fp)) {
+  if (put_section_begin(SECTION_MAT, fp) ||
+      print_material_info(mesh->material, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* MPC group info. */
-  if (print_mpc_info(mesh->mpc, fp)) {
+  if (put_section_begin(SECTION_MPC, fp) ||
+      print_mpc_info(mesh->mpc, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* amplitude info. */
-  if (print_amp_info(mesh->amp, fp)) {
+  if (put_section_begin(SECTION_AMP, fp) ||
+      print_amp_info(mesh->amp, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* node group info. */
-  if (print_node_grp_info(mesh->node_group, fp)) {
+  if (put_section_begin(SECTION_NODE_GRP, fp) ||
+      print_node_grp_info(mesh->node_group, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* element group info. */
-  if (print_elem_grp_info(mesh->elem_group, fp)) {
+  if (put_section_begin(SECTION_ELEM_GRP, fp) ||
+      print_elem_grp_info(mesh->elem_group, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* surface group info */
-  if (print_surf_grp_info(mesh->surf_group, fp)) {
+  if (put_section_begin(SECTION_SURF_GRP, fp) ||
+      print_surf_grp_info(mesh->surf_group, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* refinement info. */
-  if (print_refine_info(mesh, fp)) {
+  if (put_section_begin(SECTION_REFINE, fp) ||
+      print_refine_info(mesh, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
   /* contact info */
-  if (print_contact_info(mesh->contact_pair, fp)) {
+  if (put_section_begin(SECTION_CONTACT, fp) ||
+      print_contact_info(mesh->contact_pair, fp) ||
+      put_section_end(fp)) {
     return -1;
   }
 
@@ -8,9 +8,15 @@
 
 #include "hecmw_struct.h"
 
+#define HECMW_DIST_FORMAT_ASCII 0
+#define HECMW_DIST_FORMAT_BINARY 1
+
 extern struct hecmwST_local_mesh *HECMW_get_dist_mesh(char *fname);
 
 extern int HECMW_put_dist_mesh(const struct hecmwST_local_mesh *mesh,
                                char *fname);
 
+/* format written by HECMW_put_dist_mesh, HECMW_get_dist_mesh reads both */
+extern void HECMW_set_dist_mesh_format(int format);
+
 #endif
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include "hecmw_util.h"
 #include "hecmw_heclex.h"
@@ -20,12 +21,16 @@
 #include "hecmw_common.h"
 #include "hecmw_path.h"
 #include "hecmw_conn_conv.h"
+#include "hecmw_io_bulk.h"
 
 static char grid_filename[HECMW_FILENAME_LEN + 1]    = "Unknown";
 static char include_filename[HECMW_FILENAME_LEN + 1] = "Unknown";
 
 static int connectivity_type = HECMW_CONNTYPE_HECMW;
 
+/* end of the mesh file read into memory by HECMW_read_entire_mesh */
+static char *input_end = NULL;
+
 /*----------------------------------------------------------------------------*/
 
 static void do_logging(int loglv, int msgno, int add_location, const char *fmt,
@@ -109,6 +114,28 @@ static int read_input(int msgno_invalid_token) {
   return 0;
 }
 
+/*----------------------------------------------------------------------------*/
+/*  bulk data lines of !NODE and !ELEMENT                                     */
+/*----------------------------------------------------------------------------*/
+
+static int bulk_is_comment(const char *p) {
+  return p[0] == '#' || (p[0] == '!' && p[1] == '!');
+}
+
+static int bulk_node_line(const char *p, const char *eol, int *ival,
+                          double *dval, void *arg) {
+  if (bulk_is_comment(p)) return HECMW_IO_BULK_SKIP;
+  if (HECMW_io_bulk_scan_node(p, eol, ival, dval)) return -1;
+  return HECMW_IO_BULK_REC;
+}
+
+static int bulk_elem_line(const char *p, const char *eol, int *ival,
+                          double *dval, void *arg) {
+  if (bulk_is_comment(p)) return HECMW_IO_BULK_SKIP;
+  if (HECMW_io_bulk_scan_elem(p, eol, *(int *)arg, 0, ival)) return -1;
+  return HECMW_IO_BULK_REC;
+}
+
 /*----------------------------------------------------------------------------*/
 
 static int read_amp_head(void) {
@@ -1150,6 +1177,42 @@ static int read_elem_data_mat(int nmatitem, double *matitem) {
   return 0;
 }
 
+/*
+ * Read all data lines of the block at once. Returns 1 if they have to be
+ * read token by token instead.
+ */
+static int read_elem_bulk(int type, int nnode, int flag_egrp, char *egrp) {
+  struct hecmw_io_bulk bulk;
+  char *p, *q;
+  int nline, rtc;
+  size_t i;
+
+  if ((p = HECMW_heclex_get_input_pos()) == NULL) return 1;
+  q   = (char *)HECMW_io_bulk_block_end(p, input_end, '!', &nline);
+  rtc = HECMW_io_bulk_parse(p, q, nnode + 1, 0, bulk_elem_line, &nnode, &bulk);
+  if (rtc) return rtc;
+  if (bulk.n == 0 || bulk.n > INT_MAX) {
+    HECMW_io_bulk_free(&bulk);
+    return 1;
+  }
+
+  for (i = 0; i < bulk.n; i++) {
+    int *rec = bulk.ival + (size_t)(nnode + 1) * i;
+    if (HECMW_convert_connectivity(connectivity_type, type, rec + 1)) break;
+    if (HECMW_io_add_elem(rec[0], type, rec + 1, 0, NULL) == NULL) break;
+    /* collect the IDs in front; slot i belongs to a record already added */
+    bulk.ival[i] = rec[0];
+  }
+  if (i < bulk.n || HECMW_io_add_egrp("ALL", (int)bulk.n, bulk.ival) < 0 ||
+      (flag_egrp && HECMW_io_add_egrp(egrp, (int)bulk.n, bulk.ival) < 0)) {
+    HECMW_io_bulk_free(&bulk);
+    return -1;
+  }
+  HECMW_io_bulk_free(&bulk);
+
+  return HECMW_heclex_skip_input(q, nline);
+}
+
 static int read_element(void) {
   int token, state;
   int id;
@@ -1169,6 +1232,7 @@ static int read_element(void) {
     st_header_line_param,
     st_prepare,
     st_data_include,
+    st_data_bulk,         /* read all lines at once */
     st_data_line_conn,    /* read element ID and connectivity */
     st_data_line_matitem, /* read MATITEM */
     st_data_line_regist,
@@ -1248,7 +1312,17 @@ static int read_element(void) {
       }
 
       /* set next state */
-      state = flag_input ? st_data_include : st_data_line_conn;
+      if (flag_input) {
+        state = st_data_include;
+      } else if (flag_matitem) {
+        state = st_data_line_conn;
+      } else {
+        state = st_data_bulk;
+      }
+    } else if (state == st_data_bulk) {
+      int rtc = read_elem_bulk(type, nnode, flag_egrp, egrp);
+      if (rtc < 0) return -1;
+      state = rtc ? st_data_line_conn : st_finalize;
     } else if (state == st_data_include) {
       HECMW_assert(flag_input);
       HECMW_assert(flag_type);
@@ -2944,6 +3018,40 @@ static int read_node_convert_coord(int system, double *x, double *y,
   return 0;
 }
 
+/*
+ * Read all data lines of the block at once. Returns 1 if they have to be
+ * read token by token instead.
+ */
+static int read_node_bulk(int system, int flag_ngrp, char *ngrp) {
+  struct hecmw_io_bulk bulk;
+  char *p, *q;
+  int nline, rtc;
+  size_t i;
+
+  if ((p = HECMW_heclex_get_input_pos()) == NULL) return 1;
+  q   = (char *)HECMW_io_bulk_block_end(p, input_end, '!', &nline);
+  rtc = HECMW_io_bulk_parse(p, q, 1, 3, bulk_node_line, NULL, &bulk);
+  if (rtc) return rtc;
+  if (bulk.n == 0 || bulk.n > INT_MAX) {
+    HECMW_io_bulk_free(&bulk);
+    return 1;
+  }
+
+  for (i = 0; i < bulk.n; i++) {
+    double *x = bulk.dval + 3 * i;
+    if (read_node_convert_coord(system, &x[0], &x[1], &x[2])) break;
+    if (HECMW_io_add_node(bulk.ival[i], x[0], x[1], x[2]) == NULL) break;
+  }
+  if (i < bulk.n || HECMW_io_add_ngrp("ALL", (int)bulk.n, bulk.ival) < 0 ||
+      (flag_ngrp && HECMW_io_add_ngrp(ngrp, (int)bulk.n, bulk.ival) < 0)) {
+    HECMW_io_bulk_free(&bulk);
+    return -1;
+  }
+  HECMW_io_bulk_free(&bulk);
+
+  return HECMW_heclex_skip_input(q, nline);
+}
+
 static int read_node(void) {
   int token, state;
   int system = 'R'; /* C:cylindrical coordinates, R:cartesian coordinates */
@@ -2956,6 +3064,7 @@ static int read_node(void) {
     ST_HEADER_LINE,
     ST_HEADER_LINE_PARAM,
     ST_DATA_INCLUDE,
+    ST_DATA_BULK,
     ST_DATA_LINE
   };
 
@@ -2964,7 +3073,7 @@ static int read_node(void) {
     if (state == ST_HEADER_LINE) {
       if (read_node_head(&token)) return -1;
       if (token == HECMW_HECLEX_NL) {
-        state = ST_DATA_LINE;
+        state = ST_DATA_BULK;
       } else if (token == ',') {
         state = ST_HEADER_LINE_PARAM;
       } else {
@@ -2992,7 +3101,7 @@ static int read_node(void) {
       /* check next parameter */
       token = HECMW_heclex_next_token();
       if (token == HECMW_HECLEX_NL) {
-        state = flag_input ? ST_DATA_INCLUDE : ST_DATA_LINE;
+        state = flag_input ? ST_DATA_INCLUDE : ST_DATA_BULK;
       } else if (token == ',') {
         ; /* continue this state */
       } else {
@@ -3003,6 +3112,10 @@ static int read_node(void) {
       HECMW_assert(flag_input);
       if (HECMW_heclex_switch_to_include(include_filename)) return -1;
       state = ST_DATA_LINE;
+    } else if (state == ST_DATA_BULK) {
+      int rtc = read_node_bulk(system, flag_ngrp, ngrp);
+      if (rtc < 0) return -1;
+      state = rtc ? ST_DATA_LINE : ST_FINISHED;
     } else if (state == ST_DATA_LINE) {
       int id;
       double x, y, z;
@@ -4424,11 +4537,7 @@ static int parse(void) {
 }
 
 /* read only. Not make hecmwST_local_mesh */
-int HECMW_read_entire_mesh(const char *filename) {
-  FILE *fp;
-
-  HECMW_log(HECMW_LOG_DEBUG, "Start to read HECMW-ENTIRE mesh");
-
+static int check_filename(const char *filename) {
   if (filename == NULL) {
     HECMW_set_error(
         HECMW_IO_E0001,
@@ -4441,32 +4550,71 @@ int HECMW_read_entire_mesh(const char *filename) {
     HECMW_set_error(HECMW_IO_E0002, "");
     return -1;
   }
+  return 0;
+}
+
+/* buf holds the mesh data followed by "\n\0\0"; size counts the NUL bytes */
+static int read_buffer(const char *filename, char *buf, size_t size) {
+  int rtc;
 
   strcpy(grid_filename, filename);
   HECMW_io_set_gridfile(grid_filename);
 
-  if ((fp = fopen(filename, "r")) == NULL) {
-    HECMW_set_error(HECMW_IO_HEC_E0001, "File: %s, %s", filename,
-                    strerror(errno));
-    return -1;
-  }
+  input_end = buf + size - 2;
 
-  if (HECMW_heclex_set_input(fp)) return -1;
+  if (HECMW_heclex_set_input_buffer(buf, size)) {
+    rtc = -1;
+  } else {
+    HECMW_log(HECMW_LOG_DEBUG, "Parsing...");
+    rtc = parse();
+  }
 
-  HECMW_log(HECMW_LOG_DEBUG, "Parsing...");
-  if (parse()) {
+  input_end = NULL;
+  if (rtc) {
     return -1;
   }
 
-  if (fclose(fp)) {
-    HECMW_set_error(HECMW_IO_HEC_E0002, "File: %s, %s", filename,
+  strcpy(grid_filename, "Unknown");
+
+  return 0;
+}
+
+int HECMW_read_entire_mesh(const char *filename) {
+  char *buf;
+  size_t size;
+  int rtc;
+
+  HECMW_log(HECMW_LOG_DEBUG, "Start to read HECMW-ENTIRE mesh");
+
+  if (check_filename(filename)) return -1;
+
+  /* the lexer scans the file in memory, bulk data are parsed in parallel */
+  if ((buf = HECMW_io_bulk_load(filename, &size)) == NULL) {
+    HECMW_set_error(HECMW_IO_HEC_E0001, "File: %s, %s", filename,
                     strerror(errno));
     return -1;
   }
 
-  strcpy(grid_filename, "Unknown");
+  rtc = read_buffer(filename, buf, size);
 
-  return 0;
+  HECMW_free(buf);
+
+  return rtc;
+}
+
+int HECMW_read_entire_mesh_buffer(const char *filename, char *buf,
+                                  size_t size) {
+  HECMW_log(HECMW_LOG_DEBUG, "Start to read HECMW-ENTIRE mesh from memory");
+
+  if (check_filename(filename)) return -1;
+
+  if (size < 3 || buf[size - 3] != '\n' || buf[size - 2] != '\0' ||
+      buf[size - 1] != '\0') {
+    HECMW_set_error(HECMW_ALL_E0101, "HECMW_read_entire_mesh_buffer(): buf");
+    return -1;
+  }
+
+  return read_buffer(filename, buf, size);
 }
 
 struct hecmwST_local_mesh *HECMW_get_entire_mesh(const char *filename) {
@@ -4484,3 +4632,19 @@ struct hecmwST_local_mesh *HECMW_get_entire_mesh(const char *filename) {
 
   return local_mesh;
 }
+
+struct hecmwST_local_mesh *HECMW_get_entire_mesh_buffer(const char *filename,
+                                                        char *buf,
+                                                        size_t size) {
+  struct hecmwST_local_mesh *local_mesh;
+
+  if (HECMW_io_init()) return NULL;
+  if (HECMW_io_pre_process()) return NULL;
+  if (HECMW_read_entire_mesh_buffer(filename, buf, size)) return NULL;
+  if (HECMW_io_post_process()) return NULL;
+  local_mesh = HECMW_io_make_local_mesh();
+  if (local_mesh == NULL) return NULL;
+  if (HECMW_io_finalize()) return NULL;
+
+  return local_mesh;
+}
@@ -13,4 +13,14 @@ extern int HECMW_read_entire_mesh(const char *filename);
 
 extern struct hecmwST_local_mesh *HECMW_get_entire_mesh(const char *filename);
 
+/*
+ * Same as above for mesh data already in memory: buf holds the contents of
+ * filename followed by "\n\0\0", and size counts the two NUL bytes.
+ */
+extern int HECMW_read_entire_mesh_buffer(const char *filename, char *buf,
+                                         size_t size);
+
+extern struct hecmwST_local_mesh *HECMW_get_entire_mesh_buffer(
+    const char *filename, char *buf, size_t size);
+
 #endif
@@ -46,6 +46,9 @@ static struct hecmw_io_contact *_contact;
 
 static char grid_filename[HECMW_FILENAME_LEN + 1] = "Unknown";
 
+/* the mesh read is a part of a larger one, see HECMW_io_set_partial_mesh() */
+static int is_partial_mesh = 0;
+
 /*----------------------------------------------------------------------------*/
 
 static void do_logging(int loglv, int msgno, const char *fmt, va_list ap) {
@@ -626,6 +629,8 @@ int HECMW_io_set_gridfile(char *gridfile) {
   return 0;
 }
 
+void HECMW_io_set_partial_mesh(int flag) { is_partial_mesh = flag ? 1 : 0; }
+
 struct hecmw_io_amplitude *HECMW_io_add_amp(const char *name, int definition,
                                             int time, int value, double val,
                                             double t) {
@@ -1192,7 +1197,7 @@ static int HECMW_io_remove_node_in_ngrp(int node) {
   q = NULL;
   for (p = _ngrp; p; p = next) {
     HECMW_set_int_del(p->node, node);
-    if (HECMW_set_int_is_empty(p->node)) {
+    if (HECMW_set_int_is_empty(p->node) && !is_partial_mesh) {
       /* no node in this group */
       if (q == NULL) {
         _ngrp = p->next;
@@ -3239,7 +3244,8 @@ static int post_ngrp(void) {
     HECMW_set_int_iter_init(p->node);
     for (i = 0; HECMW_set_int_iter_next(p->node, &id); i++) {
       if (HECMW_io_get_node(id) == NULL) {
-        set_warn(HECMW_IO_W1005, "Node %d doesn't exist", id);
+        if (!is_partial_mesh)
+          set_warn(HECMW_IO_W1005, "Node %d doesn't exist", id);
         HECMW_set_int_del(p->node, id);
       }
     }
@@ -3260,7 +3266,8 @@ static int post_egrp(void) {
     HECMW_set_int_iter_init(p->elem);
     for (i = 0; HECMW_set_int_iter_next(p->elem, &id); i++) {
       if (HECMW_io_get_elem(id) == NULL) {
-        set_warn(HECMW_IO_W1002, "Element %d doesn't exist", id);
+        if (!is_partial_mesh)
+          set_warn(HECMW_IO_W1002, "Element %d doesn't exist", id);
         HECMW_set_int_del(p->elem, id);
       }
     }
@@ -3288,7 +3295,8 @@ static int post_sgrp(void) {
       /* check element */
       element = HECMW_io_get_elem(eid);
       if (element == NULL) {
-        set_warn(HECMW_IO_W1007, "Element %d doesn't exist", eid);
+        if (!is_partial_mesh)
+          set_warn(HECMW_IO_W1007, "Element %d doesn't exist", eid);
         HECMW_set_int_del(p->item, id);
         continue;
       }
@@ -23,6 +23,13 @@ extern int HECMW_io_free_all(void);
 
 extern int HECMW_io_set_gridfile(char *gridfile);
 
+/*
+ * Nonzero if the mesh read hereafter is a part of a larger mesh: group
+ * members outside of the part are dropped without warnings, and node groups
+ * left without nodes are kept.
+ */
+extern void HECMW_io_set_partial_mesh(int flag);
+
 extern struct hecmw_io_amplitude *HECMW_io_add_amp(const char *name,
                                                    int definition, int time,
                                                    int value, double val,
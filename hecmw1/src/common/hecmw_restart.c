@@ -6,36 +6,187 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
 #include <errno.h>
+#ifdef HECMW_WITH_PTHREAD
+#include <pthread.h>
+#endif
 #include "hecmw_util.h"
 #include "hecmw_config.h"
 #include "hecmw_restart.h"
 
-struct restart_list {
-  void *data;
-  size_t size;
-  struct restart_list *next;
+/*
+ * Records added by HECMW_restart_add* are packed into one contiguous staging
+ * buffer as (size_t size, data) pairs, i.e. exactly the layout of the restart
+ * file, so that a checkpoint is written by a single fwrite.
+ */
+struct restart_buffer {
+  char *data;
+  size_t len;
+  size_t cap;
+};
+
+/* checkpoint handed over to the writer */
+struct restart_job {
+  struct restart_buffer buf;
+  char *filename;
+  int n_keep;
+  int status;
+  char errmsg[HECMW_MSG_LEN + 1];
 };
 
-static struct restart_list *first_list = NULL;
-static struct restart_list *previ_list = NULL;
+static struct restart_buffer stage = {NULL, 0, 0};
 static FILE *restart_fp;
 
+static int restart_async  = 0; /* write checkpoints in the background */
+static int restart_n_keep = 1; /* number of checkpoint generations kept */
+
+#ifdef HECMW_WITH_PTHREAD
+static pthread_t writer_thread;
+static int writer_running = 0;
+#endif
+static struct restart_job *pending_job = NULL;
+
 static void clear(void) {
-  struct restart_list *p, *q;
+  HECMW_free(stage.data);
+  stage.data = NULL;
+  stage.len  = 0;
+  stage.cap  = 0;
+}
+
+static int stage_append(const void *data, size_t size) {
+  size_t need = stage.len + sizeof(size) + size;
+
+  if (need > stage.cap) {
+    size_t cap = stage.cap ? stage.cap : 4096;
+    char *p;
+    while (cap < need) cap *= 2;
+    p = HECMW_realloc(stage.data, cap);
+    if (p == NULL) {
+      HECMW_set_error(errno, "");
+      return -1;
+    }
+    stage.data = p;
+    stage.cap  = cap;
+  }
+  memcpy(stage.data + stage.len, &size, sizeof(size));
+  stage.len += sizeof(size);
+  if (size > 0) memcpy(stage.data + stage.len, data, size);
+  stage.len += size;
+  return 0;
+}
+
+static void free_job(struct restart_job *job) {
+  if (job == NULL) return;
+  HECMW_free(job->buf.data);
+  HECMW_free(job->filename);
+  HECMW_free(job);
+}
+
+static int replace_file(const char *from, const char *to) {
+  if (rename(from, to) == 0) return 0;
+  /* rename() does not overwrite on some platforms */
+  remove(to);
+  return rename(from, to);
+}
+
+/* Shift <file> -> <file>.1 -> ... -> <file>.<n_keep-1> */
+static void rotate_files(const char *filename, int n_keep) {
+  char from[HECMW_FILENAME_LEN + 16], to[HECMW_FILENAME_LEN + 16];
+  int i;
+
+  for (i = n_keep - 1; i > 0; i--) {
+    if (i == 1) {
+      snprintf(from, sizeof(from), "%s", filename);
+    } else {
+      snprintf(from, sizeof(from), "%s.%d", filename, i - 1);
+    }
+    snprintf(to, sizeof(to), "%s.%d", filename, i);
+    replace_file(from, to); /* missing generations are not an error */
+  }
+}
+
+/*
+ * Write a checkpoint to <file>.tmp and rename it to <file> only when
+ * complete, so that an interrupted write never destroys the last checkpoint.
+ * Runs on the writer thread for asynchronous output; errors are kept in the
+ * job and reported by HECMW_restart_wait.
+ */
+static int write_job(struct restart_job *job) {
+  char tmpname[HECMW_FILENAME_LEN + 16];
+  FILE *fp;
+
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", job->filename);
+  if ((fp = fopen(tmpname, "wb")) == NULL) {
+    job->status = HECMW_UTIL_E0101;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s, %s", tmpname,
+             HECMW_strmsg(errno));
+    return -1;
+  }
+  if (job->buf.len > 0 && fwrite(job->buf.data, job->buf.len, 1, fp) != 1) {
+    job->status = HECMW_UTIL_E0105;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s", tmpname);
+    fclose(fp);
+    remove(tmpname);
+    return -1;
+  }
+  if (fclose(fp)) {
+    job->status = HECMW_UTIL_E0102;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s, %s", tmpname,
+             HECMW_strmsg(errno));
+    remove(tmpname);
+    return -1;
+  }
+  if (job->n_keep > 1) rotate_files(job->filename, job->n_keep);
+  if (replace_file(tmpname, job->filename)) {
+    job->status = HECMW_UTIL_E0101;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s, %s", job->filename,
+             HECMW_strmsg(errno));
+    return -1;
+  }
+  job->status = 0;
+  return 0;
+}
+
+#ifdef HECMW_WITH_PTHREAD
+static void *writer_main(void *arg) {
+  write_job((struct restart_job *)arg);
+  return NULL;
+}
+#endif
 
-  for (p = first_list; p; p = q) {
-    q = p->next;
-    HECMW_free(p->data);
-    HECMW_free(p);
+int HECMW_restart_wait(void) {
+  int rc = 0;
+
+  if (pending_job == NULL) return 0;
+#ifdef HECMW_WITH_PTHREAD
+  if (writer_running) {
+    pthread_join(writer_thread, NULL);
+    writer_running = 0;
+  }
+#endif
+  if (pending_job->status) {
+    HECMW_set_error(pending_job->status, "%s", pending_job->errmsg);
+    rc = -1;
   }
-  first_list = NULL;
-  previ_list = NULL;
+  free_job(pending_job);
+  pending_job = NULL;
+  return rc;
+}
+
+int HECMW_restart_set_option(int async, int n_keep) {
+  if (HECMW_restart_wait()) return -1;
+  restart_async  = async ? 1 : 0;
+  restart_n_keep = n_keep > 0 ? n_keep : 1;
+  return 0;
 }
 
 int HECMW_restart_open_by_name(char *name_ID) {
   char *filename;
 
+  /* the file may still be being written */
+  if (HECMW_restart_wait()) return -1;
+
   if (name_ID) {
     if ((filename = HECMW_ctrl_get_restart_file(name_ID)) == NULL) return -1;
   } else {
@@ -117,24 +268,11 @@ void *HECMW_restart_read(void *addr) {
   return data;
 }
 
+/* data is taken over (freed) as before the records were packed */
 int HECMW_restart_add(void *data, size_t size) {
-  struct restart_list *rst;
-
-  rst = HECMW_malloc(sizeof(*rst));
-  if (rst == NULL) {
-    HECMW_set_error(errno, "");
-    return -1;
-  }
-
-  rst->data = data;
-  rst->size = size;
-  rst->next = NULL;
-
-  if (previ_list != NULL) previ_list->next = rst;
-  previ_list                               = rst;
-  if (first_list == NULL) first_list       = rst;
-
-  return 0;
+  int rc = stage_append(data, size);
+  HECMW_free(data);
+  return rc;
 }
 
 int HECMW_restart_add_int(int *data, int n_data) {
@@ -145,29 +283,11 @@ int HECMW_restart_add_double(double *data, int n_data) {
   return HECMW_restart_add(data, sizeof(double) * n_data);
 }
 
-static int restart_write(const void *ptr, size_t size, size_t nmemb,
-                         FILE *stream) {
-  int rc, msgno;
-
-  rc = fwrite(ptr, size, nmemb, stream);
-  if (rc != nmemb) {
-    if (feof(stream)) {
-      msgno = HECMW_UTIL_E0104;
-    } else if (ferror(stream)) {
-      msgno = HECMW_UTIL_E0105;
-    }
-    return msgno;
-  }
-  return 0;
-}
-
 int HECMW_restart_write_by_name(char *name_ID) {
-  FILE *fp;
-  struct restart_list *p;
+  struct restart_job *job;
   char *filename;
-  int rc;
 
-  if (previ_list == NULL) return 0;
+  if (stage.len == 0) return 0;
 
   if (name_ID) {
     if ((filename = HECMW_ctrl_get_restart_file(name_ID)) == NULL) return -1;
@@ -184,37 +304,39 @@ int HECMW_restart_write_by_name(char *name_ID) {
     }
   }
 
-  if ((fp = fopen(filename, "w")) == NULL) {
-    HECMW_set_error(HECMW_UTIL_E0101, "File: %s, %s", filename,
-                    HECMW_strmsg(errno));
+  /* at most one checkpoint in flight */
+  if (HECMW_restart_wait()) {
     HECMW_free(filename);
     return -1;
   }
-  HECMW_free(filename);
 
-  for (p = first_list; p; p = p->next) {
-    /* write size */
-    rc = restart_write(&p->size, sizeof(p->size), 1, fp);
-    if (rc) {
-      HECMW_set_error(rc, "");
-      return -1;
-    }
-    /* write data */
-    rc = restart_write(p->data, p->size, 1, fp);
-    if (rc) {
-      HECMW_set_error(rc, "");
-      return -1;
-    }
-  }
-
-  if (fclose(fp)) {
+  job = HECMW_malloc(sizeof(*job));
+  if (job == NULL) {
     HECMW_set_error(errno, "");
+    HECMW_free(filename);
     return -1;
   }
-
-  clear();
-
-  return 0;
+  job->buf       = stage;
+  job->filename  = filename;
+  job->n_keep    = restart_n_keep;
+  job->status    = 0;
+  job->errmsg[0] = '\0';
+  stage.data = NULL;
+  stage.len  = 0;
+  stage.cap  = 0;
+  pending_job = job;
+
+#ifdef HECMW_WITH_PTHREAD
+  if (restart_async) {
+    if (pthread_create(&writer_thread, NULL, writer_main, job) == 0) {
+      writer_running = 1;
+      return 0;
+    }
+    /* fall back to a synchronous write */
+  }
+#endif
+  write_job(job);
+  return HECMW_restart_wait();
 }
 
 int HECMW_restart_write(void) { return HECMW_restart_write_by_name(NULL); }
@@ -325,31 +447,8 @@ void HECMW_RESTART_READ_REAL_IF(double *dst, int *err) {
 
 /*----------------------------------------------------------------------------*/
 
-static void *restart_add_alloc(void *data, int byte, int n_data) {
-  int size;
-  void *cdata;
-
-  size  = byte * n_data;
-  cdata = HECMW_malloc(size);
-  if (cdata == NULL) {
-    HECMW_set_error(errno, "");
-    return NULL;
-  }
-  memcpy(cdata, data, size);
-
-  return cdata;
-}
-
 void hecmw_restart_add_int_if(int *data, int *n_data, int *err) {
-  int *cdata;
-
-  cdata = restart_add_alloc(data, sizeof(int), *n_data);
-  if (cdata == NULL) {
-    *err = 1;
-    return;
-  }
-
-  *err = HECMW_restart_add_int(cdata, *n_data);
+  *err = stage_append(data, sizeof(int) * (size_t)*n_data) ? 1 : 0;
 }
 
 void hecmw_restart_add_int_if_(int *data, int *n_data, int *err) {
@@ -367,14 +466,7 @@ void HECMW_RESTART_ADD_INT_IF(int *data, int *n_data, int *err) {
 /*----------------------------------------------------------------------------*/
 
 void hecmw_restart_add_real_if(double *data, int *n_data, int *err) {
-  void *cdata;
-
-  cdata = restart_add_alloc(data, sizeof(double), *n_data);
-  if (cdata == NULL) {
-    *err = 1;
-    return;
-  }
-  *err = HECMW_restart_add_double(cdata, *n_data);
+  *err = stage_append(data, sizeof(double) * (size_t)*n_data) ? 1 : 0;
 }
 
 void hecmw_restart_add_real_if_(double *data, int *n_data, int *err) {
@@ -430,3 +522,31 @@ void hecmw_restart_write_if_(int *err) { hecmw_restart_write_if(err); }
 void hecmw_restart_write_if__(int *err) { hecmw_restart_write_if(err); }
 
 void HECMW_RESTART_WRITE_IF(int *err) { hecmw_restart_write_if(err); }
+
+/*----------------------------------------------------------------------------*/
+
+void hecmw_restart_set_option_if(int *async, int *n_keep, int *err) {
+  *err = HECMW_restart_set_option(*async, *n_keep) ? 1 : 0;
+}
+
+void hecmw_restart_set_option_if_(int *async, int *n_keep, int *err) {
+  hecmw_restart_set_option_if(async, n_keep, err);
+}
+
+void hecmw_restart_set_option_if__(int *async, int *n_keep, int *err) {
+  hecmw_restart_set_option_if(async, n_keep, err);
+}
+
+void HECMW_RESTART_SET_OPTION_IF(int *async, int *n_keep, int *err) {
+  hecmw_restart_set_option_if(async, n_keep, err);
+}
+
+/*----------------------------------------------------------------------------*/
+
+void hecmw_restart_wait_if(int *err) { *err = HECMW_restart_wait() ? 1 : 0; }
+
+void hecmw_restart_wait_if_(int *err) { hecmw_restart_wait_if(err); }
+
+void hecmw_restart_wait_if__(int *err) { hecmw_restart_wait_if(err); }
+
+void HECMW_RESTART_WAIT_IF(int *err) { hecmw_restart_wait_if(err); }
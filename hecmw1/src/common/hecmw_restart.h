@@ -26,4 +26,8 @@ extern int HECMW_restart_write_by_name(char *name_ID);
 
 extern int HECMW_restart_write(void);
 
+extern int HECMW_restart_set_option(int async, int n_keep);
+
+extern int HECMW_restart_wait(void);
+
 #endif
@@ -48,6 +48,24 @@ contains
   end subroutine hecmw_restart_write_by_name
 
 
+  !> async=1 writes checkpoints in the background, n_keep generations are kept
+  subroutine hecmw_restart_set_option(async, n_keep)
+    integer(kind=kint) :: async, n_keep, ierr
+
+    call hecmw_restart_set_option_if(async, n_keep, ierr)
+    if(ierr /= 0) call hecmw_abort(hecmw_comm_get_comm())
+  end subroutine hecmw_restart_set_option
+
+
+  !> Wait until the checkpoint being written in the background is on disk
+  subroutine hecmw_restart_wait()
+    integer(kind=kint) :: ierr
+
+    call hecmw_restart_wait_if(ierr)
+    if(ierr /= 0) call hecmw_abort(hecmw_comm_get_comm())
+  end subroutine hecmw_restart_wait
+
+
   !C=============================================================================
   !C Read restart data from file
   !C=============================================================================
@@ -74,20 +74,39 @@ int HECMW_result_finalize(void) {
 /* UNIVERSAL I/O                                                             */
 /*---------------------------------------------------------------------------*/
 
+/*
+ * A result series holds all the steps of "<file>.<step>" in "<file>.series"
+ */
+#define SERIES_SUFFIX ".series"
+
 int HECMW_result_write_by_name(char *name_ID) {
   char *basename, filename[HECMW_FILENAME_LEN + 1];
-  int fg_text, ret;
+  int fg_text, fg_compress, fg_series, ret;
+  double tolerance;
 
   if ((basename =
            HECMW_ctrl_get_result_file(name_ID, istep, &fg_text)) == NULL)
     return -1;
 
-  ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s.%d", basename, istep);
+  fg_series = HECMW_ctrl_get_result_series(name_ID);
+  if (fg_series > 0) {
+    ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s%s", basename,
+                   SERIES_SUFFIX);
+  } else {
+    ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s.%d", basename, istep);
+  }
   HECMW_free(basename);
-  if (ret > HECMW_FILENAME_LEN) return -1;
+  if (fg_series < 0 || ret > HECMW_FILENAME_LEN) return -1;
+
+  fg_compress = HECMW_ctrl_get_result_compression(name_ID, &tolerance);
+  if (fg_compress < 0) return -1;
 
-  if (fg_text) {
+  if (fg_series) {
+    if (HECMW_result_write_series_by_fname(filename)) return -1;
+  } else if (fg_text) {
     if (HECMW_result_write_txt_by_fname(filename)) return -1;
+  } else if (fg_compress) {
+    if (HECMW_result_write_cmp_by_fname(filename, tolerance)) return -1;
   } else {
     if (HECMW_result_write_bin_by_fname(filename)) return -1;
   }
@@ -99,20 +118,38 @@ int HECMW_result_write_ST_by_name(char *name_ID,
                                   struct hecmwST_result_data *result,
                                   int n_node, int n_elem, char *header, char *comment) {
   char *basename, filename[HECMW_FILENAME_LEN + 1];
-  int fg_text, ret;
+  int fg_text, fg_compress, fg_series, ret;
+  double tolerance;
 
   if ((basename =
            HECMW_ctrl_get_result_file(name_ID, istep, &fg_text)) == NULL)
     return -1;
 
-  ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s.%d", basename, istep);
+  fg_series = HECMW_ctrl_get_result_series(name_ID);
+  if (fg_series > 0) {
+    ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s%s", basename,
+                   SERIES_SUFFIX);
+  } else {
+    ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s.%d", basename, istep);
+  }
   HECMW_free(basename);
-  if (ret > HECMW_FILENAME_LEN) return -1;
+  if (fg_series < 0 || ret > HECMW_FILENAME_LEN) return -1;
+
+  fg_compress = HECMW_ctrl_get_result_compression(name_ID, &tolerance);
+  if (fg_compress < 0) return -1;
 
-  if (fg_text) {
+  if (fg_series) {
+    if (HECMW_result_write_series_ST_by_fname(filename, result, n_node, n_elem,
+                                              header, comment))
+      return -1;
+  } else if (fg_text) {
     if (HECMW_result_write_txt_ST_by_fname(filename, result, n_node, n_elem,
                                            header, comment))
       return -1;
+  } else if (fg_compress) {
+    if (HECMW_result_write_cmp_ST_by_fname(filename, result, n_node, n_elem,
+                                           header, comment, tolerance))
+      return -1;
   } else {
     if (HECMW_result_write_bin_ST_by_fname(filename, result, n_node, n_elem,
                                            header, comment))
@@ -124,20 +161,34 @@ int HECMW_result_write_ST_by_name(char *name_ID,
 
 int HECMW_result_write_by_addfname(char *name_ID, char *addfname) {
   char *basename, filename[HECMW_FILENAME_LEN + 1];
-  int fg_text, myrank, ret;
+  int fg_text, fg_compress, fg_series, myrank, ret;
+  double tolerance;
 
   if ((basename = HECMW_ctrl_get_result_fileheader(name_ID, istep,
                                                    &fg_text)) == NULL)
     return -1;
 
-  myrank = HECMW_comm_get_rank();
-  ret    = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s%s.%d.%d", basename,
-                 addfname, myrank, istep);
+  myrank    = HECMW_comm_get_rank();
+  fg_series = HECMW_ctrl_get_result_series(name_ID);
+  if (fg_series > 0) {
+    ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s%s.%d%s", basename,
+                   addfname, myrank, SERIES_SUFFIX);
+  } else {
+    ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s%s.%d.%d", basename,
+                   addfname, myrank, istep);
+  }
   HECMW_free(basename);
-  if (ret > HECMW_FILENAME_LEN) return -1;
+  if (fg_series < 0 || ret > HECMW_FILENAME_LEN) return -1;
 
-  if (fg_text) {
+  fg_compress = HECMW_ctrl_get_result_compression(name_ID, &tolerance);
+  if (fg_compress < 0) return -1;
+
+  if (fg_series) {
+    if (HECMW_result_write_series_by_fname(filename)) return -1;
+  } else if (fg_text) {
     if (HECMW_result_write_txt_by_fname(filename)) return -1;
+  } else if (fg_compress) {
+    if (HECMW_result_write_cmp_by_fname(filename, tolerance)) return -1;
   } else {
     if (HECMW_result_write_bin_by_fname(filename)) return -1;
   }
@@ -145,10 +196,36 @@ int HECMW_result_write_by_addfname(char *name_ID, char *addfname) {
   return 0;
 }
 
-int HECMW_result_checkfile_by_name(char *name_ID, int i_step) {
-  char *basename, filename[HECMW_FILENAME_LEN + 1];
-  int fg_text, ret;
+/*
+ * A step file "<file>.<step>" which does not exist may be a step of the
+ * result series "<file>.series"; returns 1 then.
+ */
+static int get_series_step(char *filename, char *series, int *i_step) {
+  char *p, *q;
   FILE *fp;
+  int len;
+
+  if ((fp = fopen(filename, "rb")) != NULL) {
+    fclose(fp);
+    return 0;
+  }
+
+  p = strrchr(filename, '.');
+  if (p == NULL || p[1] == '\0') return 0;
+  *i_step = strtol(p + 1, &q, 10);
+  if (*q != '\0') return 0;
+
+  len = p - filename;
+  if (len + strlen(SERIES_SUFFIX) > HECMW_FILENAME_LEN) return 0;
+  memcpy(series, filename, len);
+  strcpy(series + len, SERIES_SUFFIX);
+
+  return HECMW_judge_result_series_step(series, *i_step);
+}
+
+static int make_step_filename(char *name_ID, int i_step, char *filename) {
+  char *basename;
+  int fg_text, ret;
 
   if ((basename = HECMW_ctrl_get_result_file(name_ID, i_step,
                                              &fg_text)) == NULL)
@@ -158,6 +235,18 @@ int HECMW_result_checkfile_by_name(char *name_ID, int i_step) {
   HECMW_free(basename);
   if (ret > HECMW_FILENAME_LEN) return -1;
 
+  return 0;
+}
+
+int HECMW_result_checkfile_by_fname(char *filename) {
+  char series[HECMW_FILENAME_LEN + 1];
+  int i_step;
+  FILE *fp;
+
+  if (HECMW_result_cmp_wait()) return -1;
+
+  if (get_series_step(filename, series, &i_step)) return 0;
+
   fp = fopen(filename, "r");
   if (fp == NULL) return -1;
   fclose(fp);
@@ -165,35 +254,209 @@ int HECMW_result_checkfile_by_name(char *name_ID, int i_step) {
   return 0;
 }
 
+int HECMW_result_checkfile_by_name(char *name_ID, int i_step) {
+  char filename[HECMW_FILENAME_LEN + 1];
+
+  if (make_step_filename(name_ID, i_step, filename)) return -1;
+
+  return HECMW_result_checkfile_by_fname(filename);
+}
+
 struct hecmwST_result_data *HECMW_result_read_by_fname(char *filename) {
+  return HECMW_result_read_subset_by_fname(filename, 0, NULL, 0, NULL, 0,
+                                           NULL);
+}
+
+struct hecmwST_result_data *HECMW_result_read_by_name(char *name_ID,
+                                                      int i_step) {
+  return HECMW_result_read_subset_by_name(name_ID, i_step, 0, NULL, 0, NULL,
+                                          0, NULL);
+}
+
+static int is_selected(char *label, int n_label, char **labels) {
+  int i;
+  if (n_label <= 0) return 1;
+  for (i = 0; i < n_label; i++) {
+    if (strcmp(label, labels[i]) == 0) return 1;
+  }
+  return 0;
+}
+
+/* keep the selected components of the selected items of a result read */
+static int select_components(int *n_comp, int **dof, char ***label,
+                             double **val, int n, int n_label, char **labels,
+                             int n_item, int *item) {
+  int i, j, k, n_val, n_val_sel, off, off_sel;
+  double *sel;
+
+  if (*n_comp <= 0) return 0;
+  if (item == NULL) n_item = n;
+
+  n_val = n_val_sel = 0;
+  for (i = 0; i < *n_comp; i++) {
+    n_val += (*dof)[i];
+    if (is_selected((*label)[i], n_label, labels)) n_val_sel += (*dof)[i];
+  }
+
+  sel = HECMW_malloc(sizeof(double) * ((size_t)n_item * n_val_sel + 1));
+  if (sel == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+
+  for (i = 0, k = 0, off = off_sel = 0; i < *n_comp; i++) {
+    if (!is_selected((*label)[i], n_label, labels)) {
+      HECMW_free((*label)[i]);
+      off += (*dof)[i];
+      continue;
+    }
+    for (j = 0; j < n_item; j++) {
+      memcpy(sel + (size_t)j * n_val_sel + off_sel,
+             *val + (size_t)(item ? item[j] : j) * n_val + off,
+             sizeof(double) * (*dof)[i]);
+    }
+    (*label)[k] = (*label)[i];
+    (*dof)[k]   = (*dof)[i];
+    off += (*dof)[i];
+    off_sel += (*dof)[i];
+    k++;
+  }
+  HECMW_free(*val);
+  *val    = sel;
+  *n_comp = k;
+
+  if (k == 0) {
+    HECMW_free(*dof);
+    HECMW_free(*label);
+    HECMW_free(*val);
+    *dof   = NULL;
+    *label = NULL;
+    *val   = NULL;
+  }
+  return 0;
+}
+
+static int check_items(int n, int n_item, int *item) {
+  int j;
+  for (j = 0; item && j < n_item; j++) {
+    if (item[j] < 0 || item[j] >= n) {
+      HECMW_set_error(HECMW_ALL_E0101, "item %d out of range", item[j]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int select_ids(int **id, int n_item, int *item) {
+  int *sel, j;
+
+  sel = HECMW_malloc(sizeof(int) * (n_item + 1));
+  if (sel == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  for (j = 0; j < n_item; j++) sel[j] = (*id)[item[j]];
+  HECMW_free(*id);
+  *id = sel;
+  return 0;
+}
+
+static int select_result(struct hecmwST_result_data *result, int n_label,
+                         char **labels, int n_node, int *node, int n_elem,
+                         int *elem) {
+  if (check_items(nnode, n_node, node)) return -1;
+  if (check_items(nelem, n_elem, elem)) return -1;
+
+  if (select_components(&result->ng_component, &result->ng_dof,
+                        &result->global_label, &result->global_val_item, 1,
+                        n_label, labels, 1, NULL))
+    return -1;
+  if (select_components(&result->nn_component, &result->nn_dof,
+                        &result->node_label, &result->node_val_item, nnode,
+                        n_label, labels, n_node, node))
+    return -1;
+  if (select_components(&result->ne_component, &result->ne_dof,
+                        &result->elem_label, &result->elem_val_item, nelem,
+                        n_label, labels, n_elem, elem))
+    return -1;
+
+  if (node) {
+    if (select_ids(&node_global_ID, n_node, node)) return -1;
+    nnode = n_node;
+  }
+  if (elem) {
+    if (elem_global_ID && select_ids(&elem_global_ID, n_elem, elem))
+      return -1;
+    nelem = n_elem;
+  }
+  return 0;
+}
+
+/*
+ * Read the components labels[] (all if n_label is 0) for the nodes node[]
+ * and the elements elem[] (all if NULL), given by their position in the
+ * file. Only the data asked for is read from a result series; a result file
+ * of the other formats is read in full and cut down.
+ */
+struct hecmwST_result_data *HECMW_result_read_subset_by_fname(
+    char *filename, int n_label, char **labels, int n_node, int *node,
+    int n_elem, int *elem) {
+  char series[HECMW_FILENAME_LEN + 1];
   struct hecmwST_result_data *result;
+  int i_step;
 
-  if (HECMW_judge_result_bin_file(filename)) {
+  /* the file may still be being written */
+  if (HECMW_result_cmp_wait()) return NULL;
+
+  if (get_series_step(filename, series, &i_step)) {
+    return HECMW_result_read_series_by_fname(series, i_step, n_label, labels,
+                                             n_node, node, n_elem, elem);
+  }
+
+  if (HECMW_judge_result_cmp_file(filename)) {
+    result = HECMW_result_read_cmp_by_fname(filename);
+  } else if (HECMW_judge_result_bin_file(filename)) {
     result = HECMW_result_read_bin_by_fname(filename);
   } else {
     result = HECMW_result_read_txt_by_fname(filename);
   }
+  if (result == NULL) return NULL;
+
+  if (n_label > 0 || node || elem) {
+    if (select_result(result, n_label, labels, n_node, node, n_elem, elem)) {
+      HECMW_result_free(result);
+      return NULL;
+    }
+  }
 
   return result;
 }
 
-struct hecmwST_result_data *HECMW_result_read_by_name(char *name_ID,
-                                                      int i_step) {
+struct hecmwST_result_data *HECMW_result_read_subset_by_name(
+    char *name_ID, int i_step, int n_label, char **labels, int n_node,
+    int *node, int n_elem, int *elem) {
+  char filename[HECMW_FILENAME_LEN + 1];
+
+  if (make_step_filename(name_ID, i_step, filename)) return NULL;
+
+  return HECMW_result_read_subset_by_fname(filename, n_label, labels, n_node,
+                                           node, n_elem, elem);
+}
+
+struct hecmwST_result_series *HECMW_result_series_open_by_name(
+    char *name_ID) {
   char *basename, filename[HECMW_FILENAME_LEN + 1];
-  struct hecmwST_result_data *result;
   int fg_text, ret;
 
-  if ((basename = HECMW_ctrl_get_result_file(name_ID, i_step,
-                                             &fg_text)) == NULL)
+  if ((basename = HECMW_ctrl_get_result_file(name_ID, 0, &fg_text)) == NULL)
     return NULL;
 
-  ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s.%d", basename, i_step);
+  ret = snprintf(filename, HECMW_FILENAME_LEN + 1, "%s%s", basename,
+                 SERIES_SUFFIX);
   HECMW_free(basename);
   if (ret > HECMW_FILENAME_LEN) return NULL;
 
-  if ((result = HECMW_result_read_by_fname(filename)) == NULL) return NULL;
-
-  return result;
+  return HECMW_result_series_open(filename);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -8,6 +8,8 @@
 
 #include "hecmw_struct.h"
 
+struct hecmwST_result_series; /* opened result series file */
+
 struct hecmwST_result_data {
   int ng_component;
   int nn_component;
@@ -39,6 +41,16 @@ extern int HECMW_result_write_ST_by_name(char *name_ID,
 extern struct hecmwST_result_data *HECMW_result_read_by_name(char *name_ID,
                                                              int i_step);
 extern struct hecmwST_result_data *HECMW_result_read_by_fname(char *filename);
+extern struct hecmwST_result_data *HECMW_result_read_subset_by_name(
+    char *name_ID, int i_step, int n_label, char **label, int n_node,
+    int *node, int n_elem, int *elem);
+extern struct hecmwST_result_data *HECMW_result_read_subset_by_fname(
+    char *filename, int n_label, char **label, int n_node, int *node,
+    int n_elem, int *elem);
+extern int HECMW_result_checkfile_by_name(char *name_ID, int i_step);
+extern int HECMW_result_checkfile_by_fname(char *filename);
+extern struct hecmwST_result_series *HECMW_result_series_open_by_name(
+    char *name_ID);
 
 extern int HECMW_result_get_nnode(void);
 extern int HECMW_result_get_nelem(void);
@@ -59,6 +71,45 @@ extern int HECMW_result_write_bin_ST_by_fname(
     char *header, char *comment);
 extern struct hecmwST_result_data *HECMW_result_read_bin_by_fname(char *filename);
 
+/*
+  functions defined in hecmw_result_cmp_io.c
+ */
+extern int HECMW_judge_result_cmp_file(char *filename);
+extern int HECMW_result_write_cmp_by_fname(char *filename, double tolerance);
+extern int HECMW_result_write_cmp_ST_by_fname(
+    char *filename, struct hecmwST_result_data *result, int n_node, int n_elem,
+    char *header, char *comment, double tolerance);
+extern struct hecmwST_result_data *HECMW_result_read_cmp_by_fname(char *filename);
+extern int HECMW_result_cmp_wait(void);
+
+/*
+  functions defined in hecmw_result_series_io.c
+ */
+extern int HECMW_result_write_series_by_fname(char *filename);
+extern int HECMW_result_write_series_ST_by_fname(
+    char *filename, struct hecmwST_result_data *result, int n_node, int n_elem,
+    char *header, char *comment);
+extern struct hecmwST_result_series *HECMW_result_series_open(char *filename);
+extern void HECMW_result_series_close(struct hecmwST_result_series *s);
+extern int HECMW_result_series_get_n_step(struct hecmwST_result_series *s);
+extern int HECMW_result_series_get_step(struct hecmwST_result_series *s, int i,
+                                        int *i_step, double *time);
+extern int HECMW_result_series_get_nnode(struct hecmwST_result_series *s);
+extern int HECMW_result_series_get_nelem(struct hecmwST_result_series *s);
+extern int HECMW_result_series_has_step(struct hecmwST_result_series *s,
+                                        int i_step);
+extern int HECMW_result_series_read_field(struct hecmwST_result_series *s,
+                                          int i_step, int dtype, char *label,
+                                          int n_item, int *item, double *val);
+extern struct hecmwST_result_data *HECMW_result_series_read(
+    struct hecmwST_result_series *s, int i_step, int n_label, char **label,
+    int n_node, int *node, int n_elem, int *elem);
+extern int HECMW_judge_result_series_step(char *filename, int i_step);
+extern struct hecmwST_result_data *HECMW_result_read_series_by_fname(
+    char *filename, int i_step, int n_label, char **label, int n_node,
+    int *node, int n_elem, int *elem);
+extern void HECMW_result_series_clear(void);
+
 /*
   functions defined in hecmw_result_txt_io.c
  */
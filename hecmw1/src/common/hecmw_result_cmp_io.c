@@ -0,0 +1,947 @@
+/*****************************************************************************
+ * Copyright (c) 2019 FrontISTR Commons
+ * This software is released under the MIT License, see LICENSE.txt
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <float.h>
+#ifdef HECMW_WITH_PTHREAD
+#include <pthread.h>
+#endif
+#include "hecmw_util.h"
+#include "hecmw_result.h"
+#include "hecmw_result_io.h"
+
+/*
+ * Compressed result file
+ *
+ *   "HECMW_COMPRESSED_RESULT", format version, byte order mark
+ *   header, comment                               (int length + chars)
+ *   ng_component, ng_dof[], global_label[], global_val_item[]
+ *   n_node, n_elem, nn_component, ne_component
+ *   nn_dof[], node_label[], ne_dof[], elem_label[]
+ *   node IDs, one stream per nodal value column,
+ *   elem IDs, one stream per elemental value column
+ *
+ * A stream holds the n_node (n_elem) values of one column: codec, step of
+ * quantization, then the column transformed by the codec, split into chunks
+ * of (raw length, compressed length, data). A chunk whose compressed length
+ * equals its raw length is stored as is.
+ *
+ *   CODEC_DELTA    IDs: zigzag coded differences of consecutive values
+ *   CODEC_SHUFFLE  lossless: the bytes of the doubles, byte 0 of all values
+ *                  first, then byte 1, ...
+ *   CODEC_QUANTIZE lossy: round(value / step) coded like the IDs, where
+ *                  step = 2 * tolerance * max|value| of the column
+ *
+ * and every chunk is compressed by a byte oriented LZ77 coder.
+ */
+#define RES_CMP_HEADER "HECMW_COMPRESSED_RESULT"
+#define RES_CMP_HEADER_LEN (sizeof(RES_CMP_HEADER) - 1)
+#define RES_CMP_VERSION 1
+#define RES_CMP_BYTE_ORDER 0x01020304
+
+#define CHUNK_SIZE (1 << 20)
+#define QUANT_MAX 1.0e9 /* |round(value / step)| must fit in int */
+
+#define LZ_HASH_LOG 14
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+enum { CODEC_DELTA = 1, CODEC_SHUFFLE, CODEC_QUANTIZE };
+
+/* a result file handed over to the writer */
+struct cmp_job {
+  char *filename;
+  struct hecmwST_result_data *result;
+  int n_node;
+  int n_elem;
+  int *node_ID;
+  int *elem_ID;
+  char header[HECMW_HEADER_LEN + 1];
+  char comment[HECMW_MSG_LEN + 1];
+  double tolerance;
+  int is_copy; /* result and IDs belong to the job */
+  int status;
+  char errmsg[HECMW_MSG_LEN + 1];
+};
+
+/* buffers of one column */
+struct cmp_work {
+  size_t n;
+  unsigned char *raw;
+  unsigned char *shuffled;
+  unsigned char *chunk;
+  int *hash;
+};
+
+#ifdef HECMW_WITH_PTHREAD
+static pthread_t writer_thread;
+static int writer_running = 0;
+#endif
+static struct cmp_job *pending_job = NULL;
+
+/*---------------------------------------------------------------------------*/
+/* LZ77 coder                                                                */
+/*---------------------------------------------------------------------------*/
+
+/*
+ * Sequences of (token, literal length, literals, offset, match length):
+ * the token holds min(literal length, 15) and min(match length - 4, 15),
+ * longer lengths continue in bytes of 255 and a last byte below 255. The
+ * last sequence has literals only.
+ */
+
+static unsigned int lz_read32(const unsigned char *p) {
+  unsigned int v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static unsigned int lz_hash(unsigned int v) {
+  return (v * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+static unsigned char *lz_put_length(unsigned char *op, size_t len) {
+  for (; len >= 255; len -= 255) *op++ = 255;
+  *op++ = (unsigned char)len;
+  return op;
+}
+
+static unsigned char *lz_put_sequence(unsigned char *op, unsigned char *oend,
+                                      const unsigned char *lit, size_t n_lit,
+                                      size_t offset, size_t n_match) {
+  size_t need = 1 + n_lit / 255 + 1 + n_lit + 2 + n_match / 255 + 1;
+  unsigned char *token;
+
+  if (need > (size_t)(oend - op)) return NULL;
+
+  token  = op++;
+  *token = (unsigned char)((n_lit < 15 ? n_lit : 15) << 4);
+  if (n_lit >= 15) op = lz_put_length(op, n_lit - 15);
+  memcpy(op, lit, n_lit);
+  op += n_lit;
+  if (n_match == 0) return op;
+
+  *op++ = (unsigned char)(offset & 0xff);
+  *op++ = (unsigned char)(offset >> 8);
+  n_match -= LZ_MIN_MATCH;
+  *token |= (unsigned char)(n_match < 15 ? n_match : 15);
+  if (n_match >= 15) op = lz_put_length(op, n_match - 15);
+  return op;
+}
+
+/* returns the compressed size, or 0 if it would not be smaller than n */
+static size_t lz_compress(const unsigned char *src, size_t n,
+                          unsigned char *dst, int *hash) {
+  const unsigned char *ip = src, *anchor = src, *end = src + n;
+  unsigned char *op = dst, *oend = dst + n;
+  size_t pos, miss = 0;
+
+  memset(hash, 0, sizeof(*hash) * (1 << LZ_HASH_LOG));
+
+  while (n >= LZ_MIN_MATCH && ip <= end - LZ_MIN_MATCH) {
+    unsigned int v = lz_read32(ip);
+    unsigned int h = lz_hash(v);
+    const unsigned char *ref = src + hash[h];
+
+    hash[h] = (int)(ip - src);
+    if (ref < ip && ip - ref <= LZ_MAX_OFFSET && lz_read32(ref) == v) {
+      const unsigned char *mp = ip + LZ_MIN_MATCH, *rp = ref + LZ_MIN_MATCH;
+      while (mp < end && *mp == *rp) {
+        mp++;
+        rp++;
+      }
+      op = lz_put_sequence(op, oend, anchor, ip - anchor, ip - ref, mp - ip);
+      if (op == NULL) return 0;
+      ip = anchor = mp;
+      miss        = 0;
+    } else {
+      /* skip faster through data that does not compress */
+      ip += 1 + (miss++ >> 5);
+    }
+  }
+
+  if (anchor < end) {
+    op = lz_put_sequence(op, oend, anchor, end - anchor, 0, 0);
+    if (op == NULL) return 0;
+  }
+
+  pos = op - dst;
+  return pos < n ? pos : 0;
+}
+
+static int lz_get_length(const unsigned char **ip, const unsigned char *iend,
+                         size_t *len) {
+  unsigned char c;
+  do {
+    if (*ip >= iend) return -1;
+    c = *(*ip)++;
+    *len += c;
+  } while (c == 255);
+  return 0;
+}
+
+static int lz_decompress(const unsigned char *src, size_t n,
+                         unsigned char *dst, size_t n_dst) {
+  const unsigned char *ip = src, *iend = src + n;
+  unsigned char *op = dst, *oend = dst + n_dst;
+
+  while (op < oend) {
+    size_t n_lit, n_match, offset;
+    unsigned char token;
+
+    if (ip >= iend) return -1;
+    token = *ip++;
+
+    n_lit = token >> 4;
+    if (n_lit == 15 && lz_get_length(&ip, iend, &n_lit)) return -1;
+    if (n_lit > (size_t)(iend - ip) || n_lit > (size_t)(oend - op)) return -1;
+    memcpy(op, ip, n_lit);
+    ip += n_lit;
+    op += n_lit;
+    if (op == oend) break;
+
+    if (iend - ip < 2) return -1;
+    offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    n_match = token & 15;
+    if (n_match == 15 && lz_get_length(&ip, iend, &n_match)) return -1;
+    n_match += LZ_MIN_MATCH;
+    if (offset == 0 || offset > (size_t)(op - dst)) return -1;
+    if (n_match > (size_t)(oend - op)) return -1;
+    for (; n_match > 0; n_match--, op++) *op = *(op - offset);
+  }
+
+  return ip == iend ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/* column transforms                                                         */
+/*---------------------------------------------------------------------------*/
+
+static void shuffle(const unsigned char *src, unsigned char *dst, size_t n,
+                    size_t size) {
+  size_t i, b;
+  for (b = 0; b < size; b++) {
+    for (i = 0; i < n; i++) dst[b * n + i] = src[i * size + b];
+  }
+}
+
+static void unshuffle(const unsigned char *src, unsigned char *dst, size_t n,
+                      size_t size) {
+  size_t i, b;
+  for (b = 0; b < size; b++) {
+    for (i = 0; i < n; i++) dst[i * size + b] = src[b * n + i];
+  }
+}
+
+/* differences are taken modulo 2^32, so any int sequence round-trips */
+static void delta_encode(const int *src, unsigned int *dst, size_t n) {
+  unsigned int prev = 0, d;
+  size_t i;
+  for (i = 0; i < n; i++) {
+    d      = (unsigned int)src[i] - prev;
+    prev   = (unsigned int)src[i];
+    dst[i] = (d << 1) ^ (0U - (d >> 31));
+  }
+}
+
+static void delta_decode(const unsigned int *src, int *dst, size_t n) {
+  unsigned int prev = 0, d;
+  size_t i;
+  for (i = 0; i < n; i++) {
+    d      = (src[i] >> 1) ^ (0U - (src[i] & 1));
+    prev  += d;
+    dst[i] = (int)prev;
+  }
+}
+
+/*
+ * Quantization step of a column for the tolerance, or 0 to keep it lossless
+ * (no tolerance, all zero, not finite or too fine a step).
+ */
+static double quantize_step(const double *val, size_t n, double tolerance) {
+  double vmax = 0.0, step;
+  size_t i;
+
+  if (tolerance <= 0.0) return 0.0;
+  for (i = 0; i < n; i++) {
+    double a = fabs(val[i]);
+    if (!(a <= DBL_MAX)) return 0.0;
+    if (a > vmax) vmax = a;
+  }
+  if (vmax == 0.0) return 0.0;
+  step = 2.0 * tolerance * vmax;
+  if (vmax / step > QUANT_MAX) return 0.0;
+  return step;
+}
+
+/*---------------------------------------------------------------------------*/
+/* COMPRESSED MODE I/O --- output                                            */
+/*---------------------------------------------------------------------------*/
+
+static int cmp_write(const void *ptr, size_t size, FILE *fp) {
+  if (size == 0) return 0;
+  return fwrite(ptr, size, 1, fp) == 1 ? 0 : -1;
+}
+
+static int cmp_write_int(int v, FILE *fp) { return cmp_write(&v, sizeof(v), fp); }
+
+static int cmp_write_str(const char *s, FILE *fp) {
+  int len = s ? strlen(s) : 0;
+  if (cmp_write_int(len, fp)) return -1;
+  return cmp_write(s, len, fp);
+}
+
+static int cmp_write_labels(int n, const int *dof, char **label, FILE *fp) {
+  int i;
+  if (n > 0 && cmp_write(dof, sizeof(int) * n, fp)) return -1;
+  for (i = 0; i < n; i++) {
+    if (cmp_write_str(label[i], fp)) return -1;
+  }
+  return 0;
+}
+
+static int work_init(struct cmp_work *w, size_t n) {
+  size_t len = sizeof(double) * (n > 0 ? n : 1);
+
+  w->n        = n;
+  w->raw      = HECMW_malloc(len);
+  w->shuffled = HECMW_malloc(len);
+  w->chunk    = HECMW_malloc(len < CHUNK_SIZE ? len : CHUNK_SIZE);
+  w->hash     = HECMW_malloc(sizeof(int) * (1 << LZ_HASH_LOG));
+  if (!w->raw || !w->shuffled || !w->chunk || !w->hash) return -1;
+  return 0;
+}
+
+static void work_free(struct cmp_work *w) {
+  HECMW_free(w->raw);
+  HECMW_free(w->shuffled);
+  HECMW_free(w->chunk);
+  HECMW_free(w->hash);
+}
+
+/* shuffle w->raw holding w->n values of size bytes and write it in chunks */
+static int put_stream(struct cmp_work *w, int codec, double step, size_t size,
+                      FILE *fp) {
+  size_t len = w->n * size, pos;
+
+  shuffle(w->raw, w->shuffled, w->n, size);
+  if (cmp_write_int(codec, fp) || cmp_write(&step, sizeof(step), fp))
+    return -1;
+
+  for (pos = 0; pos < len; pos += CHUNK_SIZE) {
+    size_t n_raw = len - pos < CHUNK_SIZE ? len - pos : CHUNK_SIZE;
+    size_t n_cmp = lz_compress(w->shuffled + pos, n_raw, w->chunk, w->hash);
+    if (cmp_write_int((int)n_raw, fp)) return -1;
+    if (n_cmp > 0) {
+      if (cmp_write_int((int)n_cmp, fp)) return -1;
+      if (cmp_write(w->chunk, n_cmp, fp)) return -1;
+    } else {
+      if (cmp_write_int((int)n_raw, fp)) return -1;
+      if (cmp_write(w->shuffled + pos, n_raw, fp)) return -1;
+    }
+  }
+  return 0;
+}
+
+static int put_id_stream(struct cmp_work *w, const int *id, FILE *fp) {
+  delta_encode(id, (unsigned int *)w->raw, w->n);
+  return put_stream(w, CODEC_DELTA, 0.0, sizeof(int), fp);
+}
+
+/* column k of the n x n_val row-major array val */
+static int put_value_stream(struct cmp_work *w, const double *val, int n_val,
+                            int k, double tolerance, FILE *fp) {
+  double *col = (double *)w->shuffled; /* scratch before put_stream */
+  double step;
+  size_t i;
+
+  for (i = 0; i < w->n; i++) col[i] = val[i * n_val + k];
+
+  step = quantize_step(col, w->n, tolerance);
+  if (step > 0.0) {
+    int *q = (int *)w->raw;
+    for (i = 0; i < w->n; i++) q[i] = (int)floor(col[i] / step + 0.5);
+    delta_encode(q, (unsigned int *)w->raw, w->n);
+    return put_stream(w, CODEC_QUANTIZE, step, sizeof(int), fp);
+  }
+
+  memcpy(w->raw, col, sizeof(double) * w->n);
+  return put_stream(w, CODEC_SHUFFLE, 0.0, sizeof(double), fp);
+}
+
+static int count_dof(int n_comp, const int *dof) {
+  int i, n = 0;
+  for (i = 0; i < n_comp; i++) n += dof[i];
+  return n;
+}
+
+static int put_values(struct cmp_work *w, const int *id, const double *val,
+                      int n_val, double tolerance, FILE *fp) {
+  int k;
+
+  if (put_id_stream(w, id, fp)) return -1;
+  for (k = 0; k < n_val; k++) {
+    if (put_value_stream(w, val, n_val, k, tolerance, fp)) return -1;
+  }
+  return 0;
+}
+
+/* runs on the writer thread for background output */
+static int write_job(struct cmp_job *job) {
+  struct hecmwST_result_data *r = job->result;
+  struct cmp_work w_node, w_elem;
+  int info[2] = {RES_CMP_VERSION, RES_CMP_BYTE_ORDER};
+  int nn_val, ne_val, rc = -1;
+  FILE *fp;
+
+  memset(&w_node, 0, sizeof(w_node));
+  memset(&w_elem, 0, sizeof(w_elem));
+
+  if ((fp = fopen(job->filename, "wb")) == NULL) {
+    job->status = HECMW_UTIL_E0201;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s, %s", job->filename,
+             HECMW_strmsg(errno));
+    return -1;
+  }
+
+  nn_val = count_dof(r->nn_component, r->nn_dof);
+  ne_val = count_dof(r->ne_component, r->ne_dof);
+  if (work_init(&w_node, job->n_node) || work_init(&w_elem, job->n_elem)) {
+    job->status = HECMW_ALL_E0101;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s", job->filename);
+    goto error;
+  }
+
+  job->status = HECMW_UTIL_E0205;
+  snprintf(job->errmsg, sizeof(job->errmsg), "File: %s", job->filename);
+
+  if (cmp_write(RES_CMP_HEADER, RES_CMP_HEADER_LEN, fp)) goto error;
+  if (cmp_write(info, sizeof(info), fp)) goto error;
+  if (cmp_write_str(job->header, fp)) goto error;
+  if (cmp_write_str(job->comment, fp)) goto error;
+
+  if (cmp_write_int(r->ng_component, fp)) goto error;
+  if (cmp_write_labels(r->ng_component, r->ng_dof, r->global_label, fp))
+    goto error;
+  if (r->ng_component > 0 &&
+      cmp_write(r->global_val_item,
+                sizeof(double) * count_dof(r->ng_component, r->ng_dof), fp))
+    goto error;
+
+  if (cmp_write_int(job->n_node, fp) || cmp_write_int(job->n_elem, fp))
+    goto error;
+  if (cmp_write_int(r->nn_component, fp) || cmp_write_int(r->ne_component, fp))
+    goto error;
+  if (cmp_write_labels(r->nn_component, r->nn_dof, r->node_label, fp))
+    goto error;
+  if (cmp_write_labels(r->ne_component, r->ne_dof, r->elem_label, fp))
+    goto error;
+
+  if (put_values(&w_node, job->node_ID, r->node_val_item, nn_val,
+                 job->tolerance, fp))
+    goto error;
+  if (put_values(&w_elem, job->elem_ID, r->elem_val_item, ne_val,
+                 job->tolerance, fp))
+    goto error;
+
+  if (fclose(fp)) {
+    fp          = NULL;
+    job->status = HECMW_UTIL_E0202;
+    snprintf(job->errmsg, sizeof(job->errmsg), "File: %s, %s", job->filename,
+             HECMW_strmsg(errno));
+    goto error;
+  }
+  fp          = NULL;
+  job->status = 0;
+  rc          = 0;
+
+error:
+  if (fp) fclose(fp);
+  work_free(&w_node);
+  work_free(&w_elem);
+  return rc;
+}
+
+static void free_job(struct cmp_job *job) {
+  if (job == NULL) return;
+  if (job->is_copy) {
+    HECMW_result_free(job->result);
+    HECMW_free(job->node_ID);
+    HECMW_free(job->elem_ID);
+  }
+  HECMW_free(job->filename);
+  HECMW_free(job);
+}
+
+#ifdef HECMW_WITH_PTHREAD
+static void *writer_main(void *arg) {
+  write_job((struct cmp_job *)arg);
+  return NULL;
+}
+#endif
+
+int HECMW_result_cmp_wait(void) {
+  int rc = 0;
+
+  if (pending_job == NULL) return 0;
+#ifdef HECMW_WITH_PTHREAD
+  if (writer_running) {
+    pthread_join(writer_thread, NULL);
+    writer_running = 0;
+  }
+#endif
+  if (pending_job->status) {
+    HECMW_set_error(pending_job->status, "%s", pending_job->errmsg);
+    rc = -1;
+  }
+  free_job(pending_job);
+  pending_job = NULL;
+  return rc;
+}
+
+static struct cmp_job *make_job(char *filename, char *header, char *comment,
+                                double tolerance) {
+  struct cmp_job *job;
+
+  if (HECMW_ctrl_is_subdir()) {
+    if (HECMW_ctrl_make_subdir(filename)) {
+      HECMW_set_error(HECMW_UTIL_E0201, "File: %s, %s", filename,
+                      HECMW_strmsg(errno));
+      return NULL;
+    }
+  }
+
+  job = HECMW_calloc(1, sizeof(*job));
+  if (job == NULL) {
+    HECMW_set_error(errno, "");
+    return NULL;
+  }
+  job->filename = HECMW_strdup(filename);
+  if (job->filename == NULL) {
+    HECMW_set_error(errno, "");
+    HECMW_free(job);
+    return NULL;
+  }
+  snprintf(job->header, sizeof(job->header), "%s", header ? header : "");
+  snprintf(job->comment, sizeof(job->comment), "%s", comment ? comment : "");
+  job->tolerance = tolerance;
+  return job;
+}
+
+static int run_job(struct cmp_job *job, int async) {
+  pending_job = job;
+#ifdef HECMW_WITH_PTHREAD
+  if (async) {
+    if (pthread_create(&writer_thread, NULL, writer_main, job) == 0) {
+      writer_running = 1;
+      return 0;
+    }
+    /* fall back to writing here */
+  }
+#endif
+  write_job(job);
+  return HECMW_result_cmp_wait();
+}
+
+static char **copy_labels(int n, struct result_list *list) {
+  char **label;
+  int i;
+
+  label = HECMW_calloc(n, sizeof(*label));
+  if (label == NULL) return NULL;
+  for (i = 0; i < n; i++, list = list->next) {
+    label[i] = HECMW_strdup(list->label);
+    if (label[i] == NULL) return NULL;
+  }
+  return label;
+}
+
+/* copy one of the result lists into a row-major array */
+static int copy_list(struct result_list *list, int n, int *n_comp,
+                     int **dof, char ***label, double **val) {
+  struct result_list *p;
+  int i, k, n_val, off;
+
+  *n_comp = 0;
+  n_val   = 0;
+  for (p = list; p; p = p->next) {
+    (*n_comp)++;
+    n_val += p->n_dof;
+  }
+  if (*n_comp == 0) return 0;
+
+  *dof   = HECMW_malloc(sizeof(int) * (*n_comp));
+  *label = copy_labels(*n_comp, list);
+  *val   = HECMW_malloc(sizeof(double) * ((size_t)n * n_val + 1));
+  if (*dof == NULL || *label == NULL || *val == NULL) return -1;
+
+  for (p = list, k = 0, off = 0; p; p = p->next, k++) {
+    (*dof)[k] = p->n_dof;
+    for (i = 0; i < n; i++) {
+      memcpy(*val + (size_t)i * n_val + off, p->ptr + (size_t)i * p->n_dof,
+             sizeof(double) * p->n_dof);
+    }
+    off += p->n_dof;
+  }
+  return 0;
+}
+
+static int *copy_ids(const int *id, int n) {
+  int *copy = HECMW_malloc(sizeof(int) * (n > 0 ? n : 1));
+  if (copy && n > 0) memcpy(copy, id, sizeof(int) * n);
+  return copy;
+}
+
+/*
+ * The values registered by HECMW_result_add are copied, and compressed and
+ * written on a writer thread while the solver goes on; the next compressed
+ * output, reading a result and HECMW_finalize wait for it.
+ */
+int HECMW_result_write_cmp_by_fname(char *filename, double tolerance) {
+  struct cmp_job *job;
+  struct hecmwST_result_data *r;
+
+  /* at most one result file in flight */
+  if (HECMW_result_cmp_wait()) return -1;
+
+  job = make_job(filename, head, comment_line, tolerance);
+  if (job == NULL) return -1;
+  job->is_copy = 1;
+  job->n_node  = nnode;
+  job->n_elem  = nelem;
+
+  r = job->result = HECMW_calloc(1, sizeof(*r));
+  if (r == NULL) goto error;
+  if (copy_list(global_list, 1, &r->ng_component, &r->ng_dof,
+                &r->global_label, &r->global_val_item))
+    goto error;
+  if (copy_list(node_list, nnode, &r->nn_component, &r->nn_dof,
+                &r->node_label, &r->node_val_item))
+    goto error;
+  if (copy_list(elem_list, nelem, &r->ne_component, &r->ne_dof,
+                &r->elem_label, &r->elem_val_item))
+    goto error;
+  job->node_ID = copy_ids(node_global_ID, nnode);
+  job->elem_ID = copy_ids(elem_global_ID, nelem);
+  if (job->node_ID == NULL || job->elem_ID == NULL) goto error;
+
+  return run_job(job, 1);
+
+error:
+  HECMW_set_error(errno, "");
+  free_job(job);
+  return -1;
+}
+
+int HECMW_result_write_cmp_ST_by_fname(char *filename,
+                                       struct hecmwST_result_data *result,
+                                       int n_node, int n_elem, char *header,
+                                       char *comment, double tolerance) {
+  struct cmp_job *job;
+
+  if (HECMW_result_cmp_wait()) return -1;
+
+  job = make_job(filename, header, comment, tolerance);
+  if (job == NULL) return -1;
+  job->result  = result;
+  job->n_node  = n_node;
+  job->n_elem  = n_elem;
+  job->node_ID = node_global_ID;
+  job->elem_ID = elem_global_ID;
+
+  return run_job(job, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+/* COMPRESSED MODE I/O --- input                                             */
+/*---------------------------------------------------------------------------*/
+
+static int cmp_read(void *ptr, size_t size, FILE *fp) {
+  if (size == 0) return 0;
+  if (fread(ptr, size, 1, fp) != 1) {
+    HECMW_set_error(feof(fp) ? HECMW_UTIL_E0204 : HECMW_UTIL_E0205, "");
+    return -1;
+  }
+  return 0;
+}
+
+static int cmp_read_int(int *v, FILE *fp) { return cmp_read(v, sizeof(*v), fp); }
+
+static int cmp_read_str(char *s, int size, FILE *fp) {
+  int len;
+  if (cmp_read_int(&len, fp)) return -1;
+  if (len < 0 || len >= size) {
+    HECMW_set_error(HECMW_UTIL_E0205, "string too long");
+    return -1;
+  }
+  if (cmp_read(s, len, fp)) return -1;
+  s[len] = '\0';
+  return 0;
+}
+
+static int cmp_read_labels(int n, int **dof, char ***label, FILE *fp) {
+  char buf[HECMW_NAME_LEN + 1];
+  int i;
+
+  if (n <= 0) return 0;
+  *dof   = HECMW_malloc(sizeof(int) * n);
+  *label = HECMW_calloc(n, sizeof(**label));
+  if (*dof == NULL || *label == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  if (cmp_read(*dof, sizeof(int) * n, fp)) return -1;
+  for (i = 0; i < n; i++) {
+    if ((*dof)[i] < 0) {
+      HECMW_set_error(HECMW_UTIL_E0205, "dof");
+      return -1;
+    }
+    if (cmp_read_str(buf, sizeof(buf), fp)) return -1;
+    (*label)[i] = HECMW_strdup(buf);
+    if ((*label)[i] == NULL) {
+      HECMW_set_error(errno, "");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/* read a stream into w->raw */
+static int get_stream(struct cmp_work *w, int *codec, double *step,
+                      FILE *fp) {
+  size_t size, len, pos;
+
+  if (cmp_read_int(codec, fp) || cmp_read(step, sizeof(*step), fp))
+    return -1;
+  size = (*codec == CODEC_SHUFFLE) ? sizeof(double) : sizeof(int);
+  len  = w->n * size;
+
+  for (pos = 0; pos < len;) {
+    int n_raw, n_cmp;
+    if (cmp_read_int(&n_raw, fp) || cmp_read_int(&n_cmp, fp)) return -1;
+    if (n_raw <= 0 || n_raw > CHUNK_SIZE || (size_t)n_raw > len - pos ||
+        n_cmp <= 0 || n_cmp > n_raw) {
+      HECMW_set_error(HECMW_UTIL_E0205, "invalid chunk");
+      return -1;
+    }
+    if (n_cmp == n_raw) {
+      if (cmp_read(w->shuffled + pos, n_raw, fp)) return -1;
+    } else {
+      if (cmp_read(w->chunk, n_cmp, fp)) return -1;
+      if (lz_decompress(w->chunk, n_cmp, w->shuffled + pos, n_raw)) {
+        HECMW_set_error(HECMW_UTIL_E0205, "broken chunk");
+        return -1;
+      }
+    }
+    pos += n_raw;
+  }
+
+  unshuffle(w->shuffled, w->raw, w->n, size);
+  return 0;
+}
+
+static int get_values(struct cmp_work *w, int *id, double *val, int n_val,
+                      FILE *fp) {
+  int codec, k;
+  double step;
+  size_t i;
+
+  if (get_stream(w, &codec, &step, fp)) return -1;
+  if (codec != CODEC_DELTA) {
+    HECMW_set_error(HECMW_UTIL_E0205, "codec %d", codec);
+    return -1;
+  }
+  delta_decode((unsigned int *)w->raw, id, w->n);
+
+  for (k = 0; k < n_val; k++) {
+    if (get_stream(w, &codec, &step, fp)) return -1;
+    if (codec == CODEC_SHUFFLE) {
+      const double *col = (const double *)w->raw;
+      for (i = 0; i < w->n; i++) val[i * n_val + k] = col[i];
+    } else if (codec == CODEC_QUANTIZE) {
+      int *q = (int *)w->shuffled;
+      delta_decode((unsigned int *)w->raw, q, w->n);
+      for (i = 0; i < w->n; i++) val[i * n_val + k] = q[i] * step;
+    } else {
+      HECMW_set_error(HECMW_UTIL_E0205, "codec %d", codec);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int get_items(int n, int n_val, struct cmp_work *w, int **id,
+                     double **val, FILE *fp) {
+  if (work_init(w, n)) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  *id  = HECMW_malloc(sizeof(int) * (n > 0 ? n : 1));
+  *val = HECMW_malloc(sizeof(double) * ((size_t)n * n_val + 1));
+  if (*id == NULL || *val == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  return get_values(w, *id, *val, n_val, fp);
+}
+
+static void free_labels(int n, char **label) {
+  int i;
+  if (label == NULL) return;
+  for (i = 0; i < n; i++) HECMW_free(label[i]);
+  HECMW_free(label);
+}
+
+/* HECMW_result_free for a result read halfway */
+static void free_result(struct hecmwST_result_data *result) {
+  free_labels(result->ng_component, result->global_label);
+  free_labels(result->nn_component, result->node_label);
+  free_labels(result->ne_component, result->elem_label);
+  HECMW_free(result->ng_dof);
+  HECMW_free(result->nn_dof);
+  HECMW_free(result->ne_dof);
+  HECMW_free(result->global_val_item);
+  HECMW_free(result->node_val_item);
+  HECMW_free(result->elem_val_item);
+  HECMW_free(result);
+}
+
+static struct hecmwST_result_data *cmp_input_result_data(FILE *fp) {
+  struct hecmwST_result_data *result;
+  struct cmp_work w_node, w_elem;
+  double *node_val = NULL, *elem_val = NULL;
+  int info[2], n_node, n_elem, n;
+
+  memset(&w_node, 0, sizeof(w_node));
+  memset(&w_elem, 0, sizeof(w_elem));
+
+  result = HECMW_calloc(1, sizeof(*result));
+  if (result == NULL) {
+    HECMW_set_error(errno, "");
+    return NULL;
+  }
+
+  if (cmp_read(info, sizeof(info), fp)) goto error;
+  if (info[0] != RES_CMP_VERSION || info[1] != RES_CMP_BYTE_ORDER) {
+    HECMW_set_error(HECMW_UTIL_E0205, "unsupported version or byte order");
+    goto error;
+  }
+  if (cmp_read_str(head, sizeof(head), fp)) goto error;
+  if (cmp_read_str(comment_line, sizeof(comment_line), fp)) goto error;
+
+  if (cmp_read_int(&result->ng_component, fp)) goto error;
+  if (result->ng_component < 0) {
+    HECMW_set_error(HECMW_UTIL_E0205, "ng_component");
+    goto error;
+  }
+  if (cmp_read_labels(result->ng_component, &result->ng_dof,
+                      &result->global_label, fp))
+    goto error;
+  if (result->ng_component > 0) {
+    n = count_dof(result->ng_component, result->ng_dof);
+    result->global_val_item = HECMW_malloc(sizeof(double) * (n + 1));
+    if (result->global_val_item == NULL) {
+      HECMW_set_error(errno, "");
+      goto error;
+    }
+    if (cmp_read(result->global_val_item, sizeof(double) * n, fp)) goto error;
+  }
+
+  if (cmp_read_int(&n_node, fp) || cmp_read_int(&n_elem, fp)) goto error;
+  if (cmp_read_int(&result->nn_component, fp) ||
+      cmp_read_int(&result->ne_component, fp))
+    goto error;
+  if (n_node < 0 || n_elem < 0 || result->nn_component < 0 ||
+      result->ne_component < 0) {
+    HECMW_set_error(HECMW_UTIL_E0205, "n_node,n_elem");
+    goto error;
+  }
+  if (cmp_read_labels(result->nn_component, &result->nn_dof,
+                      &result->node_label, fp))
+    goto error;
+  if (cmp_read_labels(result->ne_component, &result->ne_dof,
+                      &result->elem_label, fp))
+    goto error;
+
+  nnode = n_node;
+  nelem = n_elem;
+  if (get_items(n_node, count_dof(result->nn_component, result->nn_dof),
+                &w_node, &node_global_ID, &node_val, fp))
+    goto error;
+  if (get_items(n_elem, count_dof(result->ne_component, result->ne_dof),
+                &w_elem, &elem_global_ID, &elem_val, fp))
+    goto error;
+
+  /* the arrays are only kept for components present, as in the other formats */
+  if (result->nn_component > 0) {
+    result->node_val_item = node_val;
+    node_val              = NULL;
+  }
+  if (result->ne_component > 0) {
+    result->elem_val_item = elem_val;
+    elem_val              = NULL;
+  }
+  HECMW_free(node_val);
+  HECMW_free(elem_val);
+  work_free(&w_node);
+  work_free(&w_elem);
+  return result;
+
+error:
+  HECMW_free(node_val);
+  HECMW_free(elem_val);
+  work_free(&w_node);
+  work_free(&w_elem);
+  free_result(result);
+  return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int HECMW_judge_result_cmp_file(char *filename) {
+  char buff[RES_CMP_HEADER_LEN];
+  FILE *fp;
+  int rcode;
+
+  if ((fp = fopen(filename, "rb")) == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0201, "File: %s, %s", filename,
+                    HECMW_strmsg(errno));
+    return 0;
+  }
+  rcode = fread(buff, RES_CMP_HEADER_LEN, 1, fp) == 1 &&
+          memcmp(buff, RES_CMP_HEADER, RES_CMP_HEADER_LEN) == 0;
+  fclose(fp);
+
+  return rcode;
+}
+
+struct hecmwST_result_data *HECMW_result_read_cmp_by_fname(char *filename) {
+  char buff[RES_CMP_HEADER_LEN];
+  struct hecmwST_result_data *result;
+  FILE *fp;
+
+  if ((fp = fopen(filename, "rb")) == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0201, "File: %s, %s", filename,
+                    HECMW_strmsg(errno));
+    return NULL;
+  }
+
+  if (fread(buff, RES_CMP_HEADER_LEN, 1, fp) != 1 ||
+      memcmp(buff, RES_CMP_HEADER, RES_CMP_HEADER_LEN) != 0) {
+    fclose(fp);
+    HECMW_set_error(HECMW_UTIL_E0202, "%s is not compressed result file",
+                    filename);
+    return NULL;
+  }
+  result = cmp_input_result_data(fp);
+  fclose(fp);
+
+  return result;
+}
@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include "hecmw_struct.h"
 #include "hecmw_util.h"
 #include "hecmw_result.h"
@@ -340,6 +341,72 @@ void HECMW_RESULT_READ_BY_NAME_IF(char *name_ID, int *i_step,
 
 /*----------------------------------------------------------------------------*/
 
+void hecmw_result_read_subset_by_name_if(char *name_ID, int *i_step,
+                                         int *n_label, char *labels,
+                                         int *n_node, int *n_elem, int *err,
+                                         int len, int len_label) {
+  char name_ID_str[HECMW_NAME_LEN + 1];
+  char **label;
+  int i;
+
+  *err = 1;
+
+  if (HECMW_strcpy_f2c_r(name_ID, len, name_ID_str, sizeof(name_ID_str)) ==
+      NULL)
+    return;
+
+  label = HECMW_calloc(*n_label + 1, sizeof(*label));
+  if (label == NULL) {
+    HECMW_set_error(errno, "");
+    return;
+  }
+  for (i = 0; i < *n_label; i++) {
+    label[i] = HECMW_strcpy_f2c(labels + (size_t)len_label * i, len_label);
+    if (label[i] == NULL) goto finalize;
+  }
+
+  result = HECMW_result_read_subset_by_name(name_ID_str, *i_step, *n_label,
+                                            label, 0, NULL, 0, NULL);
+  if (result == NULL) goto finalize;
+
+  nnode   = HECMW_result_get_nnode();
+  nelem   = HECMW_result_get_nelem();
+  *n_node = nnode;
+  *n_elem = nelem;
+
+  *err = 0;
+
+finalize:
+  for (i = 0; i < *n_label; i++) HECMW_free(label[i]);
+  HECMW_free(label);
+}
+
+void hecmw_result_read_subset_by_name_if_(char *name_ID, int *i_step,
+                                          int *n_label, char *labels,
+                                          int *n_node, int *n_elem, int *err,
+                                          int len, int len_label) {
+  hecmw_result_read_subset_by_name_if(name_ID, i_step, n_label, labels, n_node,
+                                      n_elem, err, len, len_label);
+}
+
+void hecmw_result_read_subset_by_name_if__(char *name_ID, int *i_step,
+                                           int *n_label, char *labels,
+                                           int *n_node, int *n_elem, int *err,
+                                           int len, int len_label) {
+  hecmw_result_read_subset_by_name_if(name_ID, i_step, n_label, labels, n_node,
+                                      n_elem, err, len, len_label);
+}
+
+void HECMW_RESULT_READ_SUBSET_BY_NAME_IF(char *name_ID, int *i_step,
+                                         int *n_label, char *labels,
+                                         int *n_node, int *n_elem, int *err,
+                                         int len, int len_label) {
+  hecmw_result_read_subset_by_name_if(name_ID, i_step, n_label, labels, n_node,
+                                      n_elem, err, len, len_label);
+}
+
+/*----------------------------------------------------------------------------*/
+
 void hecmw_result_read_finalize_if(int *err) {
   *err = 1;
   HECMW_result_free(result);
@@ -21,6 +21,7 @@ module hecmw_result
   public :: hecmw_result_finalize
   public :: hecmw_result_free
   public :: hecmw_result_read_by_name
+  public :: hecmw_result_read_subset_by_name
   public :: hecmw_result_checkfile_by_name
   private :: put_node_component
   private :: put_elem_component
@@ -320,6 +321,31 @@ contains
   end subroutine hecmw_result_read_by_name
 
 
+  !> read the components labels(1:n_label) of a step only
+  !> (a result series file is not read in full)
+  subroutine hecmw_result_read_subset_by_name(hecMESH, name_ID, i_step, n_label, labels, result)
+    type(hecmwST_local_mesh), intent(in) :: hecMESH
+    character(len=HECMW_NAME_LEN), intent(in) :: name_ID
+    integer(kind=kint), intent(in) :: i_step
+    integer(kind=kint), intent(in) :: n_label
+    character(len=HECMW_NAME_LEN), intent(in) :: labels(:)
+    type(hecmwST_result_data), intent(inout) :: result
+    integer(kind=kint) :: n_node, n_elem, ierr
+
+    call hecmw_result_read_subset_by_name_if(name_ID, i_step, n_label, labels, n_node, n_elem, ierr)
+    if(ierr /=0) call hecmw_abort(hecmw_comm_get_comm())
+
+    call hecmw_result_copy_c2f(result, n_node, n_elem, ierr)
+    if(ierr /=0) call hecmw_abort(hecmw_comm_get_comm())
+
+    call hecmw_result_read_finalize_if(ierr)
+    if(ierr /=0) call hecmw_abort(hecmw_comm_get_comm())
+
+    call refine_result(hecMESH, n_node, result, ierr)
+    if(ierr /=0) call hecmw_abort(hecmw_comm_get_comm())
+  end subroutine hecmw_result_read_subset_by_name
+
+
   subroutine refine_result(hecMESH, n_node, result, ierr)
     type(hecmwST_local_mesh), intent(in) :: hecMESH
     integer(kind=kint), intent(in) :: n_node
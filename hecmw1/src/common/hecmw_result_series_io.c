@@ -0,0 +1,999 @@
+/*****************************************************************************
+ * Copyright (c) 2019 FrontISTR Commons
+ * This software is released under the MIT License, see LICENSE.txt
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "hecmw_util.h"
+#include "hecmw_result.h"
+#include "hecmw_result_io.h"
+
+/*
+ * Result series file
+ *
+ * One file per rank holds the results of all the steps. Step records are
+ * appended; the header is the only part ever rewritten.
+ *
+ *   "HECMW_RES_SERIES", format version, byte order mark
+ *   offset of the last step directory, end of the valid data
+ *   n_node, n_elem, node IDs, elem IDs
+ *   step record, step record, ...
+ *
+ * A step record is the fields of the step, each stored contiguously as the
+ * n_dof values of all its items, followed by the directory of the step:
+ *
+ *   offset of the previous directory, offset of the record
+ *   step, time, header, comment, n_field
+ *   n_field x (dtype, n_dof, label, offset of the values)
+ *
+ * so one field of one step, or some of its items, is read without touching
+ * the rest of the file. A later record of a step hides the earlier ones.
+ */
+
+#define RES_SER_HEADER "HECMW_RES_SERIES"
+#define RES_SER_HEADER_LEN (sizeof(RES_SER_HEADER) - 1)
+#define RES_SER_VERSION 1
+#define RES_SER_BYTE_ORDER 0x01020304
+#define RES_SER_POS_LAST (RES_SER_HEADER_LEN + 2 * sizeof(int))
+
+#define DTYPE_NODE 1
+#define DTYPE_ELEM 2
+#define DTYPE_GLOBAL 3
+
+#define GATHER_ITEMS 4096 /* items copied at a time to write a strided field */
+#define SPARSE_RATIO 16   /* fewer items than 1/16 are read one by one */
+
+struct series_field {
+  int dtype;
+  int n_dof;
+  char label[HECMW_NAME_LEN + 1];
+  long long offset;
+};
+
+struct series_step {
+  int i_step;
+  double time;
+  long long dir;
+  long long prev;
+  long long start;
+  char header[HECMW_HEADER_LEN + 1];
+  char comment[HECMW_MSG_LEN + 1];
+  int n_field;
+  struct series_field *field;
+};
+
+struct hecmwST_result_series {
+  char *filename;
+  FILE *fp;
+  long long last;
+  int n_node;
+  int n_elem;
+  int *node_ID;
+  int *elem_ID;
+  int n_step;               /* visible steps in the order written */
+  struct series_step *step;
+  int *sorted;              /* indices of step[] sorted by step number */
+};
+
+/* a field to be written: val[i * stride + k], k < n_dof, of item i */
+struct series_source {
+  int dtype;
+  int n_dof;
+  int stride;
+  char *label;
+  const double *val;
+};
+
+/* series files written by this process, appended to after the first write */
+struct series_name {
+  char *filename;
+  struct series_name *next;
+};
+
+static struct series_name *written = NULL;
+
+/* the series last read by HECMW_result_read_series_by_fname */
+static struct hecmwST_result_series *cache = NULL;
+
+/*---------------------------------------------------------------------------*/
+
+static int ser_write(const void *ptr, size_t size, FILE *fp) {
+  if (size == 0) return 0;
+  return fwrite(ptr, size, 1, fp) == 1 ? 0 : -1;
+}
+
+static int ser_write_int(int v, FILE *fp) {
+  return ser_write(&v, sizeof(v), fp);
+}
+
+static int ser_write_ll(long long v, FILE *fp) {
+  return ser_write(&v, sizeof(v), fp);
+}
+
+static int ser_write_str(const char *s, FILE *fp) {
+  int len = s ? strlen(s) : 0;
+  if (ser_write_int(len, fp)) return -1;
+  return ser_write(s, len, fp);
+}
+
+static int ser_read(void *ptr, size_t size, FILE *fp) {
+  if (size == 0) return 0;
+  if (fread(ptr, size, 1, fp) != 1) {
+    HECMW_set_error(feof(fp) ? HECMW_UTIL_E0204 : HECMW_UTIL_E0205, "");
+    return -1;
+  }
+  return 0;
+}
+
+static int ser_read_int(int *v, FILE *fp) {
+  return ser_read(v, sizeof(*v), fp);
+}
+
+static int ser_read_ll(long long *v, FILE *fp) {
+  return ser_read(v, sizeof(*v), fp);
+}
+
+static int ser_read_str(char *s, int size, FILE *fp) {
+  int len;
+  if (ser_read_int(&len, fp)) return -1;
+  if (len < 0 || len >= size) {
+    HECMW_set_error(HECMW_UTIL_E0205, "string too long");
+    return -1;
+  }
+  if (ser_read(s, len, fp)) return -1;
+  s[len] = '\0';
+  return 0;
+}
+
+static int ser_seek(FILE *fp, long long offset) {
+  if (fseek(fp, (long)offset, SEEK_SET)) {
+    HECMW_set_error(HECMW_UTIL_E0205, "seek");
+    return -1;
+  }
+  return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/* header and step directories                                               */
+/*---------------------------------------------------------------------------*/
+
+static int write_header(FILE *fp, int n_node, int n_elem, const int *node_ID,
+                        const int *elem_ID) {
+  if (ser_write(RES_SER_HEADER, RES_SER_HEADER_LEN, fp)) return -1;
+  if (ser_write_int(RES_SER_VERSION, fp)) return -1;
+  if (ser_write_int(RES_SER_BYTE_ORDER, fp)) return -1;
+  if (ser_write_ll(0, fp)) return -1;
+  if (ser_write_ll(0, fp)) return -1; /* set after the IDs */
+  if (ser_write_int(n_node, fp) || ser_write_int(n_elem, fp)) return -1;
+  if (ser_write(node_ID, sizeof(int) * n_node, fp)) return -1;
+  if (ser_write(elem_ID, sizeof(int) * n_elem, fp)) return -1;
+  return 0;
+}
+
+/* read the fixed part of the header; quiet if the file is not a series */
+static int read_header(FILE *fp, long long *last, long long *end, int *n_node,
+                       int *n_elem) {
+  char buff[RES_SER_HEADER_LEN];
+  int info[2];
+
+  if (fread(buff, RES_SER_HEADER_LEN, 1, fp) != 1 ||
+      memcmp(buff, RES_SER_HEADER, RES_SER_HEADER_LEN) != 0)
+    return 1;
+  if (ser_read(info, sizeof(info), fp)) return -1;
+  if (info[0] != RES_SER_VERSION || info[1] != RES_SER_BYTE_ORDER) {
+    HECMW_set_error(HECMW_UTIL_E0205, "unsupported version or byte order");
+    return -1;
+  }
+  if (ser_read_ll(last, fp) || ser_read_ll(end, fp)) return -1;
+  if (ser_read_int(n_node, fp) || ser_read_int(n_elem, fp)) return -1;
+  if (*n_node < 0 || *n_elem < 0 || *last < 0 || *end < *last) {
+    HECMW_set_error(HECMW_UTIL_E0205, "n_node,n_elem");
+    return -1;
+  }
+  return 0;
+}
+
+static int read_dir(FILE *fp, long long dir, struct series_step *st) {
+  int i;
+
+  st->dir   = dir;
+  st->field = NULL;
+  if (ser_seek(fp, dir)) return -1;
+  if (ser_read_ll(&st->prev, fp) || ser_read_ll(&st->start, fp)) return -1;
+  if (st->prev < 0 || st->prev >= dir || st->start > dir) {
+    HECMW_set_error(HECMW_UTIL_E0205, "step directory");
+    return -1;
+  }
+  if (ser_read_int(&st->i_step, fp)) return -1;
+  if (ser_read(&st->time, sizeof(st->time), fp)) return -1;
+  if (ser_read_str(st->header, sizeof(st->header), fp)) return -1;
+  if (ser_read_str(st->comment, sizeof(st->comment), fp)) return -1;
+  if (ser_read_int(&st->n_field, fp)) return -1;
+  if (st->n_field < 0) {
+    HECMW_set_error(HECMW_UTIL_E0205, "n_field");
+    return -1;
+  }
+
+  st->field = HECMW_calloc(st->n_field + 1, sizeof(*st->field));
+  if (st->field == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  for (i = 0; i < st->n_field; i++) {
+    struct series_field *f = &st->field[i];
+    if (ser_read_int(&f->dtype, fp) || ser_read_int(&f->n_dof, fp)) return -1;
+    if (ser_read_str(f->label, sizeof(f->label), fp)) return -1;
+    if (ser_read_ll(&f->offset, fp)) return -1;
+    if (f->dtype < DTYPE_NODE || f->dtype > DTYPE_GLOBAL || f->n_dof < 0 ||
+        f->offset < st->start || f->offset > dir) {
+      HECMW_set_error(HECMW_UTIL_E0205, "field %s", f->label);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void free_steps(int n, struct series_step *step) {
+  int i;
+  if (step == NULL) return;
+  for (i = 0; i < n; i++) HECMW_free(step[i].field);
+  HECMW_free(step);
+}
+
+/* all the step records reachable from dir, in the order written */
+static int read_chain(FILE *fp, long long dir, int *n_step,
+                      struct series_step **step) {
+  struct series_step *st = NULL, tmp;
+  int n = 0, size = 0, i;
+
+  for (; dir > 0; dir = st[n - 1].prev) {
+    if (n == size) {
+      struct series_step *p;
+      size = size ? 2 * size : 64;
+      p    = HECMW_realloc(st, sizeof(*st) * size);
+      if (p == NULL) {
+        HECMW_set_error(errno, "");
+        goto error;
+      }
+      st = p;
+    }
+    if (read_dir(fp, dir, &st[n])) {
+      n++;
+      goto error;
+    }
+    n++;
+  }
+
+  for (i = 0; i < n / 2; i++) {
+    tmp           = st[i];
+    st[i]         = st[n - 1 - i];
+    st[n - 1 - i] = tmp;
+  }
+  *n_step = n;
+  *step   = st;
+  return 0;
+
+error:
+  free_steps(n, st);
+  return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/* SERIES MODE I/O --- output                                                */
+/*---------------------------------------------------------------------------*/
+
+static int is_written(const char *filename) {
+  struct series_name *p;
+  for (p = written; p; p = p->next) {
+    if (strcmp(p->filename, filename) == 0) return 1;
+  }
+  return 0;
+}
+
+static int add_written(const char *filename) {
+  struct series_name *p = HECMW_malloc(sizeof(*p));
+  if (p == NULL) return -1;
+  p->filename = HECMW_strdup(filename);
+  if (p->filename == NULL) {
+    HECMW_free(p);
+    return -1;
+  }
+  p->next = written;
+  written = p;
+  return 0;
+}
+
+/*
+ * Open the series for the record of step i_step and get where to put it.
+ * The first write of a run keeps only the records of the steps before
+ * i_step, so that a restarted analysis continues the series and a new
+ * analysis starts it over.
+ */
+static FILE *open_for_append(char *filename, int i_step, int n_node,
+                             int n_elem, const int *node_ID,
+                             const int *elem_ID, long long *last,
+                             long long *end) {
+  struct series_step *step;
+  FILE *fp;
+  int rtc, nn, ne, n_step, i;
+
+  if ((fp = fopen(filename, "r+b")) != NULL) {
+    rtc = read_header(fp, last, end, &nn, &ne);
+    if (rtc == 0 && (nn != n_node || ne != n_elem)) rtc = 1;
+
+    if (is_written(filename)) {
+      if (rtc) {
+        if (rtc > 0)
+          HECMW_set_error(HECMW_UTIL_E0205, "%s: n_node,n_elem changed",
+                          filename);
+        fclose(fp);
+        return NULL;
+      }
+      return fp;
+    }
+
+    if (rtc == 0 && read_chain(fp, *last, &n_step, &step) == 0) {
+      for (i = 0; i < n_step; i++) {
+        if (step[i].i_step >= i_step) {
+          *last = step[i].prev;
+          *end  = step[i].start;
+          break;
+        }
+      }
+      free_steps(n_step, step);
+      if (add_written(filename)) {
+        HECMW_set_error(errno, "");
+        fclose(fp);
+        return NULL;
+      }
+      return fp;
+    }
+    fclose(fp);
+  }
+
+  /* a new series */
+  if ((fp = fopen(filename, "w+b")) == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0201, "File: %s, %s", filename,
+                    HECMW_strmsg(errno));
+    return NULL;
+  }
+  if (write_header(fp, n_node, n_elem, node_ID, elem_ID)) {
+    HECMW_set_error(HECMW_UTIL_E0205, "File: %s", filename);
+    fclose(fp);
+    return NULL;
+  }
+  *last = 0;
+  *end  = ftell(fp);
+  if (add_written(filename)) {
+    HECMW_set_error(errno, "");
+    fclose(fp);
+    return NULL;
+  }
+  return fp;
+}
+
+static int write_values(const struct series_source *src, int n, FILE *fp) {
+  double *buf;
+  int i, j, m;
+
+  if (src->stride == src->n_dof)
+    return ser_write(src->val, sizeof(double) * n * src->n_dof, fp);
+
+  buf = HECMW_malloc(sizeof(double) * GATHER_ITEMS * src->n_dof);
+  if (buf == NULL) return -1;
+  for (i = 0; i < n; i += m) {
+    m = (n - i < GATHER_ITEMS) ? n - i : GATHER_ITEMS;
+    for (j = 0; j < m; j++) {
+      memcpy(buf + (size_t)j * src->n_dof,
+             src->val + (size_t)(i + j) * src->stride,
+             sizeof(double) * src->n_dof);
+    }
+    if (ser_write(buf, sizeof(double) * m * src->n_dof, fp)) {
+      HECMW_free(buf);
+      return -1;
+    }
+  }
+  HECMW_free(buf);
+  return 0;
+}
+
+static double get_time(int n_src, const struct series_source *src) {
+  int i;
+  for (i = 0; i < n_src; i++) {
+    if (src[i].dtype == DTYPE_GLOBAL && src[i].n_dof > 0 &&
+        strcmp(src[i].label, "TOTALTIME") == 0)
+      return src[i].val[0];
+  }
+  return 0.0;
+}
+
+static int write_step(char *filename, int i_step, char *header, char *comment,
+                      int n_node, int n_elem, const int *node_ID,
+                      const int *elem_ID, int n_src,
+                      const struct series_source *src) {
+  FILE *fp;
+  long long last, start, dir, end, *offset;
+  double time;
+  int i, n;
+
+  fp = open_for_append(filename, i_step, n_node, n_elem, node_ID, elem_ID,
+                       &last, &start);
+  if (fp == NULL) return -1;
+
+  offset = HECMW_malloc(sizeof(*offset) * (n_src + 1));
+  if (offset == NULL) {
+    HECMW_set_error(errno, "");
+    fclose(fp);
+    return -1;
+  }
+
+  if (ser_seek(fp, start)) goto error;
+  for (i = 0, end = start; i < n_src; i++) {
+    n = (src[i].dtype == DTYPE_NODE)
+            ? n_node
+            : (src[i].dtype == DTYPE_ELEM) ? n_elem : 1;
+    offset[i] = end;
+    if (write_values(&src[i], n, fp)) goto io_error;
+    end += (long long)sizeof(double) * n * src[i].n_dof;
+  }
+
+  dir  = end;
+  time = get_time(n_src, src);
+  if (ser_write_ll(last, fp) || ser_write_ll(start, fp)) goto io_error;
+  if (ser_write_int(i_step, fp)) goto io_error;
+  if (ser_write(&time, sizeof(time), fp)) goto io_error;
+  if (ser_write_str(header, fp) || ser_write_str(comment, fp)) goto io_error;
+  if (ser_write_int(n_src, fp)) goto io_error;
+  for (i = 0; i < n_src; i++) {
+    if (ser_write_int(src[i].dtype, fp) || ser_write_int(src[i].n_dof, fp))
+      goto io_error;
+    if (ser_write_str(src[i].label, fp)) goto io_error;
+    if (ser_write_ll(offset[i], fp)) goto io_error;
+  }
+  end = ftell(fp);
+
+  /* the step becomes visible only when its record is complete */
+  if (fflush(fp)) goto io_error;
+  if (ser_seek(fp, RES_SER_POS_LAST)) goto error;
+  if (ser_write_ll(dir, fp) || ser_write_ll(end, fp)) goto io_error;
+
+  HECMW_free(offset);
+  if (fclose(fp)) {
+    HECMW_set_error(HECMW_UTIL_E0202, "File: %s, %s", filename,
+                    HECMW_strmsg(errno));
+    return -1;
+  }
+  return 0;
+
+io_error:
+  HECMW_set_error(HECMW_UTIL_E0205, "File: %s, %s", filename,
+                  HECMW_strmsg(errno));
+error:
+  HECMW_free(offset);
+  fclose(fp);
+  return -1;
+}
+
+static int count_list(struct result_list *list) {
+  int n = 0;
+  for (; list; list = list->next) n++;
+  return n;
+}
+
+int HECMW_result_write_series_by_fname(char *filename) {
+  struct series_source *src;
+  struct result_list *p;
+  int n_src, i, rtc;
+
+  n_src = count_list(global_list) + count_list(node_list) +
+          count_list(elem_list);
+  src = HECMW_malloc(sizeof(*src) * (n_src + 1));
+  if (src == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+
+  i = 0;
+  for (p = global_list; p; p = p->next, i++) {
+    src[i].dtype = DTYPE_GLOBAL;
+    src[i].n_dof = src[i].stride = p->n_dof;
+    src[i].label = p->label;
+    src[i].val   = p->ptr;
+  }
+  for (p = node_list; p; p = p->next, i++) {
+    src[i].dtype = DTYPE_NODE;
+    src[i].n_dof = src[i].stride = p->n_dof;
+    src[i].label = p->label;
+    src[i].val   = p->ptr;
+  }
+  for (p = elem_list; p; p = p->next, i++) {
+    src[i].dtype = DTYPE_ELEM;
+    src[i].n_dof = src[i].stride = p->n_dof;
+    src[i].label = p->label;
+    src[i].val   = p->ptr;
+  }
+
+  rtc = write_step(filename, istep, head, comment_line, nnode, nelem,
+                   node_global_ID, elem_global_ID, n_src, src);
+  HECMW_free(src);
+  return rtc;
+}
+
+static int add_sources(struct series_source *src, int dtype, int n_comp,
+                       const int *dof, char **label, const double *val) {
+  int i, stride, off;
+
+  for (i = 0, stride = 0; i < n_comp; i++) stride += dof[i];
+  for (i = 0, off = 0; i < n_comp; i++) {
+    src[i].dtype  = dtype;
+    src[i].n_dof  = dof[i];
+    src[i].stride = stride;
+    src[i].label  = label[i];
+    src[i].val    = val + off;
+    off += dof[i];
+  }
+  return n_comp;
+}
+
+int HECMW_result_write_series_ST_by_fname(char *filename,
+                                          struct hecmwST_result_data *result,
+                                          int n_node, int n_elem,
+                                          char *header, char *comment) {
+  struct series_source *src;
+  int n_src, rtc;
+
+  n_src = result->ng_component + result->nn_component + result->ne_component;
+  src   = HECMW_malloc(sizeof(*src) * (n_src + 1));
+  if (src == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+
+  n_src = add_sources(src, DTYPE_GLOBAL, result->ng_component, result->ng_dof,
+                      result->global_label, result->global_val_item);
+  n_src += add_sources(src + n_src, DTYPE_NODE, result->nn_component,
+                       result->nn_dof, result->node_label,
+                       result->node_val_item);
+  n_src += add_sources(src + n_src, DTYPE_ELEM, result->ne_component,
+                       result->ne_dof, result->elem_label,
+                       result->elem_val_item);
+
+  rtc = write_step(filename, istep, header, comment, n_node, n_elem,
+                   node_global_ID, elem_global_ID, n_src, src);
+  HECMW_free(src);
+  return rtc;
+}
+
+/*---------------------------------------------------------------------------*/
+/* SERIES MODE I/O --- input                                                 */
+/*---------------------------------------------------------------------------*/
+
+static struct hecmwST_result_series *ser_sort_key;
+
+static int cmp_step(const void *a, const void *b) {
+  const struct series_step *sa = &ser_sort_key->step[*(const int *)a];
+  const struct series_step *sb = &ser_sort_key->step[*(const int *)b];
+  if (sa->i_step != sb->i_step) return sa->i_step < sb->i_step ? -1 : 1;
+  return *(const int *)a - *(const int *)b;
+}
+
+/* drop the records hidden by a later record of the same step */
+static int make_index(struct hecmwST_result_series *s) {
+  int *order, *alive, i, n;
+
+  order = HECMW_malloc(sizeof(int) * (s->n_step + 1));
+  alive = HECMW_calloc(s->n_step + 1, sizeof(int));
+  if (order == NULL || alive == NULL) {
+    HECMW_set_error(errno, "");
+    HECMW_free(order);
+    HECMW_free(alive);
+    return -1;
+  }
+  for (i = 0; i < s->n_step; i++) order[i] = i;
+  ser_sort_key = s;
+  qsort(order, s->n_step, sizeof(int), cmp_step);
+  for (i = 0; i < s->n_step; i++) {
+    if (i == s->n_step - 1 ||
+        s->step[order[i]].i_step != s->step[order[i + 1]].i_step)
+      alive[order[i]] = 1;
+  }
+
+  for (i = 0, n = 0; i < s->n_step; i++) {
+    if (alive[i]) {
+      s->step[n++] = s->step[i];
+    } else {
+      HECMW_free(s->step[i].field);
+    }
+  }
+  s->n_step = n;
+
+  for (i = 0; i < n; i++) order[i] = i;
+  qsort(order, n, sizeof(int), cmp_step);
+  s->sorted = order;
+  HECMW_free(alive);
+  return 0;
+}
+
+void HECMW_result_series_close(struct hecmwST_result_series *s) {
+  if (s == NULL) return;
+  if (s->fp) fclose(s->fp);
+  free_steps(s->n_step, s->step);
+  HECMW_free(s->sorted);
+  HECMW_free(s->node_ID);
+  HECMW_free(s->elem_ID);
+  HECMW_free(s->filename);
+  HECMW_free(s);
+}
+
+struct hecmwST_result_series *HECMW_result_series_open(char *filename) {
+  struct hecmwST_result_series *s;
+  long long end;
+  int rtc;
+
+  s = HECMW_calloc(1, sizeof(*s));
+  if (s == NULL) {
+    HECMW_set_error(errno, "");
+    return NULL;
+  }
+  s->filename = HECMW_strdup(filename);
+  if (s->filename == NULL) {
+    HECMW_set_error(errno, "");
+    goto error;
+  }
+
+  if ((s->fp = fopen(filename, "rb")) == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0201, "File: %s, %s", filename,
+                    HECMW_strmsg(errno));
+    goto error;
+  }
+  rtc = read_header(s->fp, &s->last, &end, &s->n_node, &s->n_elem);
+  if (rtc > 0) {
+    HECMW_set_error(HECMW_UTIL_E0202, "%s is not result series file",
+                    filename);
+    goto error;
+  }
+  if (rtc < 0) goto error;
+
+  s->node_ID = HECMW_malloc(sizeof(int) * (s->n_node + 1));
+  s->elem_ID = HECMW_malloc(sizeof(int) * (s->n_elem + 1));
+  if (s->node_ID == NULL || s->elem_ID == NULL) {
+    HECMW_set_error(errno, "");
+    goto error;
+  }
+  if (ser_read(s->node_ID, sizeof(int) * s->n_node, s->fp)) goto error;
+  if (ser_read(s->elem_ID, sizeof(int) * s->n_elem, s->fp)) goto error;
+
+  if (read_chain(s->fp, s->last, &s->n_step, &s->step)) goto error;
+  if (make_index(s)) goto error;
+  return s;
+
+error:
+  HECMW_result_series_close(s);
+  return NULL;
+}
+
+int HECMW_result_series_get_n_step(struct hecmwST_result_series *s) {
+  return s->n_step;
+}
+
+int HECMW_result_series_get_step(struct hecmwST_result_series *s, int i,
+                                 int *i_step, double *time) {
+  if (i < 0 || i >= s->n_step) return -1;
+  if (i_step) *i_step = s->step[i].i_step;
+  if (time) *time = s->step[i].time;
+  return 0;
+}
+
+int HECMW_result_series_get_nnode(struct hecmwST_result_series *s) {
+  return s->n_node;
+}
+
+int HECMW_result_series_get_nelem(struct hecmwST_result_series *s) {
+  return s->n_elem;
+}
+
+static struct series_step *find_step(struct hecmwST_result_series *s,
+                                     int i_step) {
+  int lo = 0, hi = s->n_step - 1, mid;
+
+  while (lo <= hi) {
+    mid = (lo + hi) / 2;
+    if (s->step[s->sorted[mid]].i_step == i_step)
+      return &s->step[s->sorted[mid]];
+    if (s->step[s->sorted[mid]].i_step < i_step) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return NULL;
+}
+
+int HECMW_result_series_has_step(struct hecmwST_result_series *s,
+                                 int i_step) {
+  return find_step(s, i_step) != NULL;
+}
+
+static int n_items(struct hecmwST_result_series *s, int dtype) {
+  return (dtype == DTYPE_NODE) ? s->n_node
+                               : (dtype == DTYPE_ELEM) ? s->n_elem : 1;
+}
+
+/*
+ * Read the items item[] (all if NULL) of a field into
+ * val[j * stride + k], k < n_dof, j < n_item.
+ */
+static int read_values(struct hecmwST_result_series *s,
+                       const struct series_field *f, int n_item,
+                       const int *item, double *val, int stride) {
+  int n = n_items(s, f->dtype), i, j;
+  size_t size = sizeof(double) * f->n_dof;
+  double *buf;
+
+  if (f->n_dof == 0) return 0;
+
+  if (item != NULL && (long long)n_item * SPARSE_RATIO < n) {
+    for (j = 0; j < n_item; j++) {
+      if (ser_seek(s->fp, f->offset + (long long)item[j] * size)) return -1;
+      if (ser_read(val + (size_t)j * stride, size, s->fp)) return -1;
+    }
+    return 0;
+  }
+
+  if (ser_seek(s->fp, f->offset)) return -1;
+  if (item == NULL && stride == f->n_dof)
+    return ser_read(val, size * n, s->fp);
+
+  buf = HECMW_malloc(size * n + 1);
+  if (buf == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  if (ser_read(buf, size * n, s->fp)) {
+    HECMW_free(buf);
+    return -1;
+  }
+  for (j = 0; j < (item ? n_item : n); j++) {
+    i = item ? item[j] : j;
+    memcpy(val + (size_t)j * stride, buf + (size_t)i * f->n_dof, size);
+  }
+  HECMW_free(buf);
+  return 0;
+}
+
+static int check_items(int n, int n_item, const int *item) {
+  int j;
+  if (item == NULL) return 0;
+  if (n_item < 0) {
+    HECMW_set_error(HECMW_ALL_E0101, "number of items");
+    return -1;
+  }
+  for (j = 0; j < n_item; j++) {
+    if (item[j] < 0 || item[j] >= n) {
+      HECMW_set_error(HECMW_ALL_E0101, "item %d out of range", item[j]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static struct series_step *get_step(struct hecmwST_result_series *s,
+                                    int i_step) {
+  struct series_step *st = find_step(s, i_step);
+  if (st == NULL) {
+    HECMW_set_error(HECMW_UTIL_E0205, "%s: step %d not found", s->filename,
+                    i_step);
+  }
+  return st;
+}
+
+int HECMW_result_series_read_field(struct hecmwST_result_series *s,
+                                   int i_step, int dtype, char *label,
+                                   int n_item, int *item, double *val) {
+  struct series_step *st;
+  int i;
+
+  if ((st = get_step(s, i_step)) == NULL) return -1;
+  if (check_items(n_items(s, dtype), n_item, item)) return -1;
+
+  for (i = 0; i < st->n_field; i++) {
+    struct series_field *f = &st->field[i];
+    if (f->dtype != dtype || strcmp(f->label, label) != 0) continue;
+    if (read_values(s, f, n_item, item, val, f->n_dof)) return -1;
+    return f->n_dof;
+  }
+  HECMW_set_error(HECMW_UTIL_E0207, "%s: %s not found in step %d",
+                  s->filename, label, i_step);
+  return -1;
+}
+
+static int is_selected(const char *label, int n_label, char **labels) {
+  int i;
+  if (n_label <= 0) return 1;
+  for (i = 0; i < n_label; i++) {
+    if (strcmp(label, labels[i]) == 0) return 1;
+  }
+  return 0;
+}
+
+/* the selected fields of one kind, as the components of a result */
+static int read_components(struct hecmwST_result_series *s,
+                           struct series_step *st, int dtype, int n_label,
+                           char **labels, int n_item, const int *item,
+                           int *n_comp, int **dof, char ***label,
+                           double **val) {
+  int i, k, n_dof, off;
+
+  *n_comp = 0;
+  n_dof   = 0;
+  for (i = 0; i < st->n_field; i++) {
+    if (st->field[i].dtype == dtype &&
+        is_selected(st->field[i].label, n_label, labels)) {
+      (*n_comp)++;
+      n_dof += st->field[i].n_dof;
+    }
+  }
+  if (*n_comp == 0) return 0;
+
+  *dof   = HECMW_malloc(sizeof(int) * (*n_comp));
+  *label = HECMW_calloc(*n_comp, sizeof(**label));
+  *val   = HECMW_malloc(sizeof(double) * ((size_t)n_item * n_dof + 1));
+  if (*dof == NULL || *label == NULL || *val == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+
+  for (i = 0, k = 0, off = 0; i < st->n_field; i++) {
+    struct series_field *f = &st->field[i];
+    if (f->dtype != dtype || !is_selected(f->label, n_label, labels))
+      continue;
+    (*dof)[k]   = f->n_dof;
+    (*label)[k] = HECMW_strdup(f->label);
+    if ((*label)[k] == NULL) {
+      HECMW_set_error(errno, "");
+      return -1;
+    }
+    if (read_values(s, f, n_item, item, *val + off, n_dof)) return -1;
+    off += f->n_dof;
+    k++;
+  }
+  return 0;
+}
+
+static int *select_ids(const int *id, int n, int n_item, const int *item) {
+  int *sel, j;
+
+  sel = HECMW_malloc(sizeof(int) * (n_item + 1));
+  if (sel == NULL) {
+    HECMW_set_error(errno, "");
+    return NULL;
+  }
+  for (j = 0; j < n_item; j++) sel[j] = id[item ? item[j] : j];
+  return sel;
+}
+
+static void free_labels(int n, char **label) {
+  int i;
+  if (label == NULL) return;
+  for (i = 0; i < n; i++) HECMW_free(label[i]);
+  HECMW_free(label);
+}
+
+/* HECMW_result_free for a result read halfway */
+static void free_result(struct hecmwST_result_data *result) {
+  free_labels(result->ng_component, result->global_label);
+  free_labels(result->nn_component, result->node_label);
+  free_labels(result->ne_component, result->elem_label);
+  HECMW_free(result->ng_dof);
+  HECMW_free(result->nn_dof);
+  HECMW_free(result->ne_dof);
+  HECMW_free(result->global_val_item);
+  HECMW_free(result->node_val_item);
+  HECMW_free(result->elem_val_item);
+  HECMW_free(result);
+}
+
+/*
+ * Read the fields labels[] (all if n_label is 0) of step i_step for the
+ * nodes node[] and the elements elem[] (all if NULL), given by their
+ * position in the file. As with the other formats, the header, the comment
+ * and the IDs of the items read are kept for HECMW_result_get_*().
+ */
+struct hecmwST_result_data *HECMW_result_series_read(
+    struct hecmwST_result_series *s, int i_step, int n_label, char **labels,
+    int n_node, int *node, int n_elem, int *elem) {
+  struct hecmwST_result_data *result;
+  struct series_step *st;
+  int *node_ID = NULL, *elem_ID = NULL;
+
+  if ((st = get_step(s, i_step)) == NULL) return NULL;
+  if (check_items(s->n_node, n_node, node)) return NULL;
+  if (check_items(s->n_elem, n_elem, elem)) return NULL;
+  if (node == NULL) n_node = s->n_node;
+  if (elem == NULL) n_elem = s->n_elem;
+
+  result = HECMW_calloc(1, sizeof(*result));
+  if (result == NULL) {
+    HECMW_set_error(errno, "");
+    return NULL;
+  }
+
+  if (read_components(s, st, DTYPE_GLOBAL, n_label, labels, 1, NULL,
+                      &result->ng_component, &result->ng_dof,
+                      &result->global_label, &result->global_val_item))
+    goto error;
+  if (read_components(s, st, DTYPE_NODE, n_label, labels, n_node, node,
+                      &result->nn_component, &result->nn_dof,
+                      &result->node_label, &result->node_val_item))
+    goto error;
+  if (read_components(s, st, DTYPE_ELEM, n_label, labels, n_elem, elem,
+                      &result->ne_component, &result->ne_dof,
+                      &result->elem_label, &result->elem_val_item))
+    goto error;
+
+  node_ID = select_ids(s->node_ID, s->n_node, n_node, node);
+  elem_ID = select_ids(s->elem_ID, s->n_elem, n_elem, elem);
+  if (node_ID == NULL || elem_ID == NULL) goto error;
+
+  strcpy(head, st->header);
+  strcpy(comment_line, st->comment);
+  nnode          = n_node;
+  nelem          = n_elem;
+  node_global_ID = node_ID;
+  elem_global_ID = elem_ID;
+  return result;
+
+error:
+  HECMW_free(node_ID);
+  HECMW_free(elem_ID);
+  free_result(result);
+  return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* the series of filename, opened again only when it has been appended to */
+static struct hecmwST_result_series *get_series(char *filename) {
+  long long last;
+
+  if (cache && strcmp(cache->filename, filename) == 0) {
+    if (fseek(cache->fp, (long)RES_SER_POS_LAST, SEEK_SET) == 0 &&
+        fread(&last, sizeof(last), 1, cache->fp) == 1 && last == cache->last)
+      return cache;
+  }
+  HECMW_result_series_clear();
+  cache = HECMW_result_series_open(filename);
+  return cache;
+}
+
+void HECMW_result_series_clear(void) {
+  HECMW_result_series_close(cache);
+  cache = NULL;
+}
+
+int HECMW_judge_result_series_step(char *filename, int i_step) {
+  FILE *fp;
+  long long last, end;
+  int n_node, n_elem;
+
+  if ((fp = fopen(filename, "rb")) == NULL) return 0;
+  if (read_header(fp, &last, &end, &n_node, &n_elem)) {
+    fclose(fp);
+    return 0;
+  }
+  fclose(fp);
+
+  if (get_series(filename) == NULL) return 0;
+  return HECMW_result_series_has_step(cache, i_step);
+}
+
+struct hecmwST_result_data *HECMW_result_read_series_by_fname(
+    char *filename, int i_step, int n_label, char **labels, int n_node,
+    int *node, int n_elem, int *elem) {
+  if (get_series(filename) == NULL) return NULL;
+  return HECMW_result_series_read(cache, i_step, n_label, labels, n_node,
+                                  node, n_elem, elem);
+}
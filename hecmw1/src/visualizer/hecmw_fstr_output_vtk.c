@@ -5,6 +5,7 @@
 #include "hecmw_fstr_output_vtk.h"
 
 #include <stdint.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -16,6 +17,10 @@
 #include "hecmw_vis_combine.h"
 #include "hecmw_fstr_endian.h"
 
+#ifdef HECMW_WITH_ZLIB
+#include <zlib.h>
+#endif
+
 void vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, HECMW_Comm VIS_COMM)
 {
 	int i, j, k;
@@ -200,260 +205,433 @@ void vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *da
 	fclose (outfp);
 }
 
-void bin_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, HECMW_Comm VIS_COMM)
+/*
+ * Binary VTU pieces use the appended raw encoding with UInt64 block headers.
+ * Every array of a piece is converted and (optionally) zlib compressed into a
+ * single memory image, so that the whole piece leaves the process in one
+ * fwrite. With n_group > 1 the pieces of n_group consecutive ranks are
+ * collected by the first rank of the group and stored in one .vtu file.
+ */
+
+#define VTK_ZLIB_BLOCK_SIZE 65536
+#define VTK_COMM_CHUNK      (1 << 30)
+
+typedef struct {
+	char *data;
+	size_t len;
+	size_t size;
+} vtk_buffer;
+
+static void vtk_buffer_reserve (vtk_buffer *b, size_t n)
 {
-	int i, j, k;
-	int jS, jE;
-	int myrank, petot, steptot;
-	int n_node, n_elem, shift, etype;
-	int data_tot_n, data_tot_e, in, ioffset;
-	int *offset;
-	uint8_t uint8;
-	uint16_t uint16;
-	uint32_t uint32;
-	uint64_t uint64;
-	float val, val1, val2, val3;
-	char file_pvd[HECMW_FILENAME_LEN], file_pvtu[HECMW_FILENAME_LEN], file_vtu[HECMW_FILENAME_LEN], buf[HECMW_FILENAME_LEN];
-	char *data_label;
-	static int is_first=0;
+	size_t size;
+
+	if (b->len + n <= b->size) return;
+	size = (b->size > 0) ? b->size : 65536;
+	while (size < b->len + n) size *= 2;
+	b->data = (char *)HECMW_realloc (b->data, size);
+	if (b->data == NULL) HECMW_vis_memory_exit ("vtk_buffer");
+	b->size = size;
+}
+
+static void vtk_buffer_append (vtk_buffer *b, const void *p, size_t n)
+{
+	vtk_buffer_reserve (b, n);
+	memcpy (b->data + b->len, p, n);
+	b->len += n;
+}
+
+static void vtk_buffer_printf (vtk_buffer *b, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	vtk_buffer_reserve (b, 256);
+	va_start (ap, fmt);
+	n = vsnprintf (b->data + b->len, b->size - b->len, fmt, ap);
+	va_end (ap);
+	if ((size_t)n >= b->size - b->len) {
+		vtk_buffer_reserve (b, n + 1);
+		va_start (ap, fmt);
+		vsnprintf (b->data + b->len, b->size - b->len, fmt, ap);
+		va_end (ap);
+	}
+	b->len += n;
+}
+
+static void vtk_buffer_free (vtk_buffer *b)
+{
+	HECMW_free (b->data);
+	b->data = NULL;
+	b->len = b->size = 0;
+}
+
+/* append one array of n bytes as an appended data block */
+static void vtk_append_array (vtk_buffer *b, const void *p, size_t n, int compress)
+{
+	uint64_t header[3];
+#ifdef HECMW_WITH_ZLIB
+	uint64_t csize;
+	size_t nblock, i, pos, len;
+#endif
+
+	if (!compress) {
+		header[0] = n;
+		vtk_buffer_append (b, header, sizeof(uint64_t));
+		vtk_buffer_append (b, p, n);
+		return;
+	}
+#ifdef HECMW_WITH_ZLIB
+	nblock = (n + VTK_ZLIB_BLOCK_SIZE - 1) / VTK_ZLIB_BLOCK_SIZE;
+	header[0] = nblock;
+	header[1] = VTK_ZLIB_BLOCK_SIZE;
+	header[2] = n % VTK_ZLIB_BLOCK_SIZE;
+	vtk_buffer_append (b, header, 3*sizeof(uint64_t));
+	pos = b->len;
+	vtk_buffer_reserve (b, nblock*sizeof(uint64_t));
+	b->len += nblock*sizeof(uint64_t);
+	for(i=0; i<nblock; i++){
+		uLongf clen;
+		len = n - i*VTK_ZLIB_BLOCK_SIZE;
+		if (len > VTK_ZLIB_BLOCK_SIZE) len = VTK_ZLIB_BLOCK_SIZE;
+		clen = compressBound (len);
+		vtk_buffer_reserve (b, clen);
+		if (compress2 ((Bytef *)b->data + b->len, &clen, (const Bytef *)p + i*VTK_ZLIB_BLOCK_SIZE, len, Z_BEST_SPEED) != Z_OK) {
+			HECMW_vis_print_exit ("ERROR: HEC-MW-VIS-E0010: Cannot compress VTK data");
+		}
+		csize = clen;
+		memcpy (b->data + pos + i*sizeof(uint64_t), &csize, sizeof(uint64_t));
+		b->len += clen;
+	}
+#else
+	HECMW_vis_print_exit ("ERROR: HEC-MW-VIS-E0010: zlib is not available");
+#endif
+}
+
+static int vtk_n_dropped_node (int etype)
+{
+	if(etype==641) return 2;
+	if(etype==761) return 3;
+	if(etype==781) return 4;
+	return 0;
+}
+
+/* encode all arrays of the local piece; offset[] receives the block offsets */
+static void vtk_encode_piece (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, int compress, vtk_buffer *blob, size_t *offset)
+{
+	int i, j, k, n;
+	int jS, jE, shift;
+	int n_node, n_elem, n_conn, data_tot_n, data_tot_e, max_dof;
 	int table342[10] = {0, 1, 2, 3, 6, 4, 5, 7, 8, 9};
-	FILE *outfp;
-	HECMW_Status stat;
+	size_t work_size;
+	void *work;
+	float *fval;
+	int *ival;
 
-	HECMW_Comm_rank (VIS_COMM, &myrank);
-	HECMW_Comm_size (VIS_COMM, &petot);
 	n_node = mesh->n_node;
 	n_elem = mesh->n_elem;
 	data_tot_n = 0;
+	max_dof = 3;
 	for(i=0; i<data->nn_component; i++){
 		data_tot_n += data->nn_dof[i];
+		if (data->nn_dof[i] > max_dof) max_dof = data->nn_dof[i];
 	}
 	data_tot_e = 0;
 	for(i=0; i<data->ne_component; i++){
 		data_tot_e += data->ne_dof[i];
 	}
+	n_conn = 0;
+	for(i=0; i<n_elem; i++){
+		n_conn += mesh->elem_node_index[i+1] - mesh->elem_node_index[i] - vtk_n_dropped_node (mesh->elem_type[i]);
+	}
 
-	sprintf(file_vtu,  "%s/%s.%d.vtu", outfile1, outfile, myrank);
-	if(HECMW_ctrl_make_subdir(file_vtu)) {
-		HECMW_vis_print_exit("ERROR: HEC-MW-VIS-E0009: Cannot open output directory");
+	work_size = (size_t)max_dof*n_node;
+	if ((size_t)n_conn > work_size) work_size = n_conn;
+	for(i=0; i<data->ne_component; i++){
+		if ((size_t)data->ne_dof[i]*n_elem > work_size) work_size = (size_t)data->ne_dof[i]*n_elem;
 	}
+	if (work_size < (size_t)n_elem) work_size = n_elem;
+	work = HECMW_malloc (sizeof(float)*(work_size+1));
+	if (work == NULL) HECMW_vis_memory_exit ("work");
+	fval = (float *)work;
+	ival = (int *)work;
 
-	if (myrank == 0) {
-		/* outpu pvtu file */
-		sprintf(file_pvtu, "%s.pvtu", outfile1);
-		outfp = fopen (file_pvtu, "wb");
-		fprintf (outfp, "<?xml version=\"1.0\"?>\n");
-		fprintf (outfp, "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt32\">\n", HECMW_endian_str());
-		fprintf (outfp, "<PUnstructuredGrid>\n");
-		for(i=0; i<data->ng_component; i++){
-			fprintf (outfp, "<PDataArray type=\"Float32\" Name=\"%s\" NumberOfTuples=\"%d\"/>\n", data->global_label[i], data->ng_dof[i]);
-		}
-		fprintf (outfp, "<PPoints>\n");
-		fprintf (outfp, "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n");
-		fprintf (outfp, "</PPoints>\n");
-		fprintf (outfp, "<PCells>\n");
-		fprintf (outfp, "<PDataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\"/>\n");
-		fprintf (outfp, "<PDataArray type=\"Int32\" Name=\"offsets\" format=\"appended\"/>\n");
-		fprintf (outfp, "<PDataArray type=\"Int32\" Name=\"types\" format=\"appended\"/>\n");
-		fprintf (outfp, "</PCells>\n");
-		fprintf (outfp, "<PPointData>\n");
-		for(i=0; i<data->nn_component; i++){
-			fprintf (outfp, "<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\"/>\n", data->node_label[i], data->nn_dof[i]);
-		}
-		fprintf (outfp, "</PPointData>\n");
-		fprintf (outfp, "<PCellData>\n");
-		for(i=0; i<data->ne_component; i++){
-			fprintf (outfp, "<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\"/>\n", data->elem_label[i], data->ne_dof[i]);
-		}
-		fprintf (outfp, "<PDataArray type=\"Int32\" Name=\"Mesh_Type\" NumberOfComponents=\"1\" format=\"appended\"/>\n");
-		fprintf (outfp, "</PCellData>\n");
-		for(i=0; i<petot; i++){
-			sprintf (buf,  "./%s/%s.%d.vtu", outfile, outfile, i);
-			fprintf (outfp, "<Piece Source=\"%s\"/>\n", buf);
+	n = 0;
+	offset[n++] = blob->len;
+	for(i=0; i<3*n_node; i++){
+		fval[i] = (float)mesh->node[i];
+	}
+	vtk_append_array (blob, work, sizeof(float)*3*n_node, compress);
+
+	offset[n++] = blob->len;
+	k = 0;
+	for(i=0; i<n_elem; i++){
+		jS=mesh->elem_node_index[i];
+		jE=mesh->elem_node_index[i+1]-vtk_n_dropped_node (mesh->elem_type[i]);
+		if(mesh->elem_type[i]==342){
+			for(j=jS; j<jE; j++){
+				ival[k++] = (int)mesh->elem_node_item[jS+table342[j-jS]]-1;
+			}
+		}else{
+			for(j=jS; j<jE; j++){
+				ival[k++] = (int)mesh->elem_node_item[j]-1;
+			}
 		}
-		fprintf (outfp, "</PUnstructuredGrid>\n");
-		fprintf (outfp, "</VTKFile>\n");
-		fclose (outfp);
-		is_first = 1;
 	}
+	vtk_append_array (blob, work, sizeof(int)*n_conn, compress);
 
-	/* outpu vtu file */
-	ioffset = 5 + data->nn_component + data->ne_component;
-	offset = HECMW_malloc(sizeof(int)*ioffset);
+	offset[n++] = blob->len;
+	shift=0;
+	for(i=0; i<n_elem; i++){
+		shift += vtk_n_dropped_node (mesh->elem_type[i]);
+		ival[i] = (int)mesh->elem_node_index[i+1]-shift;
+	}
+	vtk_append_array (blob, work, sizeof(int)*n_elem, compress);
 
-	uint64 = 0;
+	offset[n++] = blob->len;
 	for(i=0; i<n_elem; i++){
-		jS=mesh->elem_node_index[i];
-		jE=mesh->elem_node_index[i+1];
-		shift=0;
-		if(mesh->elem_type[i]==641) shift=2;
-		if(mesh->elem_type[i]==761) shift=3;
-		if(mesh->elem_type[i]==781) shift=4;
-		uint64 += jE-shift-jS;
+		ival[i] = (int)HECMW_get_etype_vtk_shape(mesh->elem_type[i]);
 	}
+	vtk_append_array (blob, work, sizeof(int)*n_elem, compress);
 
-	offset[0] = 0;
-	offset[1] = offset[0] + sizeof(int) + 3*n_node   *sizeof(float);
-	offset[2] = offset[1] + sizeof(int) + (int)uint64*sizeof(int);
-	offset[3] = offset[2] + sizeof(int) + n_elem     *sizeof(int);
-	offset[4] = offset[3] + sizeof(int) + n_elem     *sizeof(int);
+	shift=0;
 	for(i=0; i<data->nn_component; i++){
-		offset[5+i] = offset[4+i] + sizeof(int) + data->nn_dof[i]*n_node*sizeof(int);
+		offset[n++] = blob->len;
+		k = 0;
+		for(j=0; j<n_node; j++){
+			for(jS=0; jS<data->nn_dof[i]; jS++){
+				fval[k++] = (float)data->node_val_item[(size_t)j*data_tot_n+jS+shift];
+			}
+		}
+		vtk_append_array (blob, work, sizeof(float)*k, compress);
+		shift += data->nn_dof[i];
 	}
+
+	shift=0;
 	for(i=0; i<data->ne_component; i++){
-		offset[5+data->nn_component+i] = offset[4+data->nn_component+i] + sizeof(int) + data->ne_dof[i]*n_elem*sizeof(int);
+		offset[n++] = blob->len;
+		k = 0;
+		for(j=0; j<n_elem; j++){
+			for(jS=0; jS<data->ne_dof[i]; jS++){
+				fval[k++] = (float)data->elem_val_item[(size_t)j*data_tot_e+jS+shift];
+			}
+		}
+		vtk_append_array (blob, work, sizeof(float)*k, compress);
+		shift += data->ne_dof[i];
 	}
 
-	outfp = fopen (file_vtu, "wb");
-	fprintf (outfp, "<?xml version=\"1.0\"?>\n");
-	fprintf (outfp, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt32\">\n", HECMW_endian_str());
-	fprintf (outfp, "<UnstructuredGrid>\n");
-	fprintf (outfp, "<FieldData>\n");
-	for(i=0; i<data->ng_component; i++){
-		fprintf (outfp, "<DataArray type=\"Float32\" Name=\"%s\" NumberOfTuples=\"%d\"  >\n", data->global_label[i], data->ng_dof[i]);
-		shift=0;
-		for(j=0; j<i; j++){
-			shift += data->ng_dof[j];
-		}
-    for(k=0; k<data->ng_dof[i]; k++){
-      fprintf (outfp, "%e ", (float)data->global_val_item[k+shift]);
-    }
-    fprintf (outfp, "\n");
-		fprintf (outfp, "</DataArray>\n");
+	offset[n++] = blob->len;
+	for(i=0; i<n_elem; i++){
+		ival[i] = (int)mesh->elem_type[i];
 	}
-	fprintf (outfp, "</FieldData>\n");
-	fprintf (outfp, "<Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", n_node, n_elem);
-	fprintf (outfp, "<Points>\n");
-	fprintf (outfp, "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%d\">\n", offset[0]);
-	fprintf (outfp, "</DataArray>\n");
-	fprintf (outfp, "</Points>\n");
-	fprintf (outfp, "<Cells>\n");
-	fprintf (outfp, "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%d\">\n", offset[1]);
-	fprintf (outfp, "</DataArray>\n");
-	fprintf (outfp, "<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%d\">\n", offset[2]);
-	fprintf (outfp, "</DataArray>\n");
-	fprintf (outfp, "<DataArray type=\"Int32\" Name=\"types\" format=\"appended\" offset=\"%d\">\n", offset[3]);
-	fprintf (outfp, "</DataArray>\n");
-	fprintf (outfp, "</Cells>\n");
-	fprintf (outfp, "<PointData>\n");
+	vtk_append_array (blob, work, sizeof(int)*n_elem, compress);
+	offset[n] = blob->len;
+
+	HECMW_free (work);
+}
+
+static void vtk_write_piece (vtk_buffer *x, struct hecmwST_result_data *data, int n_node, int n_elem, size_t *offset, size_t base)
+{
+	int i, n;
 
+	n = 0;
+	vtk_buffer_printf (x, "<Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", n_node, n_elem);
+	vtk_buffer_printf (x, "<Points>\n");
+	vtk_buffer_printf (x, "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%llu\">\n", (unsigned long long)(base+offset[n++]));
+	vtk_buffer_printf (x, "</DataArray>\n");
+	vtk_buffer_printf (x, "</Points>\n");
+	vtk_buffer_printf (x, "<Cells>\n");
+	vtk_buffer_printf (x, "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%llu\">\n", (unsigned long long)(base+offset[n++]));
+	vtk_buffer_printf (x, "</DataArray>\n");
+	vtk_buffer_printf (x, "<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%llu\">\n", (unsigned long long)(base+offset[n++]));
+	vtk_buffer_printf (x, "</DataArray>\n");
+	vtk_buffer_printf (x, "<DataArray type=\"Int32\" Name=\"types\" format=\"appended\" offset=\"%llu\">\n", (unsigned long long)(base+offset[n++]));
+	vtk_buffer_printf (x, "</DataArray>\n");
+	vtk_buffer_printf (x, "</Cells>\n");
+	vtk_buffer_printf (x, "<PointData>\n");
 	for(i=0; i<data->nn_component; i++){
-		fprintf (outfp, "<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%d\">\n", data->node_label[i], data->nn_dof[i], offset[4+i]);
-		fprintf (outfp, "</DataArray>\n");
+		vtk_buffer_printf (x, "<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%llu\">\n", data->node_label[i], data->nn_dof[i], (unsigned long long)(base+offset[n++]));
+		vtk_buffer_printf (x, "</DataArray>\n");
 	}
-
-	fprintf (outfp, "</PointData>\n");
-	fprintf (outfp, "<CellData>\n");
+	vtk_buffer_printf (x, "</PointData>\n");
+	vtk_buffer_printf (x, "<CellData>\n");
 	for(i=0; i<data->ne_component; i++){
-		fprintf (outfp, "<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%d\">\n", data->elem_label[i], data->ne_dof[i], offset[4+data->nn_component+i]);
-		fprintf (outfp, "</DataArray>\n");
+		vtk_buffer_printf (x, "<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%llu\">\n", data->elem_label[i], data->ne_dof[i], (unsigned long long)(base+offset[n++]));
+		vtk_buffer_printf (x, "</DataArray>\n");
 	}
+	vtk_buffer_printf (x, "<DataArray type=\"Int32\" Name=\"Mesh_Type\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%llu\">\n", (unsigned long long)(base+offset[n++]));
+	vtk_buffer_printf (x, "</DataArray>\n");
+	vtk_buffer_printf (x, "</CellData>\n");
+	vtk_buffer_printf (x, "</Piece>\n");
+}
 
-	fprintf (outfp, "<DataArray type=\"Int32\" Name=\"Mesh_Type\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%d\">\n", offset[ioffset-1]);
-	fprintf (outfp, "</DataArray>\n");
-	fprintf (outfp, "</CellData>\n");
-	fprintf (outfp, "</Piece>\n");
-	fprintf (outfp, "</UnstructuredGrid>\n");
-	fprintf (outfp, "<AppendedData encoding=\"raw\">\n");
+static void vtk_write_header (vtk_buffer *x, const char *type, int compress)
+{
+	vtk_buffer_printf (x, "<?xml version=\"1.0\"?>\n");
+	vtk_buffer_printf (x, "<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\"%s>\n", type, HECMW_endian_str(),
+			compress ? " compressor=\"vtkZLibDataCompressor\"" : "");
+}
 
-	fprintf (outfp, " _");
-	uint32 = (uint32_t)(3*n_node*sizeof(float));
-	fwrite (&uint32, sizeof(uint32), 1, outfp);
-	for(i=0; i<n_node; i++){
-		val = (float)mesh->node[3*i];
-		fwrite (&val, sizeof(float), 1, outfp);
-		val = (float)mesh->node[3*i+1];
-		fwrite (&val, sizeof(float), 1, outfp);
-		val = (float)mesh->node[3*i+2];
-		fwrite (&val, sizeof(float), 1, outfp);
+static void vtk_fwrite (const void *p, size_t n, FILE *outfp)
+{
+	if (n > 0 && fwrite (p, 1, n, outfp) != n) {
+		HECMW_vis_print_exit ("ERROR: HEC-MW-VIS-E0011: Cannot write VTK file");
 	}
+}
 
-	uint32 = (uint32_t)(uint64*sizeof(int));
-	fwrite (&uint32, sizeof(uint32), 1, outfp);
-	for(i=0; i<n_elem; i++){
-		jS=mesh->elem_node_index[i];
-		jE=mesh->elem_node_index[i+1];
-		shift=0;
-		if(mesh->elem_type[i]==641) shift=2;
-		if(mesh->elem_type[i]==761) shift=3;
-		if(mesh->elem_type[i]==781) shift=4;
-		if(mesh->elem_type[i]==342){
-			for(j=jS; j<jE-shift; j++){
-				in = (int)mesh->elem_node_item[jS+table342[j-jS]]-1;
-				fwrite (&in, sizeof(int), 1, outfp);
-			}
-		}else{
-			for(j=jS; j<jE-shift; j++){
-				in = (int)mesh->elem_node_item[j]-1;
-				fwrite (&in, sizeof(int), 1, outfp);
-			}
-		}
+void bin_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, int compress, int n_group, HECMW_Comm VIS_COMM)
+{
+	int i, j, k;
+	int myrank, petot, leader, n_member, n_array;
+	char file_pvtu[HECMW_FILENAME_LEN], file_vtu[HECMW_FILENAME_LEN], buf[HECMW_FILENAME_LEN];
+	size_t *offset, base, len, n;
+	double *meta;
+	vtk_buffer xml = {NULL, 0, 0}, blob = {NULL, 0, 0};
+	FILE *outfp;
+	HECMW_Status stat;
+
+	HECMW_Comm_rank (VIS_COMM, &myrank);
+	HECMW_Comm_size (VIS_COMM, &petot);
+
+#ifndef HECMW_WITH_ZLIB
+	if (compress) {
+		if (myrank == 0) fprintf (stderr, "Warning: compiled without zlib, COMP_VTK is written without compression\n");
+		compress = 0;
 	}
+#endif
+	if (n_group < 1) n_group = 1;
+	leader = myrank - myrank % n_group;
+	n_member = (leader + n_group < petot) ? n_group : petot - leader;
+	n_array = 5 + data->nn_component + data->ne_component;
 
-	uint32 = (uint32_t)(n_elem*sizeof(int));
-	fwrite (&uint32, sizeof(uint32), 1, outfp);
-	shift=0;
-	for(i=0; i<n_elem; i++){
-		if(mesh->elem_type[i]==641) shift+=2;
-		if(mesh->elem_type[i]==761) shift+=3;
-		if(mesh->elem_type[i]==781) shift+=4;
-		in = (int)mesh->elem_node_index[i+1]-shift;
-		fwrite (&in, sizeof(int), 1, outfp);
+	sprintf(file_vtu,  "%s/%s.%d.vtu", outfile1, outfile, myrank);
+	if(myrank == leader && HECMW_ctrl_make_subdir(file_vtu)) {
+		HECMW_vis_print_exit("ERROR: HEC-MW-VIS-E0009: Cannot open output directory");
 	}
 
-	uint32 = (uint32_t)(n_elem*sizeof(int));
-	fwrite (&uint32, sizeof(uint32), 1, outfp);
-	for(i=0; i<n_elem; i++){
-		//uint8 = (uint8_t)HECMW_get_etype_vtk_shape(mesh->elem_type[i]);
-	  //fwrite (&uint8, sizeof(u_int8_t), 1, outfp);
-		in = (int)HECMW_get_etype_vtk_shape(mesh->elem_type[i]);
-	  fwrite (&in, sizeof(int), 1, outfp);
+	if (myrank == 0) {
+		/* outpu pvtu file */
+		vtk_write_header (&xml, "PUnstructuredGrid", compress);
+		vtk_buffer_printf (&xml, "<PUnstructuredGrid>\n");
+		for(i=0; i<data->ng_component; i++){
+			vtk_buffer_printf (&xml, "<PDataArray type=\"Float32\" Name=\"%s\" NumberOfTuples=\"%d\"/>\n", data->global_label[i], data->ng_dof[i]);
+		}
+		vtk_buffer_printf (&xml, "<PPoints>\n");
+		vtk_buffer_printf (&xml, "<PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n");
+		vtk_buffer_printf (&xml, "</PPoints>\n");
+		vtk_buffer_printf (&xml, "<PCells>\n");
+		vtk_buffer_printf (&xml, "<PDataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\"/>\n");
+		vtk_buffer_printf (&xml, "<PDataArray type=\"Int32\" Name=\"offsets\" format=\"appended\"/>\n");
+		vtk_buffer_printf (&xml, "<PDataArray type=\"Int32\" Name=\"types\" format=\"appended\"/>\n");
+		vtk_buffer_printf (&xml, "</PCells>\n");
+		vtk_buffer_printf (&xml, "<PPointData>\n");
+		for(i=0; i<data->nn_component; i++){
+			vtk_buffer_printf (&xml, "<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\"/>\n", data->node_label[i], data->nn_dof[i]);
+		}
+		vtk_buffer_printf (&xml, "</PPointData>\n");
+		vtk_buffer_printf (&xml, "<PCellData>\n");
+		for(i=0; i<data->ne_component; i++){
+			vtk_buffer_printf (&xml, "<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\"/>\n", data->elem_label[i], data->ne_dof[i]);
+		}
+		vtk_buffer_printf (&xml, "<PDataArray type=\"Int32\" Name=\"Mesh_Type\" NumberOfComponents=\"1\" format=\"appended\"/>\n");
+		vtk_buffer_printf (&xml, "</PCellData>\n");
+		for(i=0; i<petot; i+=n_group){
+			sprintf (buf,  "./%s/%s.%d.vtu", outfile, outfile, i);
+			vtk_buffer_printf (&xml, "<Piece Source=\"%s\"/>\n", buf);
+		}
+		vtk_buffer_printf (&xml, "</PUnstructuredGrid>\n");
+		vtk_buffer_printf (&xml, "</VTKFile>\n");
+
+		sprintf(file_pvtu, "%s.pvtu", outfile1);
+		outfp = fopen (file_pvtu, "wb");
+		if (outfp == NULL) HECMW_vis_print_exit ("ERROR: HEC-MW-VIS-E0009: Cannot open output file");
+		vtk_fwrite (xml.data, xml.len, outfp);
+		fclose (outfp);
+		xml.len = 0;
 	}
 
-	for(i=0; i<data->nn_component; i++){
-		uint32 = (uint32_t)(data->nn_dof[i]*n_node*sizeof(int));
-		fwrite (&uint32, sizeof(uint32), 1, outfp);
+	/* encode the local piece */
+	offset = HECMW_malloc (sizeof(size_t)*(n_array+1));
+	meta = HECMW_malloc (sizeof(double)*(n_array+3)*n_member);
+	if (offset == NULL || meta == NULL) HECMW_vis_memory_exit ("offset");
+	vtk_encode_piece (mesh, data, compress, &blob, offset);
 
-		shift=0;
-		for(j=0; j<i; j++){
-			shift += data->nn_dof[j];
+	if (myrank != leader) {
+		meta[0] = mesh->n_node;
+		meta[1] = mesh->n_elem;
+		for(i=0; i<=n_array; i++){
+			meta[2+i] = (double)offset[i];
 		}
-		for(j=0; j<n_node; j++){
-			for(k=0; k<data->nn_dof[i]; k++){
-				val = (float)data->node_val_item[j*data_tot_n+k+shift];
-				fwrite (&val, sizeof(float), 1, outfp);
-			}
+		HECMW_Send (meta, n_array+3, HECMW_DOUBLE, leader, 0, VIS_COMM);
+		for(n=0; n<blob.len; n+=len){
+			len = blob.len - n;
+			if (len > VTK_COMM_CHUNK) len = VTK_COMM_CHUNK;
+			HECMW_Send (blob.data+n, (int)len, HECMW_CHAR, leader, 0, VIS_COMM);
 		}
+		vtk_buffer_free (&blob);
+		HECMW_free (offset);
+		HECMW_free (meta);
+		return;
 	}
 
-	for(i=0; i<data->ne_component; i++){
-		uint32 = (uint32_t)(data->ne_dof[i]*n_elem*sizeof(int));
-		fwrite (&uint32, sizeof(uint32), 1, outfp);
-
-		shift=0;
-		for(j=0; j<i; j++){
-			shift += data->ne_dof[j];
+	/* outpu vtu file */
+	vtk_write_header (&xml, "UnstructuredGrid", compress);
+	vtk_buffer_printf (&xml, "<UnstructuredGrid>\n");
+	vtk_buffer_printf (&xml, "<FieldData>\n");
+	k = 0;
+	for(i=0; i<data->ng_component; i++){
+		vtk_buffer_printf (&xml, "<DataArray type=\"Float32\" Name=\"%s\" NumberOfTuples=\"%d\"  >\n", data->global_label[i], data->ng_dof[i]);
+		for(j=0; j<data->ng_dof[i]; j++){
+			vtk_buffer_printf (&xml, "%e ", (float)data->global_val_item[k++]);
 		}
-		for(j=0; j<n_elem; j++){
-			for(k=0; k<data->ne_dof[i]; k++){
-				val = (float)data->elem_val_item[j*data_tot_e+k+shift];
-				fwrite (&val, sizeof(float), 1, outfp);
-			}
+		vtk_buffer_printf (&xml, "\n");
+		vtk_buffer_printf (&xml, "</DataArray>\n");
+	}
+	vtk_buffer_printf (&xml, "</FieldData>\n");
+	vtk_write_piece (&xml, data, mesh->n_node, mesh->n_elem, offset, 0);
+
+	base = blob.len;
+	for(i=1; i<n_member; i++){
+		double *m = meta + (size_t)(n_array+3)*i;
+		HECMW_Recv (m, n_array+3, HECMW_DOUBLE, leader+i, 0, VIS_COMM, &stat);
+		for(j=0; j<=n_array; j++){
+			offset[j] = (size_t)m[2+j];
 		}
+		vtk_write_piece (&xml, data, (int)m[0], (int)m[1], offset, base);
+		base += offset[n_array];
 	}
+	vtk_buffer_printf (&xml, "</UnstructuredGrid>\n");
+	vtk_buffer_printf (&xml, "<AppendedData encoding=\"raw\">\n");
+	vtk_buffer_printf (&xml, " _");
 
-	uint32 = (uint32_t)(n_elem*sizeof(int));
-	fwrite (&uint32, sizeof(uint32), 1, outfp);
-	for(i=0; i<n_elem; i++){
-		//uint16 = (uint16_t)mesh->elem_type[i];
-	  //fwrite (&uint16, sizeof(u_int16_t), 1, outfp);
-		in = (int)mesh->elem_type[i];
-	  fwrite (&in, sizeof(int), 1, outfp);
+	outfp = fopen (file_vtu, "wb");
+	if (outfp == NULL) HECMW_vis_print_exit ("ERROR: HEC-MW-VIS-E0009: Cannot open output file");
+	vtk_fwrite (xml.data, xml.len, outfp);
+	vtk_fwrite (blob.data, blob.len, outfp);
+
+	/* the member blocks follow in rank order, received one piece at a time */
+	for(i=1; i<n_member; i++){
+		base = (size_t)meta[(size_t)(n_array+3)*i+2+n_array];
+		blob.len = 0;
+		vtk_buffer_reserve (&blob, base);
+		for(n=0; n<base; n+=len){
+			len = base - n;
+			if (len > VTK_COMM_CHUNK) len = VTK_COMM_CHUNK;
+			HECMW_Recv (blob.data+n, (int)len, HECMW_CHAR, leader+i, 0, VIS_COMM, &stat);
+		}
+		vtk_fwrite (blob.data, base, outfp);
 	}
 
-	fprintf (outfp, "</AppendedData>\n");
-	fprintf (outfp, "</VTKFile>\n");
+	xml.len = 0;
+	vtk_buffer_printf (&xml, "</AppendedData>\n");
+	vtk_buffer_printf (&xml, "</VTKFile>\n");
+	vtk_fwrite (xml.data, xml.len, outfp);
 	fclose (outfp);
+
+	vtk_buffer_free (&xml);
+	vtk_buffer_free (&blob);
+	HECMW_free (offset);
+	HECMW_free (meta);
 }
 
 void HECMW_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, HECMW_Comm VIS_COMM)
@@ -461,7 +639,12 @@ void HECMW_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_da
 	vtk_output (mesh, data, outfile, outfile1, VIS_COMM);
 }
 
-void HECMW_bin_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, HECMW_Comm VIS_COMM)
+void HECMW_bin_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, int n_group, HECMW_Comm VIS_COMM)
+{
+	bin_vtk_output (mesh, data, outfile, outfile1, 0, n_group, VIS_COMM);
+}
+
+void HECMW_comp_vtk_output (struct hecmwST_local_mesh *mesh, struct hecmwST_result_data *data, char *outfile, char *outfile1, int n_group, HECMW_Comm VIS_COMM)
 {
-	bin_vtk_output (mesh, data, outfile, outfile1, VIS_COMM);
+	bin_vtk_output (mesh, data, outfile, outfile1, 1, n_group, VIS_COMM);
 }
@@ -16,6 +16,10 @@ HECMW_vtk_output (struct hecmwST_local_mesh *mesh,
 
 void
 HECMW_bin_vtk_output (struct hecmwST_local_mesh *mesh,
-		struct hecmwST_result_data *data, char *outfile, char *outfile1, HECMW_Comm VIS_COMM);
+		struct hecmwST_result_data *data, char *outfile, char *outfile1, int n_group, HECMW_Comm VIS_COMM);
+
+void
+HECMW_comp_vtk_output (struct hecmwST_local_mesh *mesh,
+		struct hecmwST_result_data *data, char *outfile, char *outfile1, int n_group, HECMW_Comm VIS_COMM);
 
 #endif /* HECMW_FSTR_OUTPUT_VKT_H_INCLUDED */
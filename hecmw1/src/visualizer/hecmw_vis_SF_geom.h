@@ -62,7 +62,7 @@
 
 #define HASH_TABLE_SIZE 10000
 
-#define NUM_CONTROL_PSF 73
+#define NUM_CONTROL_PSF 74
 /*
 #define MAX_LINE_LEN   256
 #define buffer_size  300
@@ -128,6 +128,7 @@ struct surface_module {
   double deform_line_color[3];
 
   int output_type;
+  int vtk_group_size;
 };
 
 typedef struct _surface_module_struct {
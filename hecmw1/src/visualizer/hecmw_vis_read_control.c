@@ -662,6 +662,8 @@ void HECMW_vis_read_control(FILE *fp, int pesize, int mynode, PSF_link *psf,
       len_para[71] = 9;
       strcpy(parameters[72], "time_interval");
       len_para[72] = 9;
+      strcpy(parameters[73], "vtk_group_size");
+      len_para[73] = 14;
 
       for (i = 0; i < NUM_CONTROL_PSF; i++) {
         stat_para[i] = 0;
@@ -1122,6 +1124,9 @@ void HECMW_vis_read_control(FILE *fp, int pesize, int mynode, PSF_link *psf,
                     case 72:
                       sr->time_interval = get_double_item(para, buf, &location);
                       break;
+                    case 73:
+                      sf[k].vtk_group_size = get_int_item(para, buf, &location);
+                      break;
                   }
                 }
                 while (cont_flag) {
@@ -1245,9 +1250,15 @@ exit(0);
               }
             }
             if (stat_para[20] == 0) sf[k].output_type = 1;
-            if ((sf[k].output_type < 1) || (sf[k].output_type > 16)) {
+            if ((sf[k].output_type < 1) || (sf[k].output_type > 17)) {
+              if (mynode == 0)
+                fprintf(stderr, "the output_type only can be 1 -- 17\n");
+              HECMW_vis_print_exit("pls input and run again");
+            }
+            if (stat_para[73] == 0) sf[k].vtk_group_size = 1;
+            if (sf[k].vtk_group_size < 1) {
               if (mynode == 0)
-                fprintf(stderr, "the output_type only can be 1 -- 16\n");
+                fprintf(stderr, "the vtk_group_size should be positive\n");
               HECMW_vis_print_exit("pls input and run again");
             }
             if (stat_para[22] == 0) sf[k].normalize_flag    = 0;
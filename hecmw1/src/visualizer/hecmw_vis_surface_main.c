@@ -108,7 +108,10 @@ void HECMW_vis_psf_rendering(struct hecmwST_local_mesh *mesh,
     HECMW_vtk_output(mesh, data, body, outfile1, VIS_COMM);
     return;
   } else if(sf[1].output_type==16) {
-    HECMW_bin_vtk_output(mesh, data, body, outfile1, VIS_COMM);
+    HECMW_bin_vtk_output(mesh, data, body, outfile1, sf[1].vtk_group_size, VIS_COMM);
+    return;
+  } else if(sf[1].output_type==17) {
+    HECMW_comp_vtk_output(mesh, data, body, outfile1, sf[1].vtk_group_size, VIS_COMM);
     return;
   }
 
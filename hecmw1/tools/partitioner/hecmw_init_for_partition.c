@@ -12,6 +12,7 @@
 #include "hecmw_msgno.h"
 #include "hecmw_malloc.h"
 #include "hecmw_error.h"
+#include "hecmw_io_dist.h"
 
 #include "hecmw_part_define.h"
 #include "hecmw_part_get_control.h"
@@ -20,11 +21,13 @@
 #define DEFAULT_CONTROL_FILE_NAME "hecmw_part_ctrl.dat"
 
 static void print_usage(void) {
-  fprintf(stderr, "Usage: hecmw_part1 [-f filename] [-v] [-d number] [-m KMETIS|PMETIS|RCB ] [-e number] \n");
+  fprintf(stderr, "Usage: hecmw_part1 [-f filename] [-v] [-b] [-p] [-d number] [-m KMETIS|PMETIS|RCB ] [-e number] \n");
   fprintf(stderr, "         [ -t NODE-BASED|ELEMENT-BASED ] [ -u filename ] [ -c DEFAULT|AGGREGATE|DISTRIBUTE|SIMPLE]\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "  -f  specify control file name\n");
   fprintf(stderr, "  -v  print verbose messages\n");
+  fprintf(stderr, "  -b  write distributed mesh files in binary format\n");
+  fprintf(stderr, "  -p  read and partition the mesh with all MPI processes\n");
   fprintf(stderr, "  -h  print usage\n");
   fprintf(stderr, "*** If the following options are set, hecmw_part_ctrl.dat will be ignored. ***\n");
   fprintf(stderr, "  -d  number of sub-domains \n");
@@ -71,6 +74,14 @@ extern int HECMW_init_for_partition(int argc, char **argv) {
         counter++;
         HECMW_setloglv(HECMW_LOG_DEBUG);
 
+      } else if (!strcmp(argv[counter], "-b")) {
+        counter++;
+        HECMW_set_dist_mesh_format(HECMW_DIST_FORMAT_BINARY);
+
+      } else if (!strcmp(argv[counter], "-p")) {
+        counter++;
+        HECMW_part_set_parallel(1);
+
       } else {
         print_usage();
         goto error;
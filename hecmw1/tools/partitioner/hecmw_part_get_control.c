@@ -18,6 +18,7 @@
 
 static char ctrl_file_name[HECMW_FILENAME_LEN] = "\0";
 static int  args_subdomain = 0;
+static int  is_parallel = 0;
 
 /*================================================================================================*/
 
@@ -26,6 +27,13 @@ extern int HECMW_part_set_subdomains(int n_domain) {
   return 0;
 }
 
+extern int HECMW_part_set_parallel(int flag) {
+  is_parallel = flag ? 1 : 0;
+  return 0;
+}
+
+extern int HECMW_part_is_parallel(void) { return is_parallel; }
+
 extern int HECMW_part_set_ctrl_file_name(char *fname) {
   if (fname == NULL) {
     HECMW_set_error(HECMW_PART_E_INV_ARG, "'fname' is NULL");
@@ -10,6 +10,8 @@
 
 extern int HECMW_part_set_ctrl_file_name(char *fname);
 extern int HECMW_part_set_subdomains(int n_domain);
+extern int HECMW_part_set_parallel(int flag);
+extern int HECMW_part_is_parallel(void);
 
 extern struct hecmw_part_cont_data *HECMW_part_get_control();
 
@@ -167,6 +167,15 @@ static int spdup_clear_IEB(char *node_flag, char *elem_flag,
   return RTC_NORMAL;
 }
 
+/*
+ * The boundary lists hold the whole overlap of each domain, of any depth,
+ * unless MPC or contact add to it while masking.
+ */
+static int is_spdup_available(const struct hecmwST_local_mesh *global_mesh) {
+  return global_mesh->hecmw_flag_parttype == HECMW_FLAG_PARTTYPE_NODEBASED &&
+         global_mesh->mpc->n_mpc == 0 && global_mesh->contact_pair->n_pair == 0;
+}
+
 static int spdup_init_list(const struct hecmwST_local_mesh *global_mesh) {
   int i, j, k;
   int js, je;
@@ -416,6 +425,184 @@ error:
   return RTC_ERROR;
 }
 
+/* elements of each node, node_elem_index[node - 1] .. node_elem_index[node] */
+static int spdup_make_node_elem_list(
+    const struct hecmwST_local_mesh *global_mesh, int **node_elem_index,
+    int **node_elem_item) {
+  int *index = NULL, *item = NULL;
+  int i, j, node;
+
+  index = (int *)HECMW_calloc(global_mesh->n_node + 1, sizeof(int));
+  if (index == NULL) {
+    HECMW_set_error(errno, "");
+    goto error;
+  }
+  for (i = 0; i < global_mesh->n_elem; i++) {
+    for (j = global_mesh->elem_node_index[i];
+         j < global_mesh->elem_node_index[i + 1]; j++) {
+      node = global_mesh->elem_node_item[j];
+      index[node]++;
+    }
+  }
+  for (i = 0; i < global_mesh->n_node; i++) {
+    index[i + 1] += index[i];
+  }
+
+  item = (int *)HECMW_malloc(sizeof(int) * (index[global_mesh->n_node] + 1));
+  if (item == NULL) {
+    HECMW_set_error(errno, "");
+    goto error;
+  }
+  for (i = 0; i < global_mesh->n_elem; i++) {
+    for (j = global_mesh->elem_node_index[i];
+         j < global_mesh->elem_node_index[i + 1]; j++) {
+      node                    = global_mesh->elem_node_item[j];
+      item[index[node - 1]++] = i + 1;
+    }
+  }
+  for (i = global_mesh->n_node; i > 0; i--) {
+    index[i] = index[i - 1];
+  }
+  index[0] = 0;
+
+  *node_elem_index = index;
+  *node_elem_item  = item;
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(index);
+  HECMW_free(item);
+  return RTC_ERROR;
+}
+
+static int spdup_append(int **list, int *n, int *size, int id) {
+  int *tmp;
+
+  if (*n == *size) {
+    *size = (*size < 16) ? 32 : 2 * (*size);
+    tmp   = (int *)HECMW_realloc(*list, sizeof(int) * (*size));
+    if (tmp == NULL) {
+      HECMW_set_error(errno, "");
+      return RTC_ERROR;
+    }
+    *list = tmp;
+  }
+  (*list)[(*n)++] = id;
+
+  return RTC_NORMAL;
+}
+
+/*
+ * Grow the boundary lists of a domain from depth 1 to the depth of overlap:
+ * each further layer takes the elements with a node in the last one, as
+ * mask_additional_overlap_elem() and mask_boundary_node() do on the whole
+ * mesh. node_mark and elem_mark are zero on entry and on return.
+ */
+static int spdup_extend_bndlist(const struct hecmwST_local_mesh *global_mesh,
+                                const int *node_elem_index,
+                                const int *node_elem_item, char *node_mark,
+                                char *elem_mark, int domain) {
+  int n_node = n_bnd_nlist[2 * domain + 1];
+  int n_elem = n_bnd_elist[2 * domain + 1];
+  int size_node = n_node, size_elem = n_elem;
+  int front, last_node, last_elem;
+  int depth, i, j, k, node, elem;
+
+  for (i = 0; i < n_node; i++) node_mark[bnd_nlist[domain][i] - 1] = 1;
+  for (i = 0; i < n_elem; i++) elem_mark[bnd_elist[domain][i] - 1] = 1;
+
+  for (front = 0, depth = 1; depth < global_mesh->hecmw_flag_partdepth;
+       depth++) {
+    last_node = n_node;
+    last_elem = n_elem;
+    for (i = front; i < last_node; i++) {
+      node = bnd_nlist[domain][i];
+      for (j = node_elem_index[node - 1]; j < node_elem_index[node]; j++) {
+        elem = node_elem_item[j];
+        if (elem_mark[elem - 1]) continue;
+        elem_mark[elem - 1] = 1;
+        if (spdup_append(&bnd_elist[domain], &n_elem, &size_elem, elem))
+          goto error;
+      }
+    }
+    for (i = last_elem; i < n_elem; i++) {
+      elem = bnd_elist[domain][i];
+      for (k = global_mesh->elem_node_index[elem - 1];
+           k < global_mesh->elem_node_index[elem]; k++) {
+        node = global_mesh->elem_node_item[k];
+        if (node_mark[node - 1]) continue;
+        node_mark[node - 1] = 1;
+        if (spdup_append(&bnd_nlist[domain], &n_node, &size_node, node))
+          goto error;
+      }
+    }
+    front = last_node;
+  }
+
+  for (i = 0; i < n_node; i++) node_mark[bnd_nlist[domain][i] - 1] = 0;
+  for (i = 0; i < n_elem; i++) elem_mark[bnd_elist[domain][i] - 1] = 0;
+
+  qsort(bnd_nlist[domain], n_node, sizeof(int), int_cmp);
+  qsort(bnd_elist[domain], n_elem, sizeof(int), int_cmp);
+  n_bnd_nlist[2 * domain + 1] = n_node;
+  n_bnd_elist[2 * domain + 1] = n_elem;
+
+  return RTC_NORMAL;
+
+error:
+  n_bnd_nlist[2 * domain + 1] = n_node;
+  n_bnd_elist[2 * domain + 1] = n_elem;
+  return RTC_ERROR;
+}
+
+/* the boundary lists of all the domains with the depth of overlap */
+static int spdup_extend_bndlist_main(
+    const struct hecmwST_local_mesh *global_mesh) {
+  int *node_elem_index = NULL, *node_elem_item = NULL;
+  char *node_mark = NULL, *elem_mark = NULL;
+  int error_in_ompsection = 0;
+  int i;
+
+  if (spdup_make_node_elem_list(global_mesh, &node_elem_index,
+                                &node_elem_item))
+    return RTC_ERROR;
+
+#ifdef _OPENMP
+#pragma omp parallel default(none), private(node_mark, elem_mark, i), \
+    shared(global_mesh, node_elem_index, node_elem_item,               \
+           error_in_ompsection)
+  {
+#endif
+    node_mark = (char *)HECMW_calloc(global_mesh->n_node, sizeof(char));
+    elem_mark = (char *)HECMW_calloc(global_mesh->n_elem, sizeof(char));
+    if (node_mark == NULL || elem_mark == NULL) {
+      HECMW_set_error(errno, "");
+      error_in_ompsection = 1;
+    }
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+    for (i = 0; i < global_mesh->n_subdomain; i++) {
+      if (node_mark == NULL || elem_mark == NULL) continue;
+      if (spdup_extend_bndlist(global_mesh, node_elem_index, node_elem_item,
+                               node_mark, elem_mark, i)) {
+        error_in_ompsection = 1;
+      }
+    }
+
+    HECMW_free(node_mark);
+    HECMW_free(elem_mark);
+#ifdef _OPENMP
+  } /* omp end parallel */
+#endif
+
+  HECMW_free(node_elem_index);
+  HECMW_free(node_elem_item);
+
+  return error_in_ompsection ? RTC_ERROR : RTC_NORMAL;
+}
+
 static int spdup_make_list(const struct hecmwST_local_mesh *global_mesh) {
   int i, j, k;
   int js, je, ks, ke;
@@ -482,6 +669,12 @@ static int spdup_make_list(const struct hecmwST_local_mesh *global_mesh) {
     if (rtc != RTC_NORMAL) goto error;
   }
 
+  if (global_mesh->hecmw_flag_partdepth > 1 &&
+      is_spdup_available(global_mesh)) {
+    rtc = spdup_extend_bndlist_main(global_mesh);
+    if (rtc != RTC_NORMAL) goto error;
+  }
+
   for (i = 0; i < global_mesh->n_subdomain; i++) {
     rtc = sort_and_resize_bndlist(global_mesh, i);
     if (rtc != RTC_NORMAL) goto error;
@@ -795,12 +988,6 @@ static void spdup_freelist(const struct hecmwST_local_mesh *global_mesh) {
   HECMW_free(egrp_item);
 }
 
-static int is_spdup_available(const struct hecmwST_local_mesh *global_mesh) {
-  return global_mesh->hecmw_flag_parttype == HECMW_FLAG_PARTTYPE_NODEBASED &&
-         global_mesh->hecmw_flag_partdepth == 1 &&
-         global_mesh->mpc->n_mpc == 0 && global_mesh->contact_pair->n_pair == 0;
-}
-
 /*================================================================================================*/
 
 static char *get_dist_file_name(char *header, int domain, char *fname) {
@@ -3878,7 +4065,10 @@ static int mask_mesh_status_nb(const struct hecmwST_local_mesh *global_mesh,
   }
 #endif
 
-  for (i = 1; i < global_mesh->hecmw_flag_partdepth; i++) {
+  /* the boundary lists have the whole overlap already if spdup is available */
+  for (i = 1; i < global_mesh->hecmw_flag_partdepth &&
+              !is_spdup_available(global_mesh);
+       i++) {
     rtc = mask_additional_overlap_elem(global_mesh, node_flag, elem_flag);
     if (rtc != RTC_NORMAL) goto error;
 
@@ -5244,6 +5434,7 @@ static int set_node_global2local_external_mod(
     node                        = bnd_nlist[domain][i];
     node_global2local[node - 1] = ++counter;
   }
+  local_mesh->nn_middle    = counter;
   local_mesh->n_node       = counter;
   local_mesh->n_node_gross = counter;
 
@@ -8845,9 +9036,13 @@ error:
 
 ==================================================================================================*/
 
-extern struct hecmwST_local_mesh *HECMW_partition_inner(
-    struct hecmwST_local_mesh *global_mesh,
-    struct hecmw_part_cont_data *cont_data) {
+/*
+ * Create and write the local meshes of domains [iS, iE) and log their sizes.
+ * node_ID and elem_ID of global_mesh hold the double numbering already.
+ */
+static int create_local_meshes(struct hecmwST_local_mesh *global_mesh,
+                               struct hecmw_part_cont_data *cont_data, int iS,
+                               int iE) {
   struct hecmwST_local_mesh *local_mesh = NULL;
   struct hecmw_ctrl_meshfiles *ofheader = NULL;
   char *node_flag                       = NULL;
@@ -8857,99 +9052,15 @@ extern struct hecmwST_local_mesh *HECMW_partition_inner(
   int *node_global2local                = NULL;
   int *elem_global2local                = NULL;
   char ofname[HECMW_FILENAME_LEN + 1];
-  int *num_elem, *num_node, *num_ielem, *num_inode, *num_nbpe;
-  int *sum_elem, *sum_node, *sum_ielem, *sum_inode, *sum_nbpe;
-  int current_domain, nrank, iS, iE;
+  int *num_elem = NULL, *num_node = NULL, *num_ielem = NULL;
+  int *num_inode = NULL, *num_nbpe = NULL;
+  int *sum_elem = NULL, *sum_node = NULL, *sum_ielem = NULL;
+  int *sum_inode = NULL, *sum_nbpe = NULL;
+  int current_domain;
   int rtc;
   int i;
   int error_in_ompsection = 0;
 
-  if (global_mesh == NULL) {
-    HECMW_set_error(HECMW_PART_E_INV_ARG, "\'global_mesh\' is NULL");
-    goto error;
-  }
-  if (cont_data == NULL) {
-    HECMW_set_error(HECMW_PART_E_INV_ARG, "\'cont_data\' is NULL");
-    goto error;
-  }
-
-  rtc = init_partition(global_mesh, cont_data);
-  if (rtc != RTC_NORMAL) goto error;
-
-  rtc = HECMW_part_init_log(global_mesh->n_subdomain);
-  if (rtc != RTC_NORMAL) goto error;
-
-  if (global_mesh->my_rank == 0) {
-    rtc = HECMW_part_set_log_part_type(cont_data->type);
-    if (rtc != RTC_NORMAL) goto error;
-    rtc = HECMW_part_set_log_part_method(cont_data->method);
-    if (rtc != RTC_NORMAL) goto error;
-    rtc = HECMW_part_set_log_part_depth(cont_data->depth);
-    if (rtc != RTC_NORMAL) goto error;
-    rtc = HECMW_part_set_log_part_contact(cont_data->contact);
-    if (rtc != RTC_NORMAL) goto error;
-
-    rtc = HECMW_part_set_log_n_node_g(global_mesh->n_node);
-    if (rtc != RTC_NORMAL) goto error;
-    rtc = HECMW_part_set_log_n_elem_g(global_mesh->n_elem);
-    if (rtc != RTC_NORMAL) goto error;
-  }
-
-  if (global_mesh->n_subdomain == 1) {
-    current_domain = 0;
-
-    if (global_mesh->my_rank == 0) {
-      HECMW_log(HECMW_LOG_INFO, "Creating local mesh for domain #%d ...",
-                current_domain);
-
-      ofheader = HECMW_ctrl_get_meshfiles_header_sub(
-          "part_out", global_mesh->n_subdomain, current_domain);
-      if (ofheader == NULL) {
-        HECMW_log(HECMW_LOG_ERROR, "not set output file header");
-        error_in_ompsection = 1;
-        goto error;
-      }
-      if (ofheader->n_mesh == 0) {
-        HECMW_log(HECMW_LOG_ERROR, "output file name is not set");
-        error_in_ompsection = 1;
-        goto error;
-      }
-
-      get_dist_file_name(ofheader->meshfiles[0].filename, current_domain,
-                         ofname);
-      HECMW_assert(ofname != NULL);
-
-      HECMW_log(HECMW_LOG_DEBUG,
-                "Starting writing local mesh for domain #%d...",
-                current_domain);
-
-      rtc = HECMW_put_dist_mesh(global_mesh, ofname);
-      if (rtc != 0) {
-        HECMW_log(HECMW_LOG_ERROR, "Failed to write local mesh for domain #%d",
-                  current_domain);
-        goto error;
-      }
-
-      HECMW_log(HECMW_LOG_DEBUG, "Writing local mesh for domain #%d done",
-                current_domain);
-
-      rtc = HECMW_part_set_log_n_elem(0, global_mesh->n_elem);
-      if (rtc != 0) goto error;
-      rtc = HECMW_part_set_log_n_node(0, global_mesh->n_node);
-      if (rtc != 0) goto error;
-      rtc = HECMW_part_set_log_ne_internal(0, global_mesh->ne_internal);
-      if (rtc != 0) goto error;
-      rtc = HECMW_part_set_log_nn_internal(0, global_mesh->nn_internal);
-      if (rtc != 0) goto error;
-
-      rtc = HECMW_part_print_log();
-      if (rtc) goto error;
-    }
-    HECMW_part_finalize_log();
-
-    return global_mesh;
-  }
-
   num_elem = (int *)HECMW_calloc(global_mesh->n_subdomain, sizeof(int));
   if (num_elem == NULL) {
     HECMW_set_error(errno, "");
@@ -9001,20 +9112,17 @@ extern struct hecmwST_local_mesh *HECMW_partition_inner(
     goto error;
   }
 
-  rtc = wnumbering(global_mesh, cont_data);
-  if (rtc != RTC_NORMAL) goto error;
-
   /*K. Inagaki */
   rtc = spdup_makelist_main(global_mesh);
   if (rtc != RTC_NORMAL) goto error;
 
 #ifdef _OPENMP
 #pragma omp parallel default(none), \
-    private(node_flag, elem_flag, local_mesh, nrank, iS, iE, i,         \
-            current_domain, rtc, ofheader, ofname),                     \
+    private(node_flag, elem_flag, local_mesh, i, current_domain, rtc,   \
+            ofheader, ofname),                                          \
     private(node_global2local, elem_global2local,                       \
             node_flag_neighbor, elem_flag_neighbor),                    \
-    shared(global_mesh, cont_data, num_elem, num_node,                  \
+    shared(global_mesh, cont_data, iS, iE, num_elem, num_node,          \
            num_ielem, num_inode, num_nbpe, error_in_ompsection)
   {
 #endif /* _OPENMP */
@@ -9068,12 +9176,6 @@ extern struct hecmwST_local_mesh *HECMW_partition_inner(
       goto error_omp;
     }
 
-    nrank = global_mesh->n_subdomain / HECMW_comm_get_size();
-    iS    = HECMW_comm_get_rank() * nrank;
-    iE    = iS + nrank;
-    if (HECMW_comm_get_rank() == HECMW_comm_get_size() - 1)
-      iE = global_mesh->n_subdomain;
-
 #ifdef _OPENMP
 #pragma omp for schedule(dynamic, 1), reduction(+ : error_in_ompsection)
 #endif
@@ -9224,7 +9326,6 @@ extern struct hecmwST_local_mesh *HECMW_partition_inner(
     rtc = HECMW_part_print_log();
     if (rtc) goto error;
   }
-  HECMW_part_finalize_log();
 
   HECMW_free(num_elem);
   HECMW_free(num_node);
@@ -9240,7 +9341,7 @@ extern struct hecmwST_local_mesh *HECMW_partition_inner(
   /*K. Inagaki */
   spdup_freelist(global_mesh);
 
-  return global_mesh;
+  return RTC_NORMAL;
 
 error:
   HECMW_free(node_flag);
@@ -9259,11 +9360,139 @@ error:
   if (ofheader) {
     HECMW_ctrl_free_meshfiles(ofheader);
   }
+
+  return RTC_ERROR;
+}
+
+
+extern struct hecmwST_local_mesh *HECMW_partition_inner(
+    struct hecmwST_local_mesh *global_mesh,
+    struct hecmw_part_cont_data *cont_data) {
+  struct hecmw_ctrl_meshfiles *ofheader = NULL;
+  char ofname[HECMW_FILENAME_LEN + 1];
+  int current_domain, nrank, iS, iE;
+  int rtc;
+
+  if (global_mesh == NULL) {
+    HECMW_set_error(HECMW_PART_E_INV_ARG, "\'global_mesh\' is NULL");
+    goto error;
+  }
+  if (cont_data == NULL) {
+    HECMW_set_error(HECMW_PART_E_INV_ARG, "\'cont_data\' is NULL");
+    goto error;
+  }
+
+  rtc = init_partition(global_mesh, cont_data);
+  if (rtc != RTC_NORMAL) goto error;
+
+  rtc = HECMW_part_init_log(global_mesh->n_subdomain);
+  if (rtc != RTC_NORMAL) goto error;
+
+  if (global_mesh->my_rank == 0) {
+    rtc = HECMW_part_set_log_part_type(cont_data->type);
+    if (rtc != RTC_NORMAL) goto error;
+    rtc = HECMW_part_set_log_part_method(cont_data->method);
+    if (rtc != RTC_NORMAL) goto error;
+    rtc = HECMW_part_set_log_part_depth(cont_data->depth);
+    if (rtc != RTC_NORMAL) goto error;
+    rtc = HECMW_part_set_log_part_contact(cont_data->contact);
+    if (rtc != RTC_NORMAL) goto error;
+
+    rtc = HECMW_part_set_log_n_node_g(global_mesh->n_node);
+    if (rtc != RTC_NORMAL) goto error;
+    rtc = HECMW_part_set_log_n_elem_g(global_mesh->n_elem);
+    if (rtc != RTC_NORMAL) goto error;
+  }
+
+  if (global_mesh->n_subdomain == 1) {
+    current_domain = 0;
+
+    if (global_mesh->my_rank == 0) {
+      HECMW_log(HECMW_LOG_INFO, "Creating local mesh for domain #%d ...",
+                current_domain);
+
+      ofheader = HECMW_ctrl_get_meshfiles_header_sub(
+          "part_out", global_mesh->n_subdomain, current_domain);
+      if (ofheader == NULL) {
+        HECMW_log(HECMW_LOG_ERROR, "not set output file header");
+        goto error;
+      }
+      if (ofheader->n_mesh == 0) {
+        HECMW_log(HECMW_LOG_ERROR, "output file name is not set");
+        goto error;
+      }
+
+      get_dist_file_name(ofheader->meshfiles[0].filename, current_domain,
+                         ofname);
+      HECMW_assert(ofname != NULL);
+
+      HECMW_log(HECMW_LOG_DEBUG,
+                "Starting writing local mesh for domain #%d...",
+                current_domain);
+
+      rtc = HECMW_put_dist_mesh(global_mesh, ofname);
+      if (rtc != 0) {
+        HECMW_log(HECMW_LOG_ERROR, "Failed to write local mesh for domain #%d",
+                  current_domain);
+        goto error;
+      }
+
+      HECMW_log(HECMW_LOG_DEBUG, "Writing local mesh for domain #%d done",
+                current_domain);
+
+      rtc = HECMW_part_set_log_n_elem(0, global_mesh->n_elem);
+      if (rtc != 0) goto error;
+      rtc = HECMW_part_set_log_n_node(0, global_mesh->n_node);
+      if (rtc != 0) goto error;
+      rtc = HECMW_part_set_log_ne_internal(0, global_mesh->ne_internal);
+      if (rtc != 0) goto error;
+      rtc = HECMW_part_set_log_nn_internal(0, global_mesh->nn_internal);
+      if (rtc != 0) goto error;
+
+      rtc = HECMW_part_print_log();
+      if (rtc) goto error;
+    }
+    HECMW_part_finalize_log();
+
+    return global_mesh;
+  }
+
+  rtc = wnumbering(global_mesh, cont_data);
+  if (rtc != RTC_NORMAL) goto error;
+
+  nrank = global_mesh->n_subdomain / HECMW_comm_get_size();
+  iS    = HECMW_comm_get_rank() * nrank;
+  iE    = iS + nrank;
+  if (HECMW_comm_get_rank() == HECMW_comm_get_size() - 1)
+    iE = global_mesh->n_subdomain;
+
+  rtc = create_local_meshes(global_mesh, cont_data, iS, iE);
+  if (rtc != RTC_NORMAL) goto error;
+
+  HECMW_part_finalize_log();
+
+  return global_mesh;
+
+error:
+  if (ofheader) {
+    HECMW_ctrl_free_meshfiles(ofheader);
+  }
   HECMW_part_finalize_log();
 
   return NULL;
 }
 
+extern int HECMW_partition_subdomains(struct hecmwST_local_mesh *mesh,
+                                      struct hecmw_part_cont_data *cont_data,
+                                      int iS, int iE) {
+  int rtc;
+
+  rtc = init_partition(mesh, cont_data);
+  if (rtc != RTC_NORMAL) return RTC_ERROR;
+
+  return create_local_meshes(mesh, cont_data, iS, iE);
+}
+
 extern struct hecmwST_local_mesh *HECMW_partition(
     struct hecmwST_local_mesh *global_mesh) {
   struct hecmwST_local_mesh *local_mesh;
@@ -13,6 +13,15 @@ extern struct hecmwST_local_mesh *HECMW_partition_inner(
     struct hecmwST_local_mesh *global_mesh,
     struct hecmw_part_cont_data *cont_data);
 
+/*
+ * Write the local meshes of domains [iS, iE). node_ID and elem_ID of mesh
+ * hold the local ID and the domain of each node and element; mesh needs to
+ * contain only the nodes and elements around these domains.
+ */
+extern int HECMW_partition_subdomains(struct hecmwST_local_mesh *mesh,
+                                      struct hecmw_part_cont_data *cont_data,
+                                      int iS, int iE);
+
 extern struct hecmwST_local_mesh *HECMW_partition(
     struct hecmwST_local_mesh *local_mesh);
 
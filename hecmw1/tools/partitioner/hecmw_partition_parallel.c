@@ -0,0 +1,2383 @@
+/*****************************************************************************
+ * Copyright (c) 2019 FrontISTR Commons
+ * This software is released under the MIT License, see LICENSE.txt
+ *****************************************************************************/
+
+/*
+ * Parallel partitioner for HECMW-ENTIRE mesh files
+ *
+ * Each process reads the lines which start in its share of the bytes of the
+ * mesh file. The data lines of !NODE and !ELEMENT are parsed into records
+ * sent to the home process of their ID; all other lines are gathered by all
+ * processes. The node graph is partitioned at the homes by RCB or ParMETIS.
+ *
+ * Domain d is written by process owner(d). That process collects the
+ * elements sharing a node with an element of its domains, so that the DOF
+ * class of every node of its local meshes is the global one, reads them
+ * with the other lines into a mesh and runs the domain extraction of the
+ * serial partitioner on it. Every !NODE and !ELEMENT block keeps its
+ * smallest record in every process so that the groups, element types etc.
+ * of the local meshes are those of the entire mesh.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+
+#include "hecmw_util.h"
+#include "hecmw_common.h"
+#include "hecmw_io.h"
+#include "hecmw_io_hec.h"
+#include "hecmw_io_mesh.h"
+#include "hecmw_io_bulk.h"
+
+#include "hecmw_part_define.h"
+#include "hecmw_part_struct.h"
+#include "hecmw_part_log.h"
+#include "hecmw_mesh_edge_info.h"
+#include "hecmw_part_get_control.h"
+#include "hecmw_partition.h"
+#include "hecmw_partition_parallel.h"
+
+#if defined(HECMW_PART_WITH_PARMETIS) && !defined(HECMW_SERIAL)
+#include "parmetis.h"
+#endif
+
+#define RTC_NORMAL 0
+
+#define RTC_ERROR (-1)
+
+#define RTC_UNSUPPORTED 1
+
+/* kinds of the blocks of a mesh file */
+#define BLOCK_OTHER 0
+#define BLOCK_NODE 1
+#define BLOCK_ELEM 2
+#define BLOCK_END 3
+
+/* DOF classes of nodes, see HECMW_reorder_node_dof() */
+#define N_DOF_CLASS 4
+
+/* bytes read at once to complete the last line of a share */
+#define READ_CHUNK (1 << 16)
+
+struct header {
+  int kind;
+  int etype;
+  int nnode;
+};
+
+/* what a process tells the others about its share of the file */
+struct share_info {
+  int nhead;      /* number of header lines */
+  int first_end;  /* index of the first !END among them, -1 if none */
+  int kind;       /* the last header */
+  int etype;
+  int nnode;
+  int lead_data;  /* data line before the first header */
+  int tail_blank; /* blank line after the last header */
+};
+
+/*
+ * data line of !NODE; block is the global index of its header line, seq
+ * the index of the record in the file
+ */
+struct node_rec {
+  int id;
+  int block;
+  int seq;
+  double xyz[3];
+};
+
+/* what the home of a node tells about it */
+struct node_info {
+  double xyz[3];
+  int block;
+  int seq;
+  int part;
+};
+
+/* elements; the nodes of element i are node[index[i]] .. node[index[i+1]-1] */
+struct elem_list {
+  int n;
+  int *id;
+  int *block;
+  int *seq;
+  int *type;
+  int *index;
+  int *node;
+};
+
+struct buffer {
+  char *p;
+  size_t n;
+  size_t size;
+};
+
+/* requests sent to the home processes of their keys, see route_init() */
+struct route {
+  int n;       /* number of requests */
+  int *slot;   /* slot[i]: position of request i in the send order */
+  int *scount; /* requests sent to each process */
+  int *rcount; /* requests received from each process */
+  int nrecv;   /* number of requests received */
+  int *recv;   /* requests received, in order of the sending process */
+};
+
+/* state of one run */
+struct part_data {
+  const char *filename;
+  struct hecmw_part_cont_data *cont_data;
+  int *dfirst; /* domains dfirst[r] .. dfirst[r+1]-1 are written by r */
+
+  struct buffer meta; /* all lines but the data lines of !NODE, !ELEMENT */
+  int nblock;         /* number of header lines up to !END */
+  int *rep;           /* smallest node and element ID of each block */
+  int node_maxid;
+  int elem_maxid;
+  long long n_node_g; /* numbers of nodes in use and of elements */
+  long long n_elem_g;
+  long long n_unused_g; /* number of nodes not in use */
+
+  /* nodes and elements this process is the home of, sorted by ID */
+  int n_node;
+  struct node_rec *node;
+  int *vtx;  /* vertex index of each node, -1 if not in use */
+  int nvtx;  /* vertices of this process */
+  int *part; /* domain of each vertex */
+  struct elem_list elem;
+
+  int n_unode;   /* nodes of elem, sorted */
+  int *unode;
+  struct route en;  /* unode to their homes */
+  int *en_node;     /* home node index of each request received by en */
+
+  long long n_edge;
+  int n_edgecut;
+
+  /* records this process keeps, sorted by ID */
+  struct elem_list kelem;
+  int n_knode;
+  int *knode;
+  struct node_info *kinfo;
+};
+
+static int nproc;
+static int myrank;
+static HECMW_Comm comm;
+static const char *unsupported; /* why this process cannot go on */
+
+/*============================================================================*/
+/*  utilities                                                                 */
+/*============================================================================*/
+
+static void *alloc(size_t n, size_t size) {
+  void *p = HECMW_malloc(n > 0 ? n * size : 1);
+  if (p == NULL) HECMW_set_error(errno, "");
+  return p;
+}
+
+static int buf_reserve(struct buffer *b, size_t n) {
+  size_t size;
+  char *p;
+
+  if (b->n + n <= b->size) return 0;
+  for (size = b->size ? b->size : 4096; size < b->n + n; size *= 2)
+    ;
+  if ((p = HECMW_realloc(b->p, size)) == NULL) {
+    HECMW_set_error(errno, "");
+    return -1;
+  }
+  b->p    = p;
+  b->size = size;
+  return 0;
+}
+
+static int buf_add(struct buffer *b, const void *src, size_t n) {
+  if (buf_reserve(b, n)) return -1;
+  memcpy(b->p + b->n, src, n);
+  b->n += n;
+  return 0;
+}
+
+static void buf_free(struct buffer *b) {
+  HECMW_free(b->p);
+  b->p    = NULL;
+  b->n    = 0;
+  b->size = 0;
+}
+
+static int cmp_int(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+static int cmp_pair(const void *a, const void *b) {
+  const int *x = a, *y = b;
+  if (x[0] != y[0]) return (x[0] > y[0]) - (x[0] < y[0]);
+  return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+static int cmp_triple(const void *a, const void *b) {
+  const int *x = a, *y = b;
+  int c = cmp_pair(a, b);
+  return c ? c : (x[2] > y[2]) - (x[2] < y[2]);
+}
+
+static int cmp_node_rec(const void *a, const void *b) {
+  return cmp_int(&((const struct node_rec *)a)->id,
+                 &((const struct node_rec *)b)->id);
+}
+
+/* sort and remove duplicates of n tuples of size ints; returns the new n */
+static int sort_unique(int *v, int n, int size) {
+  int (*cmp)(const void *, const void *) =
+      size == 1 ? cmp_int : size == 2 ? cmp_pair : cmp_triple;
+  int i, m;
+
+  if (n == 0) return 0;
+  qsort(v, n, sizeof(int) * size, cmp);
+  for (m = 1, i = 1; i < n; i++) {
+    if (cmp(v + (size_t)size * i, v + (size_t)size * (m - 1))) {
+      memmove(v + (size_t)size * m, v + (size_t)size * i, sizeof(int) * size);
+      m++;
+    }
+  }
+  return m;
+}
+
+static int find_int(const int *v, int n, int key) {
+  const int *p = bsearch(&key, v, n, sizeof(int), cmp_int);
+  return p ? (int)(p - v) : -1;
+}
+
+static int find_node(const struct node_rec *v, int n, int id) {
+  struct node_rec key;
+  const struct node_rec *p;
+
+  key.id = id;
+  p      = bsearch(&key, v, n, sizeof(*v), cmp_node_rec);
+  return p ? (int)(p - v) : -1;
+}
+
+/* first of the n sorted pairs whose first item is key */
+static int first_pair(const int *pair, int n, int key) {
+  int lo = 0, hi = n;
+
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (pair[2 * mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static int home_of(int id, int maxid) {
+  return (int)((long long)(id - 1) * nproc / maxid);
+}
+
+static int owner_of(const int *dfirst, int domain) {
+  int lo = 0, hi = nproc - 1;
+
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (dfirst[mid] <= domain) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+static void set_unsupported(const char *what) {
+  if (unsupported == NULL) unsupported = what;
+}
+
+/* go on only if no process found anything the serial partitioner must do */
+static int check_supported(void) {
+  int flag = unsupported ? 1 : 0;
+  int any;
+
+  if (HECMW_Allreduce(&flag, &any, 1, HECMW_INT, HECMW_MAX, comm))
+    return RTC_ERROR;
+  if (flag)
+    HECMW_log(HECMW_LOG_INFO, "Parallel partitioning does not support %s",
+              unsupported);
+  return any ? RTC_UNSUPPORTED : RTC_NORMAL;
+}
+
+static int allgather_int(int *mine, int n, int *all) {
+  int *count, *displ;
+  int rtc = RTC_ERROR;
+  int i;
+
+  count = alloc(nproc, sizeof(int));
+  displ = alloc(nproc, sizeof(int));
+  if (count && displ) {
+    for (i = 0; i < nproc; i++) {
+      count[i] = n;
+      displ[i] = n * i;
+    }
+    if (HECMW_Allgatherv(mine, n, HECMW_INT, all, count, displ, HECMW_INT,
+                         comm) == 0)
+      rtc = RTC_NORMAL;
+  }
+  HECMW_free(count);
+  HECMW_free(displ);
+  return rtc;
+}
+
+static long long sum_all(long long n) {
+  double v = (double)n, sum;
+
+  if (HECMW_Allreduce(&v, &sum, 1, HECMW_DOUBLE, HECMW_SUM, comm)) return -1;
+  return (long long)sum;
+}
+
+/*============================================================================*/
+/*  communication                                                             */
+/*============================================================================*/
+
+/*
+ * Personalized all-to-all: scount[p] ints of sbuf, in order of p, go to
+ * process p. *rbuf receives rcount[p] ints from each process p in order.
+ */
+static int exchange(int *sbuf, int *scount, int **rbuf, int *rcount,
+                    int *ntotal) {
+  int *sdispl = NULL, *rdispl = NULL;
+  long long n;
+  int p;
+
+  *rbuf = NULL;
+  if (HECMW_Alltoall(scount, 1, HECMW_INT, rcount, 1, HECMW_INT, comm))
+    goto error;
+
+  if ((sdispl = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rdispl = alloc(nproc, sizeof(int))) == NULL) goto error;
+  for (n = 0, p = 0; p < nproc; p++) {
+    sdispl[p] = (int)n;
+    n += scount[p];
+  }
+  for (n = 0, p = 0; p < nproc; p++) {
+    rdispl[p] = (int)n;
+    n += rcount[p];
+  }
+  if (n > INT_MAX) {
+    HECMW_set_error(HECMW_PART_E_INV_ARG, "too much data to exchange");
+    goto error;
+  }
+  if ((*rbuf = alloc(n, sizeof(int))) == NULL) goto error;
+
+  if (HECMW_Alltoallv(sbuf, scount, sdispl, HECMW_INT, *rbuf, rcount, rdispl,
+                      HECMW_INT, comm))
+    goto error;
+  *ntotal = (int)n;
+
+  HECMW_free(sdispl);
+  HECMW_free(rdispl);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(sdispl);
+  HECMW_free(rdispl);
+  HECMW_free(*rbuf);
+  *rbuf = NULL;
+  return RTC_ERROR;
+}
+
+/*
+ * Send record i (size ints at rec + i * size) to process dest[i]. The *nout
+ * records received are stored in *out in order of the sending process.
+ * slot[i], if slot is not NULL, gets the position of record i in the send
+ * order; scount and rcount get the numbers of records per process.
+ */
+static int scatter(const int *rec, int size, int n, const int *dest,
+                   int *slot, int *scount, int *rcount, int **out,
+                   int *nout) {
+  int *sbuf = NULL, *pos = NULL, *sc = NULL, *rc = NULL;
+  int i, p, k, ntotal;
+
+  *out = NULL;
+  if ((long long)n * size > INT_MAX) {
+    HECMW_set_error(HECMW_PART_E_INV_ARG, "too much data to exchange");
+    goto error;
+  }
+  if ((pos = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((sc = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rc = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((sbuf = alloc((size_t)n * size, sizeof(int))) == NULL) goto error;
+
+  memset(scount, 0, sizeof(int) * nproc);
+  for (i = 0; i < n; i++) scount[dest[i]]++;
+  for (k = 0, p = 0; p < nproc; p++) {
+    pos[p] = k;
+    k += scount[p];
+    sc[p] = scount[p] * size;
+  }
+  for (i = 0; i < n; i++) {
+    k = pos[dest[i]]++;
+    if (slot) slot[i] = k;
+    memcpy(sbuf + (size_t)size * k, rec + (size_t)size * i,
+           sizeof(int) * size);
+  }
+
+  if (exchange(sbuf, sc, out, rc, &ntotal)) goto error;
+  for (p = 0; p < nproc; p++) rcount[p] = rc[p] / size;
+  *nout = ntotal / size;
+
+  HECMW_free(sbuf);
+  HECMW_free(pos);
+  HECMW_free(sc);
+  HECMW_free(rc);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(sbuf);
+  HECMW_free(pos);
+  HECMW_free(sc);
+  HECMW_free(rc);
+  return RTC_ERROR;
+}
+
+/* send the n requests of size ints in req to the processes dest */
+static int route_init(struct route *rt, int n, const int *req, int size,
+                      const int *dest) {
+  rt->n      = n;
+  rt->nrecv  = 0;
+  rt->recv   = NULL;
+  rt->slot   = alloc(n, sizeof(int));
+  rt->scount = alloc(nproc, sizeof(int));
+  rt->rcount = alloc(nproc, sizeof(int));
+  if (rt->slot == NULL || rt->scount == NULL || rt->rcount == NULL)
+    return RTC_ERROR;
+
+  return scatter(req, size, n, dest, rt->slot, rt->scount, rt->rcount,
+                 &rt->recv, &rt->nrecv);
+}
+
+/*
+ * Answer the requests received with size ints each, in order of rt->recv.
+ * reply gets the answers in order of the requests sent.
+ */
+static int route_reply(const struct route *rt, const int *val, int size,
+                       int *reply) {
+  int *sc = NULL, *rc = NULL, *rbuf = NULL;
+  int i, p, ntotal;
+
+  if ((sc = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rc = alloc(nproc, sizeof(int))) == NULL) goto error;
+  for (p = 0; p < nproc; p++) sc[p] = rt->rcount[p] * size;
+
+  if (exchange((int *)val, sc, &rbuf, rc, &ntotal)) goto error;
+  for (i = 0; i < rt->n; i++) {
+    memcpy(reply + (size_t)size * i, rbuf + (size_t)size * rt->slot[i],
+           sizeof(int) * size);
+  }
+
+  HECMW_free(sc);
+  HECMW_free(rc);
+  HECMW_free(rbuf);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(sc);
+  HECMW_free(rc);
+  HECMW_free(rbuf);
+  return RTC_ERROR;
+}
+
+/*
+ * Answers of varying length: item[index[j]] .. item[index[j+1]-1] for the
+ * request j received. *rindex and *ritem get them in order of the requests.
+ */
+static int route_reply_list(const struct route *rt, const int *index,
+                            const int *item, int **rindex, int **ritem) {
+  int *len = NULL, *rlen = NULL, *off = NULL, *sc = NULL, *rc = NULL;
+  int *rbuf = NULL;
+  int i, j, p, n, ntotal;
+
+  *rindex = NULL;
+  *ritem  = NULL;
+  if ((len = alloc(rt->nrecv, sizeof(int))) == NULL) goto error;
+  if ((rlen = alloc(rt->n, sizeof(int))) == NULL) goto error;
+  if ((off = alloc(rt->n, sizeof(int))) == NULL) goto error;
+  if ((sc = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rc = alloc(nproc, sizeof(int))) == NULL) goto error;
+
+  for (j = 0; j < rt->nrecv; j++) len[j] = index[j + 1] - index[j];
+  if (route_reply(rt, len, 1, rlen)) goto error;
+
+  for (j = 0, p = 0; p < nproc; p++) {
+    for (sc[p] = 0, n = 0; n < rt->rcount[p]; n++, j++) sc[p] += len[j];
+  }
+  if (exchange((int *)item + index[0], sc, &rbuf, rc, &ntotal)) goto error;
+
+  /* the answers arrive in the send order of the requests */
+  for (i = 0; i < rt->n; i++) off[rt->slot[i]] = rlen[i];
+  for (n = 0, j = 0; j < rt->n; j++) {
+    int m  = off[j];
+    off[j] = n;
+    n += m;
+  }
+
+  if ((*rindex = alloc(rt->n + 1, sizeof(int))) == NULL) goto error;
+  if ((*ritem = alloc(n, sizeof(int))) == NULL) goto error;
+  (*rindex)[0] = 0;
+  for (i = 0; i < rt->n; i++) {
+    (*rindex)[i + 1] = (*rindex)[i] + rlen[i];
+    memcpy(*ritem + (*rindex)[i], rbuf + off[rt->slot[i]],
+           sizeof(int) * rlen[i]);
+  }
+
+  HECMW_free(len);
+  HECMW_free(rlen);
+  HECMW_free(off);
+  HECMW_free(sc);
+  HECMW_free(rc);
+  HECMW_free(rbuf);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(len);
+  HECMW_free(rlen);
+  HECMW_free(off);
+  HECMW_free(sc);
+  HECMW_free(rc);
+  HECMW_free(rbuf);
+  HECMW_free(*rindex);
+  HECMW_free(*ritem);
+  *rindex = NULL;
+  *ritem  = NULL;
+  return RTC_ERROR;
+}
+
+static void route_free(struct route *rt) {
+  HECMW_free(rt->slot);
+  HECMW_free(rt->scount);
+  HECMW_free(rt->rcount);
+  HECMW_free(rt->recv);
+  memset(rt, 0, sizeof(*rt));
+}
+
+/*============================================================================*/
+/*  element lists                                                             */
+/*============================================================================*/
+
+static void elem_free(struct elem_list *e) {
+  HECMW_free(e->id);
+  HECMW_free(e->block);
+  HECMW_free(e->seq);
+  HECMW_free(e->type);
+  HECMW_free(e->index);
+  HECMW_free(e->node);
+  memset(e, 0, sizeof(*e));
+}
+
+static int elem_alloc(struct elem_list *e, int n, int n_item) {
+  e->n     = n;
+  e->id    = alloc(n, sizeof(int));
+  e->block = alloc(n, sizeof(int));
+  e->seq   = alloc(n, sizeof(int));
+  e->type  = alloc(n, sizeof(int));
+  e->index = alloc(n + 1, sizeof(int));
+  e->node  = alloc(n_item, sizeof(int));
+  if (!e->id || !e->block || !e->seq || !e->type || !e->index || !e->node) {
+    elem_free(e);
+    return RTC_ERROR;
+  }
+  e->index[0] = 0;
+  return RTC_NORMAL;
+}
+
+/* sort in file order if by_seq, else by ID */
+static int elem_sort(struct elem_list *e, int by_seq) {
+  struct elem_list s;
+  int *key;
+  int i, j, k;
+
+  if ((key = alloc((size_t)e->n * 2, sizeof(int))) == NULL) return RTC_ERROR;
+  for (i = 0; i < e->n; i++) {
+    key[2 * i]     = by_seq ? e->seq[i] : e->id[i];
+    key[2 * i + 1] = i;
+  }
+  qsort(key, e->n, sizeof(int) * 2, cmp_pair);
+
+  if (elem_alloc(&s, e->n, e->index[e->n])) {
+    HECMW_free(key);
+    return RTC_ERROR;
+  }
+  for (i = 0; i < e->n; i++) {
+    k           = key[2 * i + 1];
+    s.id[i]     = e->id[k];
+    s.block[i]  = e->block[k];
+    s.seq[i]    = e->seq[k];
+    s.type[i]   = e->type[k];
+    s.index[i + 1] = s.index[i] + e->index[k + 1] - e->index[k];
+    for (j = 0; j < e->index[k + 1] - e->index[k]; j++) {
+      s.node[s.index[i] + j] = e->node[e->index[k] + j];
+    }
+  }
+  HECMW_free(key);
+  elem_free(e);
+  *e = s;
+  return RTC_NORMAL;
+}
+
+/*
+ * Send element i to the processes dest[dindex[i]] .. dest[dindex[i+1]-1];
+ * out gets the elements received.
+ */
+static int elem_send(const struct elem_list *e, const int *dindex,
+                     const int *dest, struct elem_list *out) {
+  int *sbuf = NULL, *pos = NULL, *sc = NULL, *rc = NULL, *rbuf = NULL;
+  long long total;
+  int i, j, k, p, n, n_item, ntotal;
+
+  memset(out, 0, sizeof(*out));
+  if ((pos = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((sc = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rc = alloc(nproc, sizeof(int))) == NULL) goto error;
+
+  memset(sc, 0, sizeof(int) * nproc);
+  for (total = 0, i = 0; i < e->n; i++) {
+    int size = 4 + e->index[i + 1] - e->index[i];
+    for (k = dindex[i]; k < dindex[i + 1]; k++) {
+      sc[dest[k]] += size;
+      total += size;
+    }
+  }
+  if (total > INT_MAX) {
+    HECMW_set_error(HECMW_PART_E_INV_ARG, "too much data to exchange");
+    goto error;
+  }
+  if ((sbuf = alloc(total, sizeof(int))) == NULL) goto error;
+  for (n = 0, p = 0; p < nproc; p++) {
+    pos[p] = n;
+    n += sc[p];
+  }
+  for (i = 0; i < e->n; i++) {
+    for (k = dindex[i]; k < dindex[i + 1]; k++) {
+      int *q = sbuf + pos[dest[k]];
+      *q++   = e->id[i];
+      *q++   = e->block[i];
+      *q++   = e->seq[i];
+      *q++   = e->type[i];
+      for (j = e->index[i]; j < e->index[i + 1]; j++) *q++ = e->node[j];
+      pos[dest[k]] = (int)(q - sbuf);
+    }
+  }
+
+  if (exchange(sbuf, sc, &rbuf, rc, &ntotal)) goto error;
+
+  for (n = 0, n_item = 0, i = 0; i < ntotal; n++) {
+    int nn = HECMW_get_max_node(rbuf[i + 3]);
+    n_item += nn;
+    i += 4 + nn;
+  }
+  if (elem_alloc(out, n, n_item)) goto error;
+  for (n = 0, i = 0; i < ntotal; n++) {
+    int nn            = HECMW_get_max_node(rbuf[i + 3]);
+    out->id[n]        = rbuf[i];
+    out->block[n]     = rbuf[i + 1];
+    out->seq[n]       = rbuf[i + 2];
+    out->type[n]      = rbuf[i + 3];
+    out->index[n + 1] = out->index[n] + nn;
+    memcpy(out->node + out->index[n], rbuf + i + 4, sizeof(int) * nn);
+    i += 4 + nn;
+  }
+
+  HECMW_free(sbuf);
+  HECMW_free(pos);
+  HECMW_free(sc);
+  HECMW_free(rc);
+  HECMW_free(rbuf);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(sbuf);
+  HECMW_free(pos);
+  HECMW_free(sc);
+  HECMW_free(rc);
+  HECMW_free(rbuf);
+  return RTC_ERROR;
+}
+
+/*============================================================================*/
+/*  reading the mesh file                                                     */
+/*============================================================================*/
+
+/* header lines left to the serial reader */
+static const char *const unsupported_header[] = {
+    "!CONNECTIVITY", "!CONTACT", "!ECOPY", "!EGEN",  "!EQUATION",
+    "!INCLUDE",      "!INITIAL", "!NCOPY", "!NFILL", "!NGEN"};
+
+static int is_header(const char *p) { return p[0] == '!' && p[1] != '!'; }
+
+static int is_comment(const char *p) {
+  return p[0] == '#' || (p[0] == '!' && p[1] == '!');
+}
+
+static const char *end_of_line(const char *p, const char *next) {
+  return next > p && next[-1] == '\n' ? next - 1 : next;
+}
+
+static const char *skip_ws(const char *p, const char *eol) {
+  while (p < eol && (*p == ' ' || *p == '\t')) p++;
+  return p;
+}
+
+static int is_delim(const char *p, const char *eol) {
+  return p >= eol || *p == ',' || *p == ' ' || *p == '\t' || *p == '\r';
+}
+
+static int is_word(const char *p, size_t len, const char *word) {
+  return len == strlen(word) && !strncmp(p, word, len);
+}
+
+static int has_prefix(const char *p, const char *eol, const char *key) {
+  size_t len = strlen(key);
+  return (size_t)(eol - p) >= len && !strncmp(p, key, len);
+}
+
+/*
+ * Kind of the block opened by the header line [p, eol).
+ * Returns 1 if the line has to be left to the serial reader.
+ */
+static int parse_header(const char *p, const char *eol, struct header *h) {
+  const char *name, *val;
+  size_t i;
+
+  h->kind  = BLOCK_OTHER;
+  h->etype = 0;
+  h->nnode = 0;
+
+  for (i = 0; i < sizeof(unsupported_header) / sizeof(*unsupported_header);
+       i++) {
+    if (has_prefix(p, eol, unsupported_header[i])) return 1;
+  }
+  if (has_prefix(p, eol, "!NODE")) {
+    h->kind = BLOCK_NODE;
+    p += 5;
+  } else if (has_prefix(p, eol, "!ELEMENT")) {
+    h->kind = BLOCK_ELEM;
+    p += 8;
+  } else if (has_prefix(p, eol, "!END")) {
+    h->kind = BLOCK_END;
+    return 0;
+  } else {
+    return 0;
+  }
+  if (!is_delim(p, eol)) return 1;
+
+  /* ", NAME = value" parameters */
+  for (;;) {
+    p = skip_ws(p, eol);
+    if (p + 1 == eol && *p == '\r') p++;
+    if (p >= eol) break;
+    if (*p != ',') return 1;
+    p = skip_ws(p + 1, eol);
+    for (name = p; p < eol && *p >= 'A' && *p <= 'Z'; p++)
+      ;
+    i = p - name;
+    p = skip_ws(p, eol);
+    if (p >= eol || *p != '=') return 1;
+    p = skip_ws(p + 1, eol);
+    for (val = p; !is_delim(p, eol); p++)
+      ;
+    if (p == val) return 1;
+
+    if (h->kind == BLOCK_NODE) {
+      if (is_word(name, i, "NGRP")) continue;
+      if (is_word(name, i, "SYSTEM") && is_word(val, p - val, "R")) continue;
+    } else {
+      if (is_word(name, i, "EGRP")) continue;
+      if (is_word(name, i, "TYPE")) {
+        if (HECMW_io_bulk_scan_int(&val, p, &h->etype) || val != p) return 1;
+        continue;
+      }
+    }
+    return 1;
+  }
+
+  if (h->kind == BLOCK_ELEM) {
+    h->nnode = HECMW_get_max_node(h->etype);
+    if (h->nnode <= 0) return 1;
+  }
+  return 0;
+}
+
+/*
+ * The lines which start in bytes [size * myrank / nproc,
+ * size * (myrank + 1) / nproc) of the file, the last one complete.
+ */
+static int read_share(const char *filename, struct buffer *b, char **begin,
+                      char **end) {
+  FILE *fp;
+  long size, first, stop, off;
+  size_t n;
+  char *q;
+
+  if ((fp = fopen(filename, "rb")) == NULL) goto error_io;
+  if (fseek(fp, 0L, SEEK_END) || (size = ftell(fp)) < 0) goto error_io;
+  first = (long)((long long)size * myrank / nproc);
+  stop  = (long)((long long)size * (myrank + 1) / nproc);
+
+  /* a line starts after a newline */
+  off = first > 0 ? first - 1 : 0;
+  n   = (size_t)(stop - off);
+  if (buf_reserve(b, n + 1)) goto error;
+  if (fseek(fp, off, SEEK_SET)) goto error_io;
+  if (n > 0 && fread(b->p, n, 1, fp) != 1) goto error_io;
+  b->n = n;
+
+  if (first > 0) {
+    q     = memchr(b->p, '\n', n);
+    first = q ? off + (q + 1 - b->p) : stop;
+  }
+  if (first >= stop) {
+    b->n = 0;
+    *begin = *end = b->p;
+    fclose(fp);
+    return RTC_NORMAL;
+  }
+
+  while (b->p[b->n - 1] != '\n') {
+    if (buf_reserve(b, READ_CHUNK)) goto error;
+    n = fread(b->p + b->n, 1, READ_CHUNK, fp);
+    if (n == 0) {
+      if (ferror(fp)) goto error_io;
+      b->p[b->n++] = '\n';
+      break;
+    }
+    q    = memchr(b->p + b->n, '\n', n);
+    b->n = q ? (size_t)(q + 1 - b->p) : b->n + n;
+  }
+  fclose(fp);
+
+  *begin = b->p + (first - off);
+  *end   = b->p + b->n;
+  return RTC_NORMAL;
+
+error_io:
+  HECMW_set_error(HECMW_IO_HEC_E0001, "File: %s, %s", filename,
+                  strerror(errno));
+error:
+  if (fp) fclose(fp);
+  return RTC_ERROR;
+}
+
+/* header lines and the blank and data lines around them */
+static void scan_share(const char *p, const char *end,
+                       struct share_info *info) {
+  struct header h;
+
+  memset(info, 0, sizeof(*info));
+  info->first_end = -1;
+  info->kind      = BLOCK_OTHER;
+
+  while (p < end) {
+    const char *next = HECMW_io_bulk_next_line(p, end);
+    const char *eol  = end_of_line(p, next);
+
+    if (is_header(p)) {
+      parse_header(p, eol, &h);
+      if (h.kind == BLOCK_END && info->first_end < 0)
+        info->first_end = info->nhead;
+      info->nhead++;
+      info->kind       = h.kind;
+      info->etype      = h.etype;
+      info->nnode      = h.nnode;
+      info->tail_blank = 0;
+    } else if (HECMW_io_bulk_is_eol(p, eol)) {
+      info->tail_blank = 1;
+    } else if (!is_comment(p) && info->nhead == 0) {
+      info->lead_data = 1;
+    }
+    p = next;
+  }
+}
+
+static int node_line(const char *p, const char *eol, int *ival, double *dval,
+                     void *arg) {
+  if (is_comment(p)) return HECMW_IO_BULK_SKIP;
+  if (HECMW_io_bulk_scan_node(p, eol, ival, dval)) return -1;
+  return HECMW_IO_BULK_REC;
+}
+
+static int elem_line(const char *p, const char *eol, int *ival, double *dval,
+                     void *arg) {
+  if (is_comment(p)) return HECMW_IO_BULK_SKIP;
+  if (HECMW_io_bulk_scan_elem(p, eol, *(int *)arg, 0, ival)) return -1;
+  return HECMW_IO_BULK_REC;
+}
+
+/*
+ * Parse the data lines [p, q) of block b. As for the serial reader, the
+ * data end at a blank line; only blank lines and comments may follow.
+ */
+static int read_records(const char *p, const char *q, int b,
+                        const struct header *h, struct buffer *nodes,
+                        struct buffer *elems, struct buffer *items) {
+  struct hecmw_io_bulk bulk;
+  const char *r, *s, *next;
+  size_t i;
+  int nline, rtc;
+  int rec[3];
+
+  r = HECMW_io_bulk_block_end(p, q, '!', &nline);
+  for (s = r; s < q; s = next) {
+    next = HECMW_io_bulk_next_line(s, q);
+    if (!HECMW_io_bulk_is_eol(s, end_of_line(s, next)) && !is_comment(s)) {
+      set_unsupported("data lines after a blank line");
+      return RTC_NORMAL;
+    }
+  }
+
+  if (h->kind == BLOCK_NODE) {
+    rtc = HECMW_io_bulk_parse(p, r, 1, 3, node_line, NULL, &bulk);
+  } else {
+    rtc = HECMW_io_bulk_parse(p, r, h->nnode + 1, 0, elem_line,
+                              (void *)&h->nnode, &bulk);
+  }
+  if (rtc < 0) return RTC_ERROR;
+  if (rtc > 0) {
+    set_unsupported("data lines other than one record per line");
+    return RTC_NORMAL;
+  }
+
+  for (i = 0; i < bulk.n; i++) {
+    if (h->kind == BLOCK_NODE) {
+      struct node_rec node;
+      node.id = bulk.ival[i];
+      node.block  = b;
+      node.xyz[0] = bulk.dval[3 * i];
+      node.xyz[1] = bulk.dval[3 * i + 1];
+      node.xyz[2] = bulk.dval[3 * i + 2];
+      if (buf_add(nodes, &node, sizeof(node))) goto error;
+    } else {
+      rec[0] = bulk.ival[(h->nnode + 1) * i];
+      rec[1] = b;
+      rec[2] = h->etype;
+      if (buf_add(elems, rec, sizeof(rec))) goto error;
+      if (buf_add(items, bulk.ival + (h->nnode + 1) * i + 1,
+                  sizeof(int) * h->nnode))
+        goto error;
+    }
+  }
+  HECMW_io_bulk_free(&bulk);
+  return RTC_NORMAL;
+
+error:
+  HECMW_io_bulk_free(&bulk);
+  return RTC_ERROR;
+}
+
+/*
+ * Read this process's share of the file: node records into nodes, element
+ * records (ID, block, type) into elems and their nodes into items, all
+ * other lines up to !END into pd->meta.
+ */
+static int read_mesh(struct part_data *pd, struct buffer *nodes,
+                     struct buffer *elems, struct buffer *items) {
+  struct buffer share = {NULL, 0, 0};
+  struct share_info mine, *info = NULL;
+  struct header h;
+  char *p, *begin, *end;
+  int hoff, end_index, chain_blank, total;
+  int b, r;
+
+  if (read_share(pd->filename, &share, &begin, &end)) goto error;
+
+  /* find the block each share starts in and the !END line */
+  scan_share(begin, end, &mine);
+  if ((info = alloc(nproc, sizeof(*info))) == NULL) goto error;
+  if (allgather_int((int *)&mine, sizeof(mine) / sizeof(int), (int *)info))
+    goto error;
+
+  end_index = INT_MAX;
+  for (hoff = 0, total = 0, r = 0; r < nproc; r++) {
+    if (info[r].first_end >= 0 && total + info[r].first_end < end_index)
+      end_index = total + info[r].first_end;
+    if (r == myrank) hoff = total;
+    total += info[r].nhead;
+  }
+  pd->nblock = end_index < INT_MAX ? end_index + 1 : total;
+
+  h.kind      = BLOCK_OTHER;
+  chain_blank = 0;
+  for (r = myrank - 1; r >= 0; r--) {
+    chain_blank |= info[r].tail_blank;
+    if (info[r].nhead > 0) {
+      h.kind  = info[r].kind;
+      h.etype = info[r].etype;
+      h.nnode = info[r].nnode;
+      break;
+    }
+  }
+
+  b = hoff - 1;
+  p = begin;
+  while (p < end) {
+    char *q;
+
+    if (is_header(p)) {
+      char *next = (char *)HECMW_io_bulk_next_line(p, end);
+
+      if (++b > end_index) break;
+      if (parse_header(p, end_of_line(p, next), &h))
+        set_unsupported("the header line");
+      if (buf_add(&pd->meta, p, next - p)) goto error;
+      p = next;
+      continue;
+    }
+    if (b >= end_index) break;
+
+    for (q = p; q < end && !is_header(q);) {
+      q = (char *)HECMW_io_bulk_next_line(q, end);
+    }
+    if (h.kind == BLOCK_NODE || h.kind == BLOCK_ELEM) {
+      if (p == begin && chain_blank && mine.lead_data)
+        set_unsupported("data lines after a blank line");
+      if (read_records(p, q, b, &h, nodes, elems, items)) goto error;
+    } else {
+      if (buf_add(&pd->meta, p, q - p)) goto error;
+    }
+    p = q;
+  }
+
+  buf_free(&share);
+  HECMW_free(info);
+  return RTC_NORMAL;
+
+error:
+  buf_free(&share);
+  HECMW_free(info);
+  return RTC_ERROR;
+}
+
+/* all processes get the lines of pd->meta of all processes in file order */
+static int gather_meta(struct part_data *pd) {
+  struct buffer all = {NULL, 0, 0};
+  int *count = NULL, *displ = NULL;
+  long long n;
+  int mine, r;
+
+  if (pd->meta.n > INT_MAX) goto error_size;
+  mine = (int)pd->meta.n;
+  if ((count = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((displ = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if (allgather_int(&mine, 1, count)) goto error;
+  for (n = 0, r = 0; r < nproc; r++) {
+    displ[r] = (int)n;
+    n += count[r];
+  }
+  if (n > INT_MAX) goto error_size;
+  if (buf_reserve(&all, n + 3)) goto error;
+  if (HECMW_Allgatherv(pd->meta.p, mine, HECMW_CHAR, all.p, count, displ,
+                       HECMW_CHAR, comm))
+    goto error;
+  all.n = (size_t)n;
+
+  buf_free(&pd->meta);
+  pd->meta = all;
+  HECMW_free(count);
+  HECMW_free(displ);
+  return RTC_NORMAL;
+
+error_size:
+  HECMW_set_error(HECMW_PART_E_INV_ARG, "too many lines besides node data");
+error:
+  buf_free(&all);
+  HECMW_free(count);
+  HECMW_free(displ);
+  return RTC_ERROR;
+}
+
+/*============================================================================*/
+/*  distribution of the records to their homes                                */
+/*============================================================================*/
+
+static int distribute_records(struct part_data *pd, struct buffer *nodes,
+                              struct buffer *elems, struct buffer *items) {
+  struct elem_list e = {0};
+  struct node_rec *node = (struct node_rec *)nodes->p;
+  int *rec = (int *)elems->p;
+  int *dest = NULL, *dindex = NULL, *scount = NULL, *rcount = NULL;
+  int *out = NULL, *rep = NULL, *count = NULL;
+  int n_node = (int)(nodes->n / sizeof(*node));
+  int n_elem = (int)(elems->n / (3 * sizeof(int)));
+  int mine[2], maxid[2], all[2];
+  long long noff, eoff;
+  int i, r;
+
+  /* position of the records in the file */
+  if ((count = alloc((size_t)nproc * 2, sizeof(int))) == NULL) goto error;
+  mine[0] = n_node;
+  mine[1] = n_elem;
+  if (allgather_int(mine, 2, count)) goto error;
+  for (noff = 0, eoff = 0, r = 0; r < myrank; r++) {
+    noff += count[2 * r];
+    eoff += count[2 * r + 1];
+  }
+  for (i = 0; i < n_node; i++) node[i].seq = (int)(noff + i);
+
+  /* the smallest ID of each block stays in every process */
+  if ((pd->rep = alloc((size_t)pd->nblock * 2, sizeof(int))) == NULL)
+    goto error;
+  if ((rep = alloc((size_t)pd->nblock * 2, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < 2 * pd->nblock; i++) rep[i] = INT_MAX;
+  for (i = 0; i < n_node; i++) {
+    if (node[i].id < rep[2 * node[i].block])
+      rep[2 * node[i].block] = node[i].id;
+  }
+  for (i = 0; i < n_elem; i++) {
+    if (rec[3 * i] < rep[2 * rec[3 * i + 1] + 1])
+      rep[2 * rec[3 * i + 1] + 1] = rec[3 * i];
+  }
+  if (HECMW_Allreduce(rep, pd->rep, 2 * pd->nblock, HECMW_INT, HECMW_MIN,
+                      comm))
+    goto error;
+
+  for (maxid[0] = 0, i = 0; i < n_node; i++) {
+    if (node[i].id > maxid[0]) maxid[0] = node[i].id;
+  }
+  for (maxid[1] = 0, i = 0; i < n_elem; i++) {
+    if (rec[3 * i] > maxid[1]) maxid[1] = rec[3 * i];
+  }
+  if (HECMW_Allreduce(maxid, all, 2, HECMW_INT, HECMW_MAX, comm)) goto error;
+  pd->node_maxid = all[0];
+  pd->elem_maxid = all[1];
+  if (pd->node_maxid == 0 || pd->elem_maxid == 0) {
+    set_unsupported("a mesh without nodes or elements");
+    HECMW_free(rep);
+    HECMW_free(count);
+    return RTC_NORMAL;
+  }
+
+  /* nodes */
+  if ((dest = alloc(n_node > n_elem ? n_node : n_elem, sizeof(int))) == NULL)
+    goto error;
+  if ((scount = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rcount = alloc(nproc, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < n_node; i++) dest[i] = home_of(node[i].id, pd->node_maxid);
+  if (scatter((int *)node, sizeof(*node) / sizeof(int), n_node, dest, NULL,
+              scount, rcount, &out, &pd->n_node))
+    goto error;
+  pd->node = (struct node_rec *)out;
+  out      = NULL;
+  buf_free(nodes);
+  qsort(pd->node, pd->n_node, sizeof(*pd->node), cmp_node_rec);
+  for (i = 1; i < pd->n_node; i++) {
+    if (pd->node[i].id == pd->node[i - 1].id) {
+      set_unsupported("duplicate node IDs");
+      break;
+    }
+  }
+
+  /* elements */
+  e.n     = n_elem;
+  e.id    = alloc(n_elem, sizeof(int));
+  e.block = alloc(n_elem, sizeof(int));
+  e.seq   = alloc(n_elem, sizeof(int));
+  e.type  = alloc(n_elem, sizeof(int));
+  e.index = alloc(n_elem + 1, sizeof(int));
+  dindex  = alloc(n_elem + 1, sizeof(int));
+  if (!e.id || !e.block || !e.seq || !e.type || !e.index || !dindex)
+    goto error;
+  e.index[0] = 0;
+  dindex[0]  = 0;
+  for (i = 0; i < n_elem; i++) {
+    e.id[i]        = rec[3 * i];
+    e.block[i]     = rec[3 * i + 1];
+    e.seq[i]       = (int)(eoff + i);
+    e.type[i]      = rec[3 * i + 2];
+    e.index[i + 1] = e.index[i] + HECMW_get_max_node(e.type[i]);
+    dindex[i + 1]  = i + 1;
+    dest[i]        = home_of(e.id[i], pd->elem_maxid);
+  }
+  e.node   = (int *)items->p;
+  items->p = NULL;
+  buf_free(items);
+  buf_free(elems);
+
+  if (elem_send(&e, dindex, dest, &pd->elem)) goto error;
+  elem_free(&e);
+  if (elem_sort(&pd->elem, 0)) goto error;
+  for (i = 1; i < pd->elem.n; i++) {
+    if (pd->elem.id[i] == pd->elem.id[i - 1]) {
+      set_unsupported("duplicate element IDs");
+      break;
+    }
+  }
+
+  HECMW_free(dest);
+  HECMW_free(dindex);
+  HECMW_free(scount);
+  HECMW_free(rcount);
+  HECMW_free(rep);
+  HECMW_free(count);
+  return RTC_NORMAL;
+
+error:
+  elem_free(&e);
+  HECMW_free(out);
+  HECMW_free(dest);
+  HECMW_free(dindex);
+  HECMW_free(scount);
+  HECMW_free(rcount);
+  HECMW_free(rep);
+  HECMW_free(count);
+  return RTC_ERROR;
+}
+
+/*
+ * The nodes of the elements are asked at their homes; nodes nobody asks
+ * for are not in use and not partitioned, as in the serial partitioner.
+ */
+static int check_elem_nodes(struct part_data *pd) {
+  int *dest = NULL, *found = NULL, *reply = NULL;
+  int i;
+
+  pd->n_unode = pd->elem.index[pd->elem.n];
+  if ((pd->unode = alloc(pd->n_unode, sizeof(int))) == NULL) goto error;
+  memcpy(pd->unode, pd->elem.node, sizeof(int) * pd->n_unode);
+  pd->n_unode = sort_unique(pd->unode, pd->n_unode, 1);
+
+  if ((dest = alloc(pd->n_unode, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < pd->n_unode; i++) {
+    if (pd->unode[i] > pd->node_maxid) {
+      dest[i] = nproc - 1; /* not found there */
+    } else {
+      dest[i] = home_of(pd->unode[i], pd->node_maxid);
+    }
+  }
+  if (route_init(&pd->en, pd->n_unode, pd->unode, 1, dest)) goto error;
+
+  if ((pd->en_node = alloc(pd->en.nrecv, sizeof(int))) == NULL) goto error;
+  if ((found = alloc(pd->en.nrecv, sizeof(int))) == NULL) goto error;
+  if ((pd->vtx = alloc(pd->n_node, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < pd->n_node; i++) pd->vtx[i] = -1;
+  for (i = 0; i < pd->en.nrecv; i++) {
+    pd->en_node[i] = find_node(pd->node, pd->n_node, pd->en.recv[i]);
+    found[i]       = pd->en_node[i] >= 0;
+    if (found[i]) pd->vtx[pd->en_node[i]] = 0;
+  }
+
+  if ((reply = alloc(pd->n_unode, sizeof(int))) == NULL) goto error;
+  if (route_reply(&pd->en, found, 1, reply)) goto error;
+  for (i = 0; i < pd->n_unode; i++) {
+    if (!reply[i]) {
+      set_unsupported("elements with undefined nodes");
+      break;
+    }
+  }
+
+  for (pd->nvtx = 0, i = 0; i < pd->n_node; i++) {
+    if (pd->vtx[i] == 0) pd->vtx[i] = pd->nvtx++;
+  }
+
+  HECMW_free(dest);
+  HECMW_free(found);
+  HECMW_free(reply);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(dest);
+  HECMW_free(found);
+  HECMW_free(reply);
+  return RTC_ERROR;
+}
+
+/*============================================================================*/
+/*  partitioning                                                              */
+/*============================================================================*/
+
+/*
+ * Neighbors of the vertices of this process, by node ID:
+ * adj_item[adj_index[v]] .. adj_item[adj_index[v+1]-1].
+ */
+static int create_graph(struct part_data *pd, int **adj_index,
+                        int **adj_item) {
+  struct hecmwST_local_mesh mesh;
+  struct hecmw_part_edge_data edge = {0, NULL};
+  struct elem_list *e = &pd->elem;
+  int *key = NULL, *req = NULL, *dest = NULL, *scount = NULL, *rcount = NULL;
+  int *pair = NULL;
+  int i, j, k, n, npair;
+
+  *adj_index = NULL;
+  *adj_item  = NULL;
+
+  /* edges of the elements of this process, elements grouped by type */
+  if (e->n > 0) {
+    memset(&mesh, 0, sizeof(mesh));
+    mesh.n_node = pd->n_unode;
+    mesh.n_elem = e->n;
+    if ((key = alloc((size_t)e->n * 2, sizeof(int))) == NULL) goto error;
+    for (i = 0; i < e->n; i++) {
+      key[2 * i]     = e->type[i];
+      key[2 * i + 1] = i;
+    }
+    qsort(key, e->n, sizeof(int) * 2, cmp_pair);
+
+    mesh.elem_type_index = alloc(e->n + 1, sizeof(int));
+    mesh.elem_type_item  = alloc(e->n, sizeof(int));
+    mesh.elem_node_index = alloc(e->n + 1, sizeof(int));
+    mesh.elem_node_item  = alloc(e->index[e->n], sizeof(int));
+    if (!mesh.elem_type_index || !mesh.elem_type_item ||
+        !mesh.elem_node_index || !mesh.elem_node_item) {
+      HECMW_free(mesh.elem_type_index);
+      HECMW_free(mesh.elem_type_item);
+      HECMW_free(mesh.elem_node_index);
+      HECMW_free(mesh.elem_node_item);
+      goto error;
+    }
+    mesh.elem_node_index[0] = 0;
+    for (i = 0; i < e->n; i++) {
+      k = key[2 * i + 1];
+      if (i == 0 || key[2 * i] != key[2 * i - 2]) {
+        mesh.elem_type_index[mesh.n_elem_type] = i;
+        mesh.elem_type_item[mesh.n_elem_type]  = key[2 * i];
+        mesh.n_elem_type++;
+      }
+      n = e->index[k + 1] - e->index[k];
+      memcpy(mesh.elem_node_item + mesh.elem_node_index[i],
+             e->node + e->index[k], sizeof(int) * n);
+      mesh.elem_node_index[i + 1] = mesh.elem_node_index[i] + n;
+    }
+    mesh.elem_type_index[mesh.n_elem_type] = e->n;
+
+    i = HECMW_mesh_edge_info(&mesh, &edge);
+    HECMW_free(mesh.elem_type_index);
+    HECMW_free(mesh.elem_type_item);
+    HECMW_free(mesh.elem_node_index);
+    HECMW_free(mesh.elem_node_item);
+    HECMW_free(key);
+    key = NULL;
+    if (i) goto error;
+  }
+
+  /* both directions of each edge to the home of its first node */
+  if (edge.n_edge > INT_MAX / 4) {
+    HECMW_set_error(HECMW_PART_E_INV_ARG, "too many edges");
+    goto error;
+  }
+  n = (int)edge.n_edge * 2;
+  if ((req = alloc((size_t)n * 2, sizeof(int))) == NULL) goto error;
+  if ((dest = alloc(n, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < edge.n_edge; i++) {
+    int a = edge.edge_node_item[2 * i], b = edge.edge_node_item[2 * i + 1];
+    req[4 * i]     = a;
+    req[4 * i + 1] = b;
+    req[4 * i + 2] = b;
+    req[4 * i + 3] = a;
+    dest[2 * i]     = home_of(a, pd->node_maxid);
+    dest[2 * i + 1] = home_of(b, pd->node_maxid);
+  }
+  HECMW_free(edge.edge_node_item);
+  edge.edge_node_item = NULL;
+
+  if ((scount = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rcount = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if (scatter(req, 2, n, dest, NULL, scount, rcount, &pair, &npair))
+    goto error;
+  HECMW_free(req);
+  HECMW_free(dest);
+  req  = NULL;
+  dest = NULL;
+
+  for (i = 0; i < npair; i++) {
+    k = find_node(pd->node, pd->n_node, pair[2 * i]);
+    HECMW_assert(k >= 0 && pd->vtx[k] >= 0);
+    pair[2 * i] = pd->vtx[k];
+  }
+  npair = sort_unique(pair, npair, 2);
+
+  if ((*adj_index = alloc(pd->nvtx + 1, sizeof(int))) == NULL) goto error;
+  if ((*adj_item = alloc(npair, sizeof(int))) == NULL) goto error;
+  for (j = 0, i = 0; i < pd->nvtx; i++) {
+    (*adj_index)[i] = j;
+    for (; j < npair && pair[2 * j] == i; j++) (*adj_item)[j] = pair[2 * j + 1];
+  }
+  (*adj_index)[pd->nvtx] = npair;
+
+  pd->n_edge = sum_all(npair);
+  if (pd->n_edge < 0) goto error;
+  pd->n_edge /= 2;
+
+  HECMW_free(pair);
+  HECMW_free(scount);
+  HECMW_free(rcount);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(edge.edge_node_item);
+  HECMW_free(key);
+  HECMW_free(req);
+  HECMW_free(dest);
+  HECMW_free(pair);
+  HECMW_free(scount);
+  HECMW_free(rcount);
+  HECMW_free(*adj_index);
+  HECMW_free(*adj_item);
+  *adj_index = NULL;
+  *adj_item  = NULL;
+  return RTC_ERROR;
+}
+
+/* coordinate as an unsigned integer of the same order */
+static uint64_t coord_key(double x) {
+  const uint64_t sign = (uint64_t)1 << 63;
+  uint64_t u;
+
+  if (x == 0.0) x = 0.0; /* no -0.0 */
+  memcpy(&u, &x, sizeof(u));
+  return (u & sign) ? ~u : u | sign;
+}
+
+struct rcb_item {
+  int group;
+  int id;
+  uint64_t key;
+  int vtx;
+};
+
+static int cmp_rcb_item(const void *a, const void *b) {
+  const struct rcb_item *x = a, *y = b;
+
+  if (x->group != y->group)
+    return (x->group > y->group) - (x->group < y->group);
+  if (x->key != y->key) return (x->key > y->key) - (x->key < y->key);
+  return (x->id > y->id) - (x->id < y->id);
+}
+
+/* end of the items of [s, e) not greater than (key, id) */
+static int rcb_count(const struct rcb_item *item, int s, int e, uint64_t key,
+                     int id) {
+  while (s < e) {
+    int mid = s + (e - s) / 2;
+    if (item[mid].key < key || (item[mid].key == key && item[mid].id <= id)) {
+      s = mid + 1;
+    } else {
+      e = mid;
+    }
+  }
+  return s;
+}
+
+/*
+ * RCB as in the serial partitioner: at step i, the lower ceil(n/2) of the n
+ * nodes of domain j along the axis move to domain j + 2^i. The median of
+ * each domain is found by bisection on (coordinate, node ID), so ties are
+ * broken by the node ID.
+ */
+static int rcb_partition(struct part_data *pd) {
+  const struct hecmw_part_cont_data *cont = pd->cont_data;
+  struct rcb_item *item = NULL;
+  uint64_t *klo = NULL, *khi = NULL;
+  int *first = NULL, *count = NULL, *sum = NULL, *half = NULL;
+  int *ilo = NULL, *ihi = NULL;
+  int n_group = 1 << cont->n_rcb_div;
+  int i, j, g, v, ng, axis, more;
+
+  if ((item = alloc(pd->nvtx, sizeof(*item))) == NULL) goto error;
+  if ((klo = alloc(n_group, sizeof(uint64_t))) == NULL) goto error;
+  if ((khi = alloc(n_group, sizeof(uint64_t))) == NULL) goto error;
+  if ((first = alloc(n_group + 1, sizeof(int))) == NULL) goto error;
+  if ((count = alloc(n_group, sizeof(int))) == NULL) goto error;
+  if ((sum = alloc(n_group, sizeof(int))) == NULL) goto error;
+  if ((half = alloc(n_group, sizeof(int))) == NULL) goto error;
+  if ((ilo = alloc(n_group, sizeof(int))) == NULL) goto error;
+  if ((ihi = alloc(n_group, sizeof(int))) == NULL) goto error;
+
+  for (v = 0; v < pd->nvtx; v++) pd->part[v] = 0;
+
+  for (i = 0; i < cont->n_rcb_div; i++) {
+    ng = 1 << i;
+    switch (cont->rcb_axis[i]) {
+      case HECMW_PART_RCB_X_AXIS: /* X-axis */
+        axis = 0;
+        break;
+      case HECMW_PART_RCB_Y_AXIS: /* Y-axis */
+        axis = 1;
+        break;
+      case HECMW_PART_RCB_Z_AXIS: /* Z-axis */
+        axis = 2;
+        break;
+      default:
+        HECMW_set_error(HECMW_PART_E_INVALID_RCB_DIR, "");
+        goto error;
+    }
+
+    for (v = 0, j = 0; j < pd->n_node; j++) {
+      if (pd->vtx[j] < 0) continue;
+      item[v].group = pd->part[v];
+      item[v].id    = pd->node[j].id;
+      item[v].key   = coord_key(pd->node[j].xyz[axis]);
+      item[v].vtx   = v;
+      v++;
+    }
+    qsort(item, pd->nvtx, sizeof(*item), cmp_rcb_item);
+    for (v = 0, g = 0; g < ng; g++) {
+      while (v < pd->nvtx && item[v].group < g) v++;
+      first[g] = v;
+    }
+    first[ng] = pd->nvtx;
+
+    for (g = 0; g < ng; g++) count[g] = first[g + 1] - first[g];
+    if (HECMW_Allreduce(count, sum, ng, HECMW_INT, HECMW_SUM, comm))
+      goto error;
+    for (g = 0; g < ng; g++) {
+      half[g] = (sum[g] + 1) / 2;
+      klo[g]  = 0;
+      khi[g]  = half[g] > 0 ? UINT64_MAX : 0;
+      ilo[g]  = 0;
+      ihi[g]  = half[g] > 0 ? INT_MAX : 0;
+    }
+
+    /* the smallest key K with half of the nodes up to K */
+    for (more = 1; more;) {
+      for (g = 0; g < ng; g++) {
+        uint64_t mid = klo[g] + (khi[g] - klo[g]) / 2;
+        count[g] =
+            rcb_count(item, first[g], first[g + 1], mid, INT_MAX) - first[g];
+      }
+      if (HECMW_Allreduce(count, sum, ng, HECMW_INT, HECMW_SUM, comm))
+        goto error;
+      for (more = 0, g = 0; g < ng; g++) {
+        uint64_t mid = klo[g] + (khi[g] - klo[g]) / 2;
+        if (klo[g] == khi[g]) continue;
+        if (sum[g] >= half[g]) {
+          khi[g] = mid;
+        } else {
+          klo[g] = mid + 1;
+        }
+        if (klo[g] < khi[g]) more = 1;
+      }
+    }
+
+    /* the smallest node ID I with half of the nodes up to (K, I) */
+    for (more = 1; more;) {
+      for (g = 0; g < ng; g++) {
+        int mid  = ilo[g] + (ihi[g] - ilo[g]) / 2;
+        count[g] = rcb_count(item, first[g], first[g + 1], klo[g], mid) -
+                   first[g];
+      }
+      if (HECMW_Allreduce(count, sum, ng, HECMW_INT, HECMW_SUM, comm))
+        goto error;
+      for (more = 0, g = 0; g < ng; g++) {
+        int mid = ilo[g] + (ihi[g] - ilo[g]) / 2;
+        if (ilo[g] == ihi[g]) continue;
+        if (sum[g] >= half[g]) {
+          ihi[g] = mid;
+        } else {
+          ilo[g] = mid + 1;
+        }
+        if (ilo[g] < ihi[g]) more = 1;
+      }
+    }
+
+    for (g = 0; g < ng; g++) {
+      if (half[g] == 0) continue;
+      j = rcb_count(item, first[g], first[g + 1], klo[g], ilo[g]);
+      for (v = first[g]; v < j; v++) pd->part[item[v].vtx] = g + ng;
+    }
+  }
+
+  HECMW_free(item);
+  HECMW_free(klo);
+  HECMW_free(khi);
+  HECMW_free(first);
+  HECMW_free(count);
+  HECMW_free(sum);
+  HECMW_free(half);
+  HECMW_free(ilo);
+  HECMW_free(ihi);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(item);
+  HECMW_free(klo);
+  HECMW_free(khi);
+  HECMW_free(first);
+  HECMW_free(count);
+  HECMW_free(sum);
+  HECMW_free(half);
+  HECMW_free(ilo);
+  HECMW_free(ihi);
+  return RTC_ERROR;
+}
+
+#if defined(HECMW_PART_WITH_PARMETIS) && !defined(HECMW_SERIAL)
+#if defined(PARMETIS_MAJOR_VERSION) && (PARMETIS_MAJOR_VERSION >= 4)
+typedef idx_t pm_idx;
+typedef idx_t pm_int;
+typedef real_t pm_real;
+#else
+typedef idxtype pm_idx;
+typedef int pm_int;
+typedef float pm_real;
+#endif
+
+/*
+ * k-way partitioning of the distributed graph by ParMETIS; adjncy holds
+ * the global vertex indices of the neighbors.
+ */
+static int parmetis_partition(struct part_data *pd, const int *vtxdist,
+                              const int *adj_index, const int *adjncy) {
+  pm_idx *dist = NULL, *xadj = NULL, *adj = NULL, *part = NULL;
+  pm_real *tpwgts = NULL;
+  pm_real ubvec   = 1.05;
+  pm_int wgtflag  = 0;
+  pm_int numflag  = 0;
+  pm_int ncon     = 1;
+  pm_int nparts   = pd->cont_data->n_domain;
+  pm_int edgecut  = 0;
+  pm_int options[3] = {0, 0, 0};
+  MPI_Comm mpi_comm = comm;
+  int nadj = adj_index[pd->nvtx];
+  int i;
+
+  if ((dist = alloc(nproc + 1, sizeof(pm_idx))) == NULL) goto error;
+  if ((xadj = alloc(pd->nvtx + 1, sizeof(pm_idx))) == NULL) goto error;
+  if ((adj = alloc(nadj, sizeof(pm_idx))) == NULL) goto error;
+  if ((part = alloc(pd->nvtx, sizeof(pm_idx))) == NULL) goto error;
+  if ((tpwgts = alloc(nparts, sizeof(pm_real))) == NULL) goto error;
+  for (i = 0; i <= nproc; i++) dist[i] = vtxdist[i];
+  for (i = 0; i <= pd->nvtx; i++) xadj[i] = adj_index[i];
+  for (i = 0; i < nadj; i++) adj[i] = adjncy[i];
+  for (i = 0; i < nparts; i++) tpwgts[i] = (pm_real)1.0 / nparts;
+
+  HECMW_log(HECMW_LOG_DEBUG, "Entering ParMETIS_V3_PartKway...\n");
+#if defined(PARMETIS_MAJOR_VERSION) && (PARMETIS_MAJOR_VERSION >= 4)
+  if (ParMETIS_V3_PartKway(dist, xadj, adj, NULL, NULL, &wgtflag, &numflag,
+                           &ncon, &nparts, tpwgts, &ubvec, options, &edgecut,
+                           part, &mpi_comm) != METIS_OK) {
+    HECMW_set_error(HECMW_PART_E_INVALID_PMETHOD, "ParMETIS failed");
+    goto error;
+  }
+#else
+  ParMETIS_V3_PartKway(dist, xadj, adj, NULL, NULL, &wgtflag, &numflag, &ncon,
+                       &nparts, tpwgts, &ubvec, options, &edgecut, part,
+                       &mpi_comm);
+#endif
+  HECMW_log(HECMW_LOG_DEBUG, "Returned from ParMETIS_V3_PartKway\n");
+
+  for (i = 0; i < pd->nvtx; i++) pd->part[i] = (int)part[i];
+
+  HECMW_free(dist);
+  HECMW_free(xadj);
+  HECMW_free(adj);
+  HECMW_free(part);
+  HECMW_free(tpwgts);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(dist);
+  HECMW_free(xadj);
+  HECMW_free(adj);
+  HECMW_free(part);
+  HECMW_free(tpwgts);
+  return RTC_ERROR;
+}
+#endif
+
+/* domain of each vertex and the edge cut */
+static int partition_graph(struct part_data *pd) {
+  struct route rt;
+  int *adj_index = NULL, *adj_item = NULL, *dest = NULL, *vloc = NULL;
+  int *val = NULL, *reply = NULL, *vtxdist = NULL;
+  int rtc = RTC_ERROR;
+  int nadj, ncut, i, j, k;
+
+  memset(&rt, 0, sizeof(rt));
+  if (create_graph(pd, &adj_index, &adj_item)) goto end;
+  nadj = adj_index[pd->nvtx];
+
+  /* neighbors are asked at their homes */
+  if ((dest = alloc(nadj, sizeof(int))) == NULL) goto end;
+  for (i = 0; i < nadj; i++) dest[i] = home_of(adj_item[i], pd->node_maxid);
+  if (route_init(&rt, nadj, adj_item, 1, dest)) goto end;
+  if ((vloc = alloc(rt.nrecv, sizeof(int))) == NULL) goto end;
+  if ((val = alloc(rt.nrecv, sizeof(int))) == NULL) goto end;
+  if ((reply = alloc(nadj, sizeof(int))) == NULL) goto end;
+  for (i = 0; i < rt.nrecv; i++) {
+    k = find_node(pd->node, pd->n_node, rt.recv[i]);
+    HECMW_assert(k >= 0 && pd->vtx[k] >= 0);
+    vloc[i] = pd->vtx[k];
+  }
+
+  if ((pd->part = alloc(pd->nvtx, sizeof(int))) == NULL) goto end;
+  switch (pd->cont_data->method) {
+    case HECMW_PART_METHOD_RCB: /* RCB */
+      if (rcb_partition(pd)) goto end;
+      break;
+
+#if defined(HECMW_PART_WITH_PARMETIS) && !defined(HECMW_SERIAL)
+    case HECMW_PART_METHOD_KMETIS: /* kMETIS */
+    case HECMW_PART_METHOD_PMETIS: /* pMETIS */
+      if ((vtxdist = alloc(nproc + 1, sizeof(int))) == NULL) goto end;
+      if (allgather_int(&pd->nvtx, 1, vtxdist + 1)) goto end;
+      for (vtxdist[0] = 0, j = 0; j < nproc; j++) vtxdist[j + 1] += vtxdist[j];
+      for (i = 0; i < rt.nrecv; i++) val[i] = vtxdist[myrank] + vloc[i];
+      if (route_reply(&rt, val, 1, reply)) goto end;
+
+      if (pd->nvtx == 0)
+        set_unsupported("ParMETIS with processes without nodes");
+      if ((rtc = check_supported()) != RTC_NORMAL) goto end;
+      rtc = RTC_ERROR;
+      if (parmetis_partition(pd, vtxdist, adj_index, reply)) goto end;
+      break;
+#endif
+
+    default:
+      HECMW_set_error(HECMW_PART_E_INVALID_PMETHOD, "");
+      goto end;
+  }
+
+  /* edge cut */
+  for (i = 0; i < rt.nrecv; i++) val[i] = pd->part[vloc[i]];
+  if (route_reply(&rt, val, 1, reply)) goto end;
+  for (ncut = 0, i = 0; i < pd->nvtx; i++) {
+    for (j = adj_index[i]; j < adj_index[i + 1]; j++) {
+      if (reply[j] != pd->part[i]) ncut++;
+    }
+  }
+  pd->n_edgecut = (int)(sum_all(ncut) / 2);
+  if (pd->n_edgecut < 0) goto end;
+
+  rtc = RTC_NORMAL;
+
+end:
+  route_free(&rt);
+  HECMW_free(adj_index);
+  HECMW_free(adj_item);
+  HECMW_free(dest);
+  HECMW_free(vloc);
+  HECMW_free(val);
+  HECMW_free(reply);
+  HECMW_free(vtxdist);
+  return rtc;
+}
+
+/*============================================================================*/
+/*  records kept by each process                                              */
+/*============================================================================*/
+
+/*
+ * A process keeps the elements which share a node with an element touching
+ * one of its domains, the nodes of them and the smallest record of each
+ * block.
+ */
+static int collect_records(struct part_data *pd) {
+  struct elem_list *e = &pd->elem;
+  struct route rt;
+  struct node_info *info = NULL;
+  int *val = NULL, *upart = NULL, *pair = NULL, *dest = NULL;
+  int *scount = NULL, *rcount = NULL, *recv = NULL;
+  int *index = NULL, *item = NULL, *rindex = NULL, *ritem = NULL;
+  int *dindex = NULL, *list = NULL;
+  int npair, nrecv, nlist, i, j, k, m, n, u;
+
+  memset(&rt, 0, sizeof(rt));
+
+  /* domains of the nodes of the elements */
+  if ((val = alloc(pd->en.nrecv, sizeof(int))) == NULL) goto error;
+  if ((upart = alloc(pd->n_unode, sizeof(int))) == NULL) goto error;
+  for (j = 0; j < pd->en.nrecv; j++) {
+    val[j] = pd->part[pd->vtx[pd->en_node[j]]];
+  }
+  if (route_reply(&pd->en, val, 1, upart)) goto error;
+
+  /* processes writing the domains of its nodes go to the homes of them */
+  for (npair = 0, i = 0; i < e->n; i++) {
+    n = e->index[i + 1] - e->index[i];
+    npair += n * n;
+  }
+  if ((pair = alloc((size_t)npair * 2, sizeof(int))) == NULL) goto error;
+  if ((dest = alloc(npair, sizeof(int))) == NULL) goto error;
+  if ((list = alloc(e->index[e->n] + nproc, sizeof(int))) == NULL) goto error;
+  for (npair = 0, i = 0; i < e->n; i++) {
+    for (m = 0, j = e->index[i]; j < e->index[i + 1]; j++) {
+      u         = find_int(pd->unode, pd->n_unode, e->node[j]);
+      list[m++] = owner_of(pd->dfirst, upart[u]);
+    }
+    m = sort_unique(list, m, 1);
+    for (j = e->index[i]; j < e->index[i + 1]; j++) {
+      for (k = 0; k < m; k++) {
+        pair[2 * npair]     = e->node[j];
+        pair[2 * npair + 1] = list[k];
+        dest[npair++]       = home_of(e->node[j], pd->node_maxid);
+      }
+    }
+  }
+  if ((scount = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if ((rcount = alloc(nproc, sizeof(int))) == NULL) goto error;
+  if (scatter(pair, 2, npair, dest, NULL, scount, rcount, &recv, &nrecv))
+    goto error;
+  HECMW_free(pair);
+  HECMW_free(dest);
+  pair  = NULL;
+  dest  = NULL;
+  nrecv = sort_unique(recv, nrecv, 2);
+
+  /* and come back as the processes around each node */
+  if ((index = alloc(pd->en.nrecv + 1, sizeof(int))) == NULL) goto error;
+  for (n = 0, j = 0; j < pd->en.nrecv; j++) {
+    index[j] = n;
+    for (k = first_pair(recv, nrecv, pd->en.recv[j]);
+         k < nrecv && recv[2 * k] == pd->en.recv[j]; k++)
+      n++;
+  }
+  index[pd->en.nrecv] = n;
+  if ((item = alloc(n, sizeof(int))) == NULL) goto error;
+  for (j = 0; j < pd->en.nrecv; j++) {
+    k = first_pair(recv, nrecv, pd->en.recv[j]);
+    for (m = index[j]; m < index[j + 1]; m++, k++) item[m] = recv[2 * k + 1];
+  }
+  if (route_reply_list(&pd->en, index, item, &rindex, &ritem)) goto error;
+
+  /* processes keeping each element */
+  if ((dindex = alloc(e->n + 1, sizeof(int))) == NULL) goto error;
+  for (n = 0, i = 0; i < e->n; i++) {
+    for (j = e->index[i]; j < e->index[i + 1]; j++) {
+      u = find_int(pd->unode, pd->n_unode, e->node[j]);
+      n += rindex[u + 1] - rindex[u];
+    }
+  }
+  HECMW_free(list);
+  if ((list = alloc((size_t)n + (size_t)nproc * e->n, sizeof(int))) == NULL)
+    goto error;
+  for (dindex[0] = 0, nlist = 0, i = 0; i < e->n; i++) {
+    int *l = list + nlist;
+    for (m = 0, j = e->index[i]; j < e->index[i + 1]; j++) {
+      u = find_int(pd->unode, pd->n_unode, e->node[j]);
+      for (k = rindex[u]; k < rindex[u + 1]; k++) l[m++] = ritem[k];
+    }
+    if (e->id[i] == pd->rep[2 * e->block[i] + 1]) {
+      for (k = 0; k < nproc; k++) l[m++] = k;
+    }
+    nlist += sort_unique(l, m, 1);
+    dindex[i + 1] = nlist;
+  }
+  if (elem_send(e, dindex, list, &pd->kelem)) goto error;
+  if (elem_sort(&pd->kelem, 1)) goto error;
+
+  /* their nodes */
+  n = pd->kelem.index[pd->kelem.n];
+  if ((pd->knode = alloc(n + pd->nblock, sizeof(int))) == NULL) goto error;
+  memcpy(pd->knode, pd->kelem.node, sizeof(int) * n);
+  for (i = 0; i < pd->nblock; i++) {
+    if (pd->rep[2 * i] != INT_MAX) pd->knode[n++] = pd->rep[2 * i];
+  }
+  pd->n_knode = sort_unique(pd->knode, n, 1);
+
+  HECMW_free(dest);
+  if ((dest = alloc(pd->n_knode, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < pd->n_knode; i++) {
+    dest[i] = home_of(pd->knode[i], pd->node_maxid);
+  }
+  if (route_init(&rt, pd->n_knode, pd->knode, 1, dest)) goto error;
+  if ((info = alloc(rt.nrecv, sizeof(*info))) == NULL) goto error;
+  for (j = 0; j < rt.nrecv; j++) {
+    k = find_node(pd->node, pd->n_node, rt.recv[j]);
+    HECMW_assert(k >= 0);
+    memcpy(info[j].xyz, pd->node[k].xyz, sizeof(info[j].xyz));
+    info[j].block = pd->node[k].block;
+    info[j].seq   = pd->node[k].seq;
+    info[j].part  = pd->vtx[k] >= 0 ? pd->part[pd->vtx[k]] : -1;
+  }
+  if ((pd->kinfo = alloc(pd->n_knode, sizeof(*pd->kinfo))) == NULL)
+    goto error;
+  if (route_reply(&rt, (int *)info, sizeof(*info) / sizeof(int),
+                  (int *)pd->kinfo))
+    goto error;
+
+  route_free(&rt);
+  HECMW_free(info);
+  HECMW_free(val);
+  HECMW_free(upart);
+  HECMW_free(dest);
+  HECMW_free(scount);
+  HECMW_free(rcount);
+  HECMW_free(recv);
+  HECMW_free(index);
+  HECMW_free(item);
+  HECMW_free(rindex);
+  HECMW_free(ritem);
+  HECMW_free(dindex);
+  HECMW_free(list);
+  return RTC_NORMAL;
+
+error:
+  route_free(&rt);
+  HECMW_free(info);
+  HECMW_free(val);
+  HECMW_free(upart);
+  HECMW_free(pair);
+  HECMW_free(dest);
+  HECMW_free(scount);
+  HECMW_free(rcount);
+  HECMW_free(recv);
+  HECMW_free(index);
+  HECMW_free(item);
+  HECMW_free(rindex);
+  HECMW_free(ritem);
+  HECMW_free(dindex);
+  HECMW_free(list);
+  return RTC_ERROR;
+}
+
+/*============================================================================*/
+/*  mesh of this process                                                      */
+/*============================================================================*/
+
+static char *put_int(char *q, int v) {
+  char tmp[16];
+  unsigned int u = v < 0 ? 0U - (unsigned int)v : (unsigned int)v;
+  int n = 0;
+
+  if (v < 0) *q++ = '-';
+  do {
+    tmp[n++] = (char)('0' + u % 10);
+    u /= 10;
+  } while (u);
+  while (n) *q++ = tmp[--n];
+  return q;
+}
+
+/*
+ * The mesh file as this process sees it: the data lines kept are put after
+ * the header lines of their blocks. out ends with "\n\0\0".
+ */
+static int write_mesh(struct part_data *pd, struct buffer *out) {
+  const struct elem_list *e = &pd->kelem;
+  const char *p   = pd->meta.p;
+  const char *end = pd->meta.p + pd->meta.n;
+  int *order;
+  int b, i, j, k, in, ie;
+  char *q;
+
+  /* nodes in file order */
+  if ((order = alloc((size_t)pd->n_knode * 2, sizeof(int))) == NULL)
+    return RTC_ERROR;
+  for (i = 0; i < pd->n_knode; i++) {
+    order[2 * i]     = pd->kinfo[i].seq;
+    order[2 * i + 1] = i;
+  }
+  qsort(order, pd->n_knode, sizeof(int) * 2, cmp_pair);
+
+  for (b = -1, in = 0, ie = 0; p < end;) {
+    const char *next = HECMW_io_bulk_next_line(p, end);
+
+    if (buf_add(out, p, next - p)) goto error;
+    if (is_header(p)) {
+      b++;
+      for (; in < pd->n_knode; in++) {
+        k = order[2 * in + 1];
+        if (pd->kinfo[k].block != b) break;
+        if (buf_reserve(out, 128)) goto error;
+        out->n += sprintf(out->p + out->n, "%d,%.17g,%.17g,%.17g\n",
+                          pd->knode[k], pd->kinfo[k].xyz[0],
+                          pd->kinfo[k].xyz[1], pd->kinfo[k].xyz[2]);
+      }
+      for (; ie < e->n && e->block[ie] == b; ie++) {
+        k = e->index[ie + 1] - e->index[ie] + 1;
+        if (buf_reserve(out, (size_t)12 * k)) goto error;
+        q = put_int(out->p + out->n, e->id[ie]);
+        for (j = e->index[ie]; j < e->index[ie + 1]; j++) {
+          *q++ = ',';
+          q    = put_int(q, e->node[j]);
+        }
+        *q++   = '\n';
+        out->n = q - out->p;
+      }
+    }
+    p = next;
+  }
+  HECMW_assert(in == pd->n_knode && ie == e->n);
+  if (buf_add(out, "\n\0\0", 3)) goto error;
+
+  HECMW_free(order);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(order);
+  return RTC_ERROR;
+}
+
+/*
+ * Local IDs of the nodes or elements of other processes' domains are
+ * asked at the processes writing them.
+ */
+static int ask_local_id(struct part_data *pd, int n, const int *gid,
+                        int *wnum) {
+  struct route rt;
+  int *req = NULL, *dest = NULL, *table = NULL, *val = NULL, *reply = NULL;
+  int nreq, ntable, i, j, k;
+
+  memset(&rt, 0, sizeof(rt));
+  if ((req = alloc(n, sizeof(int))) == NULL) goto error;
+  if ((dest = alloc(n, sizeof(int))) == NULL) goto error;
+  if ((table = alloc((size_t)n * 2, sizeof(int))) == NULL) goto error;
+  for (nreq = 0, ntable = 0, i = 0; i < n; i++) {
+    if (wnum[2 * i] < 0) {
+      req[nreq]    = gid[i];
+      dest[nreq++] = owner_of(pd->dfirst, wnum[2 * i + 1]);
+    } else {
+      table[2 * ntable]       = gid[i];
+      table[2 * ntable++ + 1] = wnum[2 * i];
+    }
+  }
+  qsort(table, ntable, sizeof(int) * 2, cmp_pair);
+
+  if (route_init(&rt, nreq, req, 1, dest)) goto error;
+  if ((val = alloc(rt.nrecv, sizeof(int))) == NULL) goto error;
+  for (j = 0; j < rt.nrecv; j++) {
+    int key[2], *p;
+    key[0] = rt.recv[j];
+    p      = bsearch(key, table, ntable, sizeof(int) * 2, cmp_int);
+    HECMW_assert(p);
+    val[j] = p ? p[1] : -1;
+  }
+  if ((reply = alloc(nreq, sizeof(int))) == NULL) goto error;
+  if (route_reply(&rt, val, 1, reply)) goto error;
+  for (k = 0, i = 0; i < n; i++) {
+    if (wnum[2 * i] < 0) wnum[2 * i] = reply[k++];
+  }
+
+  route_free(&rt);
+  HECMW_free(req);
+  HECMW_free(dest);
+  HECMW_free(table);
+  HECMW_free(val);
+  HECMW_free(reply);
+  return RTC_NORMAL;
+
+error:
+  route_free(&rt);
+  HECMW_free(req);
+  HECMW_free(dest);
+  HECMW_free(table);
+  HECMW_free(val);
+  HECMW_free(reply);
+  return RTC_ERROR;
+}
+
+/*
+ * The DOF groups of the entire mesh: the nodes of this mesh which are not
+ * in the local meshes may be in a group the entire mesh does not have.
+ */
+static int set_dof_groups(struct part_data *pd,
+                          struct hecmwST_local_mesh *mesh) {
+  static const int dof[N_DOF_CLASS] = {
+      HECMW_MESH_DOF_SIX, HECMW_MESH_DOF_FOUR, HECMW_MESH_DOF_THREE,
+      HECMW_MESH_DOF_TWO};
+  int flag[N_DOF_CLASS], any[N_DOF_CLASS];
+  int grp[N_DOF_CLASS], last[N_DOF_CLASS + 1];
+  int *index, *item;
+  int dS = pd->dfirst[myrank], dE = pd->dfirst[myrank + 1];
+  int i, j, k, n;
+
+  for (k = 0; k < N_DOF_CLASS; k++) flag[k] = 0;
+  for (i = 0; i < mesh->n_dof_grp; i++) {
+    for (k = 0; dof[k] != mesh->node_dof_item[i]; k++)
+      ;
+    for (j = mesh->node_dof_index[i]; j < mesh->node_dof_index[i + 1]; j++) {
+      int d = mesh->node_ID[2 * j + 1];
+      if (dS <= d && d < dE) flag[k] = 1;
+    }
+  }
+  if (HECMW_Allreduce(flag, any, N_DOF_CLASS, HECMW_INT, HECMW_MAX,
+                      comm))
+    return RTC_ERROR;
+
+  /* group of the entire mesh for each class */
+  for (n = 0, k = 0; k < N_DOF_CLASS; k++) {
+    grp[k] = any[k] ? n++ : n - 1;
+  }
+  for (k = 0; k < N_DOF_CLASS; k++) {
+    if (grp[k] < 0) grp[k] = 0;
+  }
+  HECMW_assert(n > 0);
+
+  if ((index = alloc(n + 1, sizeof(int))) == NULL) return RTC_ERROR;
+  if ((item = alloc(n, sizeof(int))) == NULL) {
+    HECMW_free(index);
+    return RTC_ERROR;
+  }
+  for (j = 0; j <= n; j++) last[j] = 0;
+  for (i = 0; i < mesh->n_dof_grp; i++) {
+    for (k = 0; dof[k] != mesh->node_dof_item[i]; k++)
+      ;
+    last[grp[k] + 1] = mesh->node_dof_index[i + 1];
+  }
+  for (index[0] = 0, j = 0, k = 0; k < N_DOF_CLASS; k++) {
+    if (!any[k]) continue;
+    item[j]      = dof[k];
+    index[j + 1] = last[j + 1] > index[j] ? last[j + 1] : index[j];
+    j++;
+  }
+  index[n] = mesh->n_node;
+
+  HECMW_free(mesh->node_dof_index);
+  HECMW_free(mesh->node_dof_item);
+  mesh->node_dof_index = index;
+  mesh->node_dof_item  = item;
+  mesh->n_dof_grp      = n;
+  mesh->n_dof          = item[0];
+  return RTC_NORMAL;
+}
+
+/*
+ * The node groups of the entire mesh: when it has nodes not in use, the
+ * serial reader drops the node groups left empty after removing them.
+ */
+static int set_node_groups(struct part_data *pd,
+                           struct hecmwST_local_mesh *mesh) {
+  struct hecmwST_node_grp *grp = mesh->node_group;
+  struct hecmwST_contact_pair *cp = mesh->contact_pair;
+  int *flag = NULL, *any = NULL;
+  int n[2], all[2];
+  int i, j;
+
+  n[0] = grp->n_grp;
+  n[1] = -grp->n_grp;
+  if (HECMW_Allreduce(n, all, 2, HECMW_INT, HECMW_MAX, comm))
+    return RTC_ERROR;
+  if (all[0] != -all[1]) {
+    set_unsupported("node groups that differ between the processes");
+    return RTC_NORMAL;
+  }
+  if (pd->n_unused_g == 0 || grp->n_grp == 0) return RTC_NORMAL;
+
+  if ((flag = alloc(grp->n_grp, sizeof(int))) == NULL) goto error;
+  if ((any = alloc(grp->n_grp, sizeof(int))) == NULL) goto error;
+  for (i = 0; i < grp->n_grp; i++) {
+    flag[i] = grp->grp_index[i + 1] > grp->grp_index[i];
+  }
+  if (HECMW_Allreduce(flag, any, grp->n_grp, HECMW_INT, HECMW_MAX, comm))
+    goto error;
+
+  /* new IDs, from 1 */
+  for (j = 0, i = 0; i < grp->n_grp; i++) flag[i] = any[i] ? ++j : 0;
+  for (i = 0; i < cp->n_pair; i++) {
+    if (cp->type[i] != HECMW_CONTACT_TYPE_NODE_SURF) continue;
+    if (flag[cp->slave_grp_id[i] - 1] == 0) {
+      set_unsupported("contact with a node group of unused nodes");
+      goto end;
+    }
+    cp->slave_grp_id[i] = flag[cp->slave_grp_id[i] - 1];
+  }
+  for (j = 0, i = 0; i < grp->n_grp; i++) {
+    if (!any[i]) {
+      HECMW_free(grp->grp_name[i]);
+      continue;
+    }
+    grp->grp_name[j]      = grp->grp_name[i];
+    grp->grp_index[j + 1] = grp->grp_index[i + 1];
+    j++;
+  }
+  grp->n_grp = j;
+
+end:
+  HECMW_free(flag);
+  HECMW_free(any);
+  return RTC_NORMAL;
+
+error:
+  HECMW_free(flag);
+  HECMW_free(any);
+  return RTC_ERROR;
+}
+
+/* double numbering of the nodes and elements as the serial partitioner */
+static int set_numbering(struct part_data *pd,
+                         struct hecmwST_local_mesh *mesh) {
+  int dS = pd->dfirst[myrank], dE = pd->dfirst[myrank + 1];
+  int *counter;
+  int i, j, k, d;
+
+  for (i = 0; i < mesh->n_node; i++) {
+    k = find_int(pd->knode, pd->n_knode, mesh->global_node_ID[i]);
+    HECMW_assert(k >= 0 && pd->kinfo[k].part >= 0);
+    mesh->node_ID[2 * i + 1] = pd->kinfo[k].part;
+  }
+  for (i = 0; i < mesh->n_elem; i++) {
+    int min_domain = pd->cont_data->n_domain;
+    for (j = mesh->elem_node_index[i]; j < mesh->elem_node_index[i + 1]; j++) {
+      d = mesh->node_ID[2 * (mesh->elem_node_item[j] - 1) + 1];
+      if (d < min_domain) min_domain = d;
+    }
+    mesh->elem_ID[2 * i + 1] = min_domain;
+  }
+
+  if ((counter = alloc(dE - dS, sizeof(int))) == NULL) return RTC_ERROR;
+  for (d = 0; d < dE - dS; d++) counter[d] = 0;
+  for (i = 0; i < mesh->n_node; i++) {
+    d                    = mesh->node_ID[2 * i + 1];
+    mesh->node_ID[2 * i] = (dS <= d && d < dE) ? ++counter[d - dS] : -1;
+  }
+  for (d = 0; d < dE - dS; d++) counter[d] = 0;
+  for (i = 0; i < mesh->n_elem; i++) {
+    d                    = mesh->elem_ID[2 * i + 1];
+    mesh->elem_ID[2 * i] = (dS <= d && d < dE) ? ++counter[d - dS] : -1;
+  }
+  HECMW_free(counter);
+
+  if (ask_local_id(pd, mesh->n_node, mesh->global_node_ID, mesh->node_ID))
+    return RTC_ERROR;
+  if (ask_local_id(pd, mesh->n_elem, mesh->global_elem_ID, mesh->elem_ID))
+    return RTC_ERROR;
+
+  return set_dof_groups(pd, mesh);
+}
+
+/*============================================================================*/
+
+static void free_part_data(struct part_data *pd) {
+  HECMW_free(pd->dfirst);
+  buf_free(&pd->meta);
+  HECMW_free(pd->rep);
+  HECMW_free(pd->node);
+  HECMW_free(pd->vtx);
+  HECMW_free(pd->part);
+  elem_free(&pd->elem);
+  HECMW_free(pd->unode);
+  route_free(&pd->en);
+  HECMW_free(pd->en_node);
+  elem_free(&pd->kelem);
+  HECMW_free(pd->knode);
+  HECMW_free(pd->kinfo);
+  memset(pd, 0, sizeof(*pd));
+}
+
+/* whether the mesh and the control data can be done in parallel */
+static void check_input(struct hecmw_ctrl_meshfiles *files,
+                        struct hecmw_part_cont_data *cont_data) {
+  if (files->n_mesh != 1 ||
+      files->meshfiles[0].type != HECMW_CTRL_FTYPE_HECMW_ENTIRE)
+    set_unsupported("mesh files other than one HECMW-ENTIRE file");
+  if (files->n_mesh > 0 && files->meshfiles[0].refine > 0)
+    set_unsupported("mesh refinement");
+  if (cont_data->type != HECMW_PART_TYPE_NODE_BASED)
+    set_unsupported("element-based partitioning");
+  if (cont_data->depth != 1) set_unsupported("depths of overlap other than 1");
+  if (cont_data->n_domain <= 1) set_unsupported("a single domain");
+#if !defined(HECMW_PART_WITH_PARMETIS) || defined(HECMW_SERIAL)
+  if (cont_data->method != HECMW_PART_METHOD_RCB)
+    set_unsupported("METIS without ParMETIS");
+#endif
+}
+
+static int set_log(struct part_data *pd) {
+  const struct hecmw_part_cont_data *cont_data = pd->cont_data;
+
+  if (HECMW_part_init_log(cont_data->n_domain)) return RTC_ERROR;
+  if (HECMW_part_set_log_n_edgecut(pd->n_edge, pd->n_edgecut))
+    return RTC_ERROR;
+  if (myrank != 0) return RTC_NORMAL;
+
+  if (HECMW_part_set_log_part_type(cont_data->type)) return RTC_ERROR;
+  if (HECMW_part_set_log_part_method(cont_data->method)) return RTC_ERROR;
+  if (HECMW_part_set_log_part_depth(cont_data->depth)) return RTC_ERROR;
+  if (HECMW_part_set_log_part_contact(cont_data->contact)) return RTC_ERROR;
+  if (HECMW_part_set_log_n_node_g((int)pd->n_node_g)) return RTC_ERROR;
+  if (HECMW_part_set_log_n_elem_g((int)pd->n_elem_g)) return RTC_ERROR;
+  return RTC_NORMAL;
+}
+
+extern int HECMW_partition_parallel(char *name_ID) {
+  struct hecmw_ctrl_meshfiles *files     = NULL;
+  struct hecmw_part_cont_data *cont_data = NULL;
+  struct hecmwST_local_mesh *mesh        = NULL;
+  struct buffer nodes = {NULL, 0, 0}, elems = {NULL, 0, 0};
+  struct buffer items = {NULL, 0, 0}, text = {NULL, 0, 0};
+  struct part_data pd;
+  int rtc = RTC_ERROR;
+  int r;
+
+  memset(&pd, 0, sizeof(pd));
+  comm        = HECMW_comm_get_comm();
+  nproc       = HECMW_comm_get_size();
+  myrank      = HECMW_comm_get_rank();
+  unsupported = NULL;
+
+  if ((files = HECMW_ctrl_get_meshfiles(name_ID)) == NULL) goto end;
+  if ((cont_data = HECMW_part_get_control()) == NULL) goto end;
+  check_input(files, cont_data);
+  if ((rtc = check_supported()) != RTC_NORMAL) goto end;
+  rtc = RTC_ERROR;
+
+  if (cont_data->is_print_ucd == 1) {
+    HECMW_log(HECMW_LOG_WARN,
+              "UCD output is not available in parallel partitioning");
+    cont_data->is_print_ucd = 0;
+  }
+
+  pd.filename  = files->meshfiles[0].filename;
+  pd.cont_data = cont_data;
+  if ((pd.dfirst = alloc(nproc + 1, sizeof(int))) == NULL) goto end;
+  for (r = 0; r <= nproc; r++) {
+    pd.dfirst[r] = (int)((long long)r * cont_data->n_domain / nproc);
+  }
+
+  HECMW_log(HECMW_LOG_INFO, "Reading mesh file in parallel...");
+  if (read_mesh(&pd, &nodes, &elems, &items)) goto end;
+  if (gather_meta(&pd)) goto end;
+  if ((rtc = check_supported()) != RTC_NORMAL) goto end;
+  rtc = RTC_ERROR;
+
+  if (distribute_records(&pd, &nodes, &elems, &items)) goto end;
+  if ((rtc = check_supported()) != RTC_NORMAL) goto end;
+  rtc = RTC_ERROR;
+  if (check_elem_nodes(&pd)) goto end;
+  if ((rtc = check_supported()) != RTC_NORMAL) goto end;
+  rtc = RTC_ERROR;
+  if ((pd.n_node_g = sum_all(pd.nvtx)) < 0) goto end;
+  if ((pd.n_elem_g = sum_all(pd.elem.n)) < 0) goto end;
+  if ((pd.n_unused_g = sum_all(pd.n_node - pd.nvtx)) < 0) goto end;
+
+  HECMW_log(HECMW_LOG_INFO, "Starting domain decomposition...\n");
+  if ((rtc = partition_graph(&pd)) != RTC_NORMAL) goto end;
+  rtc = RTC_ERROR;
+  if (collect_records(&pd)) goto end;
+  if (write_mesh(&pd, &text)) goto end;
+
+  HECMW_io_set_partial_mesh(1);
+  mesh = HECMW_get_entire_mesh_buffer(pd.filename, text.p, text.n);
+  HECMW_io_set_partial_mesh(0);
+  buf_free(&text);
+  if (mesh == NULL) goto end;
+
+  if (set_node_groups(&pd, mesh)) goto end;
+  if ((rtc = check_supported()) != RTC_NORMAL) goto end;
+  rtc = RTC_ERROR;
+  if (set_numbering(&pd, mesh)) goto end;
+  if (set_log(&pd)) goto end;
+  if (HECMW_partition_subdomains(mesh, cont_data, pd.dfirst[myrank],
+                                 pd.dfirst[myrank + 1]))
+    goto end;
+  HECMW_part_finalize_log();
+
+  HECMW_log(HECMW_LOG_INFO, "Domain decomposition done\n");
+  rtc = RTC_NORMAL;
+
+end:
+  HECMW_dist_free(mesh);
+  buf_free(&nodes);
+  buf_free(&elems);
+  buf_free(&items);
+  buf_free(&text);
+  free_part_data(&pd);
+  if (cont_data) HECMW_part_free_control(cont_data);
+  if (files) HECMW_ctrl_free_meshfiles(files);
+  return rtc;
+}
@@ -0,0 +1,17 @@
+/*****************************************************************************
+ * Copyright (c) 2019 FrontISTR Commons
+ * This software is released under the MIT License, see LICENSE.txt
+ *****************************************************************************/
+
+#ifndef INC_HECMW_PARTITION_PARALLEL
+#define INC_HECMW_PARTITION_PARALLEL
+
+/*
+ * Read the entire mesh name_ID and write its distributed meshes with all
+ * processes working on their own part of the mesh.
+ * Returns 0 on success, 1 if the mesh or the partitioning control data need
+ * the serial partitioner, and -1 on error.
+ */
+extern int HECMW_partition_parallel(char *name_ID);
+
+#endif /* INC_HECMW_PARTITION_PARALLEL */
@@ -13,6 +13,7 @@
 #include "hecmw_io.h"
 #include "hecmw_init_for_partition.h"
 #include "hecmw_partition.h"
+#include "hecmw_partition_parallel.h"
 
 int main(int argc, char **argv) {
   struct hecmwST_local_mesh *global_mesh = NULL;
@@ -25,6 +26,16 @@ int main(int argc, char **argv) {
   rtc = HECMW_init_for_partition(argc, argv);
   if (rtc != 0) goto error;
 
+  if (HECMW_part_is_parallel()) {
+    rtc = HECMW_partition_parallel("part_in");
+    if (rtc < 0) goto error;
+    if (rtc == 0) {
+      HECMW_finalize();
+      return 0;
+    }
+    HECMW_log(HECMW_LOG_INFO, "Falling back to serial partitioning");
+  }
+
   HECMW_log(HECMW_LOG_INFO, "Reading mesh file...");
   global_mesh = HECMW_get_mesh("part_in");
   if (global_mesh == NULL) goto error;
@@ -6,6 +6,7 @@
 /*
  * FSTR result 出力ファイルを1つのファイルに統合する。
  * 計算に用いたコントロールファイル、メッシュデータが必要
+ * MPI で複数プロセス実行した場合はステップを分担して処理する。
  */
 
 #include "fstr_rmerge_util.h"
@@ -28,7 +29,7 @@ void help(void) {
   printf("usage)  rmerge [options] out_fileheader\n");
   printf("[option]\n");
   printf(" -h             : help\n");
-  printf(" -o [type]      : output file type (binary/text)\n");
+  printf(" -o [type]      : output file type (binary/text/compressed)\n");
   printf(" -n [rank]      : number of ranks (default:%d)\n", nrank);
   printf(" -s [step]      : start step number (default:%d)\n", strid);
   printf(" -e [step]      : end step number (default:%d)\n", endid);
@@ -54,8 +55,11 @@ void set_fname(int argc, char** argv, char* out_fheader, int* binary) {
         *binary = 1;
       } else if (!strcmp(argv[i], "text")) {
         *binary = 0;
+      } else if (!strcmp(argv[i], "compressed")) {
+        *binary = 2;
       } else {
-        fprintf(stderr, "Error : text or binary is required after -o\n");
+        fprintf(stderr,
+                "Error : text, binary or compressed is required after -o\n");
         exit(-1);
       }
     } else if (strcmp(argv[i], "-n") == 0) {
@@ -123,13 +127,12 @@ void set_fname(int argc, char** argv, char* out_fheader, int* binary) {
 
 int main(int argc, char** argv) {
   int area_n, step_n, binary, refine, fg_text;
-  int step, rcode;
+  int step, rcode, myrank, nprocs, count;
   char out_fheader[HECMW_HEADER_LEN + 1];
   char out_fname[HECMW_FILENAME_LEN + 1];
   struct hecmwST_local_mesh** mesh;
   struct hecmwST_local_mesh* glmesh;
   struct hecmwST_result_data* data;
-  fstr_res_info** res;
   fstr_glt* glt;
   char header[HECMW_HEADER_LEN + 1];
   char comment[HECMW_MSG_LEN + 1];
@@ -141,52 +144,51 @@ int main(int argc, char** argv) {
   log_fp = stderr;
 
   if (HECMW_init(&argc, &argv)) error_stop();
+  myrank = HECMW_comm_get_rank();
+  nprocs = HECMW_comm_get_size();
 
   set_fname(argc, argv, out_fheader, &binary);
-  fprintf(log_fp, "out file name header is %s\n", out_fheader);
-
-  mesh = fstr_get_all_local_mesh("fstrMSH", &area_n, &refine);
-  if (!mesh) error_stop();
-
-  fprintf(log_fp, "table creating .. \n");
-  glt = fstr_create_glt(mesh, area_n);
+  if (myrank == 0) fprintf(log_fp, "out file name header is %s\n", out_fheader);
+
+  /* the table is built once by rank 0 and shared by all steps and ranks */
+  glt    = NULL;
+  refine = 0;
+  if (myrank == 0) {
+    mesh = fstr_get_all_local_mesh("fstrMSH", &area_n, &refine);
+    if (!mesh) {
+      if (nprocs == 1) error_stop();
+    } else {
+      fprintf(log_fp, "table creating .. \n");
+      glt = fstr_create_glt(mesh, area_n);
+      fstr_free_mesh(mesh, area_n);
+    }
+  }
+  glt = fstr_bcast_glt(glt, &refine);
   if (!glt) {
     fprintf(stderr, "ERROR : Cannot create global_local table.\n");
-    fstr_free_mesh(mesh, area_n);
     exit(-1);
   }
 
   glmesh = fstr_create_glmesh(glt);
   if (!glmesh) {
     fprintf(stderr, "ERROR : Cannot create global table.\n");
-    fstr_free_mesh(mesh, area_n);
     fstr_free_glt(glt);
     exit(-1);
   }
 
-  fstr_free_mesh(mesh, area_n);
-
   step_n = fstr_get_step_n("fstrRES");
 
+  data  = NULL;
+  count = 0;
   for (step = strid; step <= step_n; step++) {
     if ((step % intid) != 0 && step != step_n) continue;
+    if ((count++) % nprocs != myrank) continue;
 
-    fprintf(log_fp, "step:%d .. reading .. ", step);
-    res = fstr_get_all_result("fstrRES", step, area_n, refine);
-    if (!res) {
-      fstr_free_result(res, area_n);
-      continue;
-    }
-    fprintf(log_fp, "end\n");
-
-    fprintf(log_fp, "step:%d .. combining .. ", step);
-    data = fstr_all_result(glt, res, refine);
+    fprintf(log_fp, "step:%d .. reading and combining .. ", step);
+    data = fstr_merge_result(glt, "fstrRES", step, refine, data);
     if (!data) {
-      fprintf(stderr, "ERROR : Cannot combine result structure.\n");
-      fstr_free_glt(glt);
-      fstr_free_glmesh(glmesh);
-      fstr_free_result(res, area_n);
-      exit(-1);
+      fprintf(log_fp, "skipped\n");
+      continue;
     }
     fprintf(log_fp, "end\n");
 
@@ -200,6 +202,7 @@ int main(int argc, char** argv) {
         return 0;
     }
     strcpy(buff, fileheader);
+    HECMW_free(fileheader);
     strcpy(dirname, "");
     ptoken = strtok(buff, "/");
     ntoken = strtok(NULL, "/");
@@ -214,7 +217,10 @@ int main(int argc, char** argv) {
     HECMW_result_get_header(header);
     HECMW_result_get_comment(comment);
     HECMW_result_init(glmesh, step, header, comment);
-    if (binary) {
+    if (binary == 2) {
+      rcode = HECMW_result_write_cmp_ST_by_fname(
+          out_fname, data, glt->node_n, glt->elem_n, header, comment, 0.0);
+    } else if (binary) {
       rcode = HECMW_result_write_bin_ST_by_fname(out_fname, data, glt->node_n,
                                                  glt->elem_n, header, comment);
     } else {
@@ -225,16 +231,14 @@ int main(int argc, char** argv) {
       fprintf(stderr, "ERROR : Cannot open/write file %s\n", out_fname);
       fstr_free_glt(glt);
       fstr_free_glmesh(glmesh);
-      fstr_free_result(res, area_n);
       HECMW_result_free(data);
       exit(-1);
     }
+    HECMW_result_finalize();
     fprintf(log_fp, "end\n");
-
-    fstr_free_result(res, area_n);
-    HECMW_result_free(data);
   }
 
+  HECMW_result_free(data);
   fstr_free_glt(glt);
   fstr_free_glmesh(glmesh);
 
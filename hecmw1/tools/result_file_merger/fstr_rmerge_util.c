@@ -142,7 +142,6 @@ void fstr_free_mesh(struct hecmwST_local_mesh** mesh, int area_n) {
  */
 
 int fstr_get_step_n(char* name_ID) {
-  FILE* fp;
   int step, fg_text;
   char* fheader;
   char fname[HECMW_FILENAME_LEN + 1];
@@ -163,293 +162,257 @@ int fstr_get_step_n(char* name_ID) {
   while (1) {
     sprintf(fname, "%s.0.%d", fheader, step);
     out_log("try open : %s  ... ", fname);
-    fp = fopen(fname, "r");
-    if (!fp) {
+    if (HECMW_result_checkfile_by_fname(fname)) {
       out_log("fail\n");
       out_log("step number is %d\n", step - 1);
       return step - 1;
     } else {
       out_log("success\n");
-      fclose(fp);
     }
     step++;
   }
 }
 
 /**
- * @brief ステップの全領域データの読み込み
+ * @brief 結果データの成分構成が等しいか調べる
  */
 
-fstr_res_info** fstr_get_all_result(char* name_ID, int step, int area_n,
-                                    int refine) {
-  char* fheader;
-  char fname[HECMW_FILENAME_LEN + 1];
-  fstr_res_info** res;
-  struct hecmwST_result_data* data;
-  int i, j, k, count, num, nnode, nelem, flag, fg_text;
-  int *node_gid, *elem_gid;
-  int refine_nnode = 0;
+static int is_same_layout(struct hecmwST_result_data* a,
+                          struct hecmwST_result_data* b) {
+  int i;
 
-  if (nrank == 0) {
-    if ((fheader = HECMW_ctrl_get_result_fileheader(name_ID, step,
-                                                    &fg_text)) == NULL)
-      return 0;
+  if (a->ng_component != b->ng_component) return 0;
+  if (a->nn_component != b->nn_component) return 0;
+  if (a->ne_component != b->ne_component) return 0;
+  for (i = 0; i < a->ng_component; i++) {
+    if (a->ng_dof[i] != b->ng_dof[i]) return 0;
+    if (strcmp(a->global_label[i], b->global_label[i])) return 0;
+  }
+  for (i = 0; i < a->nn_component; i++) {
+    if (a->nn_dof[i] != b->nn_dof[i]) return 0;
+    if (strcmp(a->node_label[i], b->node_label[i])) return 0;
   }
+  for (i = 0; i < a->ne_component; i++) {
+    if (a->ne_dof[i] != b->ne_dof[i]) return 0;
+    if (strcmp(a->elem_label[i], b->elem_label[i])) return 0;
+  }
+  return 1;
+}
 
-  res = HECMW_malloc(area_n * sizeof(fstr_res_info*));
-  if (!res) return NULL;
+static int count_item(int n_component, int* dof) {
+  int i, n = 0;
 
-  for (i = 0; i < area_n; i++) {
-    res[i] = HECMW_malloc(sizeof(fstr_res_info));
-    if (!res[i]) return NULL;
+  for (i = 0; i < n_component; i++) n += dof[i];
+  return n;
+}
+
+/**
+ * @brief 単一領域の結果データの確保 (成分構成は src と同じ)
+ */
+
+static struct hecmwST_result_data* alloc_merged_result(
+    struct hecmwST_result_data* src, int node_n, int elem_n) {
+  struct hecmwST_result_data* data;
+  int i, gitem, nitem, eitem;
+
+  gitem = count_item(src->ng_component, src->ng_dof);
+  nitem = count_item(src->nn_component, src->nn_dof);
+  eitem = count_item(src->ne_component, src->ne_dof);
+
+  data = HECMW_calloc(1, sizeof(struct hecmwST_result_data));
+  if (!data) return NULL;
+  data->ng_component = src->ng_component;
+  data->nn_component = src->nn_component;
+  data->ne_component = src->ne_component;
+  data->ng_dof       = HECMW_malloc(src->ng_component * sizeof(int));
+  data->global_label = HECMW_malloc(src->ng_component * sizeof(char*));
+  data->global_val_item = HECMW_malloc(gitem * sizeof(double));
+  data->nn_dof       = HECMW_malloc(src->nn_component * sizeof(int));
+  data->node_label   = HECMW_malloc(src->nn_component * sizeof(char*));
+  data->node_val_item =
+      HECMW_malloc((size_t)nitem * node_n * sizeof(double));
+  data->ne_dof     = HECMW_malloc(src->ne_component * sizeof(int));
+  data->elem_label = HECMW_malloc(src->ne_component * sizeof(char*));
+  data->elem_val_item =
+      HECMW_malloc((size_t)eitem * elem_n * sizeof(double));
+
+  for (i = 0; i < src->ng_component; i++) {
+    data->ng_dof[i]       = src->ng_dof[i];
+    data->global_label[i] = HECMW_strdup(src->global_label[i]);
+  }
+  for (i = 0; i < src->nn_component; i++) {
+    data->nn_dof[i]     = src->nn_dof[i];
+    data->node_label[i] = HECMW_strdup(src->node_label[i]);
+  }
+  for (i = 0; i < src->ne_component; i++) {
+    data->ne_dof[i]     = src->ne_dof[i];
+    data->elem_label[i] = HECMW_strdup(src->elem_label[i]);
+  }
+  return data;
+}
+
+/**
+ * @brief ステップの全領域データの結合
+ *
+ * 領域の結果を1つずつ読み込み、対応表に従って直ちに単一領域データへ
+ * 配置してから解放するので、同時に保持するのは1領域分だけである。
+ * data に前ステップの結合結果を渡すと、成分構成が同じならその領域を
+ * 再利用する。失敗した場合は data を解放して NULL を返す。
+ */
 
+struct hecmwST_result_data* fstr_merge_result(
+    fstr_glt* glt, char* name_ID, int step, int refine,
+    struct hecmwST_result_data* data) {
+  char* fheader = NULL;
+  char fname[HECMW_FILENAME_LEN + 1];
+  struct hecmwST_result_data* area_data = NULL;
+  int i, j, k, pos, row, nitem, eitem, nnode, count, fg_text;
+  int* rows = NULL;
+
+  if (nrank == 0) {
+    fheader = HECMW_ctrl_get_result_fileheader(name_ID, step, &fg_text);
+    if (!fheader) goto error;
+  }
+
+  for (i = 0; i < glt->area_n; i++) {
     if (nrank != 0) {
-      if ((fheader = HECMW_ctrl_get_result_fileheader_sub(
-               name_ID, step, nrank, i, &fg_text)) == NULL)
-        return 0;
+      HECMW_free(fheader);
+      fheader =
+          HECMW_ctrl_get_result_fileheader_sub(name_ID, step, nrank, i, &fg_text);
+      if (!fheader) goto error;
     }
     sprintf(fname, "%s.%d.%d", fheader, i, step);
-    data = HECMW_result_read_by_fname(fname);
-    if (!data) return NULL;
-    nnode    = HECMW_result_get_nnode();
-    node_gid = HECMW_malloc(nnode * sizeof(int));
-    if (!node_gid) return NULL;
-    HECMW_result_get_nodeID(node_gid);
-    nelem    = HECMW_result_get_nelem();
-    elem_gid = HECMW_malloc(nelem * sizeof(int));
-    if (!elem_gid) return NULL;
-    if (data->ne_component) HECMW_result_get_elemID(elem_gid);
-
-    if (refine) {
-      res[i]->result = HECMW_malloc(sizeof(struct hecmwST_result_data));
-      if (!res[i]->result) return NULL;
-
-      res[i]->result->ng_component = data->ng_component;
-      res[i]->result->ng_dof = HECMW_malloc(data->ng_component * sizeof(int));
-      if (!res[i]->result->ng_dof) return NULL;
-      res[i]->result->global_label =
-          HECMW_malloc(data->ng_component * sizeof(char*));
-      if (!res[i]->result->global_label) return NULL;
-      for (j = 0; j < data->ng_component; j++) {
-        res[i]->result->ng_dof[j]     = data->ng_dof[j];
-        res[i]->result->global_label[j] = HECMW_strdup(data->global_label[j]);
-      }
+    area_data = HECMW_result_read_by_fname(fname);
+    if (!area_data) goto error;
 
-      res[i]->result->nn_component = data->nn_component;
-      res[i]->result->nn_dof = HECMW_malloc(data->nn_component * sizeof(int));
-      if (!res[i]->result->nn_dof) return NULL;
-      res[i]->result->node_label =
-          HECMW_malloc(data->nn_component * sizeof(char*));
-      if (!res[i]->result->node_label) return NULL;
-      num = 0;
-      for (j = 0; j < data->nn_component; j++) {
-        res[i]->result->nn_dof[j]     = data->nn_dof[j];
-        res[i]->result->node_label[j] = HECMW_strdup(data->node_label[j]);
-        num += data->nn_dof[j];
+    if (i == 0) {
+      if (data && !is_same_layout(data, area_data)) {
+        HECMW_result_free(data);
+        data = NULL;
       }
-
-      count = 1;
-      flag  = 0;
-      for (j = 1; j < nnode; j++) {
-        if (flag == refine) break;
-        count++;
-        if (node_gid[j] > 0 && node_gid[j - 1] < 0) flag++;
-        if (node_gid[j] < 0 && node_gid[j] > node_gid[j - 1]) flag++;
+      if (!data) {
+        data = alloc_merged_result(area_data, glt->node_n, glt->elem_n);
+        if (!data) goto error;
       }
-      count--;
-      out_log("\narea:%d -- refined_nn_internal:%d", i, count);
-      refine_nnode += count;
+      memcpy(data->global_val_item, area_data->global_val_item,
+             count_item(data->ng_component, data->ng_dof) * sizeof(double));
+    } else if (!is_same_layout(data, area_data)) {
+      fprintf(stderr, "ERROR : components of %s differ from area 0.\n", fname);
+      goto error;
+    }
+    nitem = count_item(data->nn_component, data->nn_dof);
+    eitem = count_item(data->ne_component, data->ne_dof);
 
-      count = 0;
-      for (j = 0; j < nnode; j++)
-        if (node_gid[j] > 0) count++;
-      res[i]->nnode_gid = count;
-      res[i]->result->node_val_item =
-          HECMW_malloc(num * count * sizeof(double));
-      if (!res[i]->result->node_val_item) return NULL;
+    /* refine : the values of the nodes with positive global ID are used */
+    nnode = HECMW_result_get_nnode();
+    if (refine) {
+      rows = HECMW_malloc(nnode * sizeof(int));
+      if (!rows) goto error;
+      HECMW_result_get_nodeID(rows);
       count = 0;
       for (j = 0; j < nnode; j++) {
-        if (node_gid[j] > 0) {
-          for (k = 0; k < num; k++) {
-            res[i]->result->node_val_item[count++] =
-                data->node_val_item[num * j + k];
-          }
-        }
-      }
-
-      res[i]->result->ne_component = data->ne_component;
-      res[i]->result->ne_dof = HECMW_malloc(data->ne_component * sizeof(int));
-      if (!res[i]->result->ne_dof) return NULL;
-      res[i]->result->elem_label =
-          HECMW_malloc(data->ne_component * sizeof(char*));
-      if (!res[i]->result->elem_label) return NULL;
-      num = 0;
-      for (j = 0; j < data->ne_component; j++) {
-        res[i]->result->ne_dof[j]     = data->ne_dof[j];
-        res[i]->result->elem_label[j] = HECMW_strdup(data->elem_label[j]);
-        num += data->ne_dof[j];
+        if (rows[j] > 0) rows[count++] = j;
       }
+    } else {
+      count = nnode;
+    }
 
-      count = 0;
-      for (j = 0; j < nelem; j++)
-        if (elem_gid[j] > 0) count++;
-      out_log("\narea:%d -- ne_original from result:%d", i, count);
-      res[i]->nelem_gid = count;
-      res[i]->result->elem_val_item =
-          HECMW_malloc(num * count * sizeof(double));
-      if (!res[i]->result->elem_val_item) return NULL;
-      count = 0;
-      for (j = 0; j < nelem; j++) {
-        if (elem_gid[j] > 0) {
-          for (k = 0; k < num; k++) {
-            res[i]->result->elem_val_item[count++] =
-                data->elem_val_item[num * j + k];
-          }
-        }
-      }
-
-      HECMW_result_free(data);
-      HECMW_result_free_nodeID();
-      HECMW_result_free_elemID();
-
-      res[i]->node_gid = HECMW_malloc(res[i]->nnode_gid * sizeof(int));
-      if (!res[i]->node_gid) return NULL;
-      count = 0;
-      for (j = 0; j < nnode; j++) {
-        if (node_gid[j] > 0) res[i]->node_gid[count++] = node_gid[j];
+    for (j = glt->node_index[i]; j < glt->node_index[i + 1]; j++) {
+      pos = glt->node_item[j];
+      row = glt->nrec[pos].local;
+      if (row >= count) {
+        fprintf(stderr, "ERROR : node %d is not found in %s.\n",
+                glt->nrec[pos].global, fname);
+        goto error;
       }
-      free(node_gid);
+      if (refine) row = rows[row];
+      memcpy(&data->node_val_item[(size_t)nitem * pos],
+             &area_data->node_val_item[(size_t)nitem * row],
+             nitem * sizeof(double));
+    }
 
-      res[i]->elem_gid = HECMW_malloc(res[i]->nelem_gid * sizeof(int));
-      if (!res[i]->elem_gid) return NULL;
-      count = 0;
-      for (j = 0; j < nelem; j++) {
-        if (elem_gid[j] > 0) res[i]->elem_gid[count++] = elem_gid[j];
+    for (j = glt->elem_index[i]; j < glt->elem_index[i + 1]; j++) {
+      pos = glt->elem_item[j];
+      row = glt->erec[pos].local;
+      if (refine) {
+        for (k = 0; k < eitem; k++)
+          data->elem_val_item[(size_t)eitem * pos + k] = 0.0;
+      } else {
+        memcpy(&data->elem_val_item[(size_t)eitem * pos],
+               &area_data->elem_val_item[(size_t)eitem * row],
+               eitem * sizeof(double));
       }
-      free(elem_gid);
-    } else {
-      res[i]->result    = data;
-      res[i]->nnode_gid = nnode;
-      res[i]->node_gid  = node_gid;
-      res[i]->nelem_gid = nelem;
-      res[i]->elem_gid  = elem_gid;
     }
+
+    HECMW_free(rows);
+    rows = NULL;
+    HECMW_result_free(area_data);
+    area_data = NULL;
+    HECMW_result_free_nodeID();
+    HECMW_result_free_elemID();
   }
 
-  if (refine) out_log("\ntotal refined_nn_internal:%d\n", refine_nnode);
+  HECMW_free(fheader);
+  return data;
 
-  return res;
+error:
+  HECMW_free(rows);
+  HECMW_free(fheader);
+  HECMW_result_free(area_data);
+  HECMW_result_free(data);
+  return NULL;
 }
 
 /**
- * @brief ステップの全領域データの結合
+ * @brief グローバルとローカル、所属領域のテーブル fstr_glt の作成
  */
 
-struct hecmwST_result_data* fstr_all_result(fstr_glt* glt, fstr_res_info** res,
-                                            int refine) {
-  int i, j, k, l_id, area;
-  int gitem, nitem, eitem, count, irec;
-  struct hecmwST_result_data* data;
-
-  gitem = 0;
-  for (i = 0; i < res[0]->result->ng_component; i++)
-    gitem += res[0]->result->ng_dof[i];
-  nitem = 0;
-  for (i = 0; i < res[0]->result->nn_component; i++)
-    nitem += res[0]->result->nn_dof[i];
-  eitem = 0;
-  for (i = 0; i < res[0]->result->ne_component; i++)
-    eitem += res[0]->result->ne_dof[i];
-
-  data             = HECMW_malloc(sizeof(struct hecmwST_result_data));
-  data->ng_dof     = HECMW_malloc(res[0]->result->ng_component * sizeof(int));
-  data->global_label = HECMW_malloc(res[0]->result->ng_component * sizeof(char*));
-  data->global_val_item = HECMW_malloc(gitem * sizeof(double));
-  data->nn_dof     = HECMW_malloc(res[0]->result->nn_component * sizeof(int));
-  data->node_label = HECMW_malloc(res[0]->result->nn_component * sizeof(char*));
-  data->node_val_item = HECMW_malloc(nitem * glt->node_n * sizeof(double));
-  data->ne_dof     = HECMW_malloc(res[0]->result->ne_component * sizeof(int));
-  data->elem_label = HECMW_malloc(res[0]->result->ne_component * sizeof(char*));
-  data->elem_val_item = HECMW_malloc(eitem * glt->elem_n * sizeof(double));
-
-  data->ng_component = res[0]->result->ng_component;
-  for (i = 0; i < res[0]->result->ng_component; i++) {
-    data->ng_dof[i]     = res[0]->result->ng_dof[i];
-    data->global_label[i] = HECMW_strdup(res[0]->result->global_label[i]);
-  }
-  for (i = 0; i < gitem; i++) {
-    data->global_val_item[i] = res[0]->result->global_val_item[i];
-  }
-  count = 0;
-  for (i = 0; i < glt->node_n; i++) {
-    l_id = glt->nrec[i].local;
-    area = glt->nrec[i].area;
-    irec = nitem * l_id;
-    for (j = 0; j < res[0]->result->nn_component; j++) {
-      for (k = 0; k < res[0]->result->nn_dof[j]; k++) {
-        data->node_val_item[count++] = res[area]->result->node_val_item[irec++];
-      }
-    }
-  }
-  data->nn_component = res[0]->result->nn_component;
-  for (i = 0; i < res[0]->result->nn_component; i++) {
-    data->nn_dof[i]     = res[0]->result->nn_dof[i];
-    data->node_label[i] = HECMW_strdup(res[0]->result->node_label[i]);
-  }
-
-  count = 0;
-  for (i = 0; i < glt->elem_n; i++) {
-    l_id = glt->erec[i].local;
-    area = glt->erec[i].area;
-    irec = eitem * l_id;
-    for (j = 0; j < res[0]->result->ne_component; j++) {
-      for (k = 0; k < res[0]->result->ne_dof[j]; k++) {
-        if (refine) {
-          data->elem_val_item[count++] = 0.0;
-        } else {
-          data->elem_val_item[count++] =
-              res[area]->result->elem_val_item[irec++];
-        }
-      }
-    }
-  }
-  data->ne_component = res[0]->result->ne_component;
-  for (i = 0; i < res[0]->result->ne_component; i++) {
-    data->ne_dof[i]     = res[0]->result->ne_dof[i];
-    data->elem_label[i] = HECMW_strdup(res[0]->result->elem_label[i]);
-  }
-
-  return data;
+static int cmp_global_glt(const fstr_gl_rec* g1, const fstr_gl_rec* g2) {
+  return (g1->global - g2->global);
 }
 
+typedef int (*cmp_func)(const void*, const void*);
+
 /**
- * @brief fstr_res_info の削除
+ * @brief 領域ごとの対応表内の位置リストの作成
+ *
+ * 全ステップで共通なので一度だけ作成し、結合時に各領域の値を直接
+ * 配置するために用いる。
  */
 
-void fstr_free_result(fstr_res_info** res, int area_n) {
+static int create_area_list(fstr_gl_rec* rec, int n, int area_n, int** index,
+                            int** item) {
   int i;
+  int* count;
 
-  if (!res) return;
+  *index = HECMW_calloc(area_n + 1, sizeof(int));
+  *item  = HECMW_malloc(sizeof(int) * (n + 1));
+  count  = HECMW_malloc(sizeof(int) * area_n);
+  if (!*index || !*item || !count) {
+    HECMW_free(count);
+    return -1;
+  }
 
+  for (i = 0; i < n; i++) (*index)[rec[i].area + 1]++;
   for (i = 0; i < area_n; i++) {
-    HECMW_result_free(res[i]->result);
-    HECMW_free(res[i]->node_gid);
-    HECMW_free(res[i]->elem_gid);
-    HECMW_free(res[i]);
+    (*index)[i + 1] += (*index)[i];
+    count[i] = (*index)[i];
   }
-  HECMW_free(res);
-  return;
-}
-
-/**
- * @brief グローバルとローカル、所属領域のテーブル fstr_glt の作成
- */
+  for (i = 0; i < n; i++) (*item)[count[rec[i].area]++] = i;
 
-static int cmp_global_glt(const fstr_gl_rec* g1, const fstr_gl_rec* g2) {
-  return (g1->global - g2->global);
+  HECMW_free(count);
+  return 0;
 }
 
-typedef int (*cmp_func)(const void*, const void*);
+static int create_area_index(fstr_glt* glt) {
+  if (create_area_list(glt->nrec, glt->node_n, glt->area_n, &glt->node_index,
+                       &glt->node_item))
+    return -1;
+  if (create_area_list(glt->erec, glt->elem_n, glt->area_n, &glt->elem_index,
+                       &glt->elem_item))
+    return -1;
+  return 0;
+}
 
 fstr_glt* fstr_create_glt(struct hecmwST_local_mesh** mesh, int area_n) {
   int i, j, k, eid, count;
@@ -533,13 +496,65 @@ fstr_glt* fstr_create_glt(struct hecmwST_local_mesh** mesh, int area_n) {
 
   qsort(erec, all_e, sizeof(fstr_gl_rec), (cmp_func)cmp_global_glt);
 
-  glt = HECMW_malloc(sizeof(fstr_glt));
+  glt = HECMW_calloc(1, sizeof(fstr_glt));
   if (!glt) return NULL;
   glt->nrec   = nrec;
   glt->erec   = erec;
   glt->node_n = all_n;
   glt->elem_n = all_e;
+  glt->area_n = area_n;
+
+  if (create_area_index(glt)) {
+    fstr_free_glt(glt);
+    return NULL;
+  }
+
+  return glt;
+}
+
+/**
+ * @brief fstr_glt をランク0から全ランクへ配布
+ *
+ * ランク0で作成に失敗した場合 (glt が NULL) は全ランクで NULL を返す。
+ */
 
+fstr_glt* fstr_bcast_glt(fstr_glt* glt, int* refine) {
+  int myrank, nrec_int;
+  int info[4];
+  HECMW_Comm comm = HECMW_comm_get_comm();
+
+  myrank = HECMW_comm_get_rank();
+  if (myrank == 0) {
+    info[0] = glt ? glt->node_n : -1;
+    info[1] = glt ? glt->elem_n : -1;
+    info[2] = glt ? glt->area_n : -1;
+    info[3] = *refine;
+  }
+  if (HECMW_comm_get_size() == 1) return glt;
+
+  HECMW_Bcast(info, 4, HECMW_INT, 0, comm);
+  if (info[0] < 0) return NULL;
+
+  if (myrank != 0) {
+    glt = HECMW_calloc(1, sizeof(fstr_glt));
+    if (!glt) return NULL;
+    glt->node_n = info[0];
+    glt->elem_n = info[1];
+    glt->area_n = info[2];
+    *refine     = info[3];
+    glt->nrec   = HECMW_malloc(sizeof(fstr_gl_rec) * (glt->node_n + 1));
+    glt->erec   = HECMW_malloc(sizeof(fstr_gl_rec) * (glt->elem_n + 1));
+    if (!glt->nrec || !glt->erec) return NULL;
+  }
+
+  nrec_int = sizeof(fstr_gl_rec) / sizeof(int);
+  HECMW_Bcast(glt->nrec, nrec_int * glt->node_n, HECMW_INT, 0, comm);
+  HECMW_Bcast(glt->erec, nrec_int * glt->elem_n, HECMW_INT, 0, comm);
+
+  if (myrank != 0 && create_area_index(glt)) {
+    fstr_free_glt(glt);
+    return NULL;
+  }
   return glt;
 }
 
@@ -552,6 +567,10 @@ void fstr_free_glt(fstr_glt* glt) {
 
   HECMW_free(glt->nrec);
   HECMW_free(glt->erec);
+  HECMW_free(glt->node_index);
+  HECMW_free(glt->node_item);
+  HECMW_free(glt->elem_index);
+  HECMW_free(glt->elem_item);
   HECMW_free(glt);
   return;
 }
@@ -25,18 +25,6 @@
 #include "hecmw_io_dist.h"
 #include "hecmw_io_get_mesh.h"
 
-/**
- * @struct fstr_res_info
- * @brief 解析結果ファイル情報
- */
-typedef struct {
-  int nnode_gid;
-  int nelem_gid;
-  int* node_gid;
-  int* elem_gid;
-  struct hecmwST_result_data* result;
-} fstr_res_info;
-
 /**
  * @struct fstr_gl_rec
  * @brief グローバル・ローカルID対応
@@ -56,6 +44,11 @@ typedef struct {
   fstr_gl_rec* erec;
   int node_n;
   int elem_n;
+  int area_n;
+  int* node_index; /**< 領域ごとの node_item の開始位置 */
+  int* node_item;  /**< 領域ごとに並べた nrec の位置 */
+  int* elem_index; /**< 領域ごとの elem_item の開始位置 */
+  int* elem_item;  /**< 領域ごとに並べた erec の位置 */
 } fstr_glt;
 
 /**
@@ -75,26 +68,21 @@ void fstr_free_mesh(struct hecmwST_local_mesh** mesh, int area_n);
 int fstr_get_step_n(char* name_ID);
 
 /**
- * @brief ステップの全領域データの読み込み
+ * @brief ステップの全領域のデータを1領域ずつ読み込んで結合
  */
-fstr_res_info** fstr_get_all_result(char* name_ID, int step, int area_n,
-                                    int refine);
+struct hecmwST_result_data* fstr_merge_result(
+    fstr_glt* glt, char* name_ID, int step, int refine,
+    struct hecmwST_result_data* data);
 
 /**
- * @brief ステップの全領域のデータの結合
- */
-struct hecmwST_result_data* fstr_all_result(fstr_glt* glt, fstr_res_info** res,
-                                            int refine);
-
-/**
- * @biref fstr_res_info の削除
+ * @brief テーブル fstr_glt の作成
  */
-void fstr_free_result(fstr_res_info** res, int area_n);
+fstr_glt* fstr_create_glt(struct hecmwST_local_mesh** mesh, int area_n);
 
 /**
- * @brief テーブル fstr_glt の作成
+ * @brief テーブル fstr_glt をランク0から全ランクへ配布
  */
-fstr_glt* fstr_create_glt(struct hecmwST_local_mesh** mesh, int area_n);
+fstr_glt* fstr_bcast_glt(fstr_glt* glt, int* refine);
 
 /**
  * @brief fstr_glt の削除